@@ -891,7 +891,8 @@ bool ACrab::IsWithinRange(Vector &point) const
 
 bool ACrab::Look(float FOVSpread, float range)
 {
-    if (!g_SceneMan.AnythingUnseen(m_Team))
+    // Between team visibility passes there's nothing to look for
+    if (!g_SceneMan.AnythingUnseen(m_Team) || (g_SceneMan.IsTeamVisibilityEnabled() && !g_SceneMan.WantsTeamViewers()))
         return false;
 
     // Set the length of the look vector
@@ -916,6 +917,14 @@ bool ACrab::Look(float FOVSpread, float range)
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
+
+    // The team visibility pass sees the whole spread at once instead of one random ray of it
+    if (g_SceneMan.IsTeamVisibilityEnabled())
+    {
+        g_SceneMan.RegisterTeamViewer(m_Team, aimPos, lookVector, FOVSpread);
+        return false;
+    }
+
     // Add the spread
     lookVector.DegRotate(FOVSpread * RandomNormalNum());
 
@@ -928,39 +937,53 @@ bool ACrab::Look(float FOVSpread, float range)
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Virtual method:  LookForMOs
+// Virtual method:  GetMOLookRay
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Casts an MO detecting ray in the direction of where the head is looking
-//                  at the time. Factors including head rotation, sharp aim mode, and
-//                  other variables determine how this ray is cast.
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added.
 
-MovableObject * ACrab::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
+void ACrab::GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector)
 {
-    MovableObject *pSeenMO = 0;
-    Vector aimPos = m_Pos;
+    lookStart = m_Pos;
     float aimDistance = m_AimDistance + g_FrameMan.GetPlayerScreenWidth() * 0.51;   // Set the length of the look vector
 
     // If aiming down the barrel, look through that
     if (m_Controller.IsState(AIM_SHARP) && m_pTurret && m_pTurret->IsAttached() && m_pTurret->IsHeldDeviceMounted())
     {
-        aimPos = m_pTurret->GetMountedDevice()->GetPos();
+        lookStart = m_pTurret->GetMountedDevice()->GetPos();
         aimDistance += m_pTurret->GetMountedDevice()->GetSharpLength();
     }
     // If just looking, use the sensors on the turret instead
     else if (m_pTurret && m_pTurret->IsAttached())
-        aimPos = GetEyePos();
+        lookStart = GetEyePos();
     // If no turret...
     else
-        aimPos = GetCPUPos();
+        lookStart = GetCPUPos();
 
     // Create the vector to trace along
-    Vector lookVector(aimDistance, 0);
+    lookVector.SetXY(aimDistance, 0);
     // Set the rotation to the actual aiming angle
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
     // Add the spread
     lookVector.DegRotate(FOVSpread * RandomNormalNum());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  LookForMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts an MO detecting ray in the direction of where the head is looking
+//                  at the time. Factors including head rotation, sharp aim mode, and
+//                  other variables determine how this ray is cast.
+
+MovableObject * ACrab::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
+{
+    MovableObject *pSeenMO = 0;
+    Vector aimPos;
+    Vector lookVector;
+    GetMOLookRay(FOVSpread, aimPos, lookVector);
 
     MOID seenMOID = g_SceneMan.CastMORay(aimPos, lookVector, m_MOID, IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5);
     pSeenMO = g_MovableMan.GetMOFromID(seenMOID);
@@ -1410,7 +1433,7 @@ void ACrab::UpdateAI()
         }
 */
         // Narrow FOV range scan, 10 degrees each direction
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(10, g_MaterialGrass, false);
         // Saw something!
         if (pSeenMO)
         {
@@ -1623,7 +1646,7 @@ void ACrab::UpdateAI()
             m_ControlStates[AIM_DOWN] = true;
 */
         // Wide FOV range scan, 25 degrees each direction
-        pSeenMO = LookForMOs(25, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(25, g_MaterialGrass, false);
         // Saw something!
         if (pSeenMO)
         {
@@ -1656,7 +1679,7 @@ void ACrab::UpdateAI()
         m_ControlStates[aimAngleDiff > 0 ? AIM_UP : AIM_DOWN] = true;
 */
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(10, g_MaterialGrass, false);
 
         // Saw the enemy actor again through the sights!
         if (pSeenMO)
@@ -1710,7 +1733,7 @@ void ACrab::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(8, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(8, g_MaterialGrass, false);
         // Still seeing enemy actor through the sights, keep firing!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
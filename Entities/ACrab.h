@@ -597,6 +597,20 @@ protected:
 	void UpdateChildMOIDs(std::vector<MovableObject *> &MOIDIndex, MOID rootMOID = g_NoMOID, bool makeNewMOID = true) override;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  GetMOLookRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added. Looks down the barrel when sharp aiming.
+// Arguments:       The degree angle to deviate from the current view point in the ray
+//                  casting. A random ray will be chosen out of this +-range.
+//                  Vector to be filled with the start of the ray.
+//                  Vector to be filled with the ray itself.
+// Return value:    None.
+
+	void GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector) override;
+
+
 	// Member variables
 	static Entity::ClassInfo m_sClass;
 
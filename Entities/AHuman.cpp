@@ -1554,7 +1554,8 @@ bool AHuman::IsWithinRange(Vector &point) const
 
 bool AHuman::Look(float FOVSpread, float range)
 {
-    if (!g_SceneMan.AnythingUnseen(m_Team))
+    // Between team visibility passes there's nothing to look for
+    if (!g_SceneMan.AnythingUnseen(m_Team) || (g_SceneMan.IsTeamVisibilityEnabled() && !g_SceneMan.WantsTeamViewers()))
         return false;
 
     // Set the length of the look vector
@@ -1579,6 +1580,14 @@ bool AHuman::Look(float FOVSpread, float range)
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
+
+    // The team visibility pass sees the whole spread at once instead of one random ray of it
+    if (g_SceneMan.IsTeamVisibilityEnabled())
+    {
+        g_SceneMan.RegisterTeamViewer(m_Team, aimPos, lookVector, FOVSpread);
+        return false;
+    }
+
     // Add the spread
 	lookVector.DegRotate(FOVSpread * RandomNormalNum());
 
@@ -1605,38 +1614,52 @@ bool AHuman::LookForGold(float FOVSpread, float range, Vector &foundLocation) co
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Virtual method:  LookForMOs
+// Virtual method:  GetMOLookRay
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Casts an MO detecting ray in the direction of where the head is looking
-//                  at the time. Factors including head rotation, sharp aim mode, and
-//                  other variables determine how this ray is cast.
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added.
 
-MovableObject * AHuman::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
+void AHuman::GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector)
 {
-    MovableObject *pSeenMO = 0;
-    Vector aimPos = m_Pos;
+    lookStart = m_Pos;
     float aimDistance = m_AimDistance + g_FrameMan.GetPlayerScreenWidth() * 0.51;   // Set the length of the look vector
 
     // If aiming down the barrel, look through that
     if (m_Controller.IsState(AIM_SHARP) && m_pFGArm && m_pFGArm->IsAttached() && m_pFGArm->HoldsHeldDevice())
     {
-        aimPos = m_pFGArm->GetHeldDevice()->GetPos();
+        lookStart = m_pFGArm->GetHeldDevice()->GetPos();
         aimDistance += m_pFGArm->GetHeldDevice()->GetSharpLength();
     }
     // If just looking, use the eyes on the head instead
     else if (m_pHead && m_pHead->IsAttached())
     {
-        aimPos = GetEyePos();
+        lookStart = GetEyePos();
     }
 
     // Create the vector to trace along
-    Vector lookVector(aimDistance, 0);
+    lookVector.SetXY(aimDistance, 0);
     // Set the rotation to the actual aiming angle
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
     // Add the spread
     lookVector.DegRotate(FOVSpread * RandomNormalNum());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  LookForMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts an MO detecting ray in the direction of where the head is looking
+//                  at the time. Factors including head rotation, sharp aim mode, and
+//                  other variables determine how this ray is cast.
+
+MovableObject * AHuman::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
+{
+    MovableObject *pSeenMO = 0;
+    Vector aimPos;
+    Vector lookVector;
+    GetMOLookRay(FOVSpread, aimPos, lookVector);
 
     MOID seenMOID = g_SceneMan.CastMORay(aimPos, lookVector, m_MOID, IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5);
     pSeenMO = g_MovableMan.GetMOFromID(seenMOID);
@@ -2101,7 +2124,7 @@ void AHuman::UpdateAI()
         }
 */
         // Narrow FOV range scan, 10 degrees each direction
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(10, g_MaterialGrass, false);
         // Saw something!
         if (pSeenMO)
         {
@@ -2340,7 +2363,7 @@ void AHuman::UpdateAI()
             m_ControlStates[AIM_DOWN] = true;
 */
         // Wide FOV range scan, 25 degrees each direction
-        pSeenMO = LookForMOs(25, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(25, g_MaterialGrass, false);
         // Saw something!
         if (pSeenMO)
         {
@@ -2398,7 +2421,7 @@ void AHuman::UpdateAI()
         m_ControlStates[aimAngleDiff > 0 ? AIM_UP : AIM_DOWN] = true;
 */
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(10, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(10, g_MaterialGrass, false);
 
         // Saw the enemy actor again through the sights!
         if (pSeenMO)
@@ -2471,7 +2494,7 @@ void AHuman::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(8, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(8, g_MaterialGrass, false);
         // Still seeing enemy actor through the sights, keep firing!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
@@ -2505,7 +2528,7 @@ void AHuman::UpdateAI()
         m_Controller.m_AnalogAim.CapMagnitude(1.0);
 
         // Narrow focused FOV range scan
-        pSeenMO = LookForMOs(18, g_MaterialGrass, false);
+        pSeenMO = SensedLookForMOs(18, g_MaterialGrass, false);
         // Still seeing enemy actor through the sights, keep aiming the throw!
         if (pSeenMO)
             pSeenActor = dynamic_cast<Actor *>(pSeenMO->GetRootParent());
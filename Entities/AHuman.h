@@ -961,6 +961,20 @@ protected:
 	void DrawThrowingReticule(BITMAP *pTargetBitmap, const Vector &targetPos = Vector(), double amount = 1.0) const;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  GetMOLookRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added. Looks down the barrel when sharp aiming.
+// Arguments:       The degree angle to deviate from the current view point in the ray
+//                  casting. A random ray will be chosen out of this +-range.
+//                  Vector to be filled with the start of the ray.
+//                  Vector to be filled with the ray itself.
+// Return value:    None.
+
+    void GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector) override;
+
+
     // Member variables
     static Entity::ClassInfo m_sClass;
     // Articulated head.
@@ -115,6 +115,8 @@ void Actor::Clear()
     m_PassengerSlots = 1;
 
     m_ScriptedAIUpdate = false;
+    m_AISensedLooks.clear();
+    m_AISenseSkipped = false;
     m_AIMode = AIMODE_NONE;
     m_Waypoints.clear();
     m_DrawWaypoints = false;
@@ -674,7 +676,8 @@ Controller::InputMode Actor::SwapControllerModes(Controller::InputMode newMode,
 
 bool Actor::Look(float FOVSpread, float range)
 {
-    if (!g_SceneMan.AnythingUnseen(m_Team))
+    // Between team visibility passes there's nothing to look for
+    if (!g_SceneMan.AnythingUnseen(m_Team) || (g_SceneMan.IsTeamVisibilityEnabled() && !g_SceneMan.WantsTeamViewers()))
         return false;
 
     // Use the 'eyes' on the 'head', if applicable
@@ -698,12 +701,23 @@ bool Actor::Look(float FOVSpread, float range)
     if (lookVector.GetLargest() < 0.01)
     {
         lookVector.SetXY(range, 0);
+        // The team visibility pass sees the whole view at once instead of one random ray of it
+        if (g_SceneMan.IsTeamVisibilityEnabled())
+        {
+            g_SceneMan.RegisterTeamViewer(m_Team, aimPos, lookVector, 180.0F);
+            return false;
+        }
 		lookVector.DegRotate(RandomNum(-180.0F, 180.0F));
     }
     else
     {
         // Set the distance in the look direction
         lookVector.SetMagnitude(range);
+        if (g_SceneMan.IsTeamVisibilityEnabled())
+        {
+            g_SceneMan.RegisterTeamViewer(m_Team, aimPos, lookVector, FOVSpread);
+            return false;
+        }
         // Add the spread from the directed look
         lookVector.DegRotate(FOVSpread * RandomNormalNum());
     }
@@ -1284,11 +1298,11 @@ bool Actor::UpdateMovePath()
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool Actor::UpdateAIScripted() {
-    if (!m_ScriptedAIUpdate || m_AllLoadedScripts.empty() || m_ScriptPresetName.empty()) {
+    if (!m_ScriptedAIUpdate || m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
         return false;
     }
 
-    int status = !g_LuaMan.ExpressionIsTrue(m_ScriptPresetName, false) ? ReloadScripts() : 0;
+    int status = (m_ScriptStateGeneration != g_LuaMan.GetMasterStateGeneration()) ? ReloadScripts() : 0;
     status = (status >= 0 && !ObjectScriptsInitialized()) ? InitializeObjectScripts() : status;
     g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
     status = (status >= 0) ? RunScriptedFunctionInAppropriateScripts("UpdateAI", false, true) : status;
@@ -1365,6 +1379,137 @@ void Actor::UpdateAI()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  PrepareAISense
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Prepares the looks this' native AI made last frame to be cast again
+//                  by SenseAI, from where this is looking now.
+
+void Actor::PrepareAISense(bool senseThisFrame)
+{
+    m_AISenseSkipped = !senseThisFrame;
+
+    // Only the native AI asks for looks, so there's nothing to sense if something else is in control
+    if (m_Controller.GetInputMode() != Controller::CIM_AI || m_ScriptedAIUpdate)
+    {
+        m_AISensedLooks.clear();
+        return;
+    }
+
+    // Drop the looks the AI didn't ask for last frame, it has likely moved on to something else
+    m_AISensedLooks.erase(std::remove_if(m_AISensedLooks.begin(), m_AISensedLooks.end(), [](const AISensedLook &look) { return !look.Requested; }), m_AISensedLooks.end());
+
+    for (AISensedLook &look : m_AISensedLooks)
+    {
+        if (m_AISenseSkipped)
+        {
+            look.Sensed = false;
+            look.Requested = false;
+            continue;
+        }
+        GetMOLookRay(look.FOVSpread, look.LookStart, look.LookVector);
+        look.IgnoreMOID = m_MOID;
+        look.IgnoreTeam = IgnoresWhichTeam();
+        look.SeenMOID = g_NoMOID;
+        look.Sensed = false;
+        look.Consumed = false;
+        look.Requested = false;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  SenseAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the looks prepared by PrepareAISense against the world as it is
+//                  before any Actor is updated.
+
+void Actor::SenseAI()
+{
+    if (m_AISenseSkipped)
+        return;
+
+    for (AISensedLook &look : m_AISensedLooks)
+    {
+        look.SeenMOID = g_SceneMan.CastMORay(look.LookStart, look.LookVector, look.IgnoreMOID, look.IgnoreTeam, look.IgnoreMaterial, look.IgnoreAllTerrain, 5);
+        look.Sensed = true;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  SensedLookForMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Native AI version of LookForMOs. Returns what the same look saw in
+//                  this frame's sense phase if it was cast there, otherwise casts it
+//                  right away and has it cast in the sense phase from the next frame on.
+
+MovableObject * Actor::SensedLookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
+{
+    MOID seenMOID = g_NoMOID;
+    bool wasSensed = false;
+    AISensedLook *matchingLook = 0;
+    for (AISensedLook &look : m_AISensedLooks)
+    {
+        if (look.FOVSpread == FOVSpread && look.IgnoreMaterial == ignoreMaterial && look.IgnoreAllTerrain == ignoreAllTerrain)
+        {
+            matchingLook = &look;
+            break;
+        }
+    }
+
+    if (!matchingLook)
+    {
+        m_AISensedLooks.push_back({FOVSpread, ignoreMaterial, ignoreAllTerrain, Vector(), Vector(), g_NoMOID, Activity::NoTeam, g_NoMOID, false, false, false});
+        matchingLook = &m_AISensedLooks.back();
+    }
+    matchingLook->Requested = true;
+
+    // Nothing is seen on frames the AI's senses are skipped, but the look is kept so it's sensed again on the next frame they aren't
+    if (m_AISenseSkipped)
+        return 0;
+
+    // Each sensed result is only used once per frame, any more looks with the same parameters get cast right away like they used to
+    if (matchingLook->Sensed && !matchingLook->Consumed)
+    {
+        matchingLook->Consumed = true;
+        seenMOID = matchingLook->SeenMOID;
+        wasSensed = true;
+    }
+
+    if (!wasSensed)
+    {
+        Vector lookStart;
+        Vector lookVector;
+        GetMOLookRay(FOVSpread, lookStart, lookVector);
+        seenMOID = g_SceneMan.CastMORay(lookStart, lookVector, m_MOID, IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5);
+    }
+
+    // The MOID was read before any Actor was updated this frame, but the MOID index isn't rebuilt until the end of it so it's still valid
+    MovableObject *pSeenMO = g_MovableMan.GetMOFromID(seenMOID);
+    return pSeenMO ? pSeenMO->GetRootParent() : 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  GetMOLookRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added.
+
+void Actor::GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector)
+{
+    lookStart = GetEyePos();
+
+    // Look along the aiming angle, as far as half a screen beyond the aim distance
+    lookVector.SetXY(m_AimDistance + g_FrameMan.GetPlayerScreenWidth() * 0.51, 0);
+    Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
+    aimMatrix.SetXFlipped(m_HFlipped);
+    lookVector *= aimMatrix;
+    lookVector.DegRotate(FOVSpread * RandomNormalNum());
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveAnyRandomWounds
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1115,6 +1115,31 @@ ClassInfoGetters
     virtual void UpdateAI();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  PrepareAISense
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Prepares the looks this' native AI made last frame to be cast again
+//                  by SenseAI, from where this is looking now. Draws random numbers and
+//                  reads attachables, so it has to be done serially before SenseAI.
+// Arguments:       Whether the AI gets to see anything this frame. If not, its looks
+//                  are kept for the next frame it does, but all of them see nothing.
+// Return value:    None.
+
+    void PrepareAISense(bool senseThisFrame = true);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  SenseAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Casts the looks prepared by PrepareAISense against the world as it is
+//                  before any Actor is updated. Only reads the Scene and MOID index and
+//                  only writes to this, so it can be done for many Actors in parallel.
+// Arguments:       None.
+// Return value:    None.
+
+    void SenseAI();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1496,6 +1521,59 @@ protected:
     // Timer for measuring interval between height checks
     Timer m_FallTimer;
 
+    // A look for MOs the native AI made, kept so it can be cast ahead of time in the next frame's sense phase
+    struct AISensedLook
+    {
+        // What the look was asked for with, which the AI has to ask for again to get the sensed result
+        float FOVSpread;
+        unsigned char IgnoreMaterial;
+        bool IgnoreAllTerrain;
+        // The ray as prepared for the sense phase, and what it should ignore
+        Vector LookStart;
+        Vector LookVector;
+        MOID IgnoreMOID;
+        int IgnoreTeam;
+        // What the ray hit in the sense phase
+        MOID SeenMOID;
+        // Whether SeenMOID is from this frame's sense phase, whether the AI has used it, and whether the AI asked for this look this frame
+        bool Sensed;
+        bool Consumed;
+        bool Requested;
+    };
+    // The looks the native AI made last frame and this frame
+    std::vector<AISensedLook> m_AISensedLooks;
+    // Whether the native AI doesn't get to see anything this frame, to save time when the simulation is struggling
+    bool m_AISenseSkipped;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  SensedLookForMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Native AI version of LookForMOs. Returns what the same look saw in
+//                  this frame's sense phase if it was cast there, otherwise casts it
+//                  right away and has it cast in the sense phase from the next frame on.
+// Arguments:       The degree angle to deviate from the current view point in the ray
+//                  casting. A random ray will be chosen out of this +-range.
+//                  A specific material ID to ignore (see through)
+//                  Whether to ignore all terrain or not (true means 'x-ray vision').
+// Return value:    The root parent of the MO seen while looking, if any.
+
+    MovableObject * SensedLookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Virtual method:  GetMOLookRay
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the ray to cast when looking for MOs from where this is looking,
+//                  with a random deviation added.
+// Arguments:       The degree angle to deviate from the current view point in the ray
+//                  casting. A random ray will be chosen out of this +-range.
+//                  Vector to be filled with the start of the ray.
+//                  Vector to be filled with the ray itself.
+// Return value:    None.
+
+    virtual void GetMOLookRay(float FOVSpread, Vector &lookStart, Vector &lookVector);
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
 
@@ -8,6 +8,92 @@ namespace RTE {
 
 	ConcreteClassInfo(AtomGroup, Entity, 500)
 
+	std::map<AtomGroup::OutlineCacheKey, std::vector<AtomGroup::OutlineAtom>> AtomGroup::s_OutlineCache;
+
+	namespace {
+
+		/// <summary>
+		/// An Atom that hit something during a step of Travel or PushTravel.
+		/// </summary>
+		struct AtomHit {
+			Atom *HitAtom; //!< The Atom that hit something.
+			Vector Offset; //!< The flipped offset of the Atom when it hit. Only used by PushTravel.
+			MOID HitMOID; //!< The MOID of the MO that was hit, or g_NoMOID if it was terrain.
+			int Order; //!< The order the hit was found in, so grouping the hits by MOID keeps each group in Atom order.
+		};
+
+		/// <summary>
+		/// The hit bookkeeping of a single Travel or PushTravel call.
+		/// </summary>
+		struct TravelScratch {
+			std::vector<AtomHit> HitMOAtoms; //!< Atoms that hit MOs this step. Grouped by MOID before the responses are calculated.
+			std::vector<AtomHit> HitTerrAtoms; //!< Atoms that hit terrain this step.
+			std::vector<AtomHit> PenetratingAtoms; //!< Atoms that are penetrating terrain this step.
+			std::vector<Atom *> HitResponseAtoms; //!< Atoms whose HitData are to be applied to the owner at the end of the step.
+			std::vector<AtomHit> IgnoredMOAtoms; //!< Atoms that started out on top of an MO and will ignore hitting it for the rest of the travel.
+			std::vector<std::pair<Vector, Vector>> ImpulseForces; //!< Impulse forces and their offsets gathered over a leg of PushTravel.
+		};
+
+		/// <summary>
+		/// Lends out a TravelScratch for as long as it's in scope, so a travel step stops allocating once the buffers have grown to fit the largest AtomGroup.
+		/// Each thread keeps its own stack of them, and OnBounce, OnSink and OnMOHit scripts can start another travel, so each nesting level gets its own too.
+		/// </summary>
+		class ScopedTravelScratch {
+
+		public:
+
+			ScopedTravelScratch() {
+				if (s_Depth == s_Scratches.size()) { s_Scratches.emplace_back(std::make_unique<TravelScratch>()); }
+				m_Scratch = s_Scratches[s_Depth++].get();
+				m_Scratch->HitMOAtoms.clear();
+				m_Scratch->HitTerrAtoms.clear();
+				m_Scratch->PenetratingAtoms.clear();
+				m_Scratch->HitResponseAtoms.clear();
+				m_Scratch->IgnoredMOAtoms.clear();
+				m_Scratch->ImpulseForces.clear();
+			}
+
+			~ScopedTravelScratch() { --s_Depth; }
+
+			TravelScratch * operator->() const { return m_Scratch; }
+
+		private:
+
+			static thread_local std::vector<std::unique_ptr<TravelScratch>> s_Scratches; //!< The scratches of this thread, one for each nesting level reached so far.
+			static thread_local size_t s_Depth; //!< How many scratches of this thread are currently lent out.
+
+			TravelScratch *m_Scratch; //!< The scratch lent out to this scope.
+
+			ScopedTravelScratch(const ScopedTravelScratch &reference) = delete;
+			ScopedTravelScratch & operator=(const ScopedTravelScratch &rhs) = delete;
+		};
+
+		thread_local std::vector<std::unique_ptr<TravelScratch>> ScopedTravelScratch::s_Scratches;
+		thread_local size_t ScopedTravelScratch::s_Depth = 0;
+
+		/// <summary>
+		/// Sorts a list of MO hits so the hits on each MO are next to each other, in ascending MOID order and in the order they were found within each MOID.
+		/// </summary>
+		/// <param name="hits">The hits to sort.</param>
+		void GroupHitsByMOID(std::vector<AtomHit> &hits) {
+			std::sort(hits.begin(), hits.end(), [](const AtomHit &lhs, const AtomHit &rhs) { return (lhs.HitMOID != rhs.HitMOID) ? lhs.HitMOID < rhs.HitMOID : lhs.Order < rhs.Order; });
+		}
+
+		/// <summary>
+		/// Finds the end of the group of hits on the same MO that starts at a specific index of a list sorted with GroupHitsByMOID.
+		/// </summary>
+		/// <param name="hits">The sorted hits.</param>
+		/// <param name="groupStart">The index of the first hit of the group.</param>
+		/// <returns>The index one past the last hit of the group.</returns>
+		size_t FindHitGroupEnd(const std::vector<AtomHit> &hits, size_t groupStart) {
+			size_t groupEnd = groupStart + 1;
+			while (groupEnd < hits.size() && hits[groupEnd].HitMOID == hits[groupStart].HitMOID) {
+				++groupEnd;
+			}
+			return groupEnd;
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void AtomGroup::Clear() {
@@ -58,6 +144,7 @@ namespace RTE {
 
 		m_Atoms.clear();
 		m_SubGroups.clear();
+		m_Atoms.reserve(reference.m_Atoms.size());
 
 		for (const Atom *atom : reference.m_Atoms) {
 			if (!onlyCopyOwnerAtoms || atom->GetSubID() == 0) {
@@ -67,18 +154,12 @@ namespace RTE {
 
 				long subgroupID = atomCopy->GetSubID();
 				if (subgroupID != 0) {
-					if (m_SubGroups.find(subgroupID) == m_SubGroups.end()) { m_SubGroups.insert({ subgroupID, std::list<Atom *>() }); }
-
-					m_SubGroups.find(subgroupID)->second.push_back(atomCopy);
+					m_SubGroups[subgroupID].push_back(atomCopy);
 				}
 			}
 		}
 
-		m_IgnoreMOIDs.clear();
-
-		for (const MOID moidToIgnore : reference.m_IgnoreMOIDs) {
-			m_IgnoreMOIDs.push_back(moidToIgnore);
-		}
+		m_IgnoreMOIDs = reference.m_IgnoreMOIDs;
 
 		if (!reference.m_Atoms.empty()) { m_Material = reference.m_Atoms.front()->GetMaterial(); }
 
@@ -220,8 +301,10 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void AtomGroup::AddAtoms(const std::list<Atom *> &atomList, long subgroupID, const Vector &offset, const Matrix &offsetRotation) {
-		if (m_SubGroups.count(subgroupID) == 0) { m_SubGroups.insert({ subgroupID, std::list<Atom *>() }); }
+	void AtomGroup::AddAtoms(const std::vector<Atom *> &atomList, long subgroupID, const Vector &offset, const Matrix &offsetRotation) {
+		std::vector<Atom *> &subGroup = m_SubGroups[subgroupID];
+		m_Atoms.reserve(m_Atoms.size() + atomList.size());
+		subGroup.reserve(subGroup.size() + atomList.size());
 
 		Atom *atomToAdd;
 		for (const Atom * atom : atomList) {
@@ -230,28 +313,22 @@ namespace RTE {
 			atomToAdd->SetOffset(offset + (atomToAdd->GetOriginalOffset() * offsetRotation));
 			atomToAdd->SetOwner(m_OwnerMOSR);
 			m_Atoms.push_back(atomToAdd);
-			m_SubGroups.at(subgroupID).push_back(atomToAdd);
+			subGroup.push_back(atomToAdd);
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	bool AtomGroup::RemoveAtoms(long removeID) {
-		bool removedAny = false;
-		std::list<Atom *>::iterator eraseItr;
-
-		// TODO: Look into using remove_if.
-		for (std::list<Atom *>::iterator atomItr = m_Atoms.begin(); atomItr != m_Atoms.end();) {
-			if ((*atomItr)->GetSubID() == removeID) {
-				delete (*atomItr);
-				eraseItr = atomItr;
-				atomItr++;
-				m_Atoms.erase(eraseItr);
-				removedAny = true;
-			} else {
-				atomItr++;
+		std::vector<Atom *>::iterator newEnd = std::remove_if(m_Atoms.begin(), m_Atoms.end(), [removeID](Atom *atom) {
+			if (atom->GetSubID() == removeID) {
+				delete atom;
+				return true;
 			}
-		}
+			return false;
+		});
+		bool removedAny = newEnd != m_Atoms.end();
+		m_Atoms.erase(newEnd, m_Atoms.end());
 		m_SubGroups.erase(removeID);
 
 		return removedAny;
@@ -263,7 +340,7 @@ namespace RTE {
 		if (m_SubGroups.empty() || m_SubGroups.count(subgroupID) == 0) {
 			return false;
 		}
-		RTEAssert(!m_SubGroups.at(subgroupID).empty(), "Found an empty subgroup list in AtomGroup!?");
+		RTEAssert(!m_SubGroups.at(subgroupID).empty(), "Found an empty subgroup in AtomGroup!?");
 
 		for (Atom *subGroupAtom : m_SubGroups.at(subgroupID)) {
 			subGroupAtom->SetOffset(newOffset + (subGroupAtom->GetOriginalOffset() * newOffsetRotation));
@@ -311,10 +388,11 @@ namespace RTE {
 
 		HitData hitData;
 
-		std::map<MOID, std::list<Atom *>> hitMOAtoms;
-		std::list<Atom *> hitTerrAtoms;
-		std::list<Atom *> penetratingAtoms;
-		std::list<Atom *> hitResponseAtoms;
+		ScopedTravelScratch scratch;
+		std::vector<AtomHit> &hitMOAtoms = scratch->HitMOAtoms;
+		std::vector<AtomHit> &hitTerrAtoms = scratch->HitTerrAtoms;
+		std::vector<AtomHit> &penetratingAtoms = scratch->PenetratingAtoms;
+		std::vector<Atom *> &hitResponseAtoms = scratch->HitResponseAtoms;
 
 		// Lock all bitmaps involved outside the loop - only relevant for video bitmaps so disabled at the moment.
 		//if (!scenePreLocked) { g_SceneMan.LockScene(); }
@@ -427,7 +505,7 @@ namespace RTE {
 						// If something was hit, first check for terrain hit.
 						if (atom->HitWhatTerrMaterial()) {
 							m_OwnerMOSR->SetHitWhatTerrMaterial(atom->HitWhatTerrMaterial());
-							hitTerrAtoms.push_back(atom);
+							hitTerrAtoms.push_back({ atom, Vector(), g_NoMOID, 0 });
 						}
 						if (hitsMOs) {
 							const MOID tempMOID = atom->HitWhatMOID();
@@ -436,15 +514,8 @@ namespace RTE {
 								MovableObject *moCollidedWith = g_MovableMan.GetMOFromID(tempMOID);
 								if (moCollidedWith && moCollidedWith->HitWhatMOID() == g_NoMOID) { moCollidedWith->SetHitWhatMOID(m_OwnerMOSR->m_MOID); }
 
-								// See if we already have another Atom hitting this MO in this step. If not, then create a new list unique for that MO's ID and insert into the map of MO-hitting Atoms.
-								if (!(hitMOAtoms.count(tempMOID))) {
-									std::list<Atom *> newList;
-									newList.push_back(atom);
-									hitMOAtoms.insert({ tempMOID, newList });
-								} else {
-									// If another Atom of this group has already hit this same MO during this step, go ahead and add the new Atom to the corresponding map for that MOID.
-									hitMOAtoms.at(tempMOID).push_back(atom);
-								}
+								// Atoms hitting the same MO get grouped together once the whole step has been taken.
+								hitMOAtoms.push_back({ atom, Vector(), tempMOID, static_cast<int>(hitMOAtoms.size()) });
 
 								// Add the hit MO to the ignore list of ignored MOIDs
 								//AddMOIDToIgnore(tempMOID);
@@ -501,10 +572,12 @@ namespace RTE {
 					const float massDistribution = mass / static_cast<float>(hitTerrAtoms.size() * (m_Resolution ? m_Resolution : 1));
 					const float momentInertiaDistribution = m_MomentOfInertia / static_cast<float>(hitTerrAtoms.size() * (m_Resolution ? m_Resolution : 1));
 
-					// Determine which of the colliding Atoms will penetrate the terrain.
-					for (std::list<Atom*>::iterator atomItr = hitTerrAtoms.begin(); atomItr != hitTerrAtoms.end(); ) {
+					// Determine which of the colliding Atoms will penetrate the terrain. The ones that don't are compacted towards the front, keeping their order.
+					size_t keptCount = 0;
+					for (const AtomHit &hitTerrAtomEntry : hitTerrAtoms) {
+						Atom *hitTerrAtom = hitTerrAtomEntry.HitAtom;
 						// Calculate and store the accurate hit radius of the Atom in relation to the CoM
-						hitData.HitRadius[HITOR] = m_OwnerMOSR->RotateOffset((*atomItr)->GetOffset()) * c_MPP;
+						hitData.HitRadius[HITOR] = m_OwnerMOSR->RotateOffset(hitTerrAtom->GetOffset()) * c_MPP;
 						// Figure out the pre-collision velocity of the hitting Atom due to body translation and rotation.
 						hitData.HitVel[HITOR] = velocity + hitData.HitRadius[HITOR].GetPerpendicular() * angularVel;
 
@@ -513,17 +586,17 @@ namespace RTE {
 						hitData.HitDenominator = (1.0F / massDistribution) + ((radMag * radMag) / momentInertiaDistribution);
 						hitData.PreImpulse[HITOR] = hitData.HitVel[HITOR] / hitData.HitDenominator;
 						// Set the Atom with the HitData with all the info we have so far.
-						(*atomItr)->SetHitData(hitData);
+						hitTerrAtom->SetHitData(hitData);
 
-						if (g_SceneMan.WillPenetrate((*atomItr)->GetCurrentPos().GetFloorIntX(), (*atomItr)->GetCurrentPos().GetFloorIntY(), hitData.PreImpulse[HITOR])) {
+						if (g_SceneMan.WillPenetrate(hitTerrAtom->GetCurrentPos().GetFloorIntX(), hitTerrAtom->GetCurrentPos().GetFloorIntY(), hitData.PreImpulse[HITOR])) {
 							// Move the penetrating Atom to the penetrating list from the collision list.
-							penetratingAtoms.push_back(*atomItr);
-							atomItr = hitTerrAtoms.erase(atomItr);
+							penetratingAtoms.push_back(hitTerrAtomEntry);
 							somethingPenetrated = true;
 						} else {
-							++atomItr;
+							hitTerrAtoms[keptCount++] = hitTerrAtomEntry;
 						}
 					}
+					hitTerrAtoms.resize(keptCount);
 				} while (!hitTerrAtoms.empty() && somethingPenetrated);
 
 				// TERRAIN BOUNCE ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -531,8 +604,8 @@ namespace RTE {
 				// If some Atoms could not penetrate even though all the impulse was on them, gather the bounce results and apply them to the owner.
 				if (!hitTerrAtoms.empty()) {
 					// Step back all Atoms that previously took one during this step iteration. This is so we aren't intersecting the hit MO anymore.
-					for (Atom *hitTerrAtom : hitTerrAtoms) {
-						hitTerrAtom->StepBack();
+					for (const AtomHit &hitTerrAtomEntry : hitTerrAtoms) {
+						hitTerrAtomEntry.HitAtom->StepBack();
 					}
 
 					// Calculate the distributed mass that each bouncing Atom has.
@@ -542,7 +615,8 @@ namespace RTE {
 					const float hitFactor = 1.0F / static_cast<float>(hitTerrAtoms.size());
 
 					// Gather the collision response effects so that the impulse force can be calculated.
-					for (Atom *hitTerrAtom : hitTerrAtoms) {
+					for (const AtomHit &hitTerrAtomEntry : hitTerrAtoms) {
+						Atom *hitTerrAtom = hitTerrAtomEntry.HitAtom;
 						hitTerrAtom->GetHitData().TotalMass[HITOR] = mass;
 						hitTerrAtom->GetHitData().MomInertia[HITOR] = m_MomentOfInertia;
 						hitTerrAtom->GetHitData().ImpulseFactor[HITOR] = hitFactor;
@@ -569,7 +643,8 @@ namespace RTE {
 					const float hitFactor = 1.0F / static_cast<float>(penetratingAtoms.size());
 
 					// Calculate and store the collision response effects.
-					for (Atom *penetratingAtom : penetratingAtoms) {
+					for (const AtomHit &penetratingAtomEntry : penetratingAtoms) {
+						Atom *penetratingAtom = penetratingAtomEntry.HitAtom;
 						/*
 						// This gets re-set later according to the ortho pixel edges hit.
 						hitData.BitmapNormal = -(hitData.HitVel[HITOR].GetNormalized());
@@ -612,11 +687,14 @@ namespace RTE {
 					hitData.MomInertia[HITOR] = m_MomentOfInertia;
 					hitData.ImpulseFactor[HITOR] = 1.0F / static_cast<float>(atomsHitMOsCount);
 
-					for (const map<MOID, std::list<Atom *>>::value_type &MOAtomMapEntry : hitMOAtoms) {
+					GroupHitsByMOID(hitMOAtoms);
+					for (size_t groupStart = 0, groupEnd = 0; groupStart < hitMOAtoms.size(); groupStart = groupEnd) {
+						groupEnd = FindHitGroupEnd(hitMOAtoms, groupStart);
 						// The denominator that the MovableObject being hit should divide its mass with for each Atom of this AtomGroup that is colliding with it during this step.
-						hitData.ImpulseFactor[HITEE] = 1.0F / static_cast<float>(MOAtomMapEntry.second.size());
+						hitData.ImpulseFactor[HITEE] = 1.0F / static_cast<float>(groupEnd - groupStart);
 
-						for (Atom *hitMOAtom : MOAtomMapEntry.second) {
+						for (size_t hitIndex = groupStart; hitIndex < groupEnd; ++hitIndex) {
+							Atom *hitMOAtom = hitMOAtoms[hitIndex].HitAtom;
 							// Step back all Atoms that hit MOs during this step iteration. This is so we aren't intersecting the hit MO anymore.
 							hitMOAtom->StepBack();
 							//hitData.HitPoint = hitMOAtom->GetCurrentPos();
@@ -754,11 +832,12 @@ namespace RTE {
 
 		HitData hitData;
 
-		std::map<MOID, std::set<Atom *>> MOIgnoreMap;
-		std::map<MOID, std::deque<std::pair<Atom *, Vector>>> hitMOAtoms;
-		std::deque<std::pair<Atom *, Vector>> hitTerrAtoms;
-		std::deque<std::pair<Atom *, Vector>> penetratingAtoms;
-		std::deque<std::pair<Vector, Vector>> impulseForces; // First Vector is the impulse force in kg * m/s, the second is force point, or its offset from the origin of the AtomGroup.
+		ScopedTravelScratch scratch;
+		std::vector<AtomHit> &MOIgnoreAtoms = scratch->IgnoredMOAtoms;
+		std::vector<AtomHit> &hitMOAtoms = scratch->HitMOAtoms;
+		std::vector<AtomHit> &hitTerrAtoms = scratch->HitTerrAtoms;
+		std::vector<AtomHit> &penetratingAtoms = scratch->PenetratingAtoms;
+		std::vector<std::pair<Vector, Vector>> &impulseForces = scratch->ImpulseForces; // First Vector is the impulse force in kg * m/s, the second is force point, or its offset from the origin of the AtomGroup.
 
 		// Lock all bitmaps involved outside the loop - only relevant for video bitmaps so disabled at the moment.
 		//if (!scenePreLocked) { g_SceneMan.LockScene(); }
@@ -774,18 +853,8 @@ namespace RTE {
 				// See if the Atom is starting out on top of another MO
 				MOID tempMOID = g_SceneMan.GetMOIDPixel(intPos[X] + flippedOffset.GetFloorIntX(), intPos[Y] + flippedOffset.GetFloorIntY());
 
-				if (tempMOID != g_NoMOID) {
-					// Make the appropriate entry in the MO-Atom interaction ignore map
-					if (MOIgnoreMap.count(tempMOID) != 0) {
-						// Found an entry for this MOID, so add the Atom entry to it
-						MOIgnoreMap.at(tempMOID).insert(atom);
-					} else {
-						// There wasn't already an entry for this MOID, so create one and add the Atom to it.
-						std::set<Atom *> newSet;
-						newSet.insert(atom);
-						MOIgnoreMap.insert({ tempMOID, newSet });
-					}
-				}
+				// Make the appropriate entry in the MO-Atom interaction ignore list
+				if (tempMOID != g_NoMOID) { MOIgnoreAtoms.push_back({ atom, flippedOffset, tempMOID, static_cast<int>(MOIgnoreAtoms.size()) }); }
 			}
 		}
 
@@ -881,25 +950,18 @@ namespace RTE {
 					bool ignoreHit = false;
 					if (hitMOs) {
 						tempMOID = g_SceneMan.GetMOIDPixel(intPos[X] + flippedOffset.GetFloorIntX(), intPos[Y] + flippedOffset.GetFloorIntY());
-						// Check the ignore map for Atoms that should ignore hits against certain MOs.
-						if (tempMOID != g_NoMOID && (MOIgnoreMap.count(tempMOID) != 0)) { ignoreHit = MOIgnoreMap.at(tempMOID).count(atom) != 0; }
+						// Check the ignore list for Atoms that should ignore hits against certain MOs.
+						if (tempMOID != g_NoMOID) { ignoreHit = std::any_of(MOIgnoreAtoms.begin(), MOIgnoreAtoms.end(), [atom, tempMOID](const AtomHit &ignoredHit) { return ignoredHit.HitAtom == atom && ignoredHit.HitMOID == tempMOID; }); }
 					}
 
 					if (hitMOs && tempMOID && !ignoreHit) {
-						// See if we already have another Atom hitting this MO in this step. If not, then create a new deque unique for that MO's ID and insert into the map of MO-hitting Atoms.
-						if (hitMOAtoms.count(tempMOID) == 0) {
-							std::deque<std::pair<Atom *, Vector>> newDeque;
-							newDeque.push_back({ atom, flippedOffset });
-							hitMOAtoms.insert({ tempMOID, newDeque });
-						} else {
-							// If another Atom of this group has already hit this same MO during this step, go ahead and add the new Atom to the corresponding deque for that MOID.
-							hitMOAtoms.at(tempMOID).push_back({ atom, flippedOffset });
-						}
+						// Atoms hitting the same MO get grouped together once the whole step has been taken.
+						hitMOAtoms.push_back({ atom, flippedOffset, tempMOID, static_cast<int>(hitMOAtoms.size()) });
 						// Count the number of Atoms of this group that hit MOs this step. Used to properly distribute the mass of the owner MO in later collision responses during this step.
 						atomsHitMOsCount++;
 					// If no MO has ever been hit yet during this step, then keep checking for terrain hits.
 					} else if (atomsHitMOsCount == 0 && g_SceneMan.GetTerrMatter(intPos[X] + flippedOffset.GetFloorIntX(), intPos[Y] + flippedOffset.GetFloorIntY())) {
-						hitTerrAtoms.push_back({ atom, flippedOffset });
+						hitTerrAtoms.push_back({ atom, flippedOffset, g_NoMOID, 0 });
 					}
 
 #ifdef DEBUG_BUILD
@@ -949,13 +1011,15 @@ namespace RTE {
 					//float hitorMass = mass / ((atomsHitMOsCount/* + hitTerrAtoms.size()*/) * (m_Resolution ? m_Resolution : 1));
 					//float hiteeMassDenom = 0;
 
-					for (const std::map<MOID, std::deque<std::pair<Atom *, Vector>>>::value_type &MOAtomMapEntry : hitMOAtoms) {
+					GroupHitsByMOID(hitMOAtoms);
+					for (size_t groupStart = 0, groupEnd = 0; groupStart < hitMOAtoms.size(); groupStart = groupEnd) {
+						groupEnd = FindHitGroupEnd(hitMOAtoms, groupStart);
 						// The denominator that the MovableObject being hit should divide its mass with for each Atom of this AtomGroup that is colliding with it during this step.
-						hitData.ImpulseFactor[HITEE] = 1.0F / static_cast<float>(MOAtomMapEntry.second.size());
+						hitData.ImpulseFactor[HITEE] = 1.0F / static_cast<float>(groupEnd - groupStart);
 
-						for (const std::pair<Atom *, Vector> &hitMOAtomEntry : MOAtomMapEntry.second) {
+						for (size_t hitIndex = groupStart; hitIndex < groupEnd; ++hitIndex) {
 							// Bake in current Atom's offset into the int positions.
-							const Vector &atomOffset = hitMOAtomEntry.second;
+							const Vector &atomOffset = hitMOAtoms[hitIndex].Offset;
 							intPos[X] += atomOffset.GetFloorIntX();
 							intPos[Y] += atomOffset.GetFloorIntY();
 							hitPos[X] += atomOffset.GetFloorIntX();
@@ -1033,16 +1097,18 @@ namespace RTE {
 
 					massDist = mass / static_cast<float>(hitTerrAtoms.size() * (m_Resolution ? m_Resolution : 1));
 
-					for (std::deque<std::pair<Atom *, Vector>>::iterator atomItr = hitTerrAtoms.begin(); atomItr != hitTerrAtoms.end(); ) {
-						if (g_SceneMan.WillPenetrate(intPos[X] + (*atomItr).second.GetFloorIntX(), intPos[Y] + (*atomItr).second.GetFloorIntY(), forceVel, massDist)) {
+					// The Atoms that don't penetrate are compacted towards the front, keeping their order.
+					size_t keptCount = 0;
+					for (const AtomHit &hitTerrAtomEntry : hitTerrAtoms) {
+						if (g_SceneMan.WillPenetrate(intPos[X] + hitTerrAtomEntry.Offset.GetFloorIntX(), intPos[Y] + hitTerrAtomEntry.Offset.GetFloorIntY(), forceVel, massDist)) {
 							// Move the penetrating Atom to the penetrating list from the collision list.
-							penetratingAtoms.push_back({ (*atomItr).first, (*atomItr).second });
-							atomItr = hitTerrAtoms.erase(atomItr);
+							penetratingAtoms.push_back(hitTerrAtomEntry);
 							somethingPenetrated = true;
 						} else {
-							++atomItr;
+							hitTerrAtoms[keptCount++] = hitTerrAtomEntry;
 						}
 					}
+					hitTerrAtoms.resize(keptCount);
 				} while (!hitTerrAtoms.empty() && somethingPenetrated);
 
 				// TERRAIN BOUNCE /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1063,9 +1129,9 @@ namespace RTE {
 					massDist = mass / static_cast<float>((hitTerrAtoms.size()/* + atomsHitMOsCount*/) * (m_Resolution ? m_Resolution : 1));
 
 					// Gather the collision response effects so that the impulse force can be calculated.
-					for (const std::pair<Atom *, Vector> &hitTerrAtomsEntry : hitTerrAtoms) {
+					for (const AtomHit &hitTerrAtomsEntry : hitTerrAtoms) {
 						// Bake in current Atom's offset into the int positions.
-						const Vector &atomOffset = hitTerrAtomsEntry.second;
+						const Vector &atomOffset = hitTerrAtomsEntry.Offset;
 						intPos[X] += atomOffset.GetFloorIntX();
 						intPos[Y] += atomOffset.GetFloorIntY();
 						hitPos[X] += atomOffset.GetFloorIntX();
@@ -1083,7 +1149,7 @@ namespace RTE {
 							domMaterial = g_SceneMan.GetMaterialFromID(domMaterialID);
 
 							// Bounce according to the collision.
-							newVel[dom] = -newVel[dom] * hitTerrAtomsEntry.first->GetMaterial()->GetRestitution() * domMaterial->GetRestitution();
+							newVel[dom] = -newVel[dom] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetRestitution() * domMaterial->GetRestitution();
 						}
 
 						// Check for and react upon a collision in the submissive direction of travel.
@@ -1093,19 +1159,19 @@ namespace RTE {
 							subMaterial = g_SceneMan.GetMaterialFromID(subMaterialID);
 
 							// Bounce according to the collision.
-							newVel[sub] = -newVel[sub] * hitTerrAtomsEntry.first->GetMaterial()->GetRestitution() * subMaterial->GetRestitution();
+							newVel[sub] = -newVel[sub] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetRestitution() * subMaterial->GetRestitution();
 						}
 
 						// If hit right on the corner of a pixel, bounce straight back with no friction.
 						if (!hit[dom] && !hit[sub]) {
 							hit[dom] = true;
-							newVel[dom] = -newVel[dom] * hitTerrAtomsEntry.first->GetMaterial()->GetRestitution() * hitMaterial->GetRestitution();
+							newVel[dom] = -newVel[dom] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetRestitution() * hitMaterial->GetRestitution();
 							hit[sub] = true;
-							newVel[sub] = -newVel[sub] * hitTerrAtomsEntry.first->GetMaterial()->GetRestitution() * hitMaterial->GetRestitution();
+							newVel[sub] = -newVel[sub] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetRestitution() * hitMaterial->GetRestitution();
 						} else if (hit[dom] && !hit[sub]) {
-							newVel[sub] -= newVel[sub] * hitTerrAtomsEntry.first->GetMaterial()->GetFriction() * domMaterial->GetFriction();
+							newVel[sub] -= newVel[sub] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetFriction() * domMaterial->GetFriction();
 						} else if (hit[sub] && !hit[dom]) {
-							newVel[dom] -= newVel[dom] * hitTerrAtomsEntry.first->GetMaterial()->GetFriction() * subMaterial->GetFriction();
+							newVel[dom] -= newVel[dom] * hitTerrAtomsEntry.HitAtom->GetMaterial()->GetFriction() * subMaterial->GetFriction();
 						}
 
 						// Compute and store this Atom's collision response impulse force.
@@ -1133,9 +1199,9 @@ namespace RTE {
 					massDist = mass / static_cast<float>(penetratingAtoms.size() * (m_Resolution ? m_Resolution : 1));
 
 					// Apply the collision response effects.
-					for (const std::pair<Atom *, Vector> &penetratingAtomsEntry : penetratingAtoms) {
-						if (g_SceneMan.TryPenetrate(intPos[X] + penetratingAtomsEntry.second.GetFloorIntX(), intPos[Y] + penetratingAtomsEntry.second.GetFloorIntY(), forceVel * massDist, forceVel, retardation, 1.0F, penetratingAtomsEntry.first->GetNumPenetrations())) {
-							impulseForces.push_back({ forceVel * massDist * retardation, penetratingAtomsEntry.second });
+					for (const AtomHit &penetratingAtomsEntry : penetratingAtoms) {
+						if (g_SceneMan.TryPenetrate(intPos[X] + penetratingAtomsEntry.Offset.GetFloorIntX(), intPos[Y] + penetratingAtomsEntry.Offset.GetFloorIntY(), forceVel * massDist, forceVel, retardation, 1.0F, penetratingAtomsEntry.HitAtom->GetNumPenetrations())) {
+							impulseForces.push_back({ forceVel * massDist * retardation, penetratingAtomsEntry.Offset });
 						}
 					}
 				}
@@ -1285,7 +1351,7 @@ namespace RTE {
 
 	// TODO: Look into breaking this into smaller methods.
 	bool AtomGroup::ResolveTerrainIntersection(Vector &position, unsigned char strongerThan) const {
-		std::list<Atom *> intersectingAtoms;
+		std::vector<Atom *> intersectingAtoms;
 		MOID hitMaterial = g_MaterialAir;
 
 		float strengthThreshold = (strongerThan != g_MaterialAir) ? g_SceneMan.GetMaterialFromID(strongerThan)->GetIntegrity() : 0.0F;
@@ -1412,7 +1478,7 @@ namespace RTE {
 			return false;
 		}
 
-		std::list<Atom *> intersectingAtoms;
+		std::vector<Atom *> intersectingAtoms;
 
 		// Restart and go through all Atoms to find all intersecting the specific intersected MO
 		for (Atom *atom : m_Atoms) {
@@ -1534,6 +1600,24 @@ namespace RTE {
 		const int spriteWidth = refSprite->w * static_cast<int>(m_OwnerMOSR->GetScale());
 		const int spriteHeight = refSprite->h * static_cast<int>(m_OwnerMOSR->GetScale());
 
+		// Presets very often share sprite frames, so reuse the Atoms generated for the same frame and settings before instead of scanning it again.
+		// Only when starting from scratch though, since what gets generated depends on whether there were any Atoms already.
+		const bool useOutlineCache = m_Atoms.empty();
+		const OutlineCacheKey cacheKey = { refSprite, static_cast<int>(m_OwnerMOSR->GetScale()), m_Resolution, m_Depth, spriteOffset.m_X, spriteOffset.m_Y };
+		if (useOutlineCache) {
+			std::map<OutlineCacheKey, std::vector<OutlineAtom>>::const_iterator cachedOutline = s_OutlineCache.find(cacheKey);
+			if (cachedOutline != s_OutlineCache.end()) {
+				m_Atoms.reserve(cachedOutline->second.size());
+				for (const OutlineAtom &outlineAtom : cachedOutline->second) {
+					Atom *atomToAdd = new Atom(outlineAtom.Offset, m_Material, ownerMOSRotating);
+					atomToAdd->SetNormal(outlineAtom.Normal);
+					atomToAdd->SetIgnoreMOIDsByGroup(&m_IgnoreMOIDs);
+					m_Atoms.push_back(atomToAdd);
+				}
+				return;
+			}
+		}
+
 		// Only try to generate AtomGroup if scaled width and height are > 0 as we're playing with fire trying to create 0x0 bitmap. 
 		if (spriteWidth > 0 && spriteHeight > 0) {
 			int x;
@@ -1728,6 +1812,14 @@ namespace RTE {
 
 		// If no Atoms were made, just place a default one in the middle
 		if (m_Atoms.empty()) { AddAtomToGroup(ownerMOSRotating, spriteOffset, spriteWidth / 2, spriteHeight / 2, false); }
+
+		if (useOutlineCache) {
+			std::vector<OutlineAtom> &outline = s_OutlineCache[cacheKey];
+			outline.reserve(m_Atoms.size());
+			for (const Atom *atom : m_Atoms) {
+				outline.push_back({ atom->GetOffset(), atom->GetNormal() });
+			}
+		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -91,6 +91,11 @@ namespace RTE {
 		/// Resets the entire AtomGroup, including its inherited members, to their default settings or values.
 		/// </summary>
 		void Reset() override { Clear(); Entity::Reset(); }
+
+		/// <summary>
+		/// Forgets all the cached sprite outlines. Has to be done before the sprite bitmaps they were made from are freed.
+		/// </summary>
+		static void ClearOutlineCache() { s_OutlineCache.clear(); }
 #pragma endregion
 
 #pragma region Getters and Setters
@@ -98,7 +103,7 @@ namespace RTE {
 		/// Gets the current list of Atoms that make up the group.
 		/// </summary>
 		/// <returns>A const reference to the Atom list.</returns>
-		const std::list<Atom *> & GetAtomList() const { return m_Atoms; }
+		const std::vector<Atom *> & GetAtomList() const { return m_Atoms; }
 
 		/// <summary>
 		/// Gets the current number of Atoms that make up the group.
@@ -191,7 +196,7 @@ namespace RTE {
 		/// <param name="subgroupID">The desired subgroup ID for the Atoms being added.</param>
 		/// <param name="offset">An offset that should be applied to all added Atoms.</param>
 		/// <param name="offsetRotation">The rotation of the placed Atoms around the specified offset.</param>
-		void AddAtoms(const std::list<Atom *> &atomList, long subgroupID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
+		void AddAtoms(const std::vector<Atom *> &atomList, long subgroupID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
 
 		/// <summary>
 		/// Removes all Atoms of a specific subgroup ID from this AtomGroup.
@@ -345,10 +350,8 @@ namespace RTE {
 
 		static Entity::ClassInfo m_sClass; //!< ClassInfo for this class.
 
-		// TODO: It's probably worth trying out changing this from a list to a vector. m_Atoms is iterated over often and we could probably get some big gainz by doing this swap.
-		// The downside is anytime attachables with atoms get added we may have the cost of resizing the vector but that's an uncommon use case while iterating over atoms happens multiple times per frame.
-		std::list<Atom *> m_Atoms; //!< List of Atoms that constitute the group. Owned by this.
-		std::unordered_map<long, std::list<Atom *>> m_SubGroups; //!< Sub groupings of Atoms. Points to Atoms owned in m_Atoms. Not owned.
+		std::vector<Atom *> m_Atoms; //!< List of Atoms that constitute the group, kept contiguous since it's iterated over several times per step. Owned by this.
+		std::unordered_map<long, std::vector<Atom *>> m_SubGroups; //!< Sub groupings of Atoms. Points to Atoms owned in m_Atoms. Not owned.
 
 		MOSRotating *m_OwnerMOSR; //!< The owner of this AtomGroup. The owner is obviously not owned by this AtomGroup.
 		const Material *m_Material; //!< Material of this AtomGroup.
@@ -370,10 +373,34 @@ namespace RTE {
 
 		float m_MomentOfInertia; //!< Moment of Inertia for this AtomGroup.
 
-		std::list<MOID> m_IgnoreMOIDs; //!< List of MOIDs this AtomGroup will ignore collisions with.
+		std::vector<MOID> m_IgnoreMOIDs; //!< List of MOIDs this AtomGroup will ignore collisions with.
 
 	private:
 
+		/// <summary>
+		/// Identifies everything the Atoms generated for a sprite frame depend on.
+		/// </summary>
+		struct OutlineCacheKey {
+			const BITMAP *SpriteFrame; //!< The sprite frame the Atoms were generated from. Not owned.
+			int Scale; //!< The whole number scale the sprite frame was scanned at.
+			int Resolution; //!< The resolution the Atoms were generated with.
+			int Depth; //!< The depth the Atoms were generated with.
+			float SpriteOffsetX; //!< The X sprite offset the Atom offsets and normals were calculated with.
+			float SpriteOffsetY; //!< The Y sprite offset the Atom offsets and normals were calculated with.
+
+			bool operator<(const OutlineCacheKey &rhs) const { return std::tie(SpriteFrame, Scale, Resolution, Depth, SpriteOffsetX, SpriteOffsetY) < std::tie(rhs.SpriteFrame, rhs.Scale, rhs.Resolution, rhs.Depth, rhs.SpriteOffsetX, rhs.SpriteOffsetY); }
+		};
+
+		/// <summary>
+		/// A generated Atom as it was added to the AtomGroup.
+		/// </summary>
+		struct OutlineAtom {
+			Vector Offset; //!< The offset of the Atom from the owner's center.
+			Vector Normal; //!< The surface normal the Atom ended up with.
+		};
+
+		static std::map<OutlineCacheKey, std::vector<OutlineAtom>> s_OutlineCache; //!< The Atoms generated for each sprite frame so far, so other presets using the same frame don't have to scan it again.
+
 #pragma region Create Breakdown
 		/// <summary>
 		/// Generates an AtomGroup using the owner MOSRotating's sprite outline.
@@ -216,6 +216,19 @@ public:
 	bool PushesEmitter() const { return m_PushesEmitter; }
 
 
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Method:  IsCosmetic
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Description:     Indicates whether the particles of this emission are only for show,
+	//                  i.e. they neither hit nor get hit by MOs and aren't devices. Unless they
+	//                  push their emitter, these are emitted through MovableMan's
+	//                  EmissionScheduler, and are the only ones held to the particle budget.
+	// Arguments:       None.
+	// Return value:    Whether the emitted particles are cosmetic.
+
+	bool IsCosmetic() const { return m_pEmission && !m_pEmission->HitsMOs() && !m_pEmission->GetsHitByMOs() && !m_pEmission->IsDevice(); }
+
+
 	//////////////////////////////////////////////////////////////////////////////////////////
 	// Method:  SetPushesEmitter
 	//////////////////////////////////////////////////////////////////////////////////////////
@@ -750,14 +750,13 @@ void HDFirearm::Update()
                 m_LastFireTmr.Reset();
             }
 
-            Vector roundVel;
             Vector shellVel;
 
-            Round *pRound = 0;
+            const Round *pRound = 0;
             Vector tempNozzle;
             Vector tempEject;
             MOPixel *pPixel;
-            float shake, particleSpread, shellSpread, lethalRange;
+            float shake, shellSpread, lethalRange;
 
 			int player = -1;
 			Controller * pController = 0;
@@ -777,69 +776,43 @@ void HDFirearm::Update()
             if (pUser)
                 lethalRange += pUser->GetAimDistance();
 
-            // Fire all rounds that were fired this frame.
+            // Fire all rounds that were fired this frame. The random spreads are drawn round by round in the same order as always, then the positions and velocities
+            // of all the fired particles are worked out together, and the particles are cloned straight from their Round's preset and added to MovableMan in one go
+            std::vector<const MovableObject *> particlePresets;
+            std::vector<float> roundAngles;
+            std::vector<float> fireVels;
+            std::vector<float> nozzleXs;
+            std::vector<float> nozzleYs;
+            std::vector<float> separationOffsets;
+            std::vector<float> spreadAngles;
+            std::vector<MovableObject *> firedParticles;
+            std::vector<MovableObject *> ejectedShells;
+
             for (int i = 0; i < roundsFired && !m_pMagazine->IsEmpty(); ++i)
             {
 				m_RoundsFired++;
 
-                pRound = m_pMagazine->PopNextRound();
+                pRound = m_pMagazine->PopNextRoundPreset();
                 shake = (m_ShakeRange - ((m_ShakeRange - m_SharpShakeRange) * m_SharpAim)) *
                         (m_Supported ? 1.0F : m_NoSupportFactor) * RandomNormalNum();
                 tempNozzle = m_MuzzleOff.GetYFlipped(m_HFlipped);
                 tempNozzle.DegRotate(degAimAngle + shake);
-                roundVel.SetIntXY(pRound->GetFireVel(), 0);
-                roundVel.DegRotate(degAimAngle + shake);
-
-                Vector particlePos;
-                Vector particleVel;
+                float roundAngle = (degAimAngle + shake) * c_PI / 180.0F;
+                // The fire velocity has always been truncated to whole pixels per frame
+                float roundFireVel = static_cast<float>(static_cast<int>(pRound->GetFireVel()));
 
-                // Launch all particles in round
-                MovableObject *pParticle = 0;
-                while (!pRound->IsEmpty())
+                const MovableObject *pParticlePreset = pRound->GetNextParticle();
+                for (int particle = 0; particle < pRound->ParticleCount() && pParticlePreset; ++particle)
                 {
-                    pParticle = pRound->PopNextParticle();
-
+                    particlePresets.push_back(pParticlePreset);
+                    roundAngles.push_back(roundAngle);
+                    fireVels.push_back(roundFireVel);
+                    nozzleXs.push_back(tempNozzle.m_X);
+                    nozzleYs.push_back(tempNozzle.m_Y);
                     // Only make the particles separate back behind the nozzle, not in front. THis is to avoid silly penetration firings
-					particlePos = tempNozzle + (roundVel.GetNormalized() * (-RandomNum()) * pRound->GetSeparation());
-                    pParticle->SetPos(m_Pos + particlePos);
-
-                    particleVel = roundVel;
-                    particleSpread = m_ParticleSpreadRange * RandomNormalNum();
-                    particleVel.DegRotate(particleSpread);
-                    pParticle->SetVel(m_Vel + particleVel);
-                    pParticle->SetRotAngle(particleVel.GetAbsRadAngle());
-                    // F = m * a
-                    totalFireForce += pParticle->GetMass() * pParticle->GetVel().GetMagnitude();
-
-                    // Detach if it's an attachable
-                    Attachable *pAttachable = dynamic_cast<Attachable *>(pParticle);
-                    if (pAttachable)
-                    {
-                        pAttachable->Detach();
-                        // Activate if it is some kind of grenade or whatnot.
-                        ThrownDevice *pTD = dynamic_cast<ThrownDevice *>(pAttachable);
-                        if (pTD)
-                            pTD->Activate();
-                    }
-
-                    // Set the fired particle to not hit this HeldDevice's parent, if applicable
-                    if (m_FireIgnoresThis)
-                        pParticle->SetWhichMOToNotHit(pRootParent, 1.0f);
-
-                    // Set the team so alarm events that happen if these gib won't freak out the guy firing
-                    pParticle->SetTeam(m_Team);
-
-                    // Also make this not hit team members
-                    pParticle->SetIgnoresTeamHits(true);
-
-                    // Decide for how long until the bullet tumble and start to lose lethality
-                    pPixel = dynamic_cast<MOPixel *>(pParticle);
-                    if (pPixel)
-                        pPixel->SetLethalRange(lethalRange);
-
-                    g_MovableMan.AddParticle(pParticle);
+                    separationOffsets.push_back(-RandomNum() * pRound->GetSeparation());
+                    spreadAngles.push_back(m_ParticleSpreadRange * RandomNormalNum() * c_PI / 180.0F);
                 }
-                pParticle = 0;
 
                 // Launch shell, if there is one.
                 MovableObject *pShell = pRound->GetShell() ? dynamic_cast<MovableObject *>(pRound->GetShell()->Clone()) : 0;
@@ -862,20 +835,80 @@ void HDFirearm::Update()
 //                      pParticle->SetWhichMOToNotHit(pRootParent, 1.0f);
                     // Set the team so alarm events that happen if these gib won't freak out the guy firing
                     pShell->SetTeam(m_Team);
-                    g_MovableMan.AddParticle(pShell);
+                    ejectedShells.push_back(pShell);
                     pShell = 0;
                 }
 
-                // Sound the extra Round firing sound, if any is defined
+                // Sound the extra Round firing sound, if any is defined. It's played from a copy so the preset is left alone
                 if (!playedRoundFireSound && pRound->HasFireSound())
                 {
-                    pRound->GetFireSound()->Play(m_Pos);
+                    SoundContainer roundFireSound(*pRound->GetFireSound());
+                    roundFireSound.Play(m_Pos);
                     playedRoundFireSound = true;
                 }
-
-                delete pRound;
             }
             pRound = 0;
+
+            // Work out where all the particles start and how fast they go. Rotating by an angle here matches Vector::RadRotate, where positive angles rotate counter-clockwise
+            int particleCount = particlePresets.size();
+            std::vector<float> particlePosXs(particleCount);
+            std::vector<float> particlePosYs(particleCount);
+            std::vector<float> particleVelXs(particleCount);
+            std::vector<float> particleVelYs(particleCount);
+            for (int particle = 0; particle < particleCount; ++particle)
+            {
+                float velAngle = roundAngles[particle] + spreadAngles[particle];
+                particlePosXs[particle] = m_Pos.m_X + nozzleXs[particle] + std::cos(roundAngles[particle]) * separationOffsets[particle];
+                particlePosYs[particle] = m_Pos.m_Y + nozzleYs[particle] - std::sin(roundAngles[particle]) * separationOffsets[particle];
+                particleVelXs[particle] = fireVels[particle] * std::cos(velAngle);
+                particleVelYs[particle] = -fireVels[particle] * std::sin(velAngle);
+            }
+
+            firedParticles.reserve(particleCount + ejectedShells.size());
+            Vector particleVel;
+            MovableObject *pParticle = 0;
+            for (int particle = 0; particle < particleCount; ++particle)
+            {
+                pParticle = dynamic_cast<MovableObject *>(particlePresets[particle]->Clone());
+                particleVel.SetXY(particleVelXs[particle], particleVelYs[particle]);
+                pParticle->SetPos(Vector(particlePosXs[particle], particlePosYs[particle]));
+                pParticle->SetVel(m_Vel + particleVel);
+                pParticle->SetRotAngle(particleVel.GetAbsRadAngle());
+                // F = m * a
+                totalFireForce += pParticle->GetMass() * pParticle->GetVel().GetMagnitude();
+
+                // Detach if it's an attachable
+                Attachable *pAttachable = dynamic_cast<Attachable *>(pParticle);
+                if (pAttachable)
+                {
+                    pAttachable->Detach();
+                    // Activate if it is some kind of grenade or whatnot.
+                    ThrownDevice *pTD = dynamic_cast<ThrownDevice *>(pAttachable);
+                    if (pTD)
+                        pTD->Activate();
+                }
+
+                // Set the fired particle to not hit this HeldDevice's parent, if applicable
+                if (m_FireIgnoresThis)
+                    pParticle->SetWhichMOToNotHit(pRootParent, 1.0f);
+
+                // Set the team so alarm events that happen if these gib won't freak out the guy firing
+                pParticle->SetTeam(m_Team);
+
+                // Also make this not hit team members
+                pParticle->SetIgnoresTeamHits(true);
+
+                // Decide for how long until the bullet tumble and start to lose lethality
+                pPixel = dynamic_cast<MOPixel *>(pParticle);
+                if (pPixel)
+                    pPixel->SetLethalRange(lethalRange);
+
+                firedParticles.push_back(pParticle);
+            }
+            pParticle = 0;
+
+            firedParticles.insert(firedParticles.end(), ejectedShells.begin(), ejectedShells.end());
+            g_MovableMan.AddParticles(firedParticles);
         }
     }
 /* This is done when manually reloading now
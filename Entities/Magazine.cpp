@@ -217,6 +217,22 @@ Round * Magazine::PopNextRound()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  PopNextRoundPreset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the preset of the next Round of ammo in this Magazine, and removes
+//                  it from the stack without making a copy of it.
+
+const Round * Magazine::PopNextRoundPreset()
+{
+    const Round *pNextRound = GetNextRound();
+    // Negative roundcount means infinite ammo
+    if (pNextRound && m_FullCapacity > 0)
+        m_RoundCount--;
+    return pNextRound;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:  EstimateDigStrenght
 //////////////////////////////////////////////////////////////////////////////////////////
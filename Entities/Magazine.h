@@ -130,6 +130,19 @@ ClassInfoGetters
 	Round * PopNextRound();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:  PopNextRoundPreset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the preset of the next Round of ammo in this Magazine, and removes
+//                  it from the stack without making a copy of it. For firing the Round
+//                  right away, where all that's needed is to read its properties.
+// Arguments:       None.
+// Return value:    A pointer to the Round preset, or 0 if this Magazine is empty.
+//                  Ownership IS NOT transferred!
+
+	const Round * PopNextRoundPreset();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetRoundCount
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -76,8 +76,9 @@ void MovableObject::Clear()
     m_HUDVisible = true;
     m_AllLoadedScripts.clear();
     m_FunctionsAndScripts.clear();
-    m_ScriptPresetName.clear();
-    m_ScriptObjectName.clear();
+    m_ScriptPresetTable = LuaMan::c_NoScriptReference;
+    m_ScriptObject = LuaMan::c_NoScriptReference;
+    m_ScriptStateGeneration = 0;
     m_ScreenEffectFile.Reset();
     m_pScreenEffect = 0;
 	m_EffectRotAngle = 0;
@@ -212,7 +213,21 @@ int MovableObject::Create(const MovableObject &reference)
     for (const std::pair<std::string, bool> &referenceScriptEntry : reference.m_AllLoadedScripts) {
         m_AllLoadedScripts.push_back({referenceScriptEntry.first, referenceScriptEntry.second});
     }
-    ReloadScripts(false);
+    // Copy the reference's table of scripted functions rather than running all its script files again. Only reload if there's no usable table to copy
+    if (!m_AllLoadedScripts.empty()) {
+        if (reference.m_ScriptPresetTable != LuaMan::c_NoScriptReference && reference.m_ScriptStateGeneration == g_LuaMan.GetMasterStateGeneration()) {
+            m_ScriptPresetTable = g_LuaMan.CopyScriptTable(reference.m_ScriptPresetTable);
+            m_ScriptStateGeneration = reference.m_ScriptStateGeneration;
+            for (const std::pair<const std::string, std::vector<std::pair<std::string, bool> *>> &referenceFunctionAndScripts : reference.m_FunctionsAndScripts) {
+                std::vector<std::pair<std::string, bool> *> &functionScripts = m_FunctionsAndScripts[referenceFunctionAndScripts.first];
+                for (const std::pair<std::string, bool> *referenceScriptEntry : referenceFunctionAndScripts.second) {
+                    functionScripts.push_back(&m_AllLoadedScripts[referenceScriptEntry - reference.m_AllLoadedScripts.data()]);
+                }
+            }
+        } else {
+            ReloadScripts(false);
+        }
+    }
 
     if (reference.m_pScreenEffect)
     {
@@ -454,8 +469,8 @@ int MovableObject::Save(Writer &writer) const
 void MovableObject::Destroy(bool notInherited) {
     if (ObjectScriptsInitialized()) {
         RunScriptedFunctionInAppropriateScripts("Destroy");
-        g_LuaMan.RunScriptString(m_ScriptObjectName + " = nil;");
     }
+    ReleaseScriptReferences(true);
 
     if (!notInherited) { SceneObject::Destroy(); }
     Clear();
@@ -466,18 +481,14 @@ void MovableObject::Destroy(bool notInherited) {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int MovableObject::InitializeObjectScripts() {
-    m_ScriptObjectName = GetClassName() + "s." + g_LuaMan.GetNewObjectID();
-
-    // Give Lua access to this object, then use that access to set up the object's Lua representation
-    g_LuaMan.SetTempEntity(this);
-
-    if (g_LuaMan.RunScriptString(m_ScriptObjectName + " = To" + GetClassName() + "(LuaMan.TempEntity);") < 0) {
-        m_ScriptObjectName = "ERROR";
+    // Set up the object's Lua representation, converted to its own class, and keep it referenced for as long as this is around
+    m_ScriptObject = g_LuaMan.CreateObjectScriptReference(this);
+    if (m_ScriptObject == LuaMan::c_NoScriptReference) {
         return -2;
     }
 
 	if (!(*m_FunctionsAndScripts.find("Create")).second.empty() && RunScriptedFunctionInAppropriateScripts("Create", true, true) < 0) {
-		m_ScriptObjectName = "ERROR";
+		ReleaseScriptReferences(false);
 		return -3;
 	}
     return 0;
@@ -485,6 +496,18 @@ int MovableObject::InitializeObjectScripts() {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void MovableObject::ReleaseScriptReferences(bool alsoReleasePresetTable) {
+    if (m_ScriptStateGeneration != g_LuaMan.GetMasterStateGeneration()) {
+        m_ScriptObject = LuaMan::c_NoScriptReference;
+        m_ScriptPresetTable = LuaMan::c_NoScriptReference;
+        return;
+    }
+    g_LuaMan.ReleaseScriptReference(m_ScriptObject);
+    if (alsoReleasePresetTable) { g_LuaMan.ReleaseScriptReference(m_ScriptPresetTable); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int MovableObject::LoadScript(const std::string &scriptPath, bool loadAsEnabledScript) {
     // Return an error if the script path is empty or already there
     if (scriptPath.empty()) {
@@ -495,31 +518,22 @@ int MovableObject::LoadScript(const std::string &scriptPath, bool loadAsEnabledS
     m_AllLoadedScripts.push_back({scriptPath, loadAsEnabledScript});
 
     // Clear the temporary variable names that will hold the functions read in from the file
-    for (const std::string &functionName : GetSupportedScriptFunctionNames()) {
-        if (g_LuaMan.RunScriptString(functionName + " = nil;") < 0) {
-            return -3;
-        }
-    }
-    // Create a new table for all presets and object instances of this class, to organize things a bit
-    if (g_LuaMan.RunScriptString(GetClassName() + "s = " + GetClassName() + "s or {};") < 0) {
-        return -3;
-    }
+    g_LuaMan.ClearGlobals(GetSupportedScriptFunctionNames());
 
     // Run the specified lua file to load everything in it into the global namespace for assignment
     if (g_LuaMan.RunScriptFile(scriptPath) < 0) {
         return -4;
     }
 
-    // If there's no ScriptPresetName this is the first script being loaded for this preset, or scripts have been reloaded.
-    // Generate a ScriptPresetName, setup a table for the preset's functions, and clear the instance object name so it gets created in the first run of UpdateScripts
-    if (m_ScriptPresetName.empty()) {
-        m_ScriptPresetName = GetClassName() + "s." + g_LuaMan.GetNewPresetID();
-
-        if (g_LuaMan.RunScriptString(m_ScriptPresetName + " = {};") < 0) {
+    // If there's no preset table this is the first script being loaded for this preset, or scripts have been reloaded.
+    // Setup a table for the preset's functions, and release the instance object so it gets created in the first run of UpdateScripts
+    if (m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
+        ReleaseScriptReferences(false);
+        m_ScriptPresetTable = g_LuaMan.CreateScriptTable();
+        m_ScriptStateGeneration = g_LuaMan.GetMasterStateGeneration();
+        if (m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
             return -3;
         }
-
-        m_ScriptObjectName.clear();
     }
 
     // Assign the different functions read in from the script to their permanent locations in the preset's table
@@ -527,16 +541,8 @@ int MovableObject::LoadScript(const std::string &scriptPath, bool loadAsEnabledS
         if (m_FunctionsAndScripts.find(functionName) == m_FunctionsAndScripts.end()) {
             m_FunctionsAndScripts.insert({functionName, std::vector<std::pair<std::string, bool> *>()});
         }
-        if (g_LuaMan.GlobalIsDefined(functionName)) {
+        if (g_LuaMan.StoreGlobalFunctionInScriptTable(m_ScriptPresetTable, functionName, scriptPath)) {
             m_FunctionsAndScripts.find(functionName)->second.push_back(&m_AllLoadedScripts.back());
-            int error = g_LuaMan.RunScriptString(
-                m_ScriptPresetName + "." + functionName + " = " + m_ScriptPresetName + "." + functionName + " or {}; " +
-                m_ScriptPresetName + "." + functionName + "[\"" + scriptPath + "\"] = " + functionName + ";"
-            );
-
-            if (error < 0) {
-                return -3;
-            }
         }
     }
     return 0;
@@ -556,11 +562,7 @@ int MovableObject::ReloadScripts(bool alsoReloadPresetScripts) {
         std::vector<std::pair<std::string, bool>> loadedScriptsCopy = object->m_AllLoadedScripts;
         object->m_AllLoadedScripts.clear();
         object->m_FunctionsAndScripts.clear();
-        if (shouldClearScriptPresetName) {
-            object->m_ScriptPresetName.clear();
-        } else {
-            object->m_ScriptObjectName.clear();
-        }
+        object->ReleaseScriptReferences(shouldClearScriptPresetName);
 
         int status = 0; 
         for (const std::pair<std::string, bool> &scriptEntry : loadedScriptsCopy) {
@@ -588,7 +590,7 @@ int MovableObject::ReloadScripts(bool alsoReloadPresetScripts) {
 bool MovableObject::AddScript(const std::string &scriptPath) {
     switch (LoadScript(scriptPath)) {
         case 0:
-            // If we have a ScriptObjectName that means Create has already been run for pre-existing scripts. Run it right away for this one.
+            // If we have a script object that means Create has already been run for pre-existing scripts. Run it right away for this one.
             if (ObjectScriptsInitialized()) {
                 RunScriptedFunction(scriptPath, "Create");
                 return false;
@@ -613,7 +615,7 @@ bool MovableObject::AddScript(const std::string &scriptPath) {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool MovableObject::EnableScript(const std::string &scriptPath) {
-    if (m_AllLoadedScripts.empty() || m_ScriptPresetName.empty()) {
+    if (m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
         return false;
     }
 
@@ -631,7 +633,7 @@ bool MovableObject::EnableScript(const std::string &scriptPath) {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool MovableObject::DisableScript(const std::string &scriptPath) {
-    if (m_AllLoadedScripts.empty() || m_ScriptPresetName.empty()) {
+    if (m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
         return false;
     }
 
@@ -649,16 +651,11 @@ bool MovableObject::DisableScript(const std::string &scriptPath) {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int MovableObject::RunScriptedFunction(const std::string &scriptPath, const std::string &functionName, std::vector<Entity *> functionEntityArguments, std::vector<std::string> functionLiteralArguments) {
-    if (m_AllLoadedScripts.empty() || m_ScriptPresetName.empty() || !ObjectScriptsInitialized()) {
+    if (m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference || !ObjectScriptsInitialized()) {
         return -1;
     }
 
-    std::string presetAndFunctionName = m_ScriptPresetName + "." + functionName;
-    std::string fullFunctionName = presetAndFunctionName + "[\"" + scriptPath + "\"]";
-    
-    int status = g_LuaMan.RunScriptedFunction(fullFunctionName, m_ScriptObjectName, {presetAndFunctionName, m_ScriptObjectName, fullFunctionName}, functionEntityArguments, functionLiteralArguments);
-    functionEntityArguments.clear();
-    functionLiteralArguments.clear();
+    int status = g_LuaMan.RunScriptedFunction(m_ScriptPresetTable, functionName, scriptPath, m_ScriptObject, functionEntityArguments, functionLiteralArguments);
     
     if (status < 0 && m_AllLoadedScripts.size() > 1) {
         g_ConsoleMan.PrintString("ERROR: An error occured while trying to run the " + functionName + " function for script at path " + scriptPath);
@@ -671,7 +668,7 @@ int MovableObject::RunScriptedFunction(const std::string &scriptPath, const std:
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int MovableObject::RunScriptedFunctionInAppropriateScripts(const std::string &functionName, bool runOnDisabledScripts, bool stopOnError, std::vector<Entity *> functionEntityArguments, std::vector<std::string> functionLiteralArguments) {
-    if (m_AllLoadedScripts.empty() || m_ScriptPresetName.empty() || !ObjectScriptsInitialized() || m_FunctionsAndScripts.find(functionName) == m_FunctionsAndScripts.end()) {
+    if (m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference || !ObjectScriptsInitialized() || m_FunctionsAndScripts.find(functionName) == m_FunctionsAndScripts.end()) {
         return -1;
     }
 
@@ -956,11 +953,12 @@ void MovableObject::Update()
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int MovableObject::UpdateScripts() {
-    if (m_AllLoadedScripts.empty() || m_ScriptPresetName.empty()) {
+    if (m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference) {
         return -1;
     }
 
-    int status = !g_LuaMan.ExpressionIsTrue(m_ScriptPresetName, false) ? ReloadScripts() : 0;
+    // If the Lua state has been recreated since the scripts were loaded, everything they set up is gone and they need loading again
+    int status = (m_ScriptStateGeneration != g_LuaMan.GetMasterStateGeneration()) ? ReloadScripts() : 0;
     status = (status >= 0 && !ObjectScriptsInitialized()) ? InitializeObjectScripts() : status;
     status = (status >= 0) ? RunScriptedFunctionInAppropriateScripts("Update", false, true) : status;
 
@@ -970,7 +968,7 @@ int MovableObject::UpdateScripts() {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int MovableObject::OnPieMenu(Actor *pieMenuActor) {
-    if (!pieMenuActor || m_AllLoadedScripts.empty() || m_ScriptPresetName.empty() || !ObjectScriptsInitialized()) {
+    if (!pieMenuActor || m_AllLoadedScripts.empty() || m_ScriptPresetTable == LuaMan::c_NoScriptReference || !ObjectScriptsInitialized()) {
         return -1;
     }
 
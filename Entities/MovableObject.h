@@ -21,6 +21,7 @@
 #include "Material.h"
 #include "MovableMan.h"
 #include "FrameMan.h"
+#include "LuaMan.h"
 
 struct BITMAP;
 
@@ -260,13 +261,13 @@ friend class Atom;
     /// Gets whether or not the object has a script name, and there were no errors when initializing its Lua scripts. If there were, the object would need to be reloaded.
     /// </summary>
     /// <returns>Whether or not the object's scripts have been successfully initialized.</returns>
-    bool ObjectScriptsInitialized() const { return !m_ScriptObjectName.empty() && m_ScriptObjectName != "ERROR"; }
+    bool ObjectScriptsInitialized() const { return m_ScriptObject != LuaMan::c_NoScriptReference; }
 
     /// <summary>
     /// Override SetPresetName so it also resets script preset name and then reloads scripts to safely allow for multiple scripts.
     /// </summary>
     /// <param name="newName">A string reference with the instance name of this Entity.</param>
-    void SetPresetName(const std::string &newName) override { Entity::SetPresetName(newName); m_ScriptPresetName.clear(); ReloadScripts(); }
+    void SetPresetName(const std::string &newName) override { Entity::SetPresetName(newName); ReleaseScriptReferences(true); ReloadScripts(); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1206,6 +1207,18 @@ friend class Atom;
 	bool IsAtRest();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsAtRestForScaledThreshold
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates wheter the MovableObject has been at rest for more than a
+//                  fraction of its rest threshold. Used to settle things sooner when the
+//                  simulation is struggling to keep up.
+// Arguments:       The fraction of the rest threshold that has to have passed.
+// Return value:    Wheter the MovableObject has been at rest for long enough.
+
+	bool IsAtRestForScaledThreshold(float thresholdScale) const { return !m_PinStrength && m_RestThreshold >= 0 && m_RestTimer.IsPastSimMS(static_cast<double>(m_RestThreshold) * thresholdScale); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsUpdated
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1765,6 +1778,13 @@ protected:
     /// <returns>0 on success, -2 if it fails to setup the script object in Lua, and -3 if it fails to run any Create function.</returns>
     int InitializeObjectScripts();
 
+    /// <summary>
+    /// Releases this' Lua registry references, or just forgets them if the Lua state they were made in is gone.
+    /// </summary>
+    /// <param name="alsoReleasePresetTable">Whether to release the reference to the preset's table of functions as well as the one to the object instance.</param>
+    void ReleaseScriptReferences(bool alsoReleasePresetTable);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  UpdateChildMOIDs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1891,10 +1911,12 @@ protected:
     // A map of function name strings to vectors of scripts for each function name. Said vectors contain pointers to pairs with the script path and whether or not the script is enabled. Used to efficiently avoid extra Lua calls.
     std::unordered_map<std::string, std::vector<std::pair<std::string, bool> *>> m_FunctionsAndScripts;
 
-    // The ID name unique to this' preset and its defined scripted functions in the lua state.
-    std::string m_ScriptPresetName;
-    // The ID name unique to this' object instance representation in the Lua state.
-    std::string m_ScriptObjectName;
+    // Registry reference to this' own table of scripted functions in the Lua state. Clones get a copy of the original's table, but the functions in it are shared.
+    int m_ScriptPresetTable;
+    // Registry reference to this' object instance representation in the Lua state.
+    int m_ScriptObject;
+    // Which Lua master state the above references were made in. They're stale if it's been recreated since.
+    int m_ScriptStateGeneration;
 
     // Special post processing flash effect file and Bitmap. Shuold be loaded from a 32bpp bitmap
     ContentFile m_ScreenEffectFile;
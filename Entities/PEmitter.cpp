@@ -16,6 +16,7 @@
 #include "RTETools.h"
 #include "PresetMan.h"
 #include "Emission.h"
+#include "RandomStream.h"
 
 namespace RTE {
 
@@ -423,8 +424,12 @@ namespace RTE {
 			double currentPPM, SPE;
 			MovableObject *pParticle = 0;
 			Vector parentVel, emitVel, pushImpulses;
+			// Draw from this emitter's own random stream for this sim update, so what it emits doesn't depend on what else drew random numbers before it
+			RandomStream emissionRandom(RandomStream::Emission, m_UniqueID, g_TimerMan.GetSimUpdateCount());
+			std::vector<float> emissionRandomValues;
+			int emissionIndex = 0;
 			// Go through all emissions and emit them according to their respective rates
-			for (list<Emission>::iterator eItr = m_EmissionList.begin(); eItr != m_EmissionList.end(); ++eItr)
+			for (list<Emission>::iterator eItr = m_EmissionList.begin(); eItr != m_EmissionList.end(); ++eItr, ++emissionIndex)
 			{
 				// Make sure the emissions only happen between the start time and end time
 				if (eItr->IsEmissionTime())
@@ -458,8 +463,36 @@ namespace RTE {
 					emitVel.Reset();
 					parentVel = pRootParent->GetVel() * (*eItr).InheritsVelocity();
 
+					// Cosmetic emissions that don't push the emitter are handed to the emission scheduler, which emits them along with all the others once everything has updated
+					if ((*eItr).IsCosmetic() && !(*eItr).PushesEmitter())
+					{
+						EmissionScheduler::EmissionRequest request;
+						request.ParticlePreset = (*eItr).GetEmissionParticlePreset();
+						request.ParticleCount = emissions;
+						request.Pos = m_EmissionOffset.IsZero() ? m_Pos : m_Pos + RotateOffset(m_EmissionOffset);
+						request.ParentVel = parentVel;
+						request.MinVelocity = (*eItr).GetMinVelocity() * (m_BurstTriggered ? m_BurstScale : 1.0);
+						request.VelocityRange = (*eItr).GetMaxVelocity() - (*eItr).GetMinVelocity() * (m_BurstTriggered ? m_BurstScale : 1.0);
+						request.EmitAngle = m_EmitAngle.GetRadAngle();
+						request.Spread = (*eItr).GetSpread() * (m_BurstTriggered ? m_BurstScale : 1.0);
+						request.Rotation = m_Rotation;
+						request.HFlipped = m_HFlipped;
+						request.LifeVariation = (*eItr).GetLifeVariation();
+						request.LifetimeScale = throttleFactor;
+						request.Team = m_Team;
+						request.MOToNotHit = m_EmissionsIgnoreThis ? pRootParent : 0;
+						request.StreamID = (static_cast<unsigned long long>(m_UniqueID) << 8) | (emissionIndex & 0xFF);
+						g_MovableMan.GetEmissionScheduler().AddRequest(request);
+						continue;
+					}
+
+					// Generate the velocity, angle and lifetime variation of all the emissions in one go
+					emissionRandomValues.resize(std::max(emissions, 0) * 3);
+					emissionRandom.FillFloats(emissionRandomValues.data(), emissionRandomValues.size(), 0.0F, 1.0F);
+
 					for (int i = 0; i < emissions; ++i)
 					{
+						const float *randomValues = &emissionRandomValues[i * 3];
 						velMin = (*eItr).GetMinVelocity() * (m_BurstTriggered ? m_BurstScale : 1.0);
 						velRange = (*eItr).GetMaxVelocity() - (*eItr).GetMinVelocity() * (m_BurstTriggered ? m_BurstScale : 1.0);
 						spread = (*eItr).GetSpread() * (m_BurstTriggered ? m_BurstScale : 1.0);
@@ -471,14 +504,13 @@ namespace RTE {
 							pParticle->SetPos(m_Pos/*Vector(m_Pos.m_X + 5 * NormalRand(), m_Pos.m_Y + 5 * NormalRand())*/);
 						else
 							pParticle->SetPos(m_Pos + RotateOffset(m_EmissionOffset));
-						// TODO: Optimize making the random angles!")
-						emitVel.SetXY(velMin + RandomNum(0.0F, velRange), 0);
-						emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * RandomNormalNum());
+						emitVel.SetXY(velMin + velRange * randomValues[0], 0);
+						emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * (randomValues[1] * 2.0F - 1.0F));
 						emitVel = RotateOffset(emitVel);
 						pParticle->SetVel(parentVel + emitVel);
 
 						if (pParticle->GetLifetime() != 0)
-							pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr).GetLifeVariation() * RandomNormalNum())));
+							pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr).GetLifeVariation() * (randomValues[2] * 2.0F - 1.0F))));
 						pParticle->SetTeam(m_Team);
 						pParticle->SetIgnoresTeamHits(true);
 
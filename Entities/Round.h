@@ -116,6 +116,12 @@ namespace RTE {
 		/// </summary>
 		/// <returns>A sound with the firing sample of this round.</returns>
 		SoundContainer * GetFireSound() { return &m_FireSound; }
+
+		/// <summary>
+		/// Gets the extra firing sound of this Round without allowing it to be changed, e.g. to copy it from a Round preset. OWNERSHIP IS NOT TRANSFERRED!
+		/// </summary>
+		/// <returns>A sound with the firing sample of this round.</returns>
+		const SoundContainer * GetFireSound() const { return &m_FireSound; }
 #pragma endregion
 
 #pragma region AI Properties
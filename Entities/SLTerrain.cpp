@@ -15,12 +15,18 @@
 #include "TerrainDebris.h"
 #include "TerrainObject.h"
 #include "PresetMan.h"
+#include "SettingsMan.h"
 #include "DataModule.h"
 #include "SceneObject.h"
 #include "MOPixel.h"
 #include "MOSprite.h"
 #include "Atom.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RTE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace RTE {
 
 ConcreteClassInfo(SLTerrain, SceneLayer, 0)
@@ -32,6 +38,7 @@ BITMAP * SLTerrain::m_spTempBitmap64 = 0;
 BITMAP * SLTerrain::m_spTempBitmap128 = 0;
 BITMAP * SLTerrain::m_spTempBitmap256 = 0;
 BITMAP * SLTerrain::m_spTempBitmap512 = 0;
+std::vector<unsigned char> SLTerrain::m_sSilhouetteRowMask;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -149,6 +156,7 @@ void SLTerrain::Clear()
     m_TerrainDebris.clear();
     m_TerrainObjects.clear();
     m_UpdatedMateralAreas.clear();
+    m_UpdatedStructuralAreas.clear();
     m_DrawMaterial = false;
 	m_NeedToClearFrostings = false;
 	m_NeedToClearDebris = false;
@@ -285,6 +293,8 @@ int SLTerrain::LoadData()
             return -1;
         }
         // Ok, we have now loaded the layers in from files, don't need to generate them from the material layer
+        if (g_SettingsMan.SparseTerrainLayers())
+            MakeLayersSparse();
         InitScrollRatios();
         return 0;
     }
@@ -498,6 +508,10 @@ int SLTerrain::LoadData()
     }
     CleanAir();
 
+    // Only now that all the layers are done being generated, so generating them doesn't give every row its own storage anyway
+    if (g_SettingsMan.SparseTerrainLayers())
+        MakeLayersSparse();
+
     InitScrollRatios();
 
     return 0;
@@ -908,6 +922,45 @@ void SLTerrain::SetMaterialPixel(const int pixelX, const int pixelY, const unsig
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BuildSilhouetteRowMask
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Compares a contiguous run of silhouette pixels against the same run
+//                  of the material and FG color layers, and flags every pixel where the
+//                  silhouette covers something that isn't air or mask color.
+
+bool SLTerrain::BuildSilhouetteRowMask(const unsigned char *silhouetteRow, const unsigned char *materialRow, const unsigned char *colorRow, unsigned char *maskRow, int length)
+{
+    int anyOverlap = 0;
+    int x = 0;
+
+#ifdef RTE_USE_SSE2
+    // Compare 16 pixels at a time; a lane overlaps if the silhouette is drawn there and the terrain has either material or color
+    const __m128i maskColor = _mm_set1_epi8(static_cast<char>(g_MaskColor));
+    const __m128i airMaterial = _mm_set1_epi8(static_cast<char>(g_MaterialAir));
+    const __m128i allSet = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; x + 16 <= length; x += 16)
+    {
+        __m128i silhouetteEmpty = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(silhouetteRow + x)), maskColor);
+        __m128i materialEmpty = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(materialRow + x)), airMaterial);
+        __m128i colorEmpty = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(colorRow + x)), maskColor);
+        __m128i overlap = _mm_andnot_si128(_mm_or_si128(silhouetteEmpty, _mm_and_si128(materialEmpty, colorEmpty)), allSet);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(maskRow + x), overlap);
+        anyOverlap |= _mm_movemask_epi8(overlap);
+    }
+#endif
+
+    for (; x < length; ++x)
+    {
+        bool overlap = silhouetteRow[x] != g_MaskColor && (materialRow[x] != g_MaterialAir || colorRow[x] != g_MaskColor);
+        maskRow[x] = overlap ? 0xFF : 0;
+        anyOverlap |= overlap;
+    }
+
+    return anyOverlap != 0;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          EraseSilhouette
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -924,8 +977,6 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
                                             int skipMOP,
                                             int maxMOPs)
 {
-// TODO: OPTIMIZE THIS, IT'S A TIME HOG. MAYBE JSUT STAMP THE OUTLINE AND SAMPLE SOME RANDOM PARTICLES?
-
     RTEAssert(pSprite, "Null BITMAP passed to SLTerrain::EraseSilhouette");
 
     deque<MOPixel *> MOPDeque;
@@ -937,19 +988,17 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
 
     int halfWidth = pSprite->w / 2;
     int halfHeight = pSprite->h / 2;
-    double SinA = sin(rotation.GetRadAngle());
-    double CosA = cos(rotation.GetRadAngle());
     int maxWidth = (pSprite->w + abs(pivot.m_X - halfWidth)) * scale;
     int maxHeight = (pSprite->h + abs(pivot.m_Y - halfHeight)) * scale;
     int maxDiameter = sqrt((float)(maxWidth * maxWidth + maxHeight * maxHeight)) * 2;
     int skipCount = skipMOP;
 
     // Choose an appropriate size
-    if (maxDiameter  >= 256)
+    if (maxDiameter >= 256)
         pTempBitmap = m_spTempBitmap512;
-    if (maxDiameter  >= 128)
+    else if (maxDiameter >= 128)
         pTempBitmap = m_spTempBitmap256;
-    else if (maxDiameter  >= 64)
+    else if (maxDiameter >= 64)
         pTempBitmap = m_spTempBitmap128;
     else if (maxDiameter >= 32)
         pTempBitmap = m_spTempBitmap64;
@@ -962,91 +1011,147 @@ deque<MOPixel *> SLTerrain::EraseSilhouette(BITMAP *pSprite,
     clear_bitmap(pTempBitmap);
     pivot_scaled_sprite(pTempBitmap, pSprite, pTempBitmap->w / 2, pTempBitmap->h / 2, pivot.m_X, pivot.m_Y,  ftofix(rotation.GetAllegroAngle()), ftofix(scale));
 
-    // Do the test of intersection between color pixels of the test bitmap and non-air pixels of the terrain
-    // Generate and collect MOPixels that represent the terrain overlap and clear the same pixels out of the terrain
-    int testX, testY, terrX, terrY;
-    MOPixel *pPixel = 0;
-	Material const * sceneMat = g_SceneMan.GetMaterialFromID(g_MaterialAir); 
-	Material const * spawnMat = g_SceneMan.GetMaterialFromID(g_MaterialAir);
-    halfWidth = pTempBitmap->w / 2;
-    halfHeight = pTempBitmap->h / 2;
-    unsigned char testPixel = 0, matPixel = 0, colorPixel = 0;
-
-    for (testY = 0; testY < pTempBitmap->h; ++testY)
+    if (m_sSilhouetteRowMask.size() < pTempBitmap->w)
+        m_sSilhouetteRowMask.resize(pTempBitmap->w);
+    unsigned char *pRowMask = &m_sSilhouetteRowMask[0];
+
+    BITMAP *pColorBitmap = m_pFGColor->GetBitmap();
+    const int terrainWidth = m_pMainBitmap->w;
+    const int terrainHeight = m_pMainBitmap->h;
+    // Upper left corner of the test bitmap in unwrapped scene coordinates
+    const int originX = std::floor(pos.m_X) - pTempBitmap->w / 2;
+    const int originY = std::floor(pos.m_Y) - pTempBitmap->h / 2;
+
+    // The terrain pixels that will become MOPixels, gathered in scan order so the skip and max counts work out as they would pixel by pixel
+    struct DislodgedPixel { int x; int y; unsigned char material; unsigned char color; };
+    std::vector<DislodgedPixel> dislodgedPixels;
+    if (makeMOPs)
+        dislodgedPixels.reserve(std::max(maxMOPs, 0));
+
+    // Bounds of the cleared color pixels, in test bitmap coordinates
+    int changedLeft = pTempBitmap->w;
+    int changedTop = pTempBitmap->h;
+    int changedRight = -1;
+    int changedBottom = -1;
+
+    // Do the test of intersection between color pixels of the test bitmap and non-air pixels of the terrain one row at a time,
+    // splitting each row into runs that are contiguous in the terrain bitmaps so wrapping is only dealt with once per run
+    for (int testY = 0; testY < pTempBitmap->h; ++testY)
     {
-        for (testX = 0; testX < pTempBitmap->w; ++testX)
+        int terrY = originY + testY;
+        if (terrY < 0 || terrY >= terrainHeight)
         {
-            terrX = pos.m_X - halfWidth + testX;
-            terrY = pos.m_Y - halfHeight + testY;
-
-            // Make sure we're checking within bounds
-            if (terrX < 0) {
-                if (m_WrapX)
-                    while (terrX < 0)
-                        terrX += m_pMainBitmap->w;
-                else
-                    continue;
-            }
-            if (terrY < 0) {
-                if (m_WrapY)
-                    while (terrY < 0)
-                        terrY += m_pMainBitmap->h;
-                else
-                    continue;
-            }
-            if (terrX >= m_pMainBitmap->w) {
-                if (m_WrapX)
-                    terrX %= m_pMainBitmap->w;
-                else
-                    continue;
-            }
-            if (terrY >= m_pMainBitmap->h) {
-                if (m_WrapY)
-                    terrY %= m_pMainBitmap->h;
-                else
-                    continue;
-            }
+            if (!m_WrapY)
+                continue;
+            terrY = ((terrY % terrainHeight) + terrainHeight) % terrainHeight;
+        }
+
+        const unsigned char *pTestRow = pTempBitmap->line[testY];
+        unsigned char *pMaterialRow = m_pMainBitmap->line[terrY];
+        unsigned char *pColorRow = pColorBitmap->line[terrY];
 
-            testPixel = getpixel(pTempBitmap, testX, testY);
-            matPixel = getpixel(m_pMainBitmap, terrX, terrY);
-            colorPixel = getpixel(m_pFGColor->GetBitmap(), terrX, terrY);
+        int testX = 0;
+        while (testX < pTempBitmap->w)
+        {
+            int terrX = originX + testX;
+            if (terrX < 0 || terrX >= terrainWidth)
+            {
+                if (!m_WrapX)
+                {
+                    // Skip ahead to the left edge of the terrain, or stop if we're past the right edge
+                    if (terrX < 0)
+                    {
+                        testX = -originX;
+                        continue;
+                    }
+                    break;
+                }
+                terrX = ((terrX % terrainWidth) + terrainWidth) % terrainWidth;
+            }
+            int runLength = std::min(pTempBitmap->w - testX, terrainWidth - terrX);
 
-            if (testPixel != g_MaskColor)
+            if (BuildSilhouetteRowMask(pTestRow + testX, pMaterialRow + terrX, pColorRow + terrX, pRowMask, runLength))
             {
-                // Only add PixelMO if we're not due to skip any
-                if (makeMOPs && matPixel != g_MaterialAir && colorPixel != g_MaskColor && ++skipCount > skipMOP && MOPDeque.size() < maxMOPs)
+                for (int i = 0; i < runLength; ++i)
                 {
-                    skipCount = 0;
-                    sceneMat = g_SceneMan.GetMaterialFromID(matPixel);
-                    spawnMat = sceneMat->GetSpawnMaterial() ? g_SceneMan.GetMaterialFromID(sceneMat->GetSpawnMaterial()) : sceneMat;
-                    // Create the MOPixel based off the Terrain data.
-                    pPixel = new MOPixel(colorPixel,
-                                         spawnMat->GetPixelDensity(),
-                                         Vector(terrX, terrY),
-                                         Vector(),
-                                         new Atom(Vector(), spawnMat->GetIndex(), 0, colorPixel, 2),
-                                         0);
-
-                    pPixel->SetToHitMOs(false);
-                    MOPDeque.push_back(pPixel);
-                    pPixel = 0;
+                    if (!pRowMask[i])
+                        continue;
+
+                    unsigned char matPixel = pMaterialRow[terrX + i];
+                    unsigned char colorPixel = pColorRow[terrX + i];
+
+                    // Only add PixelMO if we're not due to skip any
+                    if (makeMOPs && matPixel != g_MaterialAir && colorPixel != g_MaskColor && ++skipCount > skipMOP && static_cast<int>(dislodgedPixels.size()) < maxMOPs)
+                    {
+                        skipCount = 0;
+                        dislodgedPixels.push_back({terrX + i, terrY, matPixel, colorPixel});
+                    }
+
+                    if (colorPixel != g_MaskColor)
+                    {
+                        changedLeft = std::min(changedLeft, testX + i);
+                        changedRight = std::max(changedRight, testX + i);
+                        changedTop = std::min(changedTop, testY);
+                        changedBottom = std::max(changedBottom, testY);
+                    }
                 }
 
-                // Clear the terrain pixels
-                if (matPixel != g_MaterialAir)
-                    putpixel(m_pMainBitmap, terrX, terrY, g_MaterialAir);
-				if (colorPixel != g_MaskColor)
-				{
-					putpixel(m_pFGColor->GetBitmap(), terrX, terrY, g_MaskColor);
-					g_SceneMan.RegisterTerrainChange(terrX, terrY, 1, 1, g_MaskColor, false);
-				}
+                // Get the rows to write to through Allegro, so sparse layers give them their own storage first
+                pMaterialRow = reinterpret_cast<unsigned char *>(bmp_write_line(m_pMainBitmap, terrY));
+                pColorRow = reinterpret_cast<unsigned char *>(bmp_write_line(pColorBitmap, terrY));
+
+                // Clear the overlapped terrain pixels for the whole run at once
+                for (int i = 0; i < runLength; ++i)
+                {
+                    pMaterialRow[terrX + i] = pRowMask[i] ? g_MaterialAir : pMaterialRow[terrX + i];
+                    pColorRow[terrX + i] = pRowMask[i] ? g_MaskColor : pColorRow[terrX + i];
+                }
             }
-        }    
+            testX += runLength;
+        }
+    }
+
+    // Register a single change covering all the cleared color pixels, split at the vertical seam if needed since RegisterTerrainChange only handles horizontal wrapping
+    if (changedRight >= 0)
+    {
+        int changeX = originX + changedLeft;
+        int changeY = originY + changedTop;
+        int changeWidth = changedRight - changedLeft + 1;
+        int changeHeight = changedBottom - changedTop + 1;
+        if (m_WrapX)
+            changeX = ((changeX % terrainWidth) + terrainWidth) % terrainWidth;
+        if (m_WrapY)
+            changeY = ((changeY % terrainHeight) + terrainHeight) % terrainHeight;
+
+        if (changeY + changeHeight > terrainHeight)
+        {
+            g_SceneMan.RegisterTerrainChange(changeX, changeY, changeWidth, terrainHeight - changeY, g_MaskColor, false);
+            g_SceneMan.RegisterTerrainChange(changeX, 0, changeWidth, changeY + changeHeight - terrainHeight, g_MaskColor, false);
+        }
+        else
+            g_SceneMan.RegisterTerrainChange(changeX, changeY, changeWidth, changeHeight, g_MaskColor, false);
+    }
+
+    // Generate the MOPixels that represent the dislodged terrain in one go
+    for (const DislodgedPixel &dislodged : dislodgedPixels)
+    {
+        Material const *sceneMat = g_SceneMan.GetMaterialFromID(dislodged.material);
+        Material const *spawnMat = sceneMat->GetSpawnMaterial() ? g_SceneMan.GetMaterialFromID(sceneMat->GetSpawnMaterial()) : sceneMat;
+        // Create the MOPixel based off the Terrain data.
+        MOPixel *pPixel = new MOPixel(dislodged.color,
+                                      spawnMat->GetPixelDensity(),
+                                      Vector(dislodged.x, dislodged.y),
+                                      Vector(),
+                                      new Atom(Vector(), spawnMat->GetIndex(), 0, dislodged.color, 2),
+                                      0);
+
+        pPixel->SetToHitMOs(false);
+        MOPDeque.push_back(pPixel);
     }
 
     // Add a box to the updated areas list to show there's been change to the materials layer
 // TODO: improve fit/tightness of box here
-    m_UpdatedMateralAreas.push_back(Box(pos - pivot, maxWidth, maxHeight));
+    AddUpdatedMaterialArea(Box(pos - pivot, maxWidth, maxHeight));
 
     return MOPDeque;
 }
@@ -1085,7 +1190,7 @@ bool SLTerrain::ApplyObject(Entity *pEntity)
 // Description:     Draws a passed in MovableObject's graphical and material
 //                  representations to this Terrain's respective layers.
 
-void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
+void SLTerrain::ApplyMovableObject(MovableObject *pMObject, IntRect *changedArea)
 {
     if (!pMObject)
         return;
@@ -1133,8 +1238,11 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
         // Finally draw temporary bitmap to the Scene
         masked_blit(pTempBitmap, GetFGColorBitmap(), 0, 0, bitmapScroll.m_X, bitmapScroll.m_Y, pTempBitmap->w, pTempBitmap->h);
 
-		// Register terrain change
-		g_SceneMan.RegisterTerrainChange(bitmapScroll.m_X, bitmapScroll.m_Y, pTempBitmap->w, pTempBitmap->h, g_MaskColor, false);
+		// Register terrain change, or leave it to the caller if it's batching them up
+		if (changedArea)
+			*changedArea = IntRect(bitmapScroll.m_X, bitmapScroll.m_Y, bitmapScroll.m_X + pTempBitmap->w, bitmapScroll.m_Y + pTempBitmap->h);
+		else
+			g_SceneMan.RegisterTerrainChange(bitmapScroll.m_X, bitmapScroll.m_Y, pTempBitmap->w, pTempBitmap->h, g_MaskColor, false);
 
 
 // TODO: centralize seam drawing!
@@ -1162,7 +1270,7 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
         // Finally draw temporary bitmap to the Scene
         masked_blit(pTempBitmap, GetMaterialBitmap(), 0, 0, bitmapScroll.m_X, bitmapScroll.m_Y, pTempBitmap->w, pTempBitmap->h);
         // Add a box to the updated areas list to show there's been change to the materials layer
-        m_UpdatedMateralAreas.push_back(Box(bitmapScroll, pTempBitmap->w, pTempBitmap->h));
+        AddUpdatedMaterialArea(Box(bitmapScroll, pTempBitmap->w, pTempBitmap->h));
 // TODO: centralize seam drawing!
         // Draw over seams
         if (g_SceneMan.SceneWrapsX())
@@ -1184,8 +1292,11 @@ void SLTerrain::ApplyMovableObject(MovableObject *pMObject)
     else
     {
         pMObject->Draw(GetFGColorBitmap(), Vector(), g_DrawColor, true);
-		// Register terrain change
-		g_SceneMan.RegisterTerrainChange(pMObject->GetPos().m_X, pMObject->GetPos().m_Y, 1, 1, g_DrawColor, false);
+		// Register terrain change, or leave it to the caller if it's batching them up
+		if (changedArea)
+			*changedArea = IntRect(pMObject->GetPos().m_X, pMObject->GetPos().m_Y, pMObject->GetPos().m_X + 1, pMObject->GetPos().m_Y + 1);
+		else
+			g_SceneMan.RegisterTerrainChange(pMObject->GetPos().m_X, pMObject->GetPos().m_Y, 1, 1, g_DrawColor, false);
 
         pMObject->Draw(GetMaterialBitmap(), Vector(), g_DrawMaterial, true);
     }
@@ -1252,7 +1363,7 @@ void SLTerrain::ApplyTerrainObject(TerrainObject *pTObject)
 	g_SceneMan.RegisterTerrainChange(loc.m_X, loc.m_Y, pTObject->GetBitmapWidth(), pTObject->GetBitmapHeight(), g_MaskColor, false);
 
     // Add a box to the updated areas list to show there's been change to the materials layer
-    m_UpdatedMateralAreas.push_back(Box(loc, pTObject->GetMaterialBitmap()->w, pTObject->GetMaterialBitmap()->h));
+    AddUpdatedMaterialArea(Box(loc, pTObject->GetMaterialBitmap()->w, pTObject->GetMaterialBitmap()->h));
 
     // Apply all the child objects of the TO, and first reapply the team so all its children are guaranteed to be on the same team!
     pTObject->SetTeam(pTObject->GetTeam());
@@ -1335,7 +1446,8 @@ void SLTerrain::CleanAirBox(Box box, bool wrapsX, bool wrapsY)
 					_putpixel(m_pMainBitmap, wrapX, wrapY, g_MaterialAir);
 					matPixel = g_MaterialAir;
 				}
-				if (matPixel == g_MaterialAir)
+				// Only write pixels that actually change, so rows of a sparse layer that are already clean keep sharing their storage
+				if (matPixel == g_MaterialAir && _getpixel(m_pFGColor->GetBitmap(), wrapX, wrapY) != g_MaskColor)
 					_putpixel(m_pFGColor->GetBitmap(), wrapX, wrapY, g_MaskColor);
 			}
 
@@ -1369,7 +1481,8 @@ void SLTerrain::CleanAir()
                 _putpixel(m_pMainBitmap, x, y, g_MaterialAir);
                 matPixel = g_MaterialAir;
             }
-            if (matPixel == g_MaterialAir)
+            // Only write pixels that actually change, so rows of a sparse layer that are already clean keep sharing their storage
+            if (matPixel == g_MaterialAir && _getpixel(m_pFGColor->GetBitmap(), x, y) != g_MaskColor)
                 _putpixel(m_pFGColor->GetBitmap(), x, y, g_MaskColor);
         }
     }
@@ -1379,6 +1492,20 @@ void SLTerrain::CleanAir()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MakeLayersSparse
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Replaces the material, FG and BG color bitmaps of this SLTerrain with
+//                  SparseBitmaps.
+
+void SLTerrain::MakeLayersSparse()
+{
+    MakeSparse();
+    m_pFGColor->MakeSparse();
+    m_pBGColor->MakeSparse();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearAllMaterial
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@ namespace RTE
 
 class MOPixel;
 class TerrainDebris;
+struct IntRect;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -560,9 +561,11 @@ ClassInfoGetters
 // Description:     Draws a passed in MovableObject's graphical and material
 //                  representations to this Terrain's respective layers.
 // Arguments:       The MovableObject to apply to this Terrain. Ownership is NOT xferred!
+//                  An IntRect to set to the area of the terrain that was changed, instead
+//                  of registering the change right away. For batching up many changes.
 // Return value:    None.
 
-	void ApplyMovableObject(MovableObject *pMObject);
+	void ApplyMovableObject(MovableObject *pMObject, IntRect *changedArea = 0);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -589,7 +592,7 @@ ClassInfoGetters
 //                  and may be out of bounds of the scene.
 // Return value:    None.
 
-    void AddUpdatedMaterialArea(const Box &newArea) { m_UpdatedMateralAreas.push_back(newArea); }
+    void AddUpdatedMaterialArea(const Box &newArea) { m_UpdatedMateralAreas.push_back(newArea); m_UpdatedStructuralAreas.push_back(newArea); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -625,6 +628,31 @@ ClassInfoGetters
     void ClearUpdatedAreas() { m_UpdatedMateralAreas.clear(); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUpdatedStructuralAreas
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets a list of unwrapped boxes which show the areas where the material
+//                  layer has changed since the last call to ClearUpdatedStructuralAreas().
+//                  Kept apart from the updated material areas since those are consumed
+//                  on the pathfinding schedule.
+// Arguments:       None.
+// Return value:    Reference to the list that has been filled with Box:es which are
+//                  unwrapped and may be out of bounds of the scene!
+
+    std::list<Box> & GetUpdatedStructuralAreas() { return m_UpdatedStructuralAreas; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearUpdatedStructuralAreas
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears the list of areas in the material layer that need their
+//                  structural integrity re-evaluated.
+// Arguments:       None.
+// Return value:    None.
+
+    void ClearUpdatedStructuralAreas() { m_UpdatedStructuralAreas.clear(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CleanAirBox
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -646,6 +674,18 @@ ClassInfoGetters
     void CleanAir();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MakeLayersSparse
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Replaces the material, FG and BG color bitmaps of this SLTerrain with
+//                  SparseBitmaps, so rows that are all air or all one material share
+//                  their memory until they're dug into or drawn on.
+// Arguments:       None.
+// Return value:    None.
+
+    void MakeLayersSparse();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearAllMaterial
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -715,6 +755,8 @@ protected:
     // List of areas of the material layer which have been affected by the updating of new objects copied to it
     // These boxes are NOT wrapped, and can be out of bounds!
     std::list<Box> m_UpdatedMateralAreas;
+    // The same areas as above, but consumed by the structural integrity calculations instead of pathfinding
+    std::list<Box> m_UpdatedStructuralAreas;
 
     // Draw the material layer instead of the color layer.
     bool m_DrawMaterial;
@@ -726,6 +768,8 @@ protected:
     static BITMAP *m_spTempBitmap128;
     static BITMAP *m_spTempBitmap256;
     static BITMAP *m_spTempBitmap512;
+    // Reusable per-row overlap mask for EraseSilhouette, sized to the widest temp bitmap
+    static std::vector<unsigned char> m_sSilhouetteRowMask;
 
 	// Indicates, that before processing frostings-related properties for this terrain
 	// derived list with frostings must be cleared to avoid duplication when loading scenes
@@ -751,6 +795,22 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          BuildSilhouetteRowMask
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Compares a contiguous run of silhouette pixels against the same run
+//                  of the material and FG color layers, and flags every pixel where the
+//                  silhouette covers something that isn't air or mask color.
+// Arguments:       Pointer to the start of the run in the silhouette bitmap.
+//                  Pointer to the start of the run in the material bitmap.
+//                  Pointer to the start of the run in the FG color bitmap.
+//                  Pointer to the mask buffer to fill, 0xFF for overlap and 0 otherwise.
+//                  The length of the run in pixels.
+// Return value:    Whether any pixel in the run overlaps the terrain.
+
+    static bool BuildSilhouetteRowMask(const unsigned char *silhouetteRow, const unsigned char *materialRow, const unsigned char *colorRow, unsigned char *maskRow, int length);
+
+
     // Disallow the use of some implicit methods.
 	SLTerrain(const SLTerrain &reference) = delete;
 	SLTerrain & operator=(const SLTerrain &rhs) = delete;
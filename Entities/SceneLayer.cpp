@@ -13,6 +13,7 @@
 
 #include "SceneLayer.h"
 #include "ContentFile.h"
+#include "SparseBitmap.h"
 
 namespace RTE {
 
@@ -169,12 +170,21 @@ int SceneLayer::Create(const SceneLayer &reference)
         BITMAP *pCopyFrom = reference.m_pMainBitmap;
         RTEAssert(pCopyFrom, "Couldn't load the bitmap file specified for SceneLayer!");
 
-        // Destination
-        m_pMainBitmap = create_bitmap_ex(8, pCopyFrom->w, pCopyFrom->h);
-        RTEAssert(m_pMainBitmap, "Failed to allocate BITMAP in SceneLayer::Create");
+        // Keep the copy sparse if the original is, so only the rows the original had to store are copied
+        if (SparseBitmap::IsSparse(pCopyFrom))
+        {
+            m_pMainBitmap = SparseBitmap::Create(pCopyFrom);
+            RTEAssert(m_pMainBitmap, "Failed to allocate BITMAP in SceneLayer::Create");
+        }
+        else
+        {
+            // Destination
+            m_pMainBitmap = create_bitmap_ex(8, pCopyFrom->w, pCopyFrom->h);
+            RTEAssert(m_pMainBitmap, "Failed to allocate BITMAP in SceneLayer::Create");
 
-        // Copy!
-        blit(pCopyFrom, m_pMainBitmap, 0, 0, 0, 0, pCopyFrom->w, pCopyFrom->h);
+            // Copy!
+            blit(pCopyFrom, m_pMainBitmap, 0, 0, 0, 0, pCopyFrom->w, pCopyFrom->h);
+        }
 
         InitScrollRatios();
 
@@ -274,7 +284,7 @@ int SceneLayer::SaveData(string bitmapPath)
 int SceneLayer::ClearData()
 {
     if (m_pMainBitmap && m_MainBitmapOwned)
-        destroy_bitmap(m_pMainBitmap);
+        SparseBitmap::Destroy(m_pMainBitmap);
     m_pMainBitmap = 0;
 
     m_MainBitmapOwned = false;
@@ -356,7 +366,7 @@ int SceneLayer::Save(Writer &writer) const
 void SceneLayer::Destroy(bool notInherited)
 {
     if (m_MainBitmapOwned)
-        destroy_bitmap(m_pMainBitmap);
+        SparseBitmap::Destroy(m_pMainBitmap);
 
     if (!notInherited)
         Entity::Destroy();
@@ -364,6 +374,24 @@ void SceneLayer::Destroy(bool notInherited)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MakeSparse
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Replaces this' own bitmap with a SparseBitmap holding the same pixels.
+
+void SceneLayer::MakeSparse()
+{
+    if (!m_pMainBitmap || !m_MainBitmapOwned || SparseBitmap::IsSparse(m_pMainBitmap))
+        return;
+
+    BITMAP *pSparseBitmap = SparseBitmap::Create(m_pMainBitmap);
+    RTEAssert(pSparseBitmap, "Failed to allocate sparse BITMAP in SceneLayer::MakeSparse");
+
+    destroy_bitmap(m_pMainBitmap);
+    m_pMainBitmap = pSparseBitmap;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          SetScaleFactor
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -189,6 +189,19 @@ ClassInfoGetters
     virtual bool IsFileData() const { return !m_BitmapFile.GetDataPath().empty();  }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MakeSparse
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Replaces this' own bitmap with a SparseBitmap holding the same pixels,
+//                  so its rows that are filled with a single value share their memory
+//                  until something is drawn to them. Does nothing if the bitmap isn't
+//                  owned by this, or is already sparse.
+// Arguments:       None.
+// Return value:    None.
+
+    void MakeSparse();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  Reset
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -49,6 +49,8 @@ GUIListPanel::GUIListPanel(GUIManager *Manager)
 	m_AlternateDrawMode = false;
 	m_LoopSelectionScroll = false;
 	m_MouseScroll = false;
+	m_ItemStackHeights.clear();
+	m_ItemStackHeightsDirty = true;
 }
 
 
@@ -83,6 +85,8 @@ GUIListPanel::GUIListPanel()
 	m_AlternateDrawMode = false;
 	m_LoopSelectionScroll = false;
 	m_MouseScroll = false;
+	m_ItemStackHeights.clear();
+	m_ItemStackHeightsDirty = true;
 }
 
 
@@ -195,6 +199,7 @@ void GUIListPanel::ClearList(void)
     }
 
     m_Items.clear();
+    m_ItemStackHeightsDirty = true;
 
     m_SelectedList.clear();
 
@@ -223,6 +228,11 @@ void GUIListPanel::AddItem(string Name, string rightText, GUIBitmap *pBitmap, co
     I->m_Height = GetItemHeight(I);
     I->m_ID = m_Items.size();
 
+    // Keep the cached stack heights up to date without going through the whole list again
+    if (!m_ItemStackHeightsDirty && m_ItemStackHeights.size() == m_Items.size() + 1)
+        m_ItemStackHeights.push_back(m_ItemStackHeights.back() + GetItemHeight(I));
+    else
+        m_ItemStackHeightsDirty = true;
     m_Items.push_back(I);
     
     // Calculate the largest width
@@ -231,6 +241,10 @@ void GUIListPanel::AddItem(string Name, string rightText, GUIBitmap *pBitmap, co
         m_LargestWidth = MAX(m_LargestWidth, FWidth);
     }
 
+    // Leave the scrollbars and drawing to EndUpdate if many items are being added at once
+    if (m_UpdateLocked)
+        return;
+
     // Adjust the scrollbars
     AdjustScrollbars();
     ScrollToItem(I);
@@ -318,6 +332,7 @@ void GUIListPanel::BuildBitmap(bool UpdateBase, bool UpdateText)
 
         m_Font->CacheColor(m_FontColor);
         m_Font->CacheColor(m_FontSelectColor);
+        m_ItemStackHeightsDirty = true;
 
         // Build only the background                                                 BG   Frame
         m_Skin->BuildStandardRect(m_BaseBitmap, "Listbox", 0, 0, m_Width, m_Height, true, false);
@@ -352,20 +367,15 @@ void GUIListPanel::BuildDrawBitmap(void)
         Height -= m_HorzScroll->GetHeight();
     int x = m_HorzScroll->GetValue();
     int y = 1 + (m_VertScroll->_GetVisible() ? -m_VertScroll->GetValue() : 0);
-    int stackHeight = 0;
     int thirdWidth = m_Width / 3;
 
-    // Go through each item
-    for(it = m_Items.begin(); it != m_Items.end(); it++, Count++)
-    {
-        stackHeight += GetItemHeight(*it);
-        // Only draw the items after the scroll value
-        if (m_VertScroll->_GetVisible() && stackHeight < m_VertScroll->GetValue())
-        {
-            y += GetItemHeight(*it);
-            continue;
-        }
+    // Only draw the items after the scroll value, so only the visible ones get drawn no matter how long the list is
+    Count = GetFirstVisibleItemIndex();
+    y += m_ItemStackHeights[Count];
 
+    // Go through each visible item
+    for(it = m_Items.begin() + Count; it != m_Items.end(); it++, Count++)
+    {
         Item *I = *it;
 
         // Alternate drawing mode
@@ -428,6 +438,8 @@ void GUIListPanel::BuildDrawBitmap(void)
                 m_DrawBitmap->DrawLine(4, y + itemHeight + 1, m_Width - 5, y + itemHeight + 1, 144);
 
             // Save the item height for later use in selection routines etc
+            if (I->m_Height != itemHeight)
+                m_ItemStackHeightsDirty = true;
             I->m_Height = itemHeight;
             y += itemHeight;
         }
@@ -1274,9 +1286,10 @@ GUIListPanel::Item * GUIListPanel::GetItem(int X, int Y)
     int y = m_Y + 1;
     if (m_VertScroll->_GetVisible())
         y -= m_VertScroll->GetValue();
-    int Count = 0;
-    int stackHeight = 0;
-    for(vector<Item *>::iterator it = m_Items.begin(); it != m_Items.end(); it++, Count++)
+    // Start at the first visible item, the ones above it can't be under the point
+    int Count = GetFirstVisibleItemIndex();
+    y += m_ItemStackHeights[Count];
+    for(vector<Item *>::iterator it = m_Items.begin() + Count; it != m_Items.end(); it++, Count++)
     {        
         Item *pItem = *it;
 
@@ -1348,16 +1361,56 @@ int GUIListPanel::GetItemHeight(Item *pItem)
 
 int GUIListPanel::GetStackHeight(Item *pItem)
 {
-    int height = 0;
+    UpdateItemStackHeights();
 
-    for (vector<Item *>::iterator iitr = m_Items.begin(); iitr != m_Items.end(); ++iitr)
-    {
-        if ((*iitr) == pItem)
-            break;
-        height += GetItemHeight((*iitr));
-    }
+    if (!pItem)
+        return m_ItemStackHeights.back();
 
-    return height;
+    // The ID is the index of the item, unless it was set to something else from outside
+    int index = pItem->m_ID;
+    if (index < 0 || index >= m_Items.size() || m_Items[index] != pItem)
+        index = std::find(m_Items.begin(), m_Items.end(), pItem) - m_Items.begin();
+
+    return m_ItemStackHeights[index];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateItemStackHeights
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recalculates the cached stack height of every item, if any item
+//                  heights have changed since the last time.
+
+void GUIListPanel::UpdateItemStackHeights()
+{
+    if (!m_ItemStackHeightsDirty && m_ItemStackHeights.size() == m_Items.size() + 1)
+        return;
+
+    m_ItemStackHeights.resize(m_Items.size() + 1);
+    m_ItemStackHeights[0] = 0;
+    for (int i = 0; i < m_Items.size(); ++i)
+        m_ItemStackHeights[i + 1] = m_ItemStackHeights[i] + GetItemHeight(m_Items[i]);
+
+    // Items without a font have no height yet, so keep recalculating until there is one
+    m_ItemStackHeightsDirty = !m_Font;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetFirstVisibleItemIndex
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the index of the first item that is at least partly visible
+//                  with the current vertical scroll value.
+
+int GUIListPanel::GetFirstVisibleItemIndex()
+{
+    UpdateItemStackHeights();
+
+    if (!m_VertScroll->_GetVisible())
+        return 0;
+
+    // The first item whose bottom is at or below the scroll value
+    return std::lower_bound(m_ItemStackHeights.begin() + 1, m_ItemStackHeights.end(), m_VertScroll->GetValue()) - (m_ItemStackHeights.begin() + 1);
 }
 
 
@@ -1370,6 +1423,7 @@ void GUIListPanel::SetItemValues(int Index, Item &item)
 {
     if (Index >= 0 && Index < m_Items.size())
         *(m_Items.at(Index)) = item;
+    m_ItemStackHeightsDirty = true;
 
     BuildBitmap(false, true);
 }
@@ -1453,6 +1507,7 @@ void GUIListPanel::DeleteItem(int Index)
         // Delete and remove it
         delete *(m_Items.begin() + Index);
         m_Items.erase(m_Items.begin() + Index);
+        m_ItemStackHeightsDirty = true;
 
         // Reset the id's
         vector<Item *>::iterator it;
@@ -1485,6 +1540,7 @@ void GUIListPanel::SetSize(int Width, int Height)
     m_HorzScroll->SetSize(m_Width, 17);
     m_VertScroll->SetPositionAbs(m_X+m_Width-17, m_Y);
     m_VertScroll->SetSize(17, m_Height);
+    m_ItemStackHeightsDirty = true;
 
     // Adjust the scrollbar values
     AdjustScrollbars();
@@ -280,6 +280,8 @@ public:
 // Method:          BeginUpdate
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Locks the control from updating every time a new item is added.
+//                  Use this around adding many items at once, so the list is only
+//                  rebuilt once at EndUpdate instead of once per item.
 // Arguments:       None.
 
     void BeginUpdate();
@@ -573,6 +575,27 @@ private:
     void SelectItem(int X, int Y, int Modifier);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateItemStackHeights
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recalculates the cached stack height of every item, if any item
+//                  heights have changed since the last time.
+// Arguments:       None.
+
+    void UpdateItemStackHeights();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetFirstVisibleItemIndex
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the index of the first item that is at least partly visible
+//                  with the current vertical scroll value.
+// Arguments:       None.
+// Return value:    The index of the item, or the item count if no item is visible.
+
+    int GetFirstVisibleItemIndex();
+
+
 	/// <summary>
 	/// Perform list scrolling through the scrollbar.
 	/// </summary>
@@ -617,6 +640,10 @@ private:
     bool                m_AlternateDrawMode;
 
     std::vector<Item *>    m_Items;
+    // The height of the stack of items above each item, with the whole stack's height at the end, so
+    // scrolling and drawing don't have to add up all the items above the visible ones every time
+    std::vector<int>    m_ItemStackHeights;
+    bool                m_ItemStackHeightsDirty;
     std::vector<Item *>    m_SelectedList;
     unsigned long                m_SelectedColorIndex;
 };
@@ -39,6 +39,7 @@
 #include "SceneLayer.h"
 #include "MOSParticle.h"
 #include "MOSRotating.h"
+#include "AtomGroup.h"
 #include "Controller.h"
 
 #include "MultiplayerServerLobby.h"
@@ -1599,6 +1600,8 @@ bool RunGameLoop() {
 			g_ActivityMan.Update();
 			g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
 			g_MovableMan.Update();
+			g_SceneMan.StructuralCalc(g_SceneMan.GetStructuralCalcTime());
+			g_SceneMan.UpdateTeamVisibility();
 
 			g_ActivityMan.LateUpdateGlobalScripts();
 
@@ -1629,6 +1632,9 @@ bool RunGameLoop() {
 			// Resuming the simulation
 			if (g_ResumeActivity) { ResumeActivity(); }
 		}
+		// Give the Lua garbage collector some of the time left before the next sim update is due
+		long long idleTicks = g_TimerMan.GetTimeToSleep();
+		if (idleTicks > 0) { g_LuaMan.CollectGarbageWhileIdle(idleTicks * 1000000 / g_TimerMan.GetTicksPerSecond()); }
 
 		if (g_NetworkServer.IsServerModeEnabled()) {
 			// Pause sim while we're waiting for scene transmission or scene will start changing before clients receive them and those changes will be lost.
@@ -1685,6 +1691,10 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar) {
                     std::string port = argv[++i];
                     g_NetworkServer.EnableServerMode();
                     g_NetworkServer.SetServerPort(port);
+				// Write the server statistics to a CSV file once a second
+				} else if (std::strcmp(argv[i], "-statscsv") == 0 && i + 1 < argc) {
+					const char *csvPath = argv[++i];
+					if (!g_NetworkServer.SetStatisticsCSVPath(csvPath)) { g_System.PrintToCLI("Could not open " + std::string(csvPath) + " for writing server statistics"); }
 				// Load a single module right after the official modules
                 } else if (std::strcmp(argv[i], "-module") == 0 && i + 1 < argc) {
 					g_PresetMan.SetSingleModuleToLoad(argv[++i]);
@@ -1844,6 +1854,7 @@ int main(int argc, char *argv[]) {
     g_TimerMan.Destroy();
     g_SettingsMan.Destroy();
     g_LuaMan.Destroy();
+    AtomGroup::ClearOutlineCache();
     ContentFile::FreeAllLoaded();
     g_ConsoleMan.Destroy();
 
@@ -446,7 +446,10 @@ namespace RTE {
 		FMOD::Channel *channel;
 		int channelIndex;
 		Vector sceneWrapHandlingPositions[2] = {position, position + Vector(position.m_X < g_SceneMan.GetSceneWidth() * 0.5 ? g_SceneMan.GetSceneWidth() : -g_SceneMan.GetSceneWidth(), 0)};
+		float networkAudibleDistance = 0;
 		for (SoundContainer::SoundData soundData : soundContainer->GetSelectedSoundSet()) {
+			// Same inverse attenuation as UpdateMobileSoundChannelCalculated3DEffects, from each sound's own minimum audible and attenuation start distances, so no sound that can still be heard is left out
+			if (m_IsInMultiplayerMode && !soundContainer->IsImmobile()) { networkAudibleDistance = std::max(networkAudibleDistance, soundData.CustomRolloffPoints[0].x + soundData.CustomRolloffPoints[1].x / c_NetworkSoundCullVolume); }
 			for (int copyToHandleSceneWrapping = 0; copyToHandleSceneWrapping < ((!soundContainer->IsImmobile() && g_SceneMan.SceneWrapsX()) ? 1 : 2); copyToHandleSceneWrapping++) {
 				result = (result == FMOD_OK) ? m_AudioSystem->playSound(soundData.SoundObject, soundContainer->IsImmobile() ? m_ImmobileSoundChannelGroup : m_MobileSoundChannelGroup, true, &channel) : result;
 				result = (result == FMOD_OK) ? channel->getIndex(&channelIndex) : result;
@@ -480,7 +483,7 @@ namespace RTE {
 
 		// Now that the sound is playing we can register an event with the SoundContainer's channels, which can be used by clients to identify the sound being played.
 		if (m_IsInMultiplayerMode) {
-			RegisterSoundEvent(player, SOUND_PLAY, soundContainer->GetPlayingChannels(), &soundContainer->GetSelectedSoundHashes(), position, soundContainer->GetLoopSetting(), pitch, soundContainer->IsAffectedByGlobalPitch(), soundContainer->GetAttenuationStartDistance(), soundContainer->IsImmobile());
+			RegisterSoundEvent(player, SOUND_PLAY, soundContainer->GetPlayingChannels(), &soundContainer->GetSelectedSoundHashes(), position, soundContainer->GetLoopSetting(), pitch, soundContainer->IsAffectedByGlobalPitch(), soundContainer->GetAttenuationStartDistance(), soundContainer->IsImmobile(), 0, priority, networkAudibleDistance);
 		}
 		return true;
 	}
@@ -585,24 +588,38 @@ namespace RTE {
 			return;
 		}
 		list.clear();
+		std::vector<PendingNetworkSoundEvent> soundEvents;
 		g_SoundEventsListMutex[player].lock();
+		soundEvents.swap(m_SoundEvents[player]);
+		g_SoundEventsListMutex[player].unlock();
 
-		for (std::list<NetworkSoundData>::iterator eItr = m_SoundEvents[player].begin(); eItr != m_SoundEvents[player].end(); ++eItr) {
-			list.push_back((*eItr));
+		// Compact outside the lock so sounds can keep being registered meanwhile
+		CompactSoundEvents(soundEvents);
+		for (const PendingNetworkSoundEvent &soundEvent : soundEvents) {
+			list.push_back(soundEvent.SoundData);
 		}
-		m_SoundEvents[player].clear();
-		g_SoundEventsListMutex[player].unlock();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void AudioMan::RegisterSoundEvent(int player, NetworkSoundState state, const std::unordered_set<unsigned short> *channels, const std::vector<size_t> *soundFileHashes, const Vector &position, short loops, float pitch, bool affectedByGlobalPitch, float attenuationStartDistance, bool immobile, short fadeOutTime) {
+	void AudioMan::RegisterSoundEvent(int player, NetworkSoundState state, const std::unordered_set<unsigned short> *channels, const std::vector<size_t> *soundFileHashes, const Vector &position, short loops, float pitch, bool affectedByGlobalPitch, float attenuationStartDistance, bool immobile, short fadeOutTime, int priority, float audibleDistance) {
 		if (player == -1) {
 			for (int i = 0; i < c_MaxClients; i++) {
-				RegisterSoundEvent(i, state, channels, soundFileHashes, position, loops, pitch, affectedByGlobalPitch, fadeOutTime);
+				RegisterSoundEvent(i, state, channels, soundFileHashes, position, loops, pitch, affectedByGlobalPitch, attenuationStartDistance, immobile, fadeOutTime, priority, audibleDistance);
 			}
 		} else {
 			if (player >= 0 && player < c_MaxClients) {
+				float listenerDistance = 0;
+				const Activity *currentActivity = g_ActivityMan.GetActivity();
+				int screen = (currentActivity && g_SceneMan.GetScene()) ? currentActivity->ScreenOfPlayer(player) : -1;
+				if (state == SOUND_PLAY && !immobile && screen >= 0) {
+					listenerDistance = g_SceneMan.ShortestDistance(position, g_SceneMan.GetScrollTarget(screen), g_SceneMan.SceneWrapsX()).GetMagnitude();
+					// Looping sounds are sent however far off they start because they may well come closer while they play
+					if (loops == 0 && audibleDistance > 0 && listenerDistance > audibleDistance) {
+						return;
+					}
+				}
+
 				NetworkSoundData soundData;
 				soundData.State = state;
 
@@ -622,12 +639,122 @@ namespace RTE {
 				soundData.FadeOutTime = fadeOutTime;
 
 				g_SoundEventsListMutex[player].lock();
-				m_SoundEvents[player].push_back(soundData);
+				m_SoundEvents[player].push_back({ soundData, priority, listenerDistance });
 				g_SoundEventsListMutex[player].unlock();
 			}
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void AudioMan::CompactSoundEvents(std::vector<PendingNetworkSoundEvent> &soundEvents) const {
+		if (soundEvents.size() < 2) {
+			return;
+		}
+		std::vector<bool> dropEvent(soundEvents.size(), false);
+
+		// Fold position changes into the event that started the sound, as long as nothing else happened to its channels in between
+		std::vector<int> lastEventOnChannel(c_MaxVirtualChannels, -1);
+		for (int eventIndex = 0; eventIndex < static_cast<int>(soundEvents.size()); eventIndex++) {
+			const NetworkSoundData &soundData = soundEvents[eventIndex].SoundData;
+			if (soundData.State == SOUND_SET_GLOBAL_PITCH) {
+				continue;
+			}
+			int channelCount = 0;
+			int sharedLastEvent = -1;
+			for (unsigned short channel : soundData.Channels) {
+				if (channel < c_MaxVirtualChannels) {
+					sharedLastEvent = (channelCount == 0 || lastEventOnChannel[channel] == sharedLastEvent) ? lastEventOnChannel[channel] : -1;
+					channelCount++;
+				}
+			}
+			if (soundData.State == SOUND_SET_POSITION && sharedLastEvent >= 0 && soundEvents[sharedLastEvent].SoundData.State == SOUND_PLAY) {
+				NetworkSoundData &playData = soundEvents[sharedLastEvent].SoundData;
+				if (std::count_if(std::begin(playData.Channels), std::end(playData.Channels), [](unsigned short channel) { return channel < c_MaxVirtualChannels; }) == channelCount) {
+					playData.Position[0] = soundData.Position[0];
+					playData.Position[1] = soundData.Position[1];
+					dropEvent[eventIndex] = true;
+					continue;
+				}
+			}
+			for (unsigned short channel : soundData.Channels) {
+				if (channel < c_MaxVirtualChannels) { lastEventOnChannel[channel] = eventIndex; }
+			}
+		}
+
+		// Going from the last event back, note the channels whose state later events decide, and drop earlier events on only those channels
+		// Playing a sound on a channel stops and replaces whatever the client had there, so playing and stopping both override everything before them
+		std::bitset<c_MaxVirtualChannels> channelsReplaced;
+		std::bitset<c_MaxVirtualChannels> channelsPositioned;
+		std::bitset<c_MaxVirtualChannels> channelsPitched;
+		bool globalPitchSet = false;
+
+		auto allChannelsIn = [](const NetworkSoundData &soundData, const std::bitset<c_MaxVirtualChannels> &channelSet) {
+			for (unsigned short channel : soundData.Channels) {
+				if (channel < c_MaxVirtualChannels && !channelSet[channel]) {
+					return false;
+				}
+			}
+			return true;
+		};
+		auto addChannels = [](const NetworkSoundData &soundData, std::bitset<c_MaxVirtualChannels> &channelSet) {
+			for (unsigned short channel : soundData.Channels) {
+				if (channel < c_MaxVirtualChannels) { channelSet.set(channel); }
+			}
+		};
+
+		for (int eventIndex = static_cast<int>(soundEvents.size()) - 1; eventIndex >= 0; eventIndex--) {
+			if (dropEvent[eventIndex]) {
+				continue;
+			}
+			const NetworkSoundData &soundData = soundEvents[eventIndex].SoundData;
+			switch (soundData.State) {
+				case SOUND_SET_GLOBAL_PITCH:
+					dropEvent[eventIndex] = globalPitchSet;
+					globalPitchSet = true;
+					break;
+				case SOUND_PLAY:
+				case SOUND_STOP:
+					dropEvent[eventIndex] = allChannelsIn(soundData, channelsReplaced);
+					addChannels(soundData, channelsReplaced);
+					break;
+				case SOUND_SET_POSITION:
+					dropEvent[eventIndex] = allChannelsIn(soundData, channelsReplaced | channelsPositioned);
+					addChannels(soundData, channelsPositioned);
+					break;
+				case SOUND_SET_PITCH:
+					dropEvent[eventIndex] = allChannelsIn(soundData, channelsReplaced | channelsPitched);
+					addChannels(soundData, channelsPitched);
+					break;
+				default:
+					dropEvent[eventIndex] = allChannelsIn(soundData, channelsReplaced);
+					break;
+			}
+		}
+
+		// Cap how many one-shot sounds start at once, keeping the most important and then the closest ones. Looping sounds are never dropped here because nothing would start them again later
+		std::vector<int> oneShotPlays;
+		for (int eventIndex = 0; eventIndex < static_cast<int>(soundEvents.size()); eventIndex++) {
+			if (!dropEvent[eventIndex] && soundEvents[eventIndex].SoundData.State == SOUND_PLAY && soundEvents[eventIndex].SoundData.Loops == 0) { oneShotPlays.push_back(eventIndex); }
+		}
+		if (oneShotPlays.size() > c_MaxNetworkSoundPlaysPerFrame) {
+			std::stable_sort(oneShotPlays.begin(), oneShotPlays.end(), [&soundEvents](int firstIndex, int secondIndex) {
+				const PendingNetworkSoundEvent &first = soundEvents[firstIndex];
+				const PendingNetworkSoundEvent &second = soundEvents[secondIndex];
+				return (first.Priority != second.Priority) ? first.Priority < second.Priority : first.ListenerDistance < second.ListenerDistance;
+			});
+			for (size_t playIndex = c_MaxNetworkSoundPlaysPerFrame; playIndex < oneShotPlays.size(); playIndex++) {
+				dropEvent[oneShotPlays[playIndex]] = true;
+			}
+		}
+
+		int keptEvents = 0;
+		for (int eventIndex = 0; eventIndex < static_cast<int>(soundEvents.size()); eventIndex++) {
+			if (!dropEvent[eventIndex]) { soundEvents[keptEvents++] = soundEvents[eventIndex]; }
+		}
+		soundEvents.resize(keptEvents);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	FMOD_RESULT F_CALLBACK AudioMan::MusicChannelEndedCallback(FMOD_CHANNELCONTROL *channelControl, FMOD_CHANNELCONTROL_TYPE channelControlType, FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void *unusedCommandData1, void *unusedCommandData2) {
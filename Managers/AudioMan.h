@@ -382,7 +382,8 @@ namespace RTE {
 		void RegisterMusicEvent(int player, NetworkMusicState state, const char *filepath, int loops = 0, double position = 0, float pitch = 1);
 
 		/// <summary>
-		/// Fills the list with sound events happened for the specified network player.
+		/// Fills the list with sound events happened for the specified network player, compacted so only what changes the end state of this frame's sounds is left.
+		/// Events fully overridden by later ones are dropped, position changes right after a sound started are folded into starting it, and only the most important one-shot sounds are kept if too many started.
 		/// </summary>
 		/// <param name="player">Player to get events for.</param>
 		/// <param name="list">List with events for this player.</param>
@@ -400,8 +401,11 @@ namespace RTE {
 		/// <param name="pitch">Pitch value.</param>
 		/// <param name="attenuationStartDistance">The distance at which the sound will start attenuating away.</param>
 		/// <param name="affectedByGlobalPitch">Whether the sound is affected by pitch.</param>
+		/// <param name="immobile">Whether the sound is immobile, which means it's heard the same wherever the listener is.</param>
 		/// <param name="fadeOutTime">The amount of time, in ms, to fade out over.</param>
-		void RegisterSoundEvent(int player, NetworkSoundState state, const std::unordered_set<unsigned short> *channels = NULL, const std::vector<size_t> *soundFileHashes = NULL, const Vector &position = Vector(), short loops = 0, float pitch = 1, bool affectedByGlobalPitch = false, float attenuationStartDistance = 0, bool immobile = false, short fadeOutTime = 0);
+		/// <param name="priority">The playback priority of the sound, used to pick which sounds to send when too many start playing at once.</param>
+		/// <param name="audibleDistance">How far from the listener a one-shot sound can start and still be louder than c_NetworkSoundCullVolume. Players further away aren't sent it. 0 means it's sent regardless.</param>
+		void RegisterSoundEvent(int player, NetworkSoundState state, const std::unordered_set<unsigned short> *channels = NULL, const std::vector<size_t> *soundFileHashes = NULL, const Vector &position = Vector(), short loops = 0, float pitch = 1, bool affectedByGlobalPitch = false, float attenuationStartDistance = 0, bool immobile = false, short fadeOutTime = 0, int priority = PRIORITY_NORMAL, float audibleDistance = 0);
 #pragma endregion
 
 #pragma region Class Info
@@ -439,8 +443,20 @@ namespace RTE {
 		std::list<std::string> m_MusicPlayList; //!< Playlist of paths to music to play after the current non looping one is done.
 		Timer m_SilenceTimer; //!< Timer for measuring silences between songs.
 
+		/// <summary>
+		/// A sound event waiting to be sent to a network player, with what decides whether it's worth sending.
+		/// </summary>
+		struct PendingNetworkSoundEvent {
+			NetworkSoundData SoundData; //!< The event as it's sent.
+			int Priority; //!< The playback priority of the sound. Lower is more important.
+			float ListenerDistance; //!< How far from the player's listener the sound started playing, to pick between sounds of the same priority.
+		};
+
+		static constexpr float c_NetworkSoundCullVolume = 0.05F; //!< One-shot sounds that would start playing quieter than this for a network player, going by the inverse attenuation of the loudest of their sounds, aren't sent to that player.
+		static constexpr int c_MaxNetworkSoundPlaysPerFrame = 32; //!< The most one-shot sounds that are sent to a network player as starting in a single frame.
+
 		bool m_IsInMultiplayerMode; //!< If true then the server is in multiplayer mode and will register sound and music events into internal lists.
-		std::list<NetworkSoundData> m_SoundEvents[c_MaxClients]; //!< Lists of per player sound events.
+		std::vector<PendingNetworkSoundEvent> m_SoundEvents[c_MaxClients]; //!< Lists of per player sound events.
 		std::list<NetworkMusicData> m_MusicEvents[c_MaxClients]; //!< Lists of per player music events.
 
 		std::mutex g_SoundEventsListMutex[c_MaxClients]; //!< A list for locking sound events for multiplayer to avoid race conditions and other such problems.
@@ -462,6 +478,12 @@ namespace RTE {
 		/// </summary>
 		static FMOD_RESULT F_CALLBACK AudioMan::PanAndAttenuationDSPCallback(FMOD_DSP_STATE *dspState, float *inBuffer, float *outBuffer, unsigned int length, int inChannels, int *outChannels);
 
+		/// <summary>
+		/// Compacts a frame's worth of sound events for a network player. Folds position changes into the events that started the sounds, drops events that later ones override entirely, and drops the least important one-shot sounds if more than c_MaxNetworkSoundPlaysPerFrame started.
+		/// </summary>
+		/// <param name="soundEvents">The sound events in the order they happened. Gets compacted in place.</param>
+		void CompactSoundEvents(std::vector<PendingNetworkSoundEvent> &soundEvents) const;
+
 		/// <summary>
 		/// Updates 3D effects calculations for all sound channels whose SoundContainers isn't immobile.
 		/// </summary>
@@ -47,6 +47,8 @@
 #include "PrimitiveMan.h"
 #include "UInputMan.h"
 #include "SettingsMan.h"
+#include "PerformanceMan.h"
+#include "TimerMan.h"
 
 #include "lua.hpp"
 
@@ -417,12 +419,18 @@ void LuaMan::Clear()
 {
     m_pMasterState = 0;
     m_LastError.clear();
-// TODO: is this the best way to give ID's.. won't ever be reset?
-    m_NextPresetID = 0;
-    m_NextObjectID = 0;
     m_pTempEntity = 0;
     m_TempEntityVector.clear();
     m_TempEntityVector.shrink_to_fit();
+    m_UsingMasterStateAllocator = false;
+    m_GCTimeBudget = 500;
+    m_GCIdleTimeLimit = 2000;
+    m_GCAllocationRate = 0;
+    m_GCStepDebt = 0;
+    m_GCHeapAfterSteps = 0;
+    m_GCTotalAllocatedAfterSteps = 0;
+    m_GCHeapAfterCycle = 0;
+    m_GCCycleInProgress = false;
 
 	//Clear files list
 	for (int i = 0; i < MAX_OPEN_FILES; ++i)
@@ -431,8 +439,28 @@ void LuaMan::Clear()
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Panic function for the master state, for errors that happen outside of any protected call and can't be recovered from.
+/// </summary>
+/// <param name="pState">The Lua master state.</param>
+/// <returns>Nothing, as it aborts.</returns>
+int LuaPanic(lua_State* pState) {
+    const char *errorString = lua_tostring(pState, -1);
+    RTEAbort(std::string("Unprotected error in Lua: ") + (errorString ? errorString : "unknown error"));
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int LuaMan::Create() {
-    m_pMasterState = luaL_newstate();
+    // Use the pooling allocator where the Lua build allows it, otherwise it's LuaJIT's own
+    m_pMasterState = lua_newstate(&LuaAllocator::Allocate, &m_MasterStateAllocator);
+    m_UsingMasterStateAllocator = m_pMasterState != 0;
+    if (m_UsingMasterStateAllocator)
+        lua_atpanic(m_pMasterState, &LuaPanic);
+    else
+        m_pMasterState = luaL_newstate();
+    m_MasterStateGeneration++;
     // Attach the master state to LuaBind
     luabind::open(m_pMasterState);
 
@@ -1654,6 +1682,9 @@ int LuaMan::Create() {
             .property("LayerDrawMode", &SceneMan::GetLayerDrawMode, &SceneMan::SetLayerDrawMode)
             .def("GetTerrMatter", &SceneMan::GetTerrMatter)
             .def("GetMOIDPixel", &SceneMan::GetMOIDPixel)
+            .def("IsStructuralCalcEnabled", &SceneMan::IsStructuralCalcEnabled)
+            .def("EnableStructuralCalc", &SceneMan::EnableStructuralCalc)
+            .property("TeamVisibilityInterval", &SceneMan::GetTeamVisibilityInterval, &SceneMan::SetTeamVisibilityInterval)
             .property("GlobalAcc", &SceneMan::GetGlobalAcc)
             .property("OzPerKg", &SceneMan::GetOzPerKg)
             .property("KgPerOz", &SceneMan::GetKgPerOz)
@@ -2247,7 +2278,9 @@ void LuaMan::ClearUserModuleCache()
 
 void LuaMan::Destroy()
 {
-    lua_close(m_pMasterState);
+    if (m_pMasterState)
+        lua_close(m_pMasterState);
+    m_MasterStateAllocator.Destroy();
 
 	//Close all opened files
 	for (int i = 0; i < MAX_OPEN_FILES; ++i)
@@ -2464,35 +2497,288 @@ int LuaMan::RunScriptFile(const std::string &filePath, bool consoleErrors) {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-string LuaMan::GetNewPresetID()
+int LuaMan::CreateScriptTable() {
+    lua_newtable(m_pMasterState);
+    return luaL_ref(m_pMasterState, LUA_REGISTRYINDEX);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::CopyScriptTable(int tableReference) {
+    if (tableReference == c_NoScriptReference) {
+        return c_NoScriptReference;
+    }
+    lua_rawgeti(m_pMasterState, LUA_REGISTRYINDEX, tableReference);
+    if (!lua_istable(m_pMasterState, -1)) {
+        lua_pop(m_pMasterState, 1);
+        return c_NoScriptReference;
+    }
+    lua_newtable(m_pMasterState);
+
+    // The table is laid out as table[functionName][scriptPath], so copy each function name's table of script functions into a new one of its own
+    lua_pushnil(m_pMasterState);
+    while (lua_next(m_pMasterState, -3)) {
+        if (lua_istable(m_pMasterState, -1)) {
+            lua_newtable(m_pMasterState);
+            lua_pushnil(m_pMasterState);
+            while (lua_next(m_pMasterState, -3)) {
+                lua_pushvalue(m_pMasterState, -2);
+                lua_insert(m_pMasterState, -2);
+                lua_rawset(m_pMasterState, -4);
+            }
+            lua_remove(m_pMasterState, -2);
+        }
+        lua_pushvalue(m_pMasterState, -2);
+        lua_insert(m_pMasterState, -2);
+        lua_rawset(m_pMasterState, -4);
+    }
+    int copyReference = luaL_ref(m_pMasterState, LUA_REGISTRYINDEX);
+    lua_pop(m_pMasterState, 1);
+    return copyReference;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::ReleaseScriptReference(int &reference) {
+    // Objects can outlive the master state during shutdown, by which point their references are all gone anyway
+    if (m_pMasterState && reference != c_NoScriptReference) { luaL_unref(m_pMasterState, LUA_REGISTRYINDEX, reference); }
+    reference = c_NoScriptReference;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::ClearGlobals(const std::vector<std::string> &globalNames) {
+    for (const std::string &globalName : globalNames) {
+        lua_pushnil(m_pMasterState);
+        lua_setglobal(m_pMasterState, globalName.c_str());
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::StoreGlobalFunctionInScriptTable(int tableReference, const std::string &functionName, const std::string &scriptPath) {
+    lua_getglobal(m_pMasterState, functionName.c_str());
+    if (!lua_isfunction(m_pMasterState, -1)) {
+        lua_pop(m_pMasterState, 1);
+        return false;
+    }
+    lua_rawgeti(m_pMasterState, LUA_REGISTRYINDEX, tableReference);
+    if (!lua_istable(m_pMasterState, -1)) {
+        lua_pop(m_pMasterState, 2);
+        return false;
+    }
+
+    // Get or make the table of functions with this name, keyed by the script they came from
+    lua_getfield(m_pMasterState, -1, functionName.c_str());
+    if (!lua_istable(m_pMasterState, -1)) {
+        lua_pop(m_pMasterState, 1);
+        lua_newtable(m_pMasterState);
+        lua_pushvalue(m_pMasterState, -1);
+        lua_setfield(m_pMasterState, -3, functionName.c_str());
+    }
+    lua_pushvalue(m_pMasterState, -3);
+    lua_setfield(m_pMasterState, -2, scriptPath.c_str());
+
+    // Pop the function table, the preset table and the function
+    lua_pop(m_pMasterState, 3);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::CreateObjectScriptReference(Entity *entity) {
+    if (!entity) {
+        return c_NoScriptReference;
+    }
+    if (!PushEntityAsItsClass(entity)) {
+        lua_pop(m_pMasterState, 1);
+        return c_NoScriptReference;
+    }
+    return luaL_ref(m_pMasterState, LUA_REGISTRYINDEX);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::RunScriptedFunction(int tableReference, const std::string &functionName, const std::string &scriptPath, int selfReference, const std::vector<Entity *> &functionEntityArguments, const std::vector<std::string> &functionLiteralArguments) {
+    if (tableReference == c_NoScriptReference || selfReference == c_NoScriptReference) {
+        return -1;
+    }
+    int stackTop = lua_gettop(m_pMasterState);
+    int error = 0;
+
+    lua_pushcfunction(m_pMasterState, &AddFileAndLineToError);
+    try {
+        // Look up table[functionName][scriptPath], quietly doing nothing if the script doesn't define that function
+        lua_rawgeti(m_pMasterState, LUA_REGISTRYINDEX, tableReference);
+        if (lua_istable(m_pMasterState, -1)) { lua_getfield(m_pMasterState, -1, functionName.c_str()); }
+        if (lua_istable(m_pMasterState, -1)) { lua_getfield(m_pMasterState, -1, scriptPath.c_str()); }
+        if (!lua_isfunction(m_pMasterState, -1)) {
+            lua_settop(m_pMasterState, stackTop);
+            return 0;
+        }
+        // Move the function down to just above the error handler, getting rid of the tables it was looked up through
+        lua_replace(m_pMasterState, stackTop + 2);
+        lua_settop(m_pMasterState, stackTop + 2);
+
+        lua_rawgeti(m_pMasterState, LUA_REGISTRYINDEX, selfReference);
+        for (Entity *functionEntityArgument : functionEntityArguments) {
+            PushEntityAsItsClass(functionEntityArgument);
+        }
+        for (const std::string &functionLiteralArgument : functionLiteralArguments) {
+            PushLiteralArgument(functionLiteralArgument);
+        }
+
+        int argumentCount = 1 + static_cast<int>(functionEntityArguments.size() + functionLiteralArguments.size());
+        if (lua_pcall(m_pMasterState, argumentCount, 0, stackTop + 1)) {
+            m_LastError = lua_tostring(m_pMasterState, -1);
+            g_ConsoleMan.PrintString("ERROR: " + m_LastError);
+            ClearErrors();
+            error = -1;
+        }
+    } catch (const std::exception &e) {
+        m_LastError = e.what();
+        g_ConsoleMan.PrintString("ERROR: " + m_LastError);
+        ClearErrors();
+        error = -1;
+    }
+
+    // Pop the file and line error handler, and anything left above it, off the stack to clean it up
+    lua_settop(m_pMasterState, stackTop);
+
+    return error;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::PushEntityAsItsClass(Entity *entity) {
+    luabind::object(m_pMasterState, entity).push(m_pMasterState);
+    if (!entity) {
+        return false;
+    }
+
+    // Convert through the class's To function so every property of the actual class is accessible, same as scripts do themselves
+    lua_getglobal(m_pMasterState, ("To" + entity->GetClassName()).c_str());
+    if (!lua_isfunction(m_pMasterState, -1)) {
+        lua_pop(m_pMasterState, 1);
+        return true;
+    }
+    lua_insert(m_pMasterState, -2);
+    if (lua_pcall(m_pMasterState, 1, 1, 0)) {
+        m_LastError = string("When converting ") + entity->GetClassName() + " for Lua: " + lua_tostring(m_pMasterState, -1);
+        lua_pop(m_pMasterState, 1);
+        luabind::object(m_pMasterState, entity).push(m_pMasterState);
+        return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::PushLiteralArgument(const std::string &literal) {
+    if (literal == "nil") {
+        lua_pushnil(m_pMasterState);
+        return true;
+    } else if (literal == "true" || literal == "false") {
+        lua_pushboolean(m_pMasterState, literal == "true");
+        return true;
+    }
+
+    char *numberEnd = nullptr;
+    double number = std::strtod(literal.c_str(), &numberEnd);
+    if (!literal.empty() && numberEnd == literal.c_str() + literal.size()) {
+        lua_pushnumber(m_pMasterState, number);
+        return true;
+    }
+    if (literal.size() >= 2 && (literal.front() == '"' || literal.front() == '\'') && literal.back() == literal.front() && literal.find('\\') == string::npos && literal.find(literal.front(), 1) == literal.size() - 1) {
+        lua_pushlstring(m_pMasterState, literal.c_str() + 1, literal.size() - 2);
+        return true;
+    }
+
+    // Anything more elaborate has to be evaluated, which is the one case that still compiles something
+    if (luaL_loadstring(m_pMasterState, ("return " + literal).c_str()) || lua_pcall(m_pMasterState, 0, 1, 0)) {
+        m_LastError = string("When evaluating Lua argument: ") + lua_tostring(m_pMasterState, -1);
+        lua_pop(m_pMasterState, 1);
+        lua_pushnil(m_pMasterState);
+        return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::Update()
 {
-    // Generate the new ID
-    char newID[64];
-    std::snprintf(newID, sizeof(newID), "Pre%05i", m_NextPresetID);
-    // Increment the ID so it will be diff for the next one (improve this primitive approach??)
-    m_NextPresetID++;
+	g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_LUA_GC);
+
+	// Everything allocated since the collector last ran has to be collected at the same pace, but smoothed so one busy update doesn't stall
+	size_t heapSize = GetHeapSize();
+	float allocated;
+	if (m_UsingMasterStateAllocator)
+		allocated = static_cast<float>(m_MasterStateAllocator.GetTotalAllocated() - m_GCTotalAllocatedAfterSteps);
+	else
+		allocated = heapSize > m_GCHeapAfterSteps ? static_cast<float>(heapSize - m_GCHeapAfterSteps) : 0;
+	m_GCAllocationRate = m_GCAllocationRate * 0.9F + allocated * 0.1F;
+	// Each basic step does the collection work of 1 KB of allocation, same as the collector paces itself
+	m_GCStepDebt += m_GCAllocationRate / 1024.0F;
+
+	StepGarbageCollector(m_GCTimeBudget, false);
 
-    return string(newID);
+	g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_LUA_GC);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-string LuaMan::GetNewObjectID()
+void LuaMan::CollectGarbageWhileIdle(long long idleTime)
 {
-    // Generate the new ID
-    char newID[64];
-    std::snprintf(newID, sizeof(newID), "Obj%05i", m_NextObjectID);
-    // Increment the ID so it will be diff for the next one (improve this primitive approach??)
-    m_NextObjectID++;
+	if (!m_pMasterState || m_GCIdleTimeLimit <= 0 || idleTime <= 0 || (!m_GCCycleInProgress && m_GCStepDebt < 1.0F))
+		return;
 
-    return string(newID);
+	g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_LUA_GC);
+	StepGarbageCollector(std::min(idleTime, static_cast<long long>(m_GCIdleTimeLimit)), true);
+	g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_LUA_GC);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void LuaMan::Update()
+size_t LuaMan::GetHeapSize() const
+{
+	if (!m_pMasterState)
+		return 0;
+	return (static_cast<size_t>(lua_gc(m_pMasterState, LUA_GCCOUNT, 0)) << 10) + static_cast<size_t>(lua_gc(m_pMasterState, LUA_GCCOUNTB, 0));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::StepGarbageCollector(long long timeLimit, bool finishCycle)
 {
-	lua_gc(m_pMasterState, LUA_GCSTEP, 1);
+	// Letting the heap double since the last cycle is the collector's own default pace, past that it has to catch up no matter what it costs
+	bool overdue = m_GCHeapAfterCycle > 0 && GetHeapSize() > m_GCHeapAfterCycle * 2;
+
+	long long startTime = g_TimerMan.GetAbsoluteTime();
+	while (overdue || m_GCStepDebt >= 1.0F || (finishCycle && m_GCCycleInProgress))
+	{
+		if (!overdue && g_TimerMan.GetAbsoluteTime() - startTime >= timeLimit)
+			break;
+
+		m_GCStepDebt = std::max(m_GCStepDebt - 1.0F, 0.0F);
+		if (lua_gc(m_pMasterState, LUA_GCSTEP, 0))
+		{
+			m_GCCycleInProgress = false;
+			m_GCHeapAfterCycle = GetHeapSize();
+			overdue = false;
+			if (finishCycle)
+				break;
+		}
+		else
+			m_GCCycleInProgress = true;
+	}
+
+	// Stepping leaves the collector ready to step again after the next 1 KB of allocation, which would be in the middle of the scripts.
+	// Push that back so it only steps by itself if the heap more than doubles before the next update, which is a runaway the budget can't be allowed to hold up.
+	lua_gc(m_pMasterState, LUA_GCRESTART, -1);
+
+	m_GCHeapAfterSteps = GetHeapSize();
+	m_GCTotalAllocatedAfterSteps = m_MasterStateAllocator.GetTotalAllocated();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
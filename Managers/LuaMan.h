@@ -12,6 +12,7 @@
 
 #include "Serializable.h"
 #include "Entity.h"
+#include "LuaAllocator.h"
 
 // Forward declarations
 struct lua_State;
@@ -39,6 +40,8 @@ class LuaMan:
 
 public:
 
+    static constexpr int c_NoScriptReference = -2; //!< A registry reference that refers to nothing. Same as LUA_NOREF.
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Constructor:     LuaMan
@@ -47,7 +50,7 @@ public:
 //                  memory. Create() should be called before using the object.
 // Arguments:       None.
 
-    LuaMan() { Clear(); }
+    LuaMan() { m_MasterStateGeneration = 0; Clear(); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -205,28 +208,65 @@ public:
     /// <returns>Returns less than zero if any errors encountered when running this script. To get the actual error string, call GetLastError.</returns>
     int RunScriptFile(const std::string &filePath, bool consoleErrors = true);
 
+    /// <summary>
+    /// Creates a new empty table in the master state, held by a registry reference. Used to hold the scripted functions of a preset.
+    /// </summary>
+    /// <returns>The registry reference to the new table. It must be released with ReleaseScriptReference when no longer needed.</returns>
+    int CreateScriptTable();
 
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetNewPresetID
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns an ID string unique to this runtime for use by original presets
-//                  that have scripts associated with them.
-// Arguments:       None.
-// Return value:    Returns the unique ID as a string.
+    /// <summary>
+    /// Gets which master state this is, counting up every time it's recreated. Registry references made in an earlier master state are meaningless and must not be used or released.
+    /// </summary>
+    /// <returns>The generation of the current master state.</returns>
+    int GetMasterStateGeneration() const { return m_MasterStateGeneration; }
 
-    std::string GetNewPresetID();
+    /// <summary>
+    /// Makes a copy of a table of scripted functions, with its own table for each function name, so scripts can be added to or reloaded in either one without affecting the other. The functions themselves are shared.
+    /// </summary>
+    /// <param name="tableReference">The registry reference to the table of scripted functions to copy.</param>
+    /// <returns>The registry reference to the new table, or c_NoScriptReference if there was no table to copy. It must be released with ReleaseScriptReference when no longer needed.</returns>
+    int CopyScriptTable(int tableReference);
 
+    /// <summary>
+    /// Releases a registry reference, letting Lua collect what it referred to once nothing else does.
+    /// </summary>
+    /// <param name="reference">The registry reference to release. Set to c_NoScriptReference afterwards.</param>
+    void ReleaseScriptReference(int &reference);
 
-//////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetNewObjectID
-//////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns an ID string unique to this runtime for use by individual
-//                  objects that are also tracked in the Lua state and have scripts
-//                  associated with them.
-// Arguments:       None.
-// Return value:    Returns the unique ID as a string.
+    /// <summary>
+    /// Sets a number of global variables to nil.
+    /// </summary>
+    /// <param name="globalNames">The names of the globals to clear.</param>
+    void ClearGlobals(const std::vector<std::string> &globalNames);
+
+    /// <summary>
+    /// Stores the function a script file left in a global variable in a table of scripted functions, as table[functionName][scriptPath].
+    /// </summary>
+    /// <param name="tableReference">The registry reference to the table to store the function in.</param>
+    /// <param name="functionName">The name of the global the function was left in, which is also the name it's stored under.</param>
+    /// <param name="scriptPath">The path of the script file the function came from.</param>
+    /// <returns>Whether the global held a function that was stored.</returns>
+    bool StoreGlobalFunctionInScriptTable(int tableReference, const std::string &functionName, const std::string &scriptPath);
+
+    /// <summary>
+    /// Creates the Lua representation of an object, converted to its own class so all its properties are accessible, held by a registry reference.
+    /// </summary>
+    /// <param name="entity">The object to create a representation of. Ownership is NOT transferred!</param>
+    /// <returns>The registry reference to the Lua representation, or c_NoScriptReference if it couldn't be created.</returns>
+    int CreateObjectScriptReference(Entity *entity);
 
-    std::string GetNewObjectID();
+    /// <summary>
+    /// Runs a function from a table of scripted functions, passing in the object referred to as the first argument. Nothing is compiled to do this.
+    /// If either argument list has entries, they will be passed into the function in order after the self object, with entity arguments first.
+    /// </summary>
+    /// <param name="tableReference">The registry reference to the table of scripted functions.</param>
+    /// <param name="functionName">The name of the function to run.</param>
+    /// <param name="scriptPath">The path of the script file the function came from.</param>
+    /// <param name="selfReference">The registry reference to the self object.</param>
+    /// <param name="functionEntityArguments">Entity pointers that should be passed into the Lua function. Their internal Lua states will not be accessible.</param>
+    /// <param name="functionLiteralArguments">Strings with Lua literals that should be passed into the Lua function, such as numbers, booleans or quoted strings.</param>
+    /// <returns>An error return value signaling sucess or any particular failure. Anything below 0 is an error signal. A function that isn't defined is not an error.</returns>
+    int RunScriptedFunction(int tableReference, const std::string &functionName, const std::string &scriptPath, int selfReference, const std::vector<Entity *> &functionEntityArguments, const std::vector<std::string> &functionLiteralArguments);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -265,6 +305,82 @@ public:
 	void Update();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CollectGarbageWhileIdle
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Spends time that would otherwise be idle before the next sim update
+//                  on garbage collection steps, finishing the current collection cycle
+//                  early if there is one underway.
+// Arguments:       How much idle time there is, in microseconds. Only up to the idle
+//                  time limit of it is used.
+// Return value:    None.
+
+	void CollectGarbageWhileIdle(long long idleTime);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetGCTimeBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much time garbage collection may take each sim update.
+// Arguments:       None.
+// Return value:    The time budget in microseconds.
+
+	int GetGCTimeBudget() const { return m_GCTimeBudget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetGCTimeBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how much time garbage collection may take each sim update.
+//                  Collection that doesn't fit is carried over to later updates, unless
+//                  the heap has grown so much that it can't wait.
+// Arguments:       The time budget in microseconds.
+// Return value:    None.
+
+	void SetGCTimeBudget(int timeBudget) { m_GCTimeBudget = std::max(timeBudget, 0); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetGCIdleTimeLimit
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the most idle time between sim updates garbage collection may use.
+// Arguments:       None.
+// Return value:    The idle time limit in microseconds.
+
+	int GetGCIdleTimeLimit() const { return m_GCIdleTimeLimit; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetGCIdleTimeLimit
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the most idle time between sim updates garbage collection may use.
+// Arguments:       The idle time limit in microseconds. 0 disables collecting while idle.
+// Return value:    None.
+
+	void SetGCIdleTimeLimit(int timeLimit) { m_GCIdleTimeLimit = std::max(timeLimit, 0); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetHeapSize
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much memory the master state is currently using.
+// Arguments:       None.
+// Return value:    The size of the Lua heap in bytes.
+
+	size_t GetHeapSize() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetGCAllocationRate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how fast scripts have been allocating memory lately, which sets
+//                  how much garbage collection is done each sim update.
+// Arguments:       None.
+// Return value:    The smoothed allocation rate in bytes per sim update.
+
+	float GetGCAllocationRate() const { return m_GCAllocationRate; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          FileOpen
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -346,19 +462,34 @@ protected:
 
     // The master parent script state
     lua_State *m_pMasterState;
+    // Which master state this is, counted up on each Create. Deliberately not reset by Clear
+    int m_MasterStateGeneration;
     // Description of the last error that occurred in the script execution
     std::string m_LastError;
-    // The next unique preset ID to hand out to the next Preset that wants to define some functions
-    // This gets incremented each time a new one is requeste to give unique ID's to all original presets
-    long m_NextPresetID;
-    // The next unique object ID to hand out to the next scripted Entity instance that wants to run its preset's scripts
-    // This gets incremented each time a new one is requested to give unique ID's to all scripted objects
-    long m_NextObjectID;
     // Temporary holder for an Entity object that we want to pass into the Lua state without fuss. Lets you export objects to lua easily.
     Entity *m_pTempEntity;
     // Temporary holder for a vector of Entities that we want to pass into the Lua state without a fuss. Usually used to pass arguments to special Lua functions.
     std::vector<Entity *> m_TempEntityVector;
 
+    // The allocator the master state was created with, which pools small blocks
+    LuaAllocator m_MasterStateAllocator;
+    // Whether the master state actually uses the allocator. LuaJIT builds for 64 bit without GC64 can't use custom allocators at all
+    bool m_UsingMasterStateAllocator;
+    // How many microseconds of garbage collection steps may be done each sim update, and at most while idle between them
+    int m_GCTimeBudget;
+    int m_GCIdleTimeLimit;
+    // The smoothed number of bytes allocated by scripts per sim update
+    float m_GCAllocationRate;
+    // How many basic collection steps are owed to keep up with the allocations made so far
+    float m_GCStepDebt;
+    // The heap size and total bytes allocated when the collector last stopped stepping, to measure allocations against
+    size_t m_GCHeapAfterSteps;
+    unsigned long long m_GCTotalAllocatedAfterSteps;
+    // The heap size when the last collection cycle finished, which the heap must not be allowed to grow too far past
+    size_t m_GCHeapAfterCycle;
+    // Whether a collection cycle has been started but not finished yet
+    bool m_GCCycleInProgress;
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
@@ -376,6 +507,44 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StepGarbageCollector
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs basic garbage collection steps until the steps owed for the
+//                  allocations so far are done, or time runs out. If the heap has grown
+//                  too far past its size after the last cycle, the time limit is ignored
+//                  until a cycle finishes.
+// Arguments:       The time limit in microseconds.
+//                  Whether to keep going until the current cycle is finished, even if
+//                  no more steps are owed.
+// Return value:    None.
+
+    void StepGarbageCollector(long long timeLimit, bool finishCycle);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PushEntityAsItsClass
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Pushes an Entity onto the stack of the master state, converted to its
+//                  own class if there's a To function for it.
+// Arguments:       The Entity to push. Ownership is NOT transferred!
+// Return value:    Whether the conversion succeeded. An Entity is pushed either way.
+
+    bool PushEntityAsItsClass(Entity *entity);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PushLiteralArgument
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Pushes the value of a Lua literal onto the stack of the master state.
+//                  Numbers, booleans, nil and simple quoted strings are pushed directly,
+//                  anything else has to be evaluated.
+// Arguments:       The string with the literal.
+// Return value:    Whether the value could be pushed. Nil is pushed if it couldn't.
+
+    bool PushLiteralArgument(const std::string &literal);
+
+
     // Disallow the use of some implicit methods.
 	LuaMan(const LuaMan &reference) = delete;
 	LuaMan & operator=(const LuaMan &rhs) = delete;
@@ -14,6 +14,8 @@
 #include "MovableMan.h"
 #include "PostProcessMan.h"
 #include "PerformanceMan.h"
+#include "FrameMan.h"
+#include "NetworkServer.h"
 #include "PresetMan.h"
 #include "AHuman.h"
 #include "MOPixel.h"
@@ -64,6 +66,21 @@ void MovableMan::Clear()
     m_MOIDIndex.clear();
     m_SplashRatio = 0.75;
     m_MaxDroppedItems = 25;
+    m_ParticleBudget = 10000;
+    m_EmissionScheduler.Reset();
+    m_SimLODGovernor.Reset();
+    // Sense workers keep running through a Reset, and are waiting on this state, so it's only cleared once they've been stopped
+    if (m_SenseWorkers.empty())
+    {
+        m_SenseGeneration = 0;
+        m_SenseWorkersBusy = 0;
+        m_StopSenseWorkers = false;
+        m_SenseActorCount = 0;
+        m_SenseChunkSize = 0;
+        m_NextSenseChunk = 0;
+    }
+    m_SettleQueue.clear();
+    m_SettleTimeBudget = 1.0F;
     m_SloMoTimer.Reset();
     m_SloMoThreshold = 100;
     m_SloMoDuration = 1000;
@@ -112,6 +129,24 @@ int MovableMan::ReadProperty(std::string propName, Reader &reader)
         reader >> m_SplashRatio;
     else if (propName == "MaxUnheldItems")
         reader >> m_MaxDroppedItems;
+    else if (propName == "ParticleBudget")
+        reader >> m_ParticleBudget;
+    else if (propName == "SettleTimeBudgetMS")
+        reader >> m_SettleTimeBudget;
+    else if (propName == "EnableSimLODGovernor")
+        m_SimLODGovernor.SetEnabled(std::stoi(reader.ReadPropValue()));
+    else if (propName == "SimLODTargetLoad")
+        m_SimLODGovernor.SetTargetLoad(std::stof(reader.ReadPropValue()));
+    else if (propName == "LockSimLODSettling")
+        m_SimLODGovernor.SetKnobLocked(SimLODGovernor::SettleAggressiveness, std::stoi(reader.ReadPropValue()));
+    else if (propName == "LockSimLODCosmeticEmission")
+        m_SimLODGovernor.SetKnobLocked(SimLODGovernor::CosmeticEmission, std::stoi(reader.ReadPropValue()));
+    else if (propName == "LockSimLODAISensing")
+        m_SimLODGovernor.SetKnobLocked(SimLODGovernor::AISenseFrequency, std::stoi(reader.ReadPropValue()));
+    else if (propName == "LockSimLODFarUpdates")
+        m_SimLODGovernor.SetKnobLocked(SimLODGovernor::FarUpdateRate, std::stoi(reader.ReadPropValue()));
+    else if (propName == "LockSimLODTinyParticleCollisions")
+        m_SimLODGovernor.SetKnobLocked(SimLODGovernor::TinyParticleMOCollision, std::stoi(reader.ReadPropValue()));
     else if (propName == "SloMoThreshold")
         reader >> m_SloMoThreshold;
     else if (propName == "SloMoDurationMS")
@@ -156,12 +191,15 @@ int MovableMan::Save(Writer &writer) const
 
 void MovableMan::Destroy()
 {
+    StopSenseWorkers();
+
     for (deque<Actor *>::iterator it1 = m_Actors.begin(); it1 != m_Actors.end(); ++it1)
         delete (*it1);
     for (deque<MovableObject *>::iterator it2 = m_Items.begin(); it2 != m_Items.end(); ++it2)
         delete (*it2);
     for (deque<MovableObject *>::iterator it3 = m_Particles.begin(); it3 != m_Particles.end(); ++it3)
         delete (*it3);
+    ClearSettleQueue();
 
     Clear();
 }
@@ -224,6 +262,7 @@ void MovableMan::PurgeAllMOs()
         delete (*it2);
     for (deque<MovableObject *>::iterator it3 = m_Particles.begin(); it3 != m_Particles.end(); ++it3)
         delete (*it3);
+    ClearSettleQueue();
 
     m_Actors.clear();
     m_Items.clear();
@@ -243,6 +282,7 @@ void MovableMan::PurgeAllMOs()
     m_AddedAlarmEvents.clear();
     m_AlarmEvents.clear();
     m_MOIDIndex.clear();
+    m_EmissionScheduler.Reset();
 
     // Set the time limit to 0 so it will report as being past it from the start of simulation
     m_SloMoTimer.SetRealTimeLimitMS(0);
@@ -929,6 +969,36 @@ void MovableMan::AddParticle(MovableObject *pMOToAdd)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddParticles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds a batch of MovableObjects to the internal list of MO:s in one
+//                  go, the same as calling AddParticle on each of them in order.
+
+void MovableMan::AddParticles(const std::vector<MovableObject *> &particlesToAdd)
+{
+    for (MovableObject *pMOToAdd : particlesToAdd)
+    {
+        if (!pMOToAdd)
+            continue;
+
+        pMOToAdd->SetAsAddedToMovableMan();
+        // Filter out stupid fast objects
+        if (pMOToAdd->IsTooFast())
+            pMOToAdd->SetToDelete(true);
+        else
+        {
+            pMOToAdd->NotResting();
+            pMOToAdd->NewFrame();
+            pMOToAdd->SetAge(0);
+        }
+        // Fired batches are nearly all particles, so only the odd device is pulled out into the items
+        if (pMOToAdd->IsDevice())
+            m_AddedItems.push_back(pMOToAdd);
+    }
+    std::copy_if(particlesToAdd.begin(), particlesToAdd.end(), std::back_inserter(m_AddedParticles), [](const MovableObject *pMOToAdd) { return pMOToAdd && !pMOToAdd->IsDevice(); });
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveActor
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1623,6 +1693,221 @@ void MovableMan::OnPieMenu(Actor * pActor)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseActorAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the sense phase of the native AI for all Actors, casting the
+//                  looks they prepared against the world before any of them is updated.
+
+void MovableMan::SenseActorAI()
+{
+    int actorCount = m_Actors.size();
+    int threadCount = std::min(static_cast<int>(std::thread::hardware_concurrency()), actorCount / c_MinActorsPerSenseThread);
+    if (threadCount <= 1)
+    {
+        for (Actor *actor : m_Actors)
+            actor->SenseAI();
+        return;
+    }
+
+    std::unique_lock<std::mutex> senseLock(m_SenseMutex);
+    // The main thread takes part itself, so one less worker than there are cores is enough
+    if (m_SenseWorkers.empty())
+    {
+        int workerCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        for (int worker = 0; worker < workerCount; ++worker)
+            m_SenseWorkers.emplace_back(&MovableMan::SenseWorkerLoop, this, m_SenseGeneration);
+    }
+
+    // Sensing only writes to each Actor's own sense results, so the Actors can just be split up into chunks. There are a few chunks per thread so
+    // the threads that finish early can pick up the slack, but never fewer Actors in a chunk than are worth handing to a thread
+    m_SenseActorCount = actorCount;
+    m_SenseChunkSize = std::max((actorCount + threadCount * 4 - 1) / (threadCount * 4), c_MinActorsPerSenseThread);
+    m_NextSenseChunk = 0;
+    m_SenseWorkersBusy = m_SenseWorkers.size();
+    ++m_SenseGeneration;
+    senseLock.unlock();
+    m_SenseStartCondition.notify_all();
+
+    SenseActorChunks();
+
+    // The Actors are about to be updated, so every worker has to be done reading them first
+    senseLock.lock();
+    m_SenseDoneCondition.wait(senseLock, [this]() { return m_SenseWorkersBusy == 0; });
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseActorChunks
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Takes chunks of Actors of the current sense phase and runs their AI
+//                  senses, until there are none left.
+
+void MovableMan::SenseActorChunks()
+{
+    for (int chunk = m_NextSenseChunk++; chunk * m_SenseChunkSize < m_SenseActorCount; chunk = m_NextSenseChunk++)
+    {
+        int endActor = std::min((chunk + 1) * m_SenseChunkSize, m_SenseActorCount);
+        for (int actorIndex = chunk * m_SenseChunkSize; actorIndex < endActor; ++actorIndex)
+            m_Actors[actorIndex]->SenseAI();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseWorkerLoop
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The body of a sense worker thread.
+
+void MovableMan::SenseWorkerLoop(int startGeneration)
+{
+    int lastGeneration = startGeneration;
+    std::unique_lock<std::mutex> senseLock(m_SenseMutex);
+    while (true)
+    {
+        m_SenseStartCondition.wait(senseLock, [this, lastGeneration]() { return m_StopSenseWorkers || m_SenseGeneration != lastGeneration; });
+        if (m_StopSenseWorkers)
+            return;
+        lastGeneration = m_SenseGeneration;
+
+        senseLock.unlock();
+        SenseActorChunks();
+        senseLock.lock();
+
+        if (--m_SenseWorkersBusy == 0)
+            m_SenseDoneCondition.notify_one();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopSenseWorkers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops and joins all the sense worker threads.
+
+void MovableMan::StopSenseWorkers()
+{
+    {
+        std::lock_guard<std::mutex> senseLock(m_SenseMutex);
+        m_StopSenseWorkers = true;
+    }
+    m_SenseStartCondition.notify_all();
+    for (std::thread &senseWorker : m_SenseWorkers)
+        senseWorker.join();
+    m_SenseWorkers.clear();
+    m_StopSenseWorkers = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateOnThisFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether an item or particle gets updated this frame, going by
+//                  the far update interval of the sim LOD governor.
+
+bool MovableMan::UpdateOnThisFrame(const MovableObject *movableObject, int index, int farUpdateInterval, const std::vector<Vector> &screenCenters) const
+{
+    if (farUpdateInterval <= 1 || (m_SimUpdateFrameNumber + index) % farUpdateInterval == 0)
+        return true;
+
+    // Anything within a screen's width or height of the center of a screen is close enough that skipped updates might be noticed
+    Vector reach(static_cast<float>(g_FrameMan.GetPlayerScreenWidth()), static_cast<float>(g_FrameMan.GetPlayerScreenHeight()));
+    for (const Vector &screenCenter : screenCenters)
+    {
+        Vector distance = g_SceneMan.ShortestDistance(screenCenter, movableObject->GetPos());
+        if (std::fabs(distance.m_X) < reach.m_X && std::fabs(distance.m_Y) < reach.m_Y)
+            return true;
+    }
+    return false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CommitSettleQueue
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws queued settled particles into the terrain and deletes them, until
+//                  the settle time budget runs out.
+
+void MovableMan::CommitSettleQueue(bool commitAll)
+{
+    if (m_SettleQueue.empty())
+        return;
+
+    long long startTime = g_TimerMan.GetAbsoluteTime();
+    long long timeBudget = static_cast<long long>(m_SettleTimeBudget * 1000.0F);
+    SLTerrain *pTerrain = g_SceneMan.GetTerrain();
+    std::vector<IntRect> changedAreas;
+
+    for (int committed = 0; !m_SettleQueue.empty(); ++committed)
+    {
+        if (!commitAll && committed >= c_MinSettlesPerUpdate && g_TimerMan.GetAbsoluteTime() - startTime >= timeBudget)
+            break;
+
+        MovableObject *pSettled = m_SettleQueue.front();
+        m_SettleQueue.pop_front();
+
+        // The terrain may have changed since this was queued, so only now check whether it should still be drawn into it
+        Vector parPos(pSettled->GetPos().GetFloored());
+        Material const * terrMat = g_SceneMan.GetMaterialFromID(pTerrain->GetMaterialPixel(parPos.m_X, parPos.m_Y));
+        if (pSettled->GetDrawPriority() >= terrMat->GetPriority())
+        {
+            // Gold particle special case to avoid compacting of gold
+            if (pSettled->GetMaterial()->GetIndex() == c_GoldMaterialID)
+            {
+                for (int s = 0; terrMat->GetIndex() == c_GoldMaterialID; ++s)
+                {
+                    if (s % 2 == 0)
+                        parPos.m_Y -= 1.0;
+                    else
+                        parPos.m_X += (RandomNum() >= 0.5F ? 1.0F : -1.0F);
+                    terrMat = g_SceneMan.GetMaterialFromID(pTerrain->GetMaterialPixel(parPos.m_X, parPos.m_Y));
+                }
+                pSettled->SetPos(parPos);
+            }
+
+            IntRect changedArea;
+            pTerrain->ApplyMovableObject(pSettled, &changedArea);
+
+            // Fold the change into a nearby one if the two together aren't too big, so clusters of settled gibs go out as a few rects instead of one each
+            bool merged = false;
+            for (IntRect &existingArea : changedAreas)
+            {
+                IntRect reach(existingArea.m_Left - c_SettleChangeMergeDistance, existingArea.m_Top - c_SettleChangeMergeDistance, existingArea.m_Right + c_SettleChangeMergeDistance, existingArea.m_Bottom + c_SettleChangeMergeDistance);
+                IntRect combinedArea(std::min(existingArea.m_Left, changedArea.m_Left), std::min(existingArea.m_Top, changedArea.m_Top), std::max(existingArea.m_Right, changedArea.m_Right), std::max(existingArea.m_Bottom, changedArea.m_Bottom));
+                if (reach.Intersects(changedArea) && combinedArea.m_Right - combinedArea.m_Left <= c_MaxSettleChangeSize && combinedArea.m_Bottom - combinedArea.m_Top <= c_MaxSettleChangeSize)
+                {
+                    existingArea = combinedArea;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged)
+                changedAreas.push_back(changedArea);
+        }
+        delete pSettled;
+    }
+
+    for (const IntRect &changedArea : changedAreas)
+    {
+        int width = changedArea.m_Right - changedArea.m_Left;
+        int height = changedArea.m_Bottom - changedArea.m_Top;
+        // Single pixel changes are sent as just their color rather than a copy of the terrain
+        unsigned char color = (width == 1 && height == 1) ? pTerrain->GetFGColorPixel(changedArea.m_Left, changedArea.m_Top) : g_MaskColor;
+        g_SceneMan.RegisterTerrainChange(changedArea.m_Left, changedArea.m_Top, width, height, color, false);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearSettleQueue
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Deletes all queued settled particles without drawing them into the
+//                  terrain.
+
+void MovableMan::ClearSettleQueue()
+{
+    for (deque<MovableObject *>::iterator setIt = m_SettleQueue.begin(); setIt != m_SettleQueue.end(); ++setIt)
+        delete (*setIt);
+    m_SettleQueue.clear();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Update
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1636,6 +1921,23 @@ void MovableMan::Update()
 
 	m_SimUpdateFrameNumber++;
 
+    // Let the governor react to how long the last few sim updates took before deciding how much detail this one gets
+    m_SimLODGovernor.Update(g_PerformanceMan.GetSimLoad());
+    float settleThresholdScale = m_SimLODGovernor.GetSettleThresholdScale();
+    int aiSenseInterval = m_SimLODGovernor.GetAISenseInterval();
+    int farUpdateInterval = m_SimLODGovernor.GetFarUpdateInterval();
+
+    // Only worth knowing where the screens are if anything far from them is going to skip updates
+    std::vector<Vector> screenCenters;
+    if (farUpdateInterval > 1)
+    {
+        Vector halfScreen(static_cast<float>(g_FrameMan.GetPlayerScreenWidth()) / 2.0F, static_cast<float>(g_FrameMan.GetPlayerScreenHeight()) / 2.0F);
+        // A server has a screen for every possible player, without splitting its own
+        int screenCount = g_NetworkServer.IsServerModeEnabled() ? c_MaxScreenCount : g_FrameMan.GetScreenCount();
+        for (int screen = 0; screen < screenCount; ++screen)
+            screenCenters.push_back(g_SceneMan.GetOffset(screen) + halfScreen);
+    }
+
     // Clear the MO color layer only if this is a drawn update
     if (g_TimerMan.DrawnSimUpdate())
         g_SceneMan.ClearMOColorLayer();
@@ -1742,6 +2044,12 @@ void MovableMan::Update()
         // Actors
 		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_PASS2);
         {
+            // Native AI senses for all Actors first against the frozen world, then acts in each Actor's Update. If the governor is spacing out AI senses, the Actors take turns
+            int count = 0;
+            for (aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt, ++count)
+                (*aIt)->PrepareAISense((m_SimUpdateFrameNumber + count) % aiSenseInterval == 0);
+            SenseActorAI();
+
             for (aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
             {
 				(*aIt)->Update();
@@ -1754,11 +2062,14 @@ void MovableMan::Update()
         // Items
         {
             int count = 0;
-            int itemLimit = m_Items.size() - m_MaxDroppedItems;
+            int itemLimit = m_Items.size() - static_cast<int>(static_cast<float>(m_MaxDroppedItems) * settleThresholdScale);
             for (iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt, ++count)
             {
-                (*iIt)->Update();
-                (*iIt)->UpdateScripts();
+                if (UpdateOnThisFrame(*iIt, count, farUpdateInterval, screenCenters))
+                {
+                    (*iIt)->Update();
+                    (*iIt)->UpdateScripts();
+                }
                 (*iIt)->ApplyImpulses();
                 if (count <= itemLimit)
                 {
@@ -1770,14 +2081,18 @@ void MovableMan::Update()
         // Particles
 		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS2);
         {
-            for (parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
+            int count = 0;
+            for (parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt, ++count)
             {
-                (*parIt)->Update();
-                (*parIt)->UpdateScripts();
+                if (UpdateOnThisFrame(*parIt, count, farUpdateInterval, screenCenters))
+                {
+                    (*parIt)->Update();
+                    (*parIt)->UpdateScripts();
+                }
                 (*parIt)->ApplyImpulses();
                 (*parIt)->RestDetection();
-                // Copy particles that are at rest to the terrain and mark them for deletion.
-                if ((*parIt)->IsAtRest())
+                // Copy particles that are at rest to the terrain and mark them for deletion. They're settled sooner when the governor is being aggressive about it
+                if ((*parIt)->IsAtRest() || (settleThresholdScale < 1.0F && (*parIt)->IsAtRestForScaledThreshold(settleThresholdScale)))
                 {
                     // Mark for settling after update loop.
                     (*parIt)->SetToSettle(true);
@@ -1785,6 +2100,12 @@ void MovableMan::Update()
             }
         }
 		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_PARTICLES_PASS2);
+
+        // Emit everything the cosmetic emissions asked for during the updates above in one go, sharing whatever room is left under the particle budget evenly between them
+        int particleAllowance = -1;
+        if (m_ParticleBudget > 0)
+            particleAllowance = std::max(m_ParticleBudget - static_cast<int>(m_Particles.size() + m_AddedParticles.size()), 0);
+        m_EmissionScheduler.ServiceRequests(particleAllowance, m_SimLODGovernor.GetCosmeticEmissionScale());
     }
 
     ///////////////////////////////////////////////////
@@ -1837,11 +2158,17 @@ void MovableMan::Update()
         m_AddedItems.clear();
 
         // Particles
+        bool tinyParticlesHitMOs = m_SimLODGovernor.TinyParticlesHitMOs();
         for (parIt = m_AddedParticles.begin(); parIt != m_AddedParticles.end(); ++parIt)
         {
             // Delete instead if it's marked for it
             if (!(*parIt)->IsSetToDelete())
+            {
+                // Tiny pixels that can't do any damage aren't worth colliding with MOs when the governor is shedding load
+                if (!tinyParticlesHitMOs && (*parIt)->HitsMOs() && (*parIt)->GetMass() < c_TinyParticleMass && (*parIt)->GetSharpness() <= 0 && dynamic_cast<MOPixel *>(*parIt))
+                    (*parIt)->SetToHitMOs(false);
                 m_Particles.push_back(*parIt);
+            }
             else
                 delete (*parIt);
         }
@@ -1950,40 +2277,18 @@ void MovableMan::Update()
     }
 
     // SETTLE PARTICLES //////////////////////////////////////////////////
-    // Only settle after all updates and deletions are done
+    // Only settle after all updates and deletions are done. Settled particles are queued up and drawn into the terrain under a time budget, so a big explosion settling all at once doesn't cause a hitch
     if (m_SettlingEnabled)
     {
         parIt = partition(m_Particles.begin(), m_Particles.end(), std::not_fn(std::mem_fn(&MovableObject::ToSettle)));
-        midIt = parIt;
-
-        while (parIt != m_Particles.end())
-        {
-            Vector parPos((*parIt)->GetPos().GetFloored());
-            Material const * terrMat = g_SceneMan.GetMaterialFromID(g_SceneMan.GetTerrain()->GetMaterialPixel(parPos.m_X, parPos.m_Y));
-            if ((*parIt)->GetDrawPriority() >= terrMat->GetPriority())
-            {
-                // Gold particle special case to avoid compacting of gold
-                if ((*parIt)->GetMaterial()->GetIndex() == c_GoldMaterialID)
-                {
-                    for (int s = 0; terrMat->GetIndex() == c_GoldMaterialID; ++s)
-                    {
-                        if (s % 2 == 0)
-                            parPos.m_Y -= 1.0;
-                        else
-                            parPos.m_X += (RandomNum() >= 0.5F ? 1.0F : -1.0F);
-                        terrMat = g_SceneMan.GetMaterialFromID(g_SceneMan.GetTerrain()->GetMaterialPixel(parPos.m_X, parPos.m_Y));
-                    }
-                    (*parIt)->SetPos(parPos);
-                }
+        m_SettleQueue.insert(m_SettleQueue.end(), parIt, m_Particles.end());
+        m_Particles.erase(parIt, m_Particles.end());
 
-//                (*parIt)->Draw(g_SceneMan.GetTerrain()->GetFGColorBitmap(), Vector(), g_DrawColor, true);
-//                (*parIt)->Draw(g_SceneMan.GetTerrain()->GetMaterialBitmap(), Vector(), g_DrawMaterial, true);
-                g_SceneMan.GetTerrain()->ApplyMovableObject(*parIt);
-            }
-            delete *(parIt++);
-        }
-        m_Particles.erase(midIt, m_Particles.end());
+        CommitSettleQueue();
     }
+    // Settling was turned off with some still queued, so finish them off right away
+    else
+        CommitSettleQueue(true);
 
     release_bitmap(g_SceneMan.GetTerrain()->GetMaterialBitmap());
 
@@ -2151,6 +2456,10 @@ void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
 
 void MovableMan::Draw(BITMAP *pTargetBitmap, const Vector &targetPos)
 {
+    // Settled particles that haven't been drawn into the terrain yet go underneath everything else, as if they were already part of it
+    for (deque<MovableObject *>::iterator setIt = m_SettleQueue.begin(); setIt != m_SettleQueue.end(); ++setIt)
+        (*setIt)->Draw(pTargetBitmap, targetPos);
+
     // Draw objects to accumulation bitmap, in reverse order so actors appear on top.
     for (deque<MovableObject *>::iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
         (*parIt)->Draw(pTargetBitmap, targetPos);
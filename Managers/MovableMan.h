@@ -19,6 +19,8 @@
 #include "SceneMan.h"
 #include "LuaMan.h"
 #include "Singleton.h"
+#include "SimLODGovernor.h"
+#include "EmissionScheduler.h"
 
 #define g_MovableMan MovableMan::Instance()
 
@@ -422,6 +424,72 @@ public:
     int GetMaxDroppedItems() const { return m_MaxDroppedItems; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetParticleBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how many particles there can be before cosmetic emissions are cut
+//                  off entirely. Each update they share whatever room is left under it.
+// Arguments:       The particle budget. 0 or less means there's no budget.
+// Return value:    None.
+
+    void SetParticleBudget(int newBudget) { m_ParticleBudget = newBudget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetParticleBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many particles there can be before cosmetic emissions are cut
+//                  off entirely.
+// Arguments:       None.
+// Return value:    The particle budget. 0 or less means there's no budget.
+
+    int GetParticleBudget() const { return m_ParticleBudget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetEmissionScheduler
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the scheduler that emitters register their cosmetic emissions
+//                  with. They are all emitted together once the MOs have been updated.
+// Arguments:       None.
+// Return value:    A reference to the scheduler.
+
+    EmissionScheduler & GetEmissionScheduler() { return m_EmissionScheduler; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSimLODGovernor
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the governor that reduces simulation detail when sim updates take
+//                  too long to keep up with real time.
+// Arguments:       None.
+// Return value:    A reference to the governor, for reading and changing its settings.
+
+    SimLODGovernor & GetSimLODGovernor() { return m_SimLODGovernor; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetSettleTimeBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how long each sim update may spend drawing settled particles into
+//                  the terrain. Whatever doesn't fit is left for the next update.
+// Arguments:       The time budget in ms.
+// Return value:    None.
+
+    void SetSettleTimeBudget(float newBudget) { m_SettleTimeBudget = newBudget; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetSettleTimeBudget
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how long each sim update may spend drawing settled particles into
+//                  the terrain.
+// Arguments:       None.
+// Return value:    The time budget in ms.
+
+    float GetSettleTimeBudget() const { return m_SettleTimeBudget; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          SortTeamRoster
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -482,6 +550,18 @@ public:
     void AddParticle(MovableObject *pMOToAdd);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AddParticles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds a batch of MovableObjects to the internal list of MO:s in one
+//                  go, the same as calling AddParticle on each of them in order.
+//                  Ownership of all of them IS transferred!
+// Arguments:       The MovableObjects to add. Null entries are skipped.
+// Return value:    None.
+
+    void AddParticles(const std::vector<MovableObject *> &particlesToAdd);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveActor
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -922,6 +1002,29 @@ protected:
     // Member variables
     static const std::string m_ClassName;
 
+    // The fewest Actors each thread of the AI sense phase gets, so threads aren't woken for less work than they cost
+    static constexpr int c_MinActorsPerSenseThread = 16;
+
+    // Worker threads that help the main thread through the AI sense phase. Started the first time there are enough Actors and kept until Destroy
+    std::vector<std::thread> m_SenseWorkers;
+    // Guards everything the sense workers are handed, and their wait conditions
+    std::mutex m_SenseMutex;
+    // Signaled when a new sense phase starts or the workers are being stopped
+    std::condition_variable m_SenseStartCondition;
+    // Signaled when the last busy worker is done with the current sense phase
+    std::condition_variable m_SenseDoneCondition;
+    // Counted up for each sense phase the workers take part in, so they can tell a new one from a spurious wakeup
+    int m_SenseGeneration;
+    // How many workers haven't finished the current sense phase yet
+    int m_SenseWorkersBusy;
+    // Whether the workers should exit
+    bool m_StopSenseWorkers;
+    // How many Actors the current sense phase covers, and how many of them go in each chunk that a thread takes at a time
+    int m_SenseActorCount;
+    int m_SenseChunkSize;
+    // The next chunk of Actors for any thread to take
+    std::atomic<int> m_NextSenseChunk;
+
     // All actors in the scene
     std::deque<Actor *> m_Actors;
     // List of items that are pickup-able by actors
@@ -960,6 +1063,17 @@ protected:
     float m_SplashRatio;
     // The maximum number of loose items allowed.
     int m_MaxDroppedItems;
+    // The number of particles at which cosmetic emissions are cut off entirely. 0 or less means no budget
+    int m_ParticleBudget;
+    // Emits the particles of all cosmetic emissions in one pass each update, within the particle budget
+    EmissionScheduler m_EmissionScheduler;
+    // Reduces simulation detail when sim updates fall behind real time
+    SimLODGovernor m_SimLODGovernor;
+
+    // Particles that have settled but haven't been drawn into the terrain yet, oldest first. They're drawn as they are until then. Owned by this
+    std::deque<MovableObject *> m_SettleQueue;
+    // How long each sim update may spend drawing settled particles into the terrain, in ms
+    float m_SettleTimeBudget;
 
     // Timer for measuring periods of slo-mo effects
     Timer m_SloMoTimer;
@@ -973,6 +1087,14 @@ protected:
     // Whtehr MO's vcanng et subtracted form the terrain at all
     bool m_MOSubtractionEnabled;
 
+    // Particles lighter than this that can't do damage stop hitting MOs when the sim LOD governor is shedding their collisions
+    static constexpr float c_TinyParticleMass = 0.01F;
+    // How many settled particles are drawn into the terrain each sim update no matter the time budget, so the queue always moves
+    static constexpr int c_MinSettlesPerUpdate = 16;
+    // How close the changed areas of settled particles have to be to be sent as one terrain change, and how big such an area can get, in pixels
+    static constexpr int c_SettleChangeMergeDistance = 8;
+    static constexpr int c_MaxSettleChangeSize = 128;
+
 	unsigned int m_SimUpdateFrameNumber;
 
 	// Global map which stores all objects so they could be foud by their unique ID
@@ -995,6 +1117,89 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseActorAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the sense phase of the native AI for all Actors, casting the
+//                  looks they prepared against the world before any of them is updated.
+//                  Split over several threads when there are enough Actors to be worth it.
+// Arguments:       None.
+// Return value:    None.
+
+    void SenseActorAI();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseActorChunks
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Takes chunks of Actors of the current sense phase and runs their AI
+//                  senses, until there are none left. Run by the main thread and every
+//                  sense worker at the same time.
+// Arguments:       None.
+// Return value:    None.
+
+    void SenseActorChunks();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SenseWorkerLoop
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     The body of a sense worker thread. Waits for each sense phase, helps
+//                  with it, and exits once the workers are stopped.
+// Arguments:       The sense generation at the time the worker was started.
+// Return value:    None.
+
+    void SenseWorkerLoop(int startGeneration);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StopSenseWorkers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Stops and joins all the sense worker threads.
+// Arguments:       None.
+// Return value:    None.
+
+    void StopSenseWorkers();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateOnThisFrame
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether an item or particle gets updated this frame, going by
+//                  the far update interval of the sim LOD governor. Anything near one of
+//                  the screens is updated every frame, the rest take turns.
+// Arguments:       The MO to check.
+//                  Its index in its list, to spread out which MOs get their turn.
+//                  The far update interval of this frame.
+//                  The centers of all the screens in use.
+// Return value:    Whether the MO should be updated this frame.
+
+    bool UpdateOnThisFrame(const MovableObject *movableObject, int index, int farUpdateInterval, const std::vector<Vector> &screenCenters) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CommitSettleQueue
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Draws queued settled particles into the terrain and deletes them, until
+//                  the settle time budget runs out. The terrain changes of ones that are
+//                  close together are registered as one.
+// Arguments:       Whether to draw the whole queue regardless of the time budget.
+// Return value:    None.
+
+    void CommitSettleQueue(bool commitAll = false);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ClearSettleQueue
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Deletes all queued settled particles without drawing them into the
+//                  terrain.
+// Arguments:       None.
+// Return value:    None.
+
+    void ClearSettleQueue();
+
+
     // Disallow the use of some implicit methods.
 	MovableMan(const MovableMan &reference) = delete;
 	MovableMan & operator=(const MovableMan &rhs) = delete;
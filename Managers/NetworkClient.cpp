@@ -37,7 +37,6 @@ namespace RTE {
 		m_SceneBackgroundBitmap = 0;
 		m_SceneForegroundBitmap = 0;
 		m_CurrentSceneLayerReceived = -1;
-		m_CurrentFrame = 0;
 		m_UseNATPunchThroughService = false;
 		m_ServerGUID = RakNet::UNASSIGNED_RAKNET_GUID;
 		m_NATServiceServerID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
@@ -45,9 +44,34 @@ namespace RTE {
 		m_IsNATPunched = false;
 		m_ActiveBackgroundLayers = 0;
 		m_SceneWrapsX = false;
-
-		for (int f = 0; f < c_FramesToRemember; f++) {
-			m_TargetPos[f].Reset();
+		m_UseScrollPrediction = true;
+		m_ReceivedFrameBitmap = 0;
+		m_ReceivedGUIBitmap = 0;
+		m_ReceivedPostEffects.clear();
+		m_ReceivedFrame = -1;
+		m_ReceivedTargetPos.Reset();
+		m_ReceivedFrameTime = 0;
+		m_LastDrawTime = 0;
+		m_ScrollVelocity.Reset();
+		m_ScrollCorrection.Reset();
+		m_DrawnScrollOffset.Reset();
+		m_ReceiveThread = nullptr;
+		m_ReceiveThreadRunning = false;
+		m_DecodeFrameIndex = 0;
+		m_ReadyFrameIndex = 1;
+		m_DrawFrameIndex = 2;
+		m_IsDecodingFrame = false;
+		m_PacketQueue.clear();
+
+		for (ReceivedFrame &receivedFrame : m_ReceivedFrames) {
+			receivedFrame.Bitmap = 0;
+			receivedFrame.GUIBitmap = 0;
+			receivedFrame.FrameNumber = 0;
+			receivedFrame.TargetPos.Reset();
+			for (Vector &layerOffset : receivedFrame.LayerOffsets) {
+				layerOffset.Reset();
+			}
+			receivedFrame.PostEffects.clear();
 		}
 		for (int i = 0; i < c_MaxLayersStoredForNetwork; i++) {
 			m_BackgroundBitmaps[i] = 0;
@@ -71,10 +95,121 @@ namespace RTE {
 		m_ClientID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
 		m_Client = RakNet::RakPeerInterface::GetInstance();
 		m_ClientInputFps = g_SettingsMan.GetClientInputFps();
+		m_UseScrollPrediction = g_SettingsMan.GetClientUseScrollPrediction();
 
 		return 0;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::Destroy() {
+		StopReceiveThread();
+
+		for (RakNet::Packet *packet : m_PacketQueue) {
+			m_Client->DeallocatePacket(packet);
+		}
+		for (const ReceivedFrame &receivedFrame : m_ReceivedFrames) {
+			if (receivedFrame.Bitmap) { destroy_bitmap(receivedFrame.Bitmap); }
+			if (receivedFrame.GUIBitmap) { destroy_bitmap(receivedFrame.GUIBitmap); }
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::BackgroundReceiveThreadFunction(NetworkClient *client) {
+		while (client->m_ReceiveThreadRunning) {
+			// Only sleep when RakNet had nothing, so a burst of frame data is decoded as fast as it comes in
+			if (!client->ReceivePackets()) { RakSleep(1); }
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::StartReceiveThread() {
+		if (m_ReceiveThread) {
+			return;
+		}
+		const BITMAP *frameBitmap = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
+		const BITMAP *guiBitmap = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+
+		for (ReceivedFrame &receivedFrame : m_ReceivedFrames) {
+			if (!receivedFrame.Bitmap || receivedFrame.Bitmap->w != frameBitmap->w || receivedFrame.Bitmap->h != frameBitmap->h) {
+				if (receivedFrame.Bitmap) { destroy_bitmap(receivedFrame.Bitmap); }
+				if (receivedFrame.GUIBitmap) { destroy_bitmap(receivedFrame.GUIBitmap); }
+				receivedFrame.Bitmap = create_bitmap_ex(8, frameBitmap->w, frameBitmap->h);
+				receivedFrame.GUIBitmap = create_bitmap_ex(8, guiBitmap->w, guiBitmap->h);
+			}
+			clear_to_color(receivedFrame.Bitmap, g_MaskColor);
+			clear_to_color(receivedFrame.GUIBitmap, g_MaskColor);
+			receivedFrame.PostEffects.clear();
+		}
+		m_DecodeFrameIndex = 0;
+		m_ReadyFrameIndex = 1;
+		m_DrawFrameIndex = 2;
+		m_IsDecodingFrame = false;
+		m_ReceivedFrame = -1;
+		m_ReceivedFrameBitmap = 0;
+		m_ReceivedGUIBitmap = 0;
+
+		m_ReceiveThreadRunning = true;
+		m_ReceiveThread = new std::thread(BackgroundReceiveThreadFunction, this);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::StopReceiveThread() {
+		if (!m_ReceiveThread) {
+			return;
+		}
+		m_ReceiveThreadRunning = false;
+		if (m_ReceiveThread->joinable()) { m_ReceiveThread->join(); }
+		delete m_ReceiveThread;
+		m_ReceiveThread = nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool NetworkClient::ReceivePackets() {
+		std::vector<RakNet::Packet *> packetsToQueue;
+		bool receivedPackets = false;
+
+		for (RakNet::Packet *packet = m_Client->Receive(); packet; packet = m_Client->Receive()) {
+			receivedPackets = true;
+
+			switch (GetPacketIdentifier(packet)) {
+				case ID_SRV_FRAME_SETUP:
+					ReceiveFrameSetupMsg(packet);
+					break;
+				case ID_SRV_FRAME_LINE:
+					ReceiveFrameLineMsg(packet);
+					break;
+				case ID_SRV_FRAME_BOX:
+					ReceiveFrameBoxMsg(packet);
+					break;
+				case ID_SRV_POST_EFFECTS:
+					ReceivePostEffectsMsg(packet);
+					break;
+				case ID_SRV_SCENE_SETUP:
+					// A finished frame of the previous scene that wasn't taken yet must not be drawn over the new scene, and the next frame starts from scratch
+					m_ReadyFrameIndex.fetch_and(~c_FreshFrameFlag);
+					m_IsDecodingFrame = false;
+					packetsToQueue.push_back(packet);
+					continue;
+				default:
+					packetsToQueue.push_back(packet);
+					continue;
+			}
+			m_Client->DeallocatePacket(packet);
+		}
+
+		if (!packetsToQueue.empty()) {
+			std::lock_guard<std::mutex> packetQueueLock(m_PacketQueueMutex);
+			m_PacketQueue.insert(m_PacketQueue.end(), packetsToQueue.begin(), packetsToQueue.end());
+		}
+		return receivedPackets;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::Connect(std::string serverName, unsigned short serverPort, std::string playerName) {
@@ -86,6 +221,7 @@ namespace RTE {
 		m_Client->SetOccasionalPing(true);
 		m_PlayerName = playerName;
 		RakNet::ConnectionAttemptResult connectionAttempt = m_Client->Connect(serverName.c_str(), serverPort, NULL, 0);
+		StartReceiveThread();
 
 		g_ConsoleMan.PrintString((connectionAttempt == RakNet::CONNECTION_ATTEMPT_STARTED) ? "CLIENT: Connect request sent" : "CLIENT: Unable to connect");
 	}
@@ -109,6 +245,7 @@ namespace RTE {
 
 		m_IsRegistered = false;
 		m_IsConnected = false;
+		m_ReceivedFrame = -1;
 		RakSleep(250);
 		RakNet::AddressOrGUID addr = m_Client->GetSystemAddressFromIndex(0);
 		m_Client->CloseConnection(addr, true);
@@ -119,6 +256,8 @@ namespace RTE {
 
 	void NetworkClient::PerformNATPunchThrough(std::string serviceServerName, unsigned short serviceServerPort, std::string playerName, std::string serverName, std::string serverPassword) {
 		m_UseNATPunchThroughService = true;
+		// Connecting to the NAT service polls RakNet right here, so nothing else may receive until it's done
+		StopReceiveThread();
 
 		g_ConsoleMan.PrintString("CLIENT: Connecting to NAT service" + serverName);
 
@@ -129,6 +268,7 @@ namespace RTE {
 		m_PlayerName = playerName;
 		g_ConsoleMan.PrintString("CLIENT: Connect request sent");
 		m_NATServiceServerID = ConnectBlocking(m_Client, serviceServerName.c_str(), serviceServerPort);
+		StartReceiveThread();
 
 		if (m_NATServiceServerID == RakNet::UNASSIGNED_SYSTEM_ADDRESS) {
 			g_ConsoleMan.PrintString("CLIENT: Unable to connect");
@@ -281,18 +421,29 @@ namespace RTE {
 			return;
 		}
 
-		DrawFrame();
+		if (m_IsDecodingFrame) {
+			// Hand the finished frame over and continue with whichever one the main thread isn't drawing
+			int finishedFrameIndex = m_DecodeFrameIndex;
+			m_DecodeFrameIndex = m_ReadyFrameIndex.exchange(finishedFrameIndex | c_FreshFrameFlag) & ~c_FreshFrameFlag;
 
-		m_PostEffects[m_CurrentFrame].clear();
-		m_CurrentFrame = frameData->FrameNumber;
+			// Whatever isn't sent again for this frame, like the other half of an interlaced frame, carries over from the finished one
+			const ReceivedFrame &finishedFrame = m_ReceivedFrames[finishedFrameIndex];
+			blit(finishedFrame.Bitmap, m_ReceivedFrames[m_DecodeFrameIndex].Bitmap, 0, 0, 0, 0, finishedFrame.Bitmap->w, finishedFrame.Bitmap->h);
+			blit(finishedFrame.GUIBitmap, m_ReceivedFrames[m_DecodeFrameIndex].GUIBitmap, 0, 0, 0, 0, finishedFrame.GUIBitmap->w, finishedFrame.GUIBitmap->h);
+		} else {
+			clear_to_color(m_ReceivedFrames[m_DecodeFrameIndex].Bitmap, g_MaskColor);
+			clear_to_color(m_ReceivedFrames[m_DecodeFrameIndex].GUIBitmap, g_MaskColor);
+		}
+		m_IsDecodingFrame = true;
 
-		m_TargetPos[m_CurrentFrame].m_X = frameData->TargetPosX;
-		m_TargetPos[m_CurrentFrame].m_Y = frameData->TargetPosY;
+		ReceivedFrame &decodeFrame = m_ReceivedFrames[m_DecodeFrameIndex];
+		decodeFrame.FrameNumber = frameData->FrameNumber;
+		decodeFrame.TargetPos.SetXY(frameData->TargetPosX, frameData->TargetPosY);
 
 		for (int i = 0; i < c_MaxLayersStoredForNetwork; i++) {
-			m_BackgroundLayers[m_CurrentFrame][i].OffsetX = frameData->OffsetX[i];
-			m_BackgroundLayers[m_CurrentFrame][i].OffsetY = frameData->OffsetY[i];
+			decodeFrame.LayerOffsets[i].SetXY(frameData->OffsetX[i], frameData->OffsetY[i]);
 		}
+		decodeFrame.PostEffects.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -300,14 +451,16 @@ namespace RTE {
 	void NetworkClient::ReceiveFrameLineMsg(RakNet::Packet *packet) {
 		const MsgFrameLine *frameData = (MsgFrameLine *)packet->data;
 		int lineNumber = frameData->LineNumber;
-		m_CurrentSceneLayerReceived = -1;
 
 		BITMAP *bmp = 0;
 
 		if (frameData->Layer == 0) {
-			bmp = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
+			bmp = m_ReceivedFrames[m_DecodeFrameIndex].Bitmap;
 		} else if (frameData->Layer == 1) {
-			bmp = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+			bmp = m_ReceivedFrames[m_DecodeFrameIndex].GUIBitmap;
+		}
+		if (!bmp) {
+			return;
 		}
 
 		acquire_bitmap(bmp);
@@ -343,14 +496,16 @@ namespace RTE {
 		const MsgFrameBox *frameData = (MsgFrameBox *)packet->data;
 		int bpx = frameData->BoxX;
 		int bpy = frameData->BoxY;
-		m_CurrentSceneLayerReceived = -1;
 
 		BITMAP *bmp = 0;
 
 		if (frameData->Layer == 0) {
-			bmp = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
+			bmp = m_ReceivedFrames[m_DecodeFrameIndex].Bitmap;
 		} else if (frameData->Layer == 1) {
-			bmp = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+			bmp = m_ReceivedFrames[m_DecodeFrameIndex].GUIBitmap;
+		}
+		if (!bmp) {
+			return;
 		}
 
 		acquire_bitmap(bmp);
@@ -368,19 +523,19 @@ namespace RTE {
 				//memset(bmp->line[lineNumber], g_MaskColor, bmp->w);
 				rectfill(bmp, bpx, bpy, bpx + maxWidth - 1, bpy + maxHeight - 1, g_MaskColor);
 			} else {
-				if (frameData->DataSize == frameData->UncompressedSize) {
-#ifdef _WIN32
-					memcpy_s(m_PixelLineBuffer, size, packet->data + sizeof(MsgFrameBox), size);
-#else
-					// Fallback to unsafe memcpy
-					memcpy(m_PixelLineBuffer, packet->data + sizeof(MsgFrameBox), size);
-#endif
-
-				} else {
-					LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameBox)), (char *)(m_PixelLineBuffer), size, frameData->UncompressedSize);
+				// Uncompressed boxes are copied straight out of the packet. Compressed ones have to be decompressed in one piece first because the rows of a box aren't next to each other in the bitmap
+				const unsigned char *lineAddr = packet->data + sizeof(MsgFrameBox);
+				if (frameData->DataSize != frameData->UncompressedSize) {
+					if (LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameBox)), (char *)(m_ReceivePixelBuffer), size, c_MaxPixelLineBufferSize) != maxWidth * maxHeight) {
+						release_bitmap(bmp);
+						return;
+					}
+					lineAddr = m_ReceivePixelBuffer;
+				} else if (size != maxWidth * maxHeight) {
+					release_bitmap(bmp);
+					return;
 				}
 				// Copy box to bitmap line by line
-				const unsigned char *lineAddr = m_PixelLineBuffer;
 				for (int y = 0; y < maxHeight; y++) {
 #ifdef _WIN32
 					memcpy_s(bmp->line[bpy + y] + bpx, maxWidth, lineAddr, maxWidth);
@@ -459,7 +614,6 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::ReceiveSceneSetupMsg(RakNet::Packet *packet) {
-		clear_to_color(g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0), g_MaskColor);
 		clear_to_color(g_FrameMan.GetNetworkBackBufferGUI8Ready(0), g_MaskColor);
 
 		const MsgSceneSetup *frameData = (MsgSceneSetup *)packet->data;
@@ -479,6 +633,12 @@ namespace RTE {
 		m_SceneWidth = frameData->Width;
 		m_SceneHeight = frameData->Height;
 
+		// Frames of the previous scene tell nothing about how the view scrolls in this one
+		m_ReceivedFrame = -1;
+		m_ScrollVelocity.Reset();
+		m_ScrollCorrection.Reset();
+		m_DrawnScrollOffset.Reset();
+
 		m_ActiveBackgroundLayers = frameData->BackgroundLayerCount;
 
 		for (int i = 0; i < m_ActiveBackgroundLayers; i++) {
@@ -572,16 +732,12 @@ namespace RTE {
 		MsgPostEffects *msg = (MsgPostEffects *)packet->data;
 		const PostEffectNetworkData *effDataPtr = (PostEffectNetworkData *)((char *)msg + sizeof(MsgPostEffects));
 
-		for (int i = 0; i < msg->PostEffectsCount; i++) {
-			BITMAP *bmp = 0;
-			std::string bitmapPath = ContentFile::GetPathFromHash(effDataPtr->BitmapHash);
-			if (!bitmapPath.empty()) {
-				ContentFile fl(bitmapPath.c_str());
-				bmp = fl.GetAsBitmap();
-			}
-			if (bmp) { m_PostEffects[msg->FrameNumber].push_back(PostEffect(Vector(effDataPtr->X, effDataPtr->Y), bmp, 0, effDataPtr->Strength, effDataPtr->Angle)); }
-			effDataPtr++;
+		// Post-effects are sent right after the setup of their frame, so ones for any other frame are late and of no use anymore
+		ReceivedFrame &decodeFrame = m_ReceivedFrames[m_DecodeFrameIndex];
+		if (!m_IsDecodingFrame || msg->FrameNumber != decodeFrame.FrameNumber) {
+			return;
 		}
+		decodeFrame.PostEffects.insert(decodeFrame.PostEffects.end(), effDataPtr, effDataPtr + msg->PostEffectsCount);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -683,15 +839,13 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkClient::DrawBackgrounds(BITMAP *targetBitmap) {
+	void NetworkClient::DrawBackgrounds(BITMAP *targetBitmap, int frame, const Vector &scrollOffset) {
 		for (int i = m_ActiveBackgroundLayers - 1; i >= 0; i--) {
 			if (m_BackgroundBitmaps[i] != 0) {
 				//masked_blit(m_BackgroundBitmaps[i], targetBitmap, 0, 0, 0, 0, m_BackgroundBitmaps[i]->w, m_BackgroundBitmaps[i]->h);
 				Vector scrollOverride(0, 0);
 				bool scrollOverridden = false;
 
-				int frame = m_CurrentFrame;
-
 				// Set up the target box to draw to on the target bitmap, if it is larger than the scene in either dimension
 				Box targetBox(Vector(0, 0), targetBitmap->w, targetBitmap->h);
 
@@ -721,8 +875,8 @@ namespace RTE {
 					offsetY = scrollOverride.GetFloorIntY();
 				} else {
 					// Regular scroll
-					offsetX = std::floor(m_BackgroundLayers[frame][i].OffsetX * m_BackgroundLayers[frame][i].ScrollRatioX);
-					offsetY = std::floor(m_BackgroundLayers[frame][i].OffsetY * m_BackgroundLayers[frame][i].ScrollRatioY);
+					offsetX = std::floor((m_BackgroundLayers[frame][i].OffsetX + scrollOffset.m_X) * m_BackgroundLayers[frame][i].ScrollRatioX);
+					offsetY = std::floor((m_BackgroundLayers[frame][i].OffsetY + scrollOffset.m_Y) * m_BackgroundLayers[frame][i].ScrollRatioY);
 			
 					// Only force bounds when doing regular scroll offset because the override is used to do terrain object application tricks and sometimes needs the offsets to be < 0
 					// ForceBounds(offsetX, offsetY);
@@ -866,28 +1020,140 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkClient::DrawPostEffects(int frame) { g_PostProcessMan.SetNetworkPostEffectsList(0, m_PostEffects[frame]); }
+	void NetworkClient::DrawPostEffects(const Vector &scrollOffset) {
+		std::list<PostEffect> postEffects;
+		for (const PostEffect &postEffect : m_ReceivedPostEffects) {
+			postEffects.push_back(PostEffect(postEffect.m_Pos - scrollOffset, postEffect.m_Bitmap, postEffect.m_BitmapHash, postEffect.m_Strength, postEffect.m_Angle));
+		}
+		g_PostProcessMan.SetNetworkPostEffectsList(0, postEffects);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::StoreReceivedFrame() {
+		const ReceivedFrame &receivedFrame = m_ReceivedFrames[m_DrawFrameIndex];
+
+		// Frames only come in once the scene is loaded
+		m_CurrentSceneLayerReceived = -1;
+
+		m_ReceivedFrameBitmap = receivedFrame.Bitmap;
+		m_ReceivedGUIBitmap = receivedFrame.GUIBitmap;
+
+		for (int i = 0; i < c_MaxLayersStoredForNetwork; i++) {
+			m_BackgroundLayers[receivedFrame.FrameNumber][i].OffsetX = receivedFrame.LayerOffsets[i].m_X;
+			m_BackgroundLayers[receivedFrame.FrameNumber][i].OffsetY = receivedFrame.LayerOffsets[i].m_Y;
+		}
+
+		m_ReceivedPostEffects.clear();
+		for (const PostEffectNetworkData &postEffectData : receivedFrame.PostEffects) {
+			std::string bitmapPath = ContentFile::GetPathFromHash(postEffectData.BitmapHash);
+			if (!bitmapPath.empty()) {
+				ContentFile fl(bitmapPath.c_str());
+				BITMAP *bmp = fl.GetAsBitmap();
+				if (bmp) { m_ReceivedPostEffects.push_back(PostEffect(Vector(postEffectData.X, postEffectData.Y), bmp, 0, postEffectData.Strength, postEffectData.Angle)); }
+			}
+		}
+
+		long long currentTicks = g_TimerMan.GetRealTickCount();
+		Vector previousView;
+		bool hadPreviousFrame = m_ReceivedFrame >= 0;
+
+		if (hadPreviousFrame) {
+			Vector scrolled = receivedFrame.TargetPos - m_ReceivedTargetPos;
+			// Crossing the seam of a wrapping scene isn't scrolling the whole scene width
+			if (m_SceneWrapsX && m_SceneWidth > 0) {
+				if (scrolled.m_X > static_cast<float>(m_SceneWidth / 2)) {
+					scrolled.m_X -= static_cast<float>(m_SceneWidth);
+				} else if (scrolled.m_X < -static_cast<float>(m_SceneWidth / 2)) {
+					scrolled.m_X += static_cast<float>(m_SceneWidth);
+				}
+			}
+			float intervalMS = static_cast<float>(static_cast<double>(currentTicks - m_ReceivedFrameTime) * 1000.0 / static_cast<double>(g_TimerMan.GetTicksPerSecond()));
+			if (intervalMS > 0 && intervalMS < static_cast<float>(c_MaxScrollVelocityIntervalMS)) {
+				// Frames don't arrive evenly enough to go by one interval alone
+				m_ScrollVelocity = (m_ScrollVelocity + scrolled * (1000.0F / intervalMS)) * 0.5F;
+			} else {
+				m_ScrollVelocity.Reset();
+			}
+			previousView = m_DrawnScrollOffset - scrolled;
+		}
+
+		m_ReceivedFrame = receivedFrame.FrameNumber;
+		m_ReceivedTargetPos = receivedFrame.TargetPos;
+		m_ReceivedFrameTime = currentTicks;
+		m_LastDrawTime = currentTicks;
+
+		// Start from where the view was drawn last and blend towards the prediction from the new frame
+		m_ScrollCorrection.Reset();
+		if (hadPreviousFrame && m_UseScrollPrediction) { m_ScrollCorrection = previousView - PredictScrollOffset(); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Vector NetworkClient::PredictScrollOffset() {
+		long long currentTicks = g_TimerMan.GetRealTickCount();
+		double ticksPerMS = static_cast<double>(g_TimerMan.GetTicksPerSecond()) / 1000.0;
+
+		float msSinceDraw = static_cast<float>(static_cast<double>(currentTicks - m_LastDrawTime) / ticksPerMS);
+		m_LastDrawTime = currentTicks;
+		if (msSinceDraw > 0) { m_ScrollCorrection *= std::pow(0.5F, msSinceDraw / c_ScrollCorrectionHalfLifeMS); }
+
+		bool isSteering = !g_UInputMan.GetMouseMovement(-1).IsZero();
+		for (int element : { INPUT_L_UP, INPUT_L_DOWN, INPUT_L_LEFT, INPUT_L_RIGHT, INPUT_R_UP, INPUT_R_DOWN, INPUT_R_LEFT, INPUT_R_RIGHT, INPUT_AIM_UP, INPUT_AIM_DOWN, INPUT_AIM_LEFT, INPUT_AIM_RIGHT, INPUT_JUMP }) {
+			if (isSteering) {
+				break;
+			}
+			isSteering = g_UInputMan.ElementHeld(0, element);
+		}
+
+		// Without input the view may well be slowing down on its own, so only lead by the round trip while it's being steered
+		float leadMS = std::min(static_cast<float>(static_cast<double>(currentTicks - m_ReceivedFrameTime) / ticksPerMS), static_cast<float>(c_MaxScrollVelocityIntervalMS));
+		if (isSteering) { leadMS += static_cast<float>(GetPing()); }
+
+		Vector scrollOffset = m_ScrollVelocity * (leadMS / 1000.0F) + m_ScrollCorrection;
+		scrollOffset.SetXY(std::clamp(scrollOffset.m_X, -static_cast<float>(c_MaxScrollPredictionPixels), static_cast<float>(c_MaxScrollPredictionPixels)), std::clamp(scrollOffset.m_Y, -static_cast<float>(c_MaxScrollPredictionPixels), static_cast<float>(c_MaxScrollPredictionPixels)));
+
+		// Don't scroll past the edges of the scene where the server wouldn't either
+		const Vector &targetPos = m_ReceivedTargetPos;
+		if (m_ReceivedFrameBitmap) {
+			if (!m_SceneWrapsX) {
+				scrollOffset.m_X = std::clamp(scrollOffset.m_X, std::min(targetPos.m_X, 0.0F) - targetPos.m_X, std::max(targetPos.m_X, static_cast<float>(m_SceneWidth - m_ReceivedFrameBitmap->w)) - targetPos.m_X);
+			}
+			scrollOffset.m_Y = std::clamp(scrollOffset.m_Y, std::min(targetPos.m_Y, 0.0F) - targetPos.m_Y, std::max(targetPos.m_Y, static_cast<float>(m_SceneHeight - m_ReceivedFrameBitmap->h)) - targetPos.m_Y);
+		}
+		return scrollOffset;
+	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::DrawFrame() {
-		BITMAP *src_bmp = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
+		if (m_ReceivedFrame < 0 || !m_ReceivedFrameBitmap) {
+			return;
+		}
+		BITMAP *src_bmp = m_ReceivedFrameBitmap;
 		BITMAP *dst_bmp = g_FrameMan.GetNetworkBackBuffer8Ready(0);
 
-		BITMAP *src_gui_bmp = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+		BITMAP *src_gui_bmp = m_ReceivedGUIBitmap;
 		BITMAP *dst_gui_bmp = g_FrameMan.GetNetworkBackBufferGUI8Ready(0);
 
+		Vector scrollOffset = m_UseScrollPrediction ? PredictScrollOffset() : Vector();
+		int shiftX = scrollOffset.GetRoundIntX();
+		int shiftY = scrollOffset.GetRoundIntY();
+		m_DrawnScrollOffset.SetXY(static_cast<float>(shiftX), static_cast<float>(shiftY));
+
 		// Have to clear to color to fallback if there's no skybox on client
 		clear_to_color(dst_bmp, g_BlackColor);
 		clear_to_color(dst_gui_bmp, g_MaskColor);
 
 		// Draw Scene background
-		int sourceX = m_TargetPos[m_CurrentFrame].m_X;
-		int sourceY = m_TargetPos[m_CurrentFrame].m_Y;
+		int sourceX = static_cast<int>(m_ReceivedTargetPos.m_X) + shiftX;
+		int sourceY = static_cast<int>(m_ReceivedTargetPos.m_Y) + shiftY;
 		int destX = 0;
 		int destY = 0;
 
-		DrawBackgrounds(dst_bmp);
+		if (m_SceneWrapsX && sourceX >= m_SceneBackgroundBitmap->w) { sourceX -= m_SceneBackgroundBitmap->w; }
+
+		DrawBackgrounds(dst_bmp, m_ReceivedFrame, m_DrawnScrollOffset);
 		masked_blit(m_SceneBackgroundBitmap, dst_bmp, sourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
 		
 		if (sourceX < 0) {
@@ -903,9 +1169,9 @@ namespace RTE {
 			masked_blit(m_SceneBackgroundBitmap, dst_bmp, 0, sourceY, newDestX, destY, width, src_bmp->h);
 		}
 
-		//draw_sprite(src_bmp, dst_bmp, 0, 0);
-		masked_blit(src_bmp, dst_bmp, 0, 0, 0, 0, src_bmp->w, src_bmp->h);
-		masked_blit(src_gui_bmp, dst_gui_bmp, 0, 0, 0, 0, src_bmp->w, src_bmp->h);
+		// The received frame layer was drawn at the frame's target position, so move it along with the view drawn here. The GUI layer stays put since most of it, like menus and the cursor, is anchored to the screen
+		masked_blit(src_bmp, dst_bmp, 0, 0, -shiftX, -shiftY, src_bmp->w, src_bmp->h);
+		masked_blit(src_gui_bmp, dst_gui_bmp, 0, 0, 0, 0, src_gui_bmp->w, src_gui_bmp->h);
 		masked_blit(m_SceneForegroundBitmap, dst_bmp, sourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
 
 		if (sourceX < 0) {
@@ -921,7 +1187,7 @@ namespace RTE {
 			masked_blit(m_SceneForegroundBitmap, dst_bmp, 0, sourceY, newDestX, destY, width, src_bmp->h);
 		}
 
-		DrawPostEffects(m_CurrentFrame);
+		DrawPostEffects(m_DrawnScrollOffset);
 
 		g_PerformanceMan.SetCurrentPing(GetPing());
 	}
@@ -929,7 +1195,12 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::Update() {
+		// Take the frame only after the queued packets so a scene setup that came in before it is handled first
 		HandleNetworkPackets();
+		if (TakeReceivedFrame() && !m_UseScrollPrediction) {
+			// Without prediction the view only changes when a frame completes, so there's no need to draw it every client frame
+			DrawFrame();
+		}
 
 		// Draw level loading animation
 		if (m_CurrentSceneLayerReceived != -1) {
@@ -970,6 +1241,9 @@ namespace RTE {
 			if (m_CurrentSceneLayerReceived == 1) { masked_stretch_blit(m_SceneBackgroundBitmap, dst_bmp, 0, 0, bmp->w, bmp->h, x, y, w, h); }
 
 			masked_stretch_blit(bmp, dst_bmp, 0, 0, bmp->w, bmp->h, x, y, w, h);
+		} else if (m_UseScrollPrediction) {
+			// Draw the view anew every client frame so it keeps scrolling between frames from the server
+			DrawFrame();
 		}
 
 		// Detect short mouse events like presses and releases. Holds are detected during input send
@@ -1001,10 +1275,14 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::HandleNetworkPackets() {
-		RakNet::Packet *packet;
+		std::deque<RakNet::Packet *> packets;
+		{
+			std::lock_guard<std::mutex> packetQueueLock(m_PacketQueueMutex);
+			packets.swap(m_PacketQueue);
+		}
 		std::string msg;
 
-		for (packet = m_Client->Receive(); packet; m_Client->DeallocatePacket(packet), packet = m_Client->Receive()) {
+		for (RakNet::Packet *packet : packets) {
 			// We got a packet, get the identifier with our handy function
 			unsigned char packetIdentifier = GetPacketIdentifier(packet);
 
@@ -1085,15 +1363,6 @@ namespace RTE {
 					msg += packet->systemAddress.ToString(true);
 					g_ConsoleMan.PrintString(msg);
 					break;
-				case ID_SRV_FRAME_SETUP:
-					ReceiveFrameSetupMsg(packet);
-					break;
-				case ID_SRV_FRAME_LINE:
-					ReceiveFrameLineMsg(packet);
-					break;
-				case ID_SRV_FRAME_BOX:
-					ReceiveFrameBoxMsg(packet);
-					break;
 				case ID_SRV_SCENE_SETUP:
 					ReceiveSceneSetupMsg(packet);
 					break;
@@ -1116,9 +1385,6 @@ namespace RTE {
 					m_IsConnected = false;
 					m_IsNATPunched = false;
 					break;
-				case ID_SRV_POST_EFFECTS:
-					ReceivePostEffectsMsg(packet);
-					break;
 				case ID_SRV_SOUND_EVENTS:
 					ReceiveSoundEventsMsg(packet);
 					break;
@@ -1153,6 +1419,23 @@ namespace RTE {
 				default:
 					break;
 			}
+			m_Client->DeallocatePacket(packet);
 		}
 	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool NetworkClient::TakeReceivedFrame() {
+		int readyFrameIndex = m_ReadyFrameIndex;
+		do {
+			if (!(readyFrameIndex & c_FreshFrameFlag)) {
+				return false;
+			}
+		} while (!m_ReadyFrameIndex.compare_exchange_weak(readyFrameIndex, m_DrawFrameIndex));
+
+		// The frame drawn until now went back to the receive thread with the swap, so the new one has to be stored before anything is drawn
+		m_DrawFrameIndex = readyFrameIndex & ~c_FreshFrameFlag;
+		StoreReceivedFrame();
+		return true;
+	}
 }
@@ -46,9 +46,9 @@ namespace RTE {
 		~NetworkClient() { Destroy(); }
 
 		/// <summary>
-		/// Destroys and resets (through Clear()) the NetworkClient object.
+		/// Destroys and resets (through Clear()) the NetworkClient object, stopping the receive thread.
 		/// </summary>
-		void Destroy() { Clear(); }
+		void Destroy();
 #pragma endregion
 
 #pragma region Getters
@@ -139,17 +139,12 @@ namespace RTE {
 
 		unsigned char m_PixelLineBuffer[c_MaxPixelLineBufferSize]; //!<
 
-		long int m_ReceivedData; //!<
-		long int m_CompressedData; //!<
+		long int m_ReceivedData; //!< Only touched by the receive thread.
+		long int m_CompressedData; //!< Only touched by the receive thread.
 
 		int m_ClientInputFps; //!< The rate (in FPS) the client input is sent to the server.
 		long long m_LastInputSentTime; //!< The last time input was sent in real time ticks.
 
-		int m_CurrentFrame; //!<
-
-		Vector m_TargetPos[c_FramesToRemember]; //!<
-		std::list<PostEffect> m_PostEffects[c_FramesToRemember]; //!< List of post-effects received from server.
-
 		std::unordered_map<unsigned short, SoundContainer *> m_ServerSounds; //!< Unordered map of SoundContainers received from server. OWNED!!!
 
 		unsigned char m_SceneID; //!< 
@@ -168,13 +163,86 @@ namespace RTE {
 		int m_MouseButtonPressedState[3]; //!<
 		int m_MouseButtonReleasedState[3]; //!<
 
+		/// <summary>
+		/// A frame being decoded by the receive thread, or one that's done and waiting to be drawn or being drawn.
+		/// </summary>
+		struct ReceivedFrame {
+			BITMAP *Bitmap; //!< The frame layer, the size of the client resolution.
+			BITMAP *GUIBitmap; //!< The GUI layer.
+			int FrameNumber; //!< The server's frame number, which post-effects are sent for.
+			Vector TargetPos; //!< Where in the scene the frame was drawn.
+			Vector LayerOffsets[c_MaxLayersStoredForNetwork]; //!< The background layer offsets of the frame.
+			std::vector<PostEffectNetworkData> PostEffects; //!< The post-effects of the frame as received. Their bitmaps are only looked up on the main thread.
+		};
+
+		static constexpr int c_FreshFrameFlag = 4; //!< Flag set next to the index in m_ReadyFrameIndex when the receive thread finished a frame the main thread didn't take yet.
+
+		std::thread *m_ReceiveThread; //!< The thread that receives all packets and decodes the frame messages among them.
+		std::atomic<bool> m_ReceiveThreadRunning; //!< Whether the receive thread should keep going.
+
+		std::array<ReceivedFrame, 3> m_ReceivedFrames; //!< The receive thread decodes into one of these while the main thread draws another, and the third holds the latest finished frame, so neither thread ever waits on the other.
+		int m_DecodeFrameIndex; //!< The index of the frame being decoded. Only touched by the receive thread.
+		std::atomic<int> m_ReadyFrameIndex; //!< The index of the latest finished frame, with c_FreshFrameFlag set if the main thread didn't take it yet. The threads swap their own index with this to hand frames over.
+		int m_DrawFrameIndex; //!< The index of the frame being drawn. Only touched by the main thread.
+		bool m_IsDecodingFrame; //!< Whether the receive thread started decoding a frame since the scene was set up. Only touched by the receive thread.
+		unsigned char m_ReceivePixelBuffer[c_MaxPixelLineBufferSize]; //!< Buffer the receive thread decompresses boxes into before copying them into the frame.
+
+		std::mutex m_PacketQueueMutex; //!< Mutex guarding the packet queue.
+		std::deque<RakNet::Packet *> m_PacketQueue; //!< Packets other than frame data, received by the receive thread and waiting to be handled on the main thread in the order they came in.
+
+		static constexpr int c_MaxScrollPredictionPixels = 96; //!< The furthest the view is drawn from where the last received frame was, however fast it scrolls.
+		static constexpr int c_MaxScrollVelocityIntervalMS = 250; //!< Frames further apart than this are too stale to tell the scroll velocity from.
+		static constexpr float c_ScrollCorrectionHalfLifeMS = 50.0F; //!< How long it takes to blend away half of the difference between the predicted view and a newly received frame.
+
+		bool m_UseScrollPrediction; //!< Whether to draw the view at where it's predicted to have scrolled since the last received frame, instead of where that frame was.
+		BITMAP *m_ReceivedFrameBitmap; //!< The frame layer of the last completed frame, kept by the main thread so the view can be drawn anew every client frame while the next one is still arriving.
+		BITMAP *m_ReceivedGUIBitmap; //!< The GUI layer of the last completed frame.
+		std::list<PostEffect> m_ReceivedPostEffects; //!< The post-effects of the last completed frame.
+		int m_ReceivedFrame; //!< The frame number of the last completed frame, whose background layer offsets the view is drawn with. -1 until a frame completes.
+		Vector m_ReceivedTargetPos; //!< The target position of the last completed frame.
+		long long m_ReceivedFrameTime; //!< When the last frame completed, in real time ticks.
+		long long m_LastDrawTime; //!< When the view was last drawn, in real time ticks.
+		Vector m_ScrollVelocity; //!< How fast the view scrolls, in pixels per second, going by the target positions of the last completed frames.
+		Vector m_ScrollCorrection; //!< Offset that makes up for where the view was predicted to be when a frame completed and gets blended away, so the view eases onto the frame instead of jumping.
+		Vector m_DrawnScrollOffset; //!< How far from the last completed frame's target position the view was last drawn.
+
 	private:
 
+#pragma region Thread Handling
+		/// <summary>
+		/// Receives packets until the receive thread is stopped, sleeping a little whenever there are none.
+		/// </summary>
+		/// <param name="client">The NetworkClient to receive packets for.</param>
+		static void BackgroundReceiveThreadFunction(NetworkClient *client);
+
+		/// <summary>
+		/// Creates the frame buffers if needed and starts the receive thread if it isn't running.
+		/// </summary>
+		void StartReceiveThread();
+
+		/// <summary>
+		/// Stops the receive thread and waits for it to finish, so RakNet can be polled from the main thread, like when connecting through a NAT service.
+		/// </summary>
+		void StopReceiveThread();
+
+		/// <summary>
+		/// Receives all packets RakNet has ready. Decodes frame setup, line and box messages right away and queues everything else for the main thread in one go.
+		/// </summary>
+		/// <returns>Whether there were any packets.</returns>
+		bool ReceivePackets();
+#pragma endregion
+
 #pragma region Update Breakdown
 		/// <summary>
-		/// 
+		/// Handles the packets the receive thread queued since the last call.
 		/// </summary>
 		void HandleNetworkPackets();
+
+		/// <summary>
+		/// Takes the latest frame the receive thread finished, if there's one the main thread didn't take yet.
+		/// </summary>
+		/// <returns>Whether a new frame was taken.</returns>
+		bool TakeReceivedFrame();
 #pragma endregion
 
 #pragma region Network Event Handling
@@ -220,21 +288,21 @@ namespace RTE {
 		void SendInputMsg();
 
 		/// <summary>
-		/// 
+		/// Hands the frame decoded so far over to the main thread and starts decoding the next one into the frame buffer not being drawn. Done on the receive thread.
 		/// </summary>
-		/// <param name="packet"></param>
+		/// <param name="packet">The packet to handle.</param>
 		void ReceiveFrameSetupMsg(RakNet::Packet *packet);
 
 		/// <summary>
-		/// 
+		/// Decodes a frame line straight into the row of the frame being decoded. Done on the receive thread.
 		/// </summary>
-		/// <param name="packet"></param>
+		/// <param name="packet">The packet to handle.</param>
 		void ReceiveFrameLineMsg(RakNet::Packet *packet);
 
 		/// <summary>
-		/// 
+		/// Decodes a frame box into the frame being decoded. Done on the receive thread.
 		/// </summary>
-		/// <param name="packet"></param>
+		/// <param name="packet">The packet to handle.</param>
 		void ReceiveFrameBoxMsg(RakNet::Packet *packet);
 
 		/// <summary>
@@ -271,7 +339,7 @@ namespace RTE {
 		void ReceiveTerrainChangeMsg(RakNet::Packet *packet);
 
 		/// <summary>
-		/// Receive and handle a packet of post-effect data. 
+		/// Receive and handle a packet of post-effect data, adding it to the frame being decoded. Done on the receive thread.
 		/// </summary>
 		/// <param name="packet">The packet to handle.</param>
 		void ReceivePostEffectsMsg(RakNet::Packet *packet);
@@ -294,16 +362,30 @@ namespace RTE {
 		/// 
 		/// </summary>
 		/// <param name="targetBitmap"></param>
-		void DrawBackgrounds(BITMAP *targetBitmap);
+		/// <param name="frame">The frame whose background layer offsets to draw at.</param>
+		/// <param name="scrollOffset">How far from those offsets to draw, to match a predicted view.</param>
+		void DrawBackgrounds(BITMAP *targetBitmap, int frame, const Vector &scrollOffset);
 
 		/// <summary>
-		/// 
+		/// Hands the post-effects of the last completed frame to the PostProcessMan, moved to match a predicted view.
 		/// </summary>
-		/// <param name="frame"></param>
-		void DrawPostEffects(int frame);
+		/// <param name="scrollOffset">How far from the last completed frame's target position the view is drawn.</param>
+		void DrawPostEffects(const Vector &scrollOffset);
 
 		/// <summary>
-		/// 
+		/// Makes the frame just taken from the receive thread the one drawn every client frame until the next one completes, and updates the scroll velocity from its target position.
+		/// </summary>
+		void StoreReceivedFrame();
+
+		/// <summary>
+		/// Predicts how far the view scrolled since the last completed frame. Extrapolates the scroll velocity over the time since the frame completed, and over the round trip as well while movement or aiming input is held, since that's how long until the server shows what the input does.
+		/// Adds the blended away remainder of the difference to where the view was drawn before the frame completed.
+		/// </summary>
+		/// <returns>How far from the last completed frame's target position to draw the view.</returns>
+		Vector PredictScrollOffset();
+
+		/// <summary>
+		/// Draws the last completed frame over the scene terrain and backgrounds, drawn locally at the predicted scroll position with the received frame layer moved to match.
 		/// </summary>
 		void DrawFrame();
 #pragma endregion
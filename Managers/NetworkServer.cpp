@@ -13,6 +13,7 @@
 #include "UInputMan.h"
 #include "TimerMan.h"
 #include "AudioMan.h"
+#include "PerformanceMan.h"
 
 #include "RakNetStatistics.h"
 #include "RakSleep.h"
@@ -38,10 +39,16 @@ namespace RTE {
 				server->ClearTerrainChangeQueue(player);
 				server->SendSceneData(player);
 			}
+			// Catch up a spectator relay that connected after this player got the scene, once the player itself is done with it
+			if (server->NeedToSendRelaySceneData(player) && server->IsSceneAvailable(player) && server->SendFrameData(player)) {
+				server->SendSceneSetupData(player, true);
+				server->SendSceneData(player, true);
+			}
 			if (server->SendFrameData(player)) {
 				int ret = server->SendFrame(player);
 				server->SetMSecsToSleep(player, ret / 1000);
 				if (ret > 0) { std::this_thread::sleep_for(std::chrono::microseconds(ret)); }
+				server->UpdateQualityLevel(player);
 			}
 			server->UpdateStats(player);
 		}
@@ -56,78 +63,44 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkServer::Clear() {
-		for (short i = 0; i < c_MaxClients; i++) {
-			m_BackBuffer8[i] = 0;
-			m_BackBufferGUI8[i] = 0;
-
-			m_LastFrameSentTime[i] = 0;
-			m_LastStatResetTime[i] = 0;
-
-			m_DelayedFrames[i] = 0;
-			m_MsecPerFrame[i] = 0;
-			m_MsecPerSendCall[i] = 0;
-
-			m_LZ4CompressionState[i] = 0;
-			m_LZ4FastCompressionState[i] = 0;
-
-			m_MouseState1[i] = 0;
-			m_MouseState2[i] = 0;
-			m_MouseState3[i] = 0;
-
-			m_MouseEvent1[i] = 0;
-			m_MouseEvent2[i] = 0;
-			m_MouseEvent3[i] = 0;
-
-			m_SendEven[i] = false;
-
-			m_ThreadExitReason[i] = 0;
-			m_MSecsToSleep[i] = 0;
-
-			// Set to send scene setup data by default
-			m_SendSceneSetupData[i] = false;
-			m_SendSceneData[i] = false;
-			m_SceneAvailable[i] = false;
-			m_SendFrameData[i] = false;
-
-			m_ResetActivityVotes[i] = false;
+	bool NetworkServer::AcquireEncodeSlot(short player) {
+		std::unique_lock<std::mutex> schedulerLock(m_EncodeSchedulerMutex);
+		m_EncodeQueue.push_back(player);
 
-			m_FrameNumbers[i] = 0;
+		m_EncodeSchedulerCondition.wait(schedulerLock, [this, player] {
+			return !IsServerModeEnabled() || !IsPlayerConnected(player) || (m_EncodeQueue.front() == player && m_EncodersRunning < m_MaxConcurrentEncoders);
+		});
 
-			m_Ping[i] = 0;
-			m_PingTimer[i].Reset();
-
-			ClearInputMessages(i);
+		if (m_EncodeQueue.front() != player || !IsServerModeEnabled() || !IsPlayerConnected(player)) {
+			m_EncodeQueue.erase(std::find(m_EncodeQueue.begin(), m_EncodeQueue.end(), player));
+			m_EncodeSchedulerCondition.notify_all();
+			return false;
 		}
+		m_EncodeQueue.pop_front();
+		m_EncodersRunning++;
 
-		for (short i = 0; i < MAX_STAT_RECORDS; i++) {
-			m_FramesSent[i] = 0;
-			m_FramesSkipped[i] = 0;
-
-			for (int j = 0; j < 2; j++) {
-				m_DataUncompressedCurrent[i][j] = 0;
-				m_DataSentCurrent[i][j] = 0;
-				m_FrameDataSentCurrent[i][j] = 0;
-				m_PostEffectDataSentCurrent[i][j] = 0;
-				m_SoundDataSentCurrent[i][j] = 0;
-				m_TerrainDataSentCurrent[i][j] = 0;
-				m_OtherDataSentCurrent[i][j] = 0;
-			}
+		// There may be more free slots than this one, let the next in line check
+		m_EncodeSchedulerCondition.notify_all();
+		return true;
+	}
 
-			m_FrameDataSentTotal[i] = 0;
-			m_PostEffectDataSentTotal[i] = 0;
-			m_TerrainDataSentTotal[i] = 0;
-			m_OtherDataSentTotal[i] = 0;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-			m_DataUncompressedTotal[i] = 0;
-			m_DataSentTotal[i] = 0;
+	void NetworkServer::ReleaseEncodeSlot() {
+		{
+			std::lock_guard<std::mutex> schedulerLock(m_EncodeSchedulerMutex);
+			m_EncodersRunning--;
+		}
+		m_EncodeSchedulerCondition.notify_all();
+	}
 
-			m_SendBufferBytes[i] = 0;
-			m_SendBufferMessages[i] = 0;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-			m_EmptyBlocks[i] = 0;
-			m_FullBlocks[i] = 0;
+	void NetworkServer::Clear() {
+		for (short i = 0; i < c_MaxClients; i++) {
+			m_ClientConnections[i].reset();
 		}
+		m_TotalStats = NetworkStats{};
 
 		m_UseHighCompression = true;
 		m_UseFastCompression = false;
@@ -135,15 +108,93 @@ namespace RTE {
 		m_FastAccelerationFactor = 1;
 		m_UseInterlacing = false;
 		m_EncodingFps = 30;
+		m_UseAdaptiveQuality = true;
 		m_ShowInput = false;
 		m_ShowStats = false;
 		m_TransmitAsBoxes = true;
 		m_BoxWidth = 32;
 		m_BoxHeight = 44;
 		m_NatServerConnected = false;
+		m_SceneAvailable = false;
+		m_EncodeQueue.clear();
+		m_EncodersRunning = 0;
+		m_MaxConcurrentEncoders = 1;
+		m_RelayId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+		m_RelayPlayer = -1;
+		m_SendRelaySceneData = false;
 		m_LastPackedReceived.Reset();
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	NetworkServer::ClientConnection::ClientConnection(const RakNet::SystemAddress &clientId, const RakNet::SystemAddress &internalId) : IsActive(false), ClientId(clientId), InternalId(internalId) {
+		ResX = 0;
+		ResY = 0;
+		SendThread = nullptr;
+
+		ThreadExitReason = 0;
+		MSecsSinceLastUpdate = 0;
+		MSecsToSleep = 0;
+
+		BackBuffer8 = nullptr;
+		BackBufferGUI8 = nullptr;
+
+		LZ4CompressionState = malloc(LZ4_sizeofStateHC());
+		LZ4FastCompressionState = malloc(LZ4_sizeofState());
+
+		MouseState1 = 0;
+		MouseState2 = 0;
+		MouseState3 = 0;
+
+		SendEven = false;
+
+		SendSceneSetupData = false;
+		SendSceneData = false;
+		SendFrameData = false;
+
+		ResetActivityVote = false;
+		FrameNumber = 0;
+
+		Ping = 0;
+		PingTimer.Reset();
+
+		DelayedFrames = 0;
+		MsecPerFrame = 0;
+		MsecPerSendCall = 0;
+
+		LastFrameSentTime = 0;
+		LastStatResetTime = 0;
+
+		Stats = NetworkStats{};
+
+		QualityLevel = 0;
+		EncodingFps = 30;
+		UseInterlacing = false;
+		BoxWidth = 32;
+		CompressionLevel = LZ4HC_CLEVEL_OPT_MIN;
+		CompressionLimitedByTime = false;
+		QueueDelay = 0;
+		EstimatedBandwidth = 0;
+		FramesSkippedAtQualityUpdate = 0;
+		ProbingQuality = false;
+		QualityProbeHoldMS = c_MinQualityProbeHoldMS;
+		QualityUpdateTimer.Reset();
+		QualityStepTimer.Reset();
+		QualityClearTimer.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	NetworkServer::ClientConnection::~ClientConnection() {
+		if (BackBuffer8) { destroy_bitmap(BackBuffer8); }
+		if (BackBufferGUI8) { destroy_bitmap(BackBufferGUI8); }
+
+		if (LZ4CompressionState) { free(LZ4CompressionState); }
+		if (LZ4FastCompressionState) { free(LZ4FastCompressionState); }
+
+		delete SendThread;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	int NetworkServer::Create() {
@@ -151,26 +202,20 @@ namespace RTE {
 		m_ServerPort = "";
 		m_Server = RakNet::RakPeerInterface::GetInstance();
 
-		for (int i = 0; i < c_MaxClients; i++) {
-			m_ClientConnections[i].InternalId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
-			m_ClientConnections[i].ClientId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
-			m_ClientConnections[i].IsActive = false;
-			m_ClientConnections[i].SendThread = 0;
-
-			m_LZ4CompressionState[i] = malloc(LZ4_sizeofStateHC());
-			m_LZ4FastCompressionState[i] = malloc(LZ4_sizeofState());
-		}
-
 		m_UseHighCompression = g_SettingsMan.GetServerUseHighCompression();
 		m_UseFastCompression = g_SettingsMan.GetServerUseFastCompression();
 		m_HighCompressionLevel = g_SettingsMan.GetServerHighCompressionLevel();
 		m_FastAccelerationFactor = g_SettingsMan.GetServerFastAccelerationFactor();
 		m_UseInterlacing = g_SettingsMan.GetServerUseInterlacing();
 		m_EncodingFps = g_SettingsMan.GetServerEncodingFps();
+		m_UseAdaptiveQuality = g_SettingsMan.GetServerUseAdaptiveQuality();
 		m_TransmitAsBoxes = g_SettingsMan.GetServerTransmitAsBoxes();
 		m_BoxWidth = g_SettingsMan.GetServerBoxWidth();
 		m_BoxHeight = g_SettingsMan.GetServerBoxHeight();
 
+		// Keep a core free for the simulation thread. hardware_concurrency may return 0 if it can't tell, in which case only one client encodes at a time.
+		m_MaxConcurrentEncoders = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+
 		return 0;
 	}
 
@@ -178,22 +223,19 @@ namespace RTE {
 
 	void NetworkServer::Destroy() {
 		//Send a signal that server is going to shutdown
-		m_IsInServerMode = false;
-		// Wait for thread to shut down
-		RakSleep(250);
+		{
+			std::lock_guard<std::mutex> schedulerLock(m_EncodeSchedulerMutex);
+			m_IsInServerMode = false;
+		}
+		m_EncodeSchedulerCondition.notify_all();
+
+		for (short player = 0; player < c_MaxClients; player++) {
+			DestroyClientConnection(player);
+		}
 		m_Server->Shutdown(300);
 		// We're done with the network
 		RakNet::RakPeerInterface::DestroyInstance(m_Server);
 
-		for (short i = 0; i < c_MaxClients; i++) {
-			DestroyBackBuffer(i);
-
-			if (m_LZ4CompressionState[i]) { free(m_LZ4CompressionState[i]); }		
-			m_LZ4CompressionState[i] = 0;
-
-			if (m_LZ4FastCompressionState[i]) { free(m_LZ4FastCompressionState[i]); }		
-			m_LZ4FastCompressionState[i] = 0;
-		}
 		Clear();
 	}
 
@@ -218,13 +260,14 @@ namespace RTE {
 		socketDescriptors[0].port = atoi(m_ServerPort.c_str());
 		socketDescriptors[0].socketFamily = AF_INET; // Test out IPV4
 
-		bool ok = m_Server->Startup(4, socketDescriptors, 1) == RakNet::RAKNET_STARTED;
+		// Leave room for a spectator relay on top of the players
+		bool ok = m_Server->Startup(c_MaxClients + 1, socketDescriptors, 1) == RakNet::RAKNET_STARTED;
 
 		if (!ok) {
 			g_ConsoleMan.PrintString("SERVER: Failed to start. Terminating!");
 			exit(1);
 		} else {
-			m_Server->SetMaximumIncomingConnections(4);
+			m_Server->SetMaximumIncomingConnections(c_MaxClients + 1);
 			g_ConsoleMan.PrintString("SERVER: STARTED!");
 		}
 
@@ -261,12 +304,10 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::LockScene(bool isLocked) {
-		for (int i = 0; i < c_MaxClients; i++) {
-			if (isLocked) {
-				m_SceneLock[i].lock();
-			} else {
-				m_SceneLock[i].unlock();
-			}
+		if (isLocked) {
+			m_SceneLock.lock();
+		} else {
+			m_SceneLock.unlock();
 		}
 	}
 
@@ -274,11 +315,13 @@ namespace RTE {
 
 	void NetworkServer::ResetScene() {
 		m_SceneID++;
-		for (int i = 0; i < c_MaxClients; i++) {
-			m_SendSceneSetupData[i] = true;
-			m_SceneAvailable[i] = true;
-			m_SendSceneData[i] = false;
-			m_SendFrameData[i] = false;
+		m_SceneAvailable = true;
+		for (const std::unique_ptr<ClientConnection> &connection : m_ClientConnections) {
+			if (connection) {
+				connection->SendSceneSetupData = true;
+				connection->SendSceneData = false;
+				connection->SendFrameData = false;
+			}
 		}
 	}
 
@@ -288,9 +331,10 @@ namespace RTE {
 		if (m_IsInServerMode) {
 			for (short player = 0; player < c_MaxClients; player++) {
 				if (IsPlayerConnected(player)) {
-					m_Mutex[player].lock();
-					m_PendingTerrainChanges[player].push(terrainChange);
-					m_Mutex[player].unlock();
+					ClientConnection &connection = *m_ClientConnections[player];
+					connection.Mutex.lock();
+					connection.PendingTerrainChanges.push(terrainChange);
+					connection.Mutex.unlock();
 				}
 			}
 		}
@@ -339,11 +383,8 @@ namespace RTE {
 
 		// Store client connection data
 		for (int index = 0; index < c_MaxClients; index++) {
-			g_ConsoleMan.PrintString(m_ClientConnections[index].ClientId.ToString());
-
-			if (m_ClientConnections[index].ClientId == RakNet::UNASSIGNED_SYSTEM_ADDRESS) {
-				m_ClientConnections[index].ClientId = clientID;
-				m_ClientConnections[index].InternalId = internalId;
+			if (!m_ClientConnections[index]) {
+				m_ClientConnections[index] = std::make_unique<ClientConnection>(clientID, internalId);
 
 				connected = true;
 
@@ -359,9 +400,10 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendAcceptedMsg(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		MsgAccepted msg;
 		msg.Id = ID_SRV_ACCEPTED;
-		m_Server->Send((const char *)&msg, sizeof(MsgAccepted), HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+		m_Server->Send((const char *)&msg, sizeof(MsgAccepted), HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, connection.ClientId, false);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -371,20 +413,38 @@ namespace RTE {
 		msg += packet->systemAddress.ToString(true);
 		g_ConsoleMan.PrintString(msg);
 
-		for (int index = 0; index < c_MaxClients; index++) {
-			if (m_ClientConnections[index].ClientId == packet->systemAddress) {
-				m_ClientConnections[index].IsActive = false;
-				m_ClientConnections[index].ClientId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
-				m_ClientConnections[index].InternalId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+		{
+			std::lock_guard<std::mutex> relayLock(m_RelayMutex);
+			if (m_RelayPlayer >= 0 && m_RelayId == packet->systemAddress) {
+				m_RelayPlayer = -1;
+				m_RelayId = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+				m_SendRelaySceneData = false;
+				g_ConsoleMan.PrintString("SERVER: Spectator relay disconnected");
+			}
+		}
 
-				//delete m_ClientConnections[index].SendThread;
-				m_ClientConnections[index].SendThread = 0;
+		for (short index = 0; index < c_MaxClients; index++) {
+			if (m_ClientConnections[index] && m_ClientConnections[index]->ClientId == packet->systemAddress) { DestroyClientConnection(index); }
+		}
+	}
 
-				m_SendSceneSetupData[index] = true;
-				m_SendSceneData[index] = false;
-				m_SendFrameData[index] = false;
-			}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::DestroyClientConnection(short player) {
+		if (!m_ClientConnections[player]) {
+			return;
+		}
+		ClientConnection &connection = *m_ClientConnections[player];
+
+		// Stop the send thread, waking it up if it's waiting for an encode slot, and wait for it to let go of the connection
+		{
+			std::lock_guard<std::mutex> schedulerLock(m_EncodeSchedulerMutex);
+			connection.IsActive = false;
 		}
+		m_EncodeSchedulerCondition.notify_all();
+		if (connection.SendThread && connection.SendThread->joinable()) { connection.SendThread->join(); }
+
+		m_ClientConnections[player].reset();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -392,7 +452,6 @@ namespace RTE {
 	void NetworkServer::ReceiveRegisterMsg(RakNet::Packet *packet) {
 		std::string msg;
 		const MsgRegister *msgReg = (MsgRegister *)packet->data;
-		char buf[32];
 
 		msg = "SERVER: CLIENT REGISTRATION: RES ";
 		msg += std::to_string(msgReg->ResolutionX);
@@ -401,25 +460,75 @@ namespace RTE {
 		g_ConsoleMan.PrintString(msg);
 
 		for (short index = 0; index < c_MaxClients; index++) {
-			if (m_ClientConnections[index].ClientId == packet->systemAddress) {
-				m_ClientConnections[index].ResX = msgReg->ResolutionX;
-				m_ClientConnections[index].ResY = msgReg->ResolutionY;
-				m_ClientConnections[index].IsActive = true;
-				m_ClientConnections[index].PlayerName = msgReg->Name;
+			if (m_ClientConnections[index] && m_ClientConnections[index]->ClientId == packet->systemAddress && !m_ClientConnections[index]->IsActive) {
+				ClientConnection &connection = *m_ClientConnections[index];
+				connection.ResX = msgReg->ResolutionX;
+				connection.ResY = msgReg->ResolutionY;
+				connection.PlayerName = msgReg->Name;
+				ApplyQualityLevel(index, 0);
 				g_FrameMan.CreateNewNetworkPlayerBackBuffer(index, msgReg->ResolutionX, msgReg->ResolutionY);
 
-				m_Server->SetTimeoutTime(5000, m_ClientConnections[index].ClientId);
+				m_Server->SetTimeoutTime(5000, connection.ClientId);
 
-				m_ClientConnections[index].SendThread = new std::thread(BackgroundSendThreadFunction, this, index);
-				SendAcceptedMsg(index);
+				connection.SendSceneSetupData = true;
+				connection.SendSceneData = false;
+				connection.SendFrameData = false;
+				connection.IsActive = true;
 
-				m_SendSceneSetupData[index] = true;
-				m_SendSceneData[index] = false;
-				m_SendFrameData[index] = false;
+				connection.SendThread = new std::thread(BackgroundSendThreadFunction, this, index);
+				SendAcceptedMsg(index);
 			}
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::ReceiveRelayRegisterMsg(RakNet::Packet *packet) {
+		if (packet->length < sizeof(MsgRegisterRelay)) {
+			g_ConsoleMan.PrintString("SERVER: Malformed spectator relay registration from " + std::string(packet->systemAddress.ToString(true)) + ". Ignored.");
+			return;
+		}
+		const MsgRegisterRelay *msgReg = (MsgRegisterRelay *)packet->data;
+		const std::string &relayPassword = g_SettingsMan.GetSpectatorRelayPassword();
+		if (relayPassword.empty() || relayPassword != std::string(msgReg->Password, strnlen(msgReg->Password, sizeof(msgReg->Password)))) {
+			g_ConsoleMan.PrintString("SERVER: Spectator relay from " + std::string(packet->systemAddress.ToString(true)) + " refused, " + (relayPassword.empty() ? "relays are disabled." : "wrong password."));
+			m_Server->CloseConnection(packet->systemAddress, true);
+			return;
+		}
+		if (msgReg->Player >= c_MaxClients) {
+			g_ConsoleMan.PrintString("SERVER: Spectator relay asked for an invalid player. Ignored.");
+			return;
+		}
+
+		// The relay was given a player slot when it connected like everyone else, give it back so a player can take it
+		for (short index = 0; index < c_MaxClients; index++) {
+			if (m_ClientConnections[index] && m_ClientConnections[index]->ClientId == packet->systemAddress && !m_ClientConnections[index]->IsActive) { m_ClientConnections[index].reset(); }
+		}
+
+		{
+			std::lock_guard<std::mutex> relayLock(m_RelayMutex);
+			m_RelayId = packet->systemAddress;
+			m_RelayPlayer = msgReg->Player;
+			m_SendRelaySceneData = true;
+		}
+
+		m_Server->SetTimeoutTime(5000, packet->systemAddress);
+		g_ConsoleMan.PrintString("SERVER: Spectator relay connected from " + std::string(packet->systemAddress.ToString(true)) + ", watching player " + std::to_string(msgReg->Player));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::SendPlayerPacket(short player, const char *data, int size, PacketPriority priority, PacketReliability reliability, bool relayOnly) {
+		ClientConnection &connection = *m_ClientConnections[player];
+		if (!relayOnly) { m_Server->Send(data, size, priority, reliability, 0, connection.ClientId, false); }
+
+		RakNet::SystemAddress relayAddress = GetRelayAddress(player);
+		if (relayAddress != RakNet::UNASSIGNED_SYSTEM_ADDRESS) {
+			PacketReliability relayReliability = (reliability == RELIABLE || reliability == RELIABLE_SEQUENCED) ? RELIABLE_ORDERED : reliability;
+			m_Server->Send(data, size, priority, relayReliability, 0, relayAddress, false);
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendNATServerRegistrationMsg(RakNet::SystemAddress address) {
@@ -444,10 +553,12 @@ namespace RTE {
 		int player = -1;
 
 		for (int index = 0; index < c_MaxClients; index++) {
-			if (m_ClientConnections[index].ClientId == packet->systemAddress) { player = index; }
+			if (m_ClientConnections[index] && m_ClientConnections[index]->ClientId == packet->systemAddress) { player = index; }
 		}
 
 		if (player >= 0 && player < c_MaxClients) {
+			ClientConnection &connection = *m_ClientConnections[player];
+
 			// Copy message data
 			MsgInput msg;
 
@@ -470,8 +581,8 @@ namespace RTE {
 
 			bool skip = true;
 
-			if (!m_InputMessages[player].empty()) {
-				MsgInput lastmsg = m_InputMessages[player].back();
+			if (!connection.InputMessages.empty()) {
+				MsgInput lastmsg = connection.InputMessages.back();
 
 				if (msg.MouseX != lastmsg.MouseX) { skip = false; }
 				if (msg.MouseY != lastmsg.MouseY) { skip = false; }
@@ -492,14 +603,16 @@ namespace RTE {
 				skip = false;
 			}
 
-			if (!skip) { m_InputMessages[player].push(msg); }
+			if (!skip) { connection.InputMessages.push(msg); }
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::ProcessInputMsg(short player, MsgInput msg) {
-		if (player >= 0 && player < c_MaxClients) {
+		if (player >= 0 && player < c_MaxClients && m_ClientConnections[player]) {
+			ClientConnection &connection = *m_ClientConnections[player];
+
 			Vector input;
 			input.m_X = msg.MouseX;
 			input.m_Y = msg.MouseY;
@@ -509,7 +622,7 @@ namespace RTE {
 			g_UInputMan.SetNetworkMouseButtonPressedState(player, MOUSE_LEFT, msg.MouseButtonPressed[MOUSE_LEFT]);
 			g_UInputMan.SetNetworkMouseButtonReleasedState(player, MOUSE_LEFT, msg.MouseButtonReleased[MOUSE_LEFT]);
 
-			m_MouseState1[player] = (msg.MouseButtonPressed[MOUSE_LEFT] || msg.MouseButtonHeld[MOUSE_LEFT]) ? 1 : 0;
+			connection.MouseState1 = (msg.MouseButtonPressed[MOUSE_LEFT] || msg.MouseButtonHeld[MOUSE_LEFT]) ? 1 : 0;
 
 			g_UInputMan.SetNetworkMouseButtonHeldState(player, MOUSE_RIGHT, msg.MouseButtonHeld[MOUSE_RIGHT]);
 			g_UInputMan.SetNetworkMouseButtonPressedState(player, MOUSE_RIGHT, msg.MouseButtonPressed[MOUSE_RIGHT]);
@@ -519,7 +632,7 @@ namespace RTE {
 			g_UInputMan.SetNetworkMouseButtonPressedState(player, MOUSE_MIDDLE, msg.MouseButtonPressed[MOUSE_MIDDLE]);
 			g_UInputMan.SetNetworkMouseButtonReleasedState(player, MOUSE_MIDDLE, msg.MouseButtonReleased[MOUSE_MIDDLE]);
 
-			GUIInput::SetNetworkMouseButton(player, m_MouseState1[player], m_MouseState2[player], m_MouseState3[player]);
+			GUIInput::SetNetworkMouseButton(player, connection.MouseState1, connection.MouseState2, connection.MouseState3);
 
 			g_UInputMan.SetNetworkMouseWheelState(player, msg.MouseWheelMoved);
 
@@ -536,7 +649,7 @@ namespace RTE {
 				bitMask <<= 1;
 			}
 
-			m_ResetActivityVotes[player] = msg.ResetActivityVote;
+			connection.ResetActivityVote = msg.ResetActivityVote;
 
 			// We need to replace mouse input obtained from the allegro with mouse input obtained from network clients
 			GUIInput::SetNetworkMouseMovement(player, msg.MouseX, msg.MouseY);
@@ -545,19 +658,10 @@ namespace RTE {
 		}
 	}
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	void NetworkServer::ClearInputMessages(short player) {
-		if (player >= 0 && player < c_MaxClients) {
-			while (!m_InputMessages[player].empty()) {
-				m_InputMessages[player].pop();
-			}
-		}
-	}
-
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendSoundData(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		std::list<AudioMan::NetworkSoundData> events;
 		g_AudioMan.GetSoundEvents(player, events);
 
@@ -565,11 +669,11 @@ namespace RTE {
 			return;
 		}
 
-		MsgSoundEvents *msg = (MsgSoundEvents *)m_PixelLineBuffer[player];
+		MsgSoundEvents *msg = (MsgSoundEvents *)connection.PixelLineBuffer;
 		AudioMan::NetworkSoundData *sndDataPtr = (AudioMan::NetworkSoundData *)((char *)msg + sizeof(MsgSoundEvents));
 
 		msg->Id = ID_SRV_SOUND_EVENTS;
-		msg->FrameNumber = m_FrameNumbers[player];
+		msg->FrameNumber = connection.FrameNumber;
 		msg->SoundEventsCount = 0;
 
 		for (const AudioMan::NetworkSoundData &soundEvent : events) {
@@ -591,14 +695,14 @@ namespace RTE {
 			//If one more sound would overflow the container, send sounds now then reset to continue
 			if ((msg->SoundEventsCount * sizeof(AudioMan::NetworkSoundData)) >= (c_MaxPixelLineBufferSize - sizeof(AudioMan::NetworkSoundData) - sizeof(MsgSoundEvents))) {
 				int payloadSize = sizeof(MsgSoundEvents) + sizeof(AudioMan::NetworkSoundData) * msg->SoundEventsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->SoundEventsCount = 0;
 				sndDataPtr = (AudioMan::NetworkSoundData *)((char *)msg + sizeof(MsgSoundEvents));
 
-				m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-				m_SoundDataSentTotal[player] += payloadSize;
+				connection.Stats.SoundDataSentCurrent[STAT_CURRENT] += payloadSize;
+				connection.Stats.SoundDataSentTotal += payloadSize;
 
-				m_DataSentTotal[player] += payloadSize;
+				connection.Stats.DataSentTotal += payloadSize;
 			}
 		}
 
@@ -609,18 +713,19 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgSoundEvents) + sizeof(AudioMan::NetworkSoundData) * msg->SoundEventsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
-			m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_SoundDataSentTotal[player] += payloadSize;
+			connection.Stats.SoundDataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.SoundDataSentTotal += payloadSize;
 
-			m_DataSentTotal[player] += payloadSize;
+			connection.Stats.DataSentTotal += payloadSize;
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendMusicData(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		std::list<AudioMan::NetworkMusicData> events;
 		g_AudioMan.GetMusicEvents(player, events);
 
@@ -628,11 +733,11 @@ namespace RTE {
 			return;
 		}
 
-		MsgMusicEvents *msg = (MsgMusicEvents *)m_PixelLineBuffer[player];
+		MsgMusicEvents *msg = (MsgMusicEvents *)connection.PixelLineBuffer;
 		AudioMan::NetworkMusicData *musDataPtr = (AudioMan::NetworkMusicData *)((char *)msg + sizeof(MsgMusicEvents));
 
 		msg->Id = ID_SRV_MUSIC_EVENTS;
-		msg->FrameNumber = m_FrameNumbers[player];
+		msg->FrameNumber = connection.FrameNumber;
 		msg->MusicEventsCount = 0;
 
 		for (const AudioMan::NetworkMusicData &musicEvent : events) {
@@ -647,14 +752,14 @@ namespace RTE {
 
 			if (msg->MusicEventsCount >= 4) {
 				int payloadSize = sizeof(MsgMusicEvents) + sizeof(AudioMan::NetworkMusicData) * msg->MusicEventsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->MusicEventsCount = 0;
 				musDataPtr = (AudioMan::NetworkMusicData *)((char *)msg + sizeof(MsgMusicEvents));
 
-				m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-				m_SoundDataSentTotal[player] += payloadSize;
+				connection.Stats.SoundDataSentCurrent[STAT_CURRENT] += payloadSize;
+				connection.Stats.SoundDataSentTotal += payloadSize;
 
-				m_DataSentTotal[player] += payloadSize;
+				connection.Stats.DataSentTotal += payloadSize;
 
 			}
 		}
@@ -666,18 +771,19 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgMusicEvents) + sizeof(AudioMan::NetworkMusicData) * msg->MusicEventsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
-			m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_SoundDataSentTotal[player] += payloadSize;
+			connection.Stats.SoundDataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.SoundDataSentTotal += payloadSize;
 
-			m_DataSentTotal[player] += payloadSize;
+			connection.Stats.DataSentTotal += payloadSize;
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkServer::SendSceneSetupData(short player) {
+	void NetworkServer::SendSceneSetupData(short player, bool relayOnly) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		MsgSceneSetup msgSceneSetup;
 		msgSceneSetup.Id = ID_SRV_SCENE_SETUP;
 		msgSceneSetup.SceneId = m_SceneID;
@@ -726,18 +832,21 @@ namespace RTE {
 
 		int payloadSize = sizeof(MsgSceneSetup);
 
-		m_Server->Send((const char *)&msgSceneSetup, payloadSize, HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+		SendPlayerPacket(player, (const char *)&msgSceneSetup, payloadSize, HIGH_PRIORITY, RELIABLE_SEQUENCED, relayOnly);
 
-		m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-		m_DataSentTotal[player] += payloadSize;
+		connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.DataSentTotal += payloadSize;
 
-		m_OtherDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-		m_OtherDataSentTotal[player] += payloadSize;
+		connection.Stats.OtherDataSentCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.OtherDataSentTotal += payloadSize;
 
-		m_DataUncompressedCurrent[player][STAT_CURRENT] += payloadSize;
-		m_DataUncompressedTotal[player] += payloadSize;
+		connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.DataUncompressedTotal += payloadSize;
 
-		m_SendSceneSetupData[player] = false;
+		if (relayOnly) {
+			return;
+		}
+		connection.SendSceneSetupData = false;
 
 		// While we're on the same thread with freshly connected player, send current music being played
 		if (g_AudioMan.IsMusicPlaying()) {
@@ -749,26 +858,24 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::ReceiveSceneSetupDataAccepted(RakNet::Packet *packet) {
-		short player = -1;
-
 		for (short index = 0; index < c_MaxClients; index++) {
-			if (m_ClientConnections[index].ClientId == packet->systemAddress) { player = index; }
-		}
-
-		if (player > -1) {
-			m_SendSceneSetupData[player] = false;
-			m_SendSceneData[player] = true;
-			m_SendFrameData[player] = false;
+			if (m_ClientConnections[index] && m_ClientConnections[index]->ClientId == packet->systemAddress) {
+				ClientConnection &connection = *m_ClientConnections[index];
+				connection.SendSceneSetupData = false;
+				connection.SendSceneData = true;
+				connection.SendFrameData = false;
+			}
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkServer::SendSceneData(short player) {
+	void NetworkServer::SendSceneData(short player, bool relayOnly) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		// Check for congestion
 		RakNet::RakNetStatistics rns;
 
-		MsgSceneLine *sceneData = (MsgSceneLine *)m_PixelLineBuffer[player];
+		MsgSceneLine *sceneData = (MsgSceneLine *)connection.PixelLineBuffer;
 
 		// Save message ID
 		sceneData->Id = ID_SRV_SCENE;
@@ -790,7 +897,7 @@ namespace RTE {
 		}
 
 		// Lock the scene until current bitmap is fully transfered
-		m_SceneLock[player].lock();
+		m_SceneLock.lock_shared();
 
 		for (int layer = 0; layer < 2; layer++) {
 			BITMAP *bmp = 0;
@@ -819,14 +926,14 @@ namespace RTE {
 					int result = 0;
 					//bool lineIsEmpty = false;
 
-					result = LZ4_compress_HC_extStateHC(m_LZ4CompressionState[player], (char *)bmp->line[lineY] + lineX, (char *)(m_PixelLineBuffer[player] + sizeof(MsgSceneLine)), width, width, LZ4HC_CLEVEL_MAX);
+					result = LZ4_compress_HC_extStateHC(connection.LZ4CompressionState, (char *)bmp->line[lineY] + lineX, (char *)(connection.PixelLineBuffer + sizeof(MsgSceneLine)), width, width, LZ4HC_CLEVEL_MAX);
 
 					// Compression failed or ineffective, send as is
 					if (result == 0 || result == width) {
 #ifdef _WIN32
-						memcpy_s(m_PixelLineBuffer[player] + sizeof(MsgSceneLine), c_MaxPixelLineBufferSize, bmp->line[lineY] + lineX, width);
+						memcpy_s(connection.PixelLineBuffer + sizeof(MsgSceneLine), c_MaxPixelLineBufferSize, bmp->line[lineY] + lineX, width);
 #else
-						memcpy(m_PixelLineBuffer[player] + sizeof(MsgSceneLine), bmp->line[lineY] + lineX, width);
+						memcpy(connection.PixelLineBuffer + sizeof(MsgSceneLine), bmp->line[lineY] + lineX, width);
 #endif
 					} else {
 						sceneData->DataSize = result;
@@ -834,24 +941,26 @@ namespace RTE {
 
 					int payloadSize = sceneData->DataSize + sizeof(MsgSceneLine);
 
-					m_Server->Send((const char *)sceneData, payloadSize, HIGH_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+					SendPlayerPacket(player, (const char *)sceneData, payloadSize, HIGH_PRIORITY, RELIABLE, relayOnly);
 
-					m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-					m_DataSentTotal[player] += payloadSize;
+					connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+					connection.Stats.DataSentTotal += payloadSize;
 
-					m_TerrainDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-					m_TerrainDataSentTotal[player] += payloadSize;
+					connection.Stats.TerrainDataSentCurrent[STAT_CURRENT] += payloadSize;
+					connection.Stats.TerrainDataSentTotal += payloadSize;
 
-					m_DataUncompressedCurrent[player][STAT_CURRENT] += sceneData->UncompressedSize;
-					m_DataUncompressedTotal[player] += sceneData->UncompressedSize;
+					connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += sceneData->UncompressedSize;
+					connection.Stats.DataUncompressedTotal += sceneData->UncompressedSize;
 
 					// Wait for the  messages to leave to avoid congestion
 					if (lineY % 250 == 0) {
 						do {
-							m_Server->GetStatistics(m_ClientConnections[player].ClientId, &rns);
+							if (!m_Server->GetStatistics(relayOnly ? GetRelayAddress(player) : connection.ClientId, &rns)) {
+								break;
+							}
 
-							m_SendBufferBytes[player] = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
-							m_SendBufferMessages[player] = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
+							connection.Stats.SendBufferBytes = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
+							connection.Stats.SendBufferMessages = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
 
 							RakSleep(25);
 						} while (rns.messageInSendBuffer[HIGH_PRIORITY] > 1000 && IsPlayerConnected(player));
@@ -868,36 +977,42 @@ namespace RTE {
 			release_bitmap(bmp);
 		}
 
-		m_SceneLock[player].unlock();
+		m_SceneLock.unlock_shared();
 
-		m_SendSceneSetupData[player] = false;
-		m_SendSceneData[player] = false;
-		m_SendFrameData[player] = false;
+		if (relayOnly) {
+			m_SendRelaySceneData = false;
+		} else {
+			connection.SendSceneSetupData = false;
+			connection.SendSceneData = false;
+			connection.SendFrameData = false;
+		}
 
-		SendSceneEndMsg(player);
+		SendSceneEndMsg(player, relayOnly);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::ClearTerrainChangeQueue(short player) {
-		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty()) {
-			m_PendingTerrainChanges[player].pop();
+		ClientConnection &connection = *m_ClientConnections[player];
+		connection.Mutex.lock();
+		while (!connection.PendingTerrainChanges.empty()) {
+			connection.PendingTerrainChanges.pop();
 		}
-		while (!m_CurrentTerrainChanges[player].empty()) {
-			m_CurrentTerrainChanges[player].pop();
+		while (!connection.CurrentTerrainChanges.empty()) {
+			connection.CurrentTerrainChanges.pop();
 		}
-		m_Mutex[player].unlock();
+		connection.Mutex.unlock();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	bool NetworkServer::NeedToProcessTerrainChanges(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		bool result;
 
-		m_Mutex[player].lock();
-		result = !m_PendingTerrainChanges[player].empty();
-		m_Mutex[player].unlock();
+		connection.Mutex.lock();
+		result = !connection.PendingTerrainChanges.empty();
+		connection.Mutex.unlock();
 
 		return result;
 	}
@@ -905,18 +1020,19 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::ProcessTerrainChanges(short player) {
-		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty()) {
-			m_CurrentTerrainChanges[player].push(m_PendingTerrainChanges[player].front());
-			m_PendingTerrainChanges[player].pop();
+		ClientConnection &connection = *m_ClientConnections[player];
+		connection.Mutex.lock();
+		while (!connection.PendingTerrainChanges.empty()) {
+			connection.CurrentTerrainChanges.push(connection.PendingTerrainChanges.front());
+			connection.PendingTerrainChanges.pop();
 		}
-		m_Mutex[player].unlock();
+		connection.Mutex.unlock();
 
-		while (!m_CurrentTerrainChanges[player].empty()) {
+		while (!connection.CurrentTerrainChanges.empty()) {
 			int maxSize = 1280;
 
-			SceneMan::TerrainChange terrainChange = m_CurrentTerrainChanges[player].front();
-			m_CurrentTerrainChanges[player].pop();
+			SceneMan::TerrainChange terrainChange = connection.CurrentTerrainChanges.front();
+			connection.CurrentTerrainChanges.pop();
 
 			// Fragment region if it does not fit one packet
 			if (terrainChange.w * terrainChange.h > maxSize) {
@@ -954,6 +1070,7 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendTerrainChangeMsg(short player, SceneMan::TerrainChange terrainChange) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		if (terrainChange.w == 1 && terrainChange.h == 1) {
 			MsgTerrainChange msg;
 			msg.Id = ID_SRV_TERRAIN;
@@ -969,18 +1086,18 @@ namespace RTE {
 
 			int payloadSize = sizeof(MsgTerrainChange);
 
-			m_Server->Send((const char *)&msg, payloadSize, MEDIUM_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+			SendPlayerPacket(player, (const char *)&msg, payloadSize, MEDIUM_PRIORITY, RELIABLE);
 
-			m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_DataSentTotal[player] += payloadSize;
+			connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.DataSentTotal += payloadSize;
 
-			m_TerrainDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_TerrainDataSentTotal[player] += payloadSize;
+			connection.Stats.TerrainDataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.TerrainDataSentTotal += payloadSize;
 
-			m_DataUncompressedCurrent[player][STAT_CURRENT] += payloadSize;
-			m_DataUncompressedTotal[player] += payloadSize;
+			connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.DataUncompressedTotal += payloadSize;
 		} else {
-			MsgTerrainChange *msg = (MsgTerrainChange *)m_PixelLineBuffer[player];
+			MsgTerrainChange *msg = (MsgTerrainChange *)connection.PixelLineBuffer;
 			msg->Id = ID_SRV_TERRAIN;
 			msg->X = terrainChange.x;
 			msg->Y = terrainChange.y;
@@ -999,7 +1116,7 @@ namespace RTE {
 			const BITMAP *bmp = 0;
 			bmp = msg->Back ? terrain->GetBGColorBitmap() : terrain->GetFGColorBitmap();
 
-			unsigned char *dest = (unsigned char *)(m_TerrainChangeBuffer[player]);
+			unsigned char *dest = (unsigned char *)(connection.TerrainChangeBuffer);
 
 			// Copy bitmap data
 			for (int y = 0; y < msg->H && msg->Y + y < bmp->h; y++) {
@@ -1009,14 +1126,14 @@ namespace RTE {
 
 			int result = 0;
 
-			result = LZ4_compress_HC_extStateHC(m_LZ4CompressionState[player], (char *)m_TerrainChangeBuffer[player], (char *)(m_PixelLineBuffer[player] + sizeof(MsgTerrainChange)), size, size, LZ4HC_CLEVEL_OPT_MIN);
+			result = LZ4_compress_HC_extStateHC(connection.LZ4CompressionState, (char *)connection.TerrainChangeBuffer, (char *)(connection.PixelLineBuffer + sizeof(MsgTerrainChange)), size, size, LZ4HC_CLEVEL_OPT_MIN);
 
 			// Compression failed or ineffective, send as is
 			if (result == 0 || result == size) {
 #ifdef _WIN32
-				memcpy_s(m_PixelLineBuffer[player] + sizeof(MsgTerrainChange), c_MaxPixelLineBufferSize, m_TerrainChangeBuffer[player], size);
+				memcpy_s(connection.PixelLineBuffer + sizeof(MsgTerrainChange), c_MaxPixelLineBufferSize, connection.TerrainChangeBuffer, size);
 #else
-				memcpy(m_PixelLineBuffer[player] + sizeof(MsgTerrainChange), m_TerrainChangeBuffer[player], size);
+				memcpy(connection.PixelLineBuffer + sizeof(MsgTerrainChange), connection.TerrainChangeBuffer, size);
 #endif
 			} else {
 				msg->DataSize = result;
@@ -1024,16 +1141,16 @@ namespace RTE {
 
 			int payloadSize = sizeof(MsgTerrainChange) + msg->DataSize;
 
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+			SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE);
 
-			m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_DataSentTotal[player] += payloadSize;
+			connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.DataSentTotal += payloadSize;
 
-			m_TerrainDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_TerrainDataSentTotal[player] += payloadSize;
+			connection.Stats.TerrainDataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.TerrainDataSentTotal += payloadSize;
 
-			m_DataUncompressedCurrent[player][STAT_CURRENT] += msg->UncompressedSize;
-			m_DataUncompressedTotal[player] += msg->UncompressedSize;
+			connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += msg->UncompressedSize;
+			connection.Stats.DataUncompressedTotal += msg->UncompressedSize;
 		}
 	}
 
@@ -1041,41 +1158,51 @@ namespace RTE {
 
 	void NetworkServer::ReceiveSceneAcceptedMsg(RakNet::Packet *packet) {
 		for (short player = 0; player < c_MaxClients; player++) {
-			if (m_ClientConnections[player].ClientId == packet->systemAddress) { m_SendFrameData[player] = true; }
+			if (m_ClientConnections[player] && m_ClientConnections[player]->ClientId == packet->systemAddress) {
+				ClientConnection &connection = *m_ClientConnections[player];
+
+				// Offset each slot's frames by a fraction of the frame period, so clients that get the scene at the same time don't all have their frames encoded at once
+				long long ticksPerFrame = g_TimerMan.GetTicksPerSecond() / std::max(connection.EncodingFps, 1);
+				connection.LastFrameSentTime = g_TimerMan.GetRealTickCount() - ticksPerFrame + (ticksPerFrame * player) / c_MaxClients;
+				connection.SendFrameData = true;
+			}
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void NetworkServer::SendSceneEndMsg(short player) {
+	void NetworkServer::SendSceneEndMsg(short player, bool relayOnly) {
 		MsgSceneEnd msg;
 		msg.Id = ID_SRV_SCENE_END;
-		m_Server->Send((const char *)&msg, sizeof(MsgSceneSetup), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+		SendPlayerPacket(player, (const char *)&msg, sizeof(MsgSceneSetup), HIGH_PRIORITY, RELIABLE_ORDERED, relayOnly);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::CreateBackBuffer(short player, int w, int h) {
-		m_BackBuffer8[player] = create_bitmap_ex(8, w, h);
-		m_BackBufferGUI8[player] = create_bitmap_ex(8, w, h);
+		ClientConnection &connection = *m_ClientConnections[player];
+		connection.BackBuffer8 = create_bitmap_ex(8, w, h);
+		connection.BackBufferGUI8 = create_bitmap_ex(8, w, h);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::DestroyBackBuffer(short player) {
-		if (m_BackBuffer8) { destroy_bitmap(m_BackBuffer8[player]); }
-		m_BackBuffer8[player] = 0;
+		ClientConnection &connection = *m_ClientConnections[player];
+		if (connection.BackBuffer8) { destroy_bitmap(connection.BackBuffer8); }
+		connection.BackBuffer8 = 0;
 
-		if (m_BackBufferGUI8) { destroy_bitmap(m_BackBufferGUI8[player]); }
-		m_BackBufferGUI8[player] = 0;
+		if (connection.BackBufferGUI8) { destroy_bitmap(connection.BackBufferGUI8); }
+		connection.BackBufferGUI8 = 0;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendFrameSetupMsg(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		MsgFrameSetup msgFrameSetup;
 		msgFrameSetup.Id = ID_SRV_FRAME_SETUP;
-		msgFrameSetup.FrameNumber = m_FrameNumbers[player];
+		msgFrameSetup.FrameNumber = connection.FrameNumber;
 		msgFrameSetup.TargetPosX = g_FrameMan.GetTargetPos(player).m_X;
 		msgFrameSetup.TargetPosY = g_FrameMan.GetTargetPos(player).m_Y;
 
@@ -1086,23 +1213,24 @@ namespace RTE {
 
 		int payloadSize = sizeof(MsgSceneSetup);
 
-		m_Server->Send((const char *)&msgFrameSetup, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+		SendPlayerPacket(player, (const char *)&msgFrameSetup, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
-		m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-		m_DataSentTotal[player] += payloadSize;
+		connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.DataSentTotal += payloadSize;
 
-		m_FrameDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-		m_FrameDataSentTotal[player] += payloadSize;
+		connection.Stats.FrameDataSentCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.FrameDataSentTotal += payloadSize;
 
-		m_DataUncompressedCurrent[player][STAT_CURRENT] += payloadSize;
-		m_DataUncompressedTotal[player] += payloadSize;
+		connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += payloadSize;
+		connection.Stats.DataUncompressedTotal += payloadSize;
 
-		m_SendSceneData[player] = false;
+		connection.SendSceneData = false;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendPostEffectData(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		std::list<PostEffect> effects;
 		g_PostProcessMan.GetNetworkPostEffectsList(player, effects);
 
@@ -1110,11 +1238,11 @@ namespace RTE {
 			return;
 		}
 
-		MsgPostEffects *msg = (MsgPostEffects *)m_PixelLineBuffer[player];
+		MsgPostEffects *msg = (MsgPostEffects *)connection.PixelLineBuffer;
 		PostEffectNetworkData *effDataPtr = (PostEffectNetworkData *)((char *)msg + sizeof(MsgPostEffects));
 
 		msg->Id = ID_SRV_POST_EFFECTS;
-		msg->FrameNumber = m_FrameNumbers[player];
+		msg->FrameNumber = connection.FrameNumber;
 		msg->PostEffectsCount = 0;
 
 		for (const PostEffect postEffectEvent : effects) {
@@ -1129,14 +1257,14 @@ namespace RTE {
 
 			if (msg->PostEffectsCount >= 75) {
 				int payloadSize = sizeof(MsgPostEffects) + sizeof(PostEffectNetworkData) * msg->PostEffectsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->PostEffectsCount = 0;
 				effDataPtr = (PostEffectNetworkData *)((char *)msg + sizeof(MsgPostEffects));
 
-				m_PostEffectDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-				m_PostEffectDataSentTotal[player] += payloadSize;
+				connection.Stats.PostEffectDataSentCurrent[STAT_CURRENT] += payloadSize;
+				connection.Stats.PostEffectDataSentTotal += payloadSize;
 
-				m_DataSentTotal[player] += payloadSize;
+				connection.Stats.DataSentTotal += payloadSize;
 			}
 		}
 
@@ -1147,22 +1275,106 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgPostEffects) + sizeof(PostEffectNetworkData) * msg->PostEffectsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendPlayerPacket(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
-			m_PostEffectDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-			m_PostEffectDataSentTotal[player] += payloadSize;
+			connection.Stats.PostEffectDataSentCurrent[STAT_CURRENT] += payloadSize;
+			connection.Stats.PostEffectDataSentTotal += payloadSize;
 
-			m_DataSentTotal[player] += payloadSize;
+			connection.Stats.DataSentTotal += payloadSize;
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::ApplyQualityLevel(short player, int level) {
+		ClientConnection &connection = *m_ClientConnections[player];
+		const QualityStep &step = c_QualitySteps[level];
+
+		connection.QualityLevel = level;
+		connection.EncodingFps = std::max(static_cast<int>(static_cast<float>(m_EncodingFps) * step.FpsScale + 0.5F), 1);
+		connection.UseInterlacing = m_UseInterlacing || step.ForceInterlacing;
+
+		// Boxes only grow wider, as far as the width fits in a MsgFrameBox and a whole box still fits the pixel buffers
+		int maxBoxWidth = std::min(static_cast<int>(std::numeric_limits<unsigned char>::max()), static_cast<int>(c_MaxPixelLineBufferSize - sizeof(MsgFrameBox)) / std::max(m_BoxHeight, 1));
+		connection.BoxWidth = std::max(std::min(m_BoxWidth * step.BoxWidthScale, maxBoxWidth), m_BoxWidth);
+
+		int extraCompression = connection.CompressionLimitedByTime ? 0 : step.ExtraCompression;
+		connection.CompressionLevel = m_UseHighCompression ? std::min(m_HighCompressionLevel + extraCompression, std::max(m_HighCompressionLevel, LZ4HC_CLEVEL_MAX)) : std::max(m_FastAccelerationFactor - extraCompression, 1);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::UpdateQualityLevel(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
+		if (!connection.QualityUpdateTimer.IsPastRealMS(c_QualityUpdateIntervalMS)) {
+			return;
+		}
+		connection.QualityUpdateTimer.Reset();
+
+		RakNet::RakNetStatistics rns;
+		if (!m_UseAdaptiveQuality || !m_Server->GetStatistics(connection.ClientId, &rns)) {
+			// Still reapply so changes to the configured settings get picked up
+			ApplyQualityLevel(player, 0);
+			return;
+		}
+
+		double sendRate = static_cast<double>(rns.valueOverLastSecond[RakNet::ACTUAL_BYTES_SENT]);
+		double bufferedBytes = rns.bytesInSendBuffer[MEDIUM_PRIORITY] + rns.bytesInSendBuffer[HIGH_PRIORITY];
+		connection.QueueDelay = static_cast<int>(std::min(bufferedBytes * 1000.0 / std::max(sendRate, 1.0), 99999.0));
+
+		bool framesSkipped = connection.Stats.FramesSkipped != connection.FramesSkippedAtQualityUpdate;
+		connection.FramesSkippedAtQualityUpdate = connection.Stats.FramesSkipped;
+
+		bool isCongested = rns.isLimitedByCongestionControl || framesSkipped || connection.QueueDelay > c_TargetQueueDelayMS || rns.packetlossLastSecond > 0.05F;
+
+		// Whatever the link carries while it keeps up is a lower bound of what it can carry, while congested it's the most it can
+		if (rns.isLimitedByCongestionControl) {
+			connection.EstimatedBandwidth = static_cast<unsigned long>(rns.BPSLimitByCongestionControl);
+		} else if (isCongested) {
+			connection.EstimatedBandwidth = static_cast<unsigned long>(sendRate);
+		} else {
+			connection.EstimatedBandwidth = std::max(connection.EstimatedBandwidth, static_cast<unsigned long>(sendRate));
+		}
+
+		// Compressing harder than configured is only worth it while there's time for it, otherwise frames get delayed just like when congested. Needs to get well under the limit again before trying, so it doesn't flip back and forth.
+		int msecPerFrame = 1000 / std::max(connection.EncodingFps, 1);
+		if (connection.MsecPerSendCall > msecPerFrame / 2) {
+			connection.CompressionLimitedByTime = true;
+		} else if (connection.MsecPerSendCall < msecPerFrame / 4) {
+			connection.CompressionLimitedByTime = false;
+		}
+
+		int level = connection.QualityLevel;
+		if (isCongested) {
+			connection.QualityClearTimer.Reset();
+			if (connection.QualityStepTimer.IsPastRealMS(c_QualityStepDownIntervalMS) && level < static_cast<int>(c_QualitySteps.size()) - 1) {
+				// A step up that congested the link right away means it's at its limit, so wait longer before trying again
+				if (connection.ProbingQuality) { connection.QualityProbeHoldMS = std::min(connection.QualityProbeHoldMS * 2, c_MaxQualityProbeHoldMS); }
+				connection.ProbingQuality = false;
+				level++;
+				connection.QualityStepTimer.Reset();
+			}
+		} else if (level > 0 && connection.QualityClearTimer.IsPastRealMS(connection.QualityProbeHoldMS) && connection.QualityStepTimer.IsPastRealMS(connection.QualityProbeHoldMS)) {
+			// The last step up held, so the link may have room for more
+			if (connection.ProbingQuality) { connection.QualityProbeHoldMS = c_MinQualityProbeHoldMS; }
+			connection.ProbingQuality = true;
+			level--;
+			connection.QualityStepTimer.Reset();
+		} else if (connection.ProbingQuality && connection.QualityStepTimer.IsPastRealMS(connection.QualityProbeHoldMS)) {
+			connection.ProbingQuality = false;
+			connection.QualityProbeHoldMS = c_MinQualityProbeHoldMS;
+		}
+		ApplyQualityLevel(player, level);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	int NetworkServer::SendFrame(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		long long currentTicks = g_TimerMan.GetRealTickCount();
-		double fps = static_cast<double>(m_EncodingFps);
+		double fps = static_cast<double>(connection.EncodingFps);
 		double secsPerFrame = 1.0 / fps;
-		double secsSinceLastFrame = static_cast<double>(currentTicks - m_LastFrameSentTime[player]) / static_cast<double>(g_TimerMan.GetTicksPerSecond());
+		double secsSinceLastFrame = static_cast<double>(currentTicks - connection.LastFrameSentTime) / static_cast<double>(g_TimerMan.GetTicksPerSecond());
 		int microSeconds = 1000000;
 
 		// Fix for an overflow which may happen if server lags for a few seconds when loading activities
@@ -1170,7 +1382,7 @@ namespace RTE {
 
 		// Is it time to send frame?
 		// Return time to sleep till next frame in microseconds
-		m_MSecsSinceLastUpdate[player] = static_cast<long>(secsSinceLastFrame * 1000.0);
+		connection.MSecsSinceLastUpdate = static_cast<long>(secsSinceLastFrame * 1000.0);
 
 		if (secsSinceLastFrame < secsPerFrame) {
 			SetThreadExitReason(player, NetworkServer::TOO_EARLY_TO_SEND);
@@ -1178,89 +1390,95 @@ namespace RTE {
 		}
 
 		// Accumulate delayed frames counter for stats
-		if (secsSinceLastFrame > secsPerFrame * 1.5) { m_DelayedFrames[player]++; }
+		if (secsSinceLastFrame > secsPerFrame * 1.5) { connection.DelayedFrames++; }
 
-		m_MsecPerFrame[player] = static_cast<int>(secsSinceLastFrame * 1000.0);
+		connection.MsecPerFrame = static_cast<int>(secsSinceLastFrame * 1000.0);
 
-		m_LastFrameSentTime[player] = g_TimerMan.GetRealTickCount();
+		// Advance by a whole frame period so frames go out at an even pace instead of drifting later by however late this call was, unless a frame was missed entirely, which there's no point catching up on
+		long long ticksPerFrame = static_cast<long long>(secsPerFrame * static_cast<double>(g_TimerMan.GetTicksPerSecond()));
+		connection.LastFrameSentTime = (currentTicks - connection.LastFrameSentTime < ticksPerFrame * 2) ? connection.LastFrameSentTime + ticksPerFrame : currentTicks;
 
 		// Check for congestion
 		RakNet::RakNetStatistics rns;
 
-		m_Server->GetStatistics(m_ClientConnections[player].ClientId, &rns);
+		m_Server->GetStatistics(connection.ClientId, &rns);
 
-		m_SendBufferBytes[player] = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
-		m_SendBufferMessages[player] = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
+		connection.Stats.SendBufferBytes = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
+		connection.Stats.SendBufferMessages = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
 
 		if (rns.isLimitedByCongestionControl) {
 			SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_LIMITED_BY_CONGESTION);
-			m_FramesSkipped[player]++;
+			connection.Stats.FramesSkipped++;
 			return static_cast<int>((1.0 / fps) * microSeconds);
 		}
 		if (rns.messageInSendBuffer[MEDIUM_PRIORITY] > 1000) {
 			SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_FULL);
-			m_FramesSkipped[player]++;
+			connection.Stats.FramesSkipped++;
 			return 0;
 		}
 
-		// Wait till FrameMan releases bitmap
+		// Wait for a turn to encode, clients whose frames became due earlier go first
 		SetThreadExitReason(player, NetworkServer::LOCKED);
+		if (!AcquireEncodeSlot(player)) {
+			return 0;
+		}
 		SetThreadExitReason(player, NetworkServer::NORMAL);
 
 		// Get backbuffer bitmap for this player
 		BITMAP *frameManBmp = g_FrameMan.GetNetworkBackBuffer8Ready(player);
 		BITMAP *frameManGUIBmp = g_FrameMan.GetNetworkBackBufferGUI8Ready(player);
 
-		if (!m_BackBuffer8[player]) {
+		if (!connection.BackBuffer8) {
 			CreateBackBuffer(player, frameManBmp->w, frameManBmp->h);
 		} else {
 			// If for whatever reasons frameMans back buffer changed dimensions, recreate our internal backbuffer
-			if (m_BackBuffer8[player]->w != frameManBmp->w || m_BackBuffer8[player]->h != frameManBmp->h) {
+			if (connection.BackBuffer8->w != frameManBmp->w || connection.BackBuffer8->h != frameManBmp->h) {
 				DestroyBackBuffer(player);
 				CreateBackBuffer(player, frameManBmp->w, frameManBmp->h);
 				//g_ConsoleMan.PrintString("SERVER: Backbuffer recreated");
 			}
 		}
 
-		m_FrameNumbers[player]++;
-		if (m_FrameNumbers[player] >= c_FramesToRemember) { m_FrameNumbers[player] = 0; }
+		connection.FrameNumber++;
+		if (connection.FrameNumber >= c_FramesToRemember) { connection.FrameNumber = 0; }
 
 		// Save a copy of buffer to avoid tearing when the original is updated by frame man
-		blit(frameManBmp, m_BackBuffer8[player], 0, 0, 0, 0, frameManBmp->w, frameManBmp->h);
-		blit(frameManGUIBmp, m_BackBufferGUI8[player], 0, 0, 0, 0, frameManGUIBmp->w, frameManGUIBmp->h);
+		blit(frameManBmp, connection.BackBuffer8, 0, 0, 0, 0, frameManBmp->w, frameManBmp->h);
+		blit(frameManGUIBmp, connection.BackBufferGUI8, 0, 0, 0, 0, frameManGUIBmp->w, frameManGUIBmp->h);
 
 		SendFrameSetupMsg(player);
 		SendPostEffectData(player);
 		SendSoundData(player);
 		SendMusicData(player);
 
-		m_FramesSent[player]++;
+		connection.Stats.FramesSent++;
 
 		// Compression section
-		int compressionMethod = m_HighCompressionLevel;
-		int accelerationFactor = m_FastAccelerationFactor;
+		int compressionMethod = connection.CompressionLevel;
+		int accelerationFactor = connection.CompressionLevel;
+		int boxWidth = connection.BoxWidth;
 
-		m_SendEven[player] = !m_SendEven[player];
+		connection.SendEven = !connection.SendEven;
 
 		if (m_TransmitAsBoxes) {
-			MsgFrameBox *frameData = (MsgFrameBox *)m_PixelLineBuffer[player];
-			frameData->FrameNumber = m_FrameNumbers[player];
+			MsgFrameBox *frameData = (MsgFrameBox *)connection.PixelLineBuffer;
+			frameData->FrameNumber = connection.FrameNumber;
 
 			// Save message ID
 			frameData->Id = ID_SRV_FRAME_BOX;
-			frameData->BoxWidth = m_BoxWidth;
+			frameData->BoxWidth = boxWidth;
 			frameData->BoxHeight = m_BoxHeight;
 
-			int bw = m_BackBuffer8[player]->w / m_BoxWidth;
-			int bh = m_BackBuffer8[player]->h / m_BoxHeight;
+			int bw = connection.BackBuffer8->w / boxWidth;
+			int bh = connection.BackBuffer8->h / m_BoxHeight;
 
 			for (int by = 0; by <= bh; by++) {
 				int step = 1;
 				int startLine = 0;
 
-				if (m_UseInterlacing) {
+				if (connection.UseInterlacing) {
 					step = 2;
-					if (m_SendEven[player]) {
+					if (connection.SendEven) {
 						startLine = (by % 2 == 0) ? 1 : 0;
 					} else {
 						startLine = (by % 2 == 0) ? 0 : 1;
@@ -1268,25 +1486,25 @@ namespace RTE {
 				}
 
 				for (int bx = startLine; bx <= bw; bx += step) {
-					int bpx = bx * m_BoxWidth;
+					int bpx = bx * boxWidth;
 					int bpy = by * m_BoxHeight;
 
-					if (bpx >= m_BackBuffer8[player]->w || bpy >= m_BackBuffer8[player]->h) {
+					if (bpx >= connection.BackBuffer8->w || bpy >= connection.BackBuffer8->h) {
 						break;
 					}
 
 					frameData->BoxX = bpx;
 					frameData->BoxY = bpy;
 
-					int maxWidth = m_BoxWidth;
-					if (bpx + m_BoxWidth >= m_BackBuffer8[player]->w) {
-						maxWidth = m_BackBuffer8[player]->w - bpx;
+					int maxWidth = boxWidth;
+					if (bpx + boxWidth >= connection.BackBuffer8->w) {
+						maxWidth = connection.BackBuffer8->w - bpx;
 						frameData->BoxWidth = maxWidth;
 					}
 
 					int maxHeight = m_BoxHeight;
-					if (bpy + m_BoxHeight >= m_BackBuffer8[player]->h) {
-						maxHeight = m_BackBuffer8[player]->h - bpy;
+					if (bpy + m_BoxHeight >= connection.BackBuffer8->h) {
+						maxHeight = connection.BackBuffer8->h - bpy;
 						frameData->BoxHeight = maxHeight;
 					}
 
@@ -1300,14 +1518,14 @@ namespace RTE {
 
 						const BITMAP *backBuffer = 0;
 						if (layer == 0) {
-							backBuffer = m_BackBuffer8[player];
+							backBuffer = connection.BackBuffer8;
 						} else if (layer == 1) {
-							backBuffer = m_BackBufferGUI8[player];
+							backBuffer = connection.BackBufferGUI8;
 						}
 
 						frameData->Layer = layer;
 
-						unsigned char *dest = (unsigned char *)(m_TerrainChangeBuffer[player]);
+						unsigned char *dest = (unsigned char *)(connection.TerrainChangeBuffer);
 
 						// Copy block to line buffer and also check if block is empty
 						for (line = 0; line < maxHeight; line++) {
@@ -1317,7 +1535,7 @@ namespace RTE {
 						}
 
 						// Check if block is empty
-						unsigned long *pixelInt = (unsigned long *)m_TerrainChangeBuffer[player];
+						unsigned long *pixelInt = (unsigned long *)connection.TerrainChangeBuffer;
 						int counter = 0;
 
 						for (counter = 0; counter < size; counter += sizeof(unsigned long)) {
@@ -1345,46 +1563,46 @@ namespace RTE {
 							int result = 0;
 
 							if (m_UseHighCompression) {
-								result = LZ4_compress_HC_extStateHC(m_LZ4CompressionState[player], (char *)m_TerrainChangeBuffer[player], (char *)(m_PixelLineBuffer[player] + sizeof(MsgFrameBox)), size, size, compressionMethod);
+								result = LZ4_compress_HC_extStateHC(connection.LZ4CompressionState, (char *)connection.TerrainChangeBuffer, (char *)(connection.PixelLineBuffer + sizeof(MsgFrameBox)), size, size, compressionMethod);
 							} else if (m_UseFastCompression) {
-								result = LZ4_compress_fast_extState(m_LZ4FastCompressionState[player], (char *)m_TerrainChangeBuffer[player], (char *)(m_PixelLineBuffer[player] + sizeof(MsgFrameBox)), size, size, accelerationFactor);
+								result = LZ4_compress_fast_extState(connection.LZ4FastCompressionState, (char *)connection.TerrainChangeBuffer, (char *)(connection.PixelLineBuffer + sizeof(MsgFrameBox)), size, size, accelerationFactor);
 							}
 
 							// Compression failed or ineffective, send as is
 							if (result == 0 || result == backBuffer->w) {
 #ifdef _WIN32
-								memcpy_s(m_PixelLineBuffer[player] + sizeof(MsgFrameBox), c_MaxPixelLineBufferSize, m_TerrainChangeBuffer[player], size);
+								memcpy_s(connection.PixelLineBuffer + sizeof(MsgFrameBox), c_MaxPixelLineBufferSize, connection.TerrainChangeBuffer, size);
 #else
-								memcpy(m_PixelLineBuffer[player] + sizeof(MsgFrameBox), m_TerrainChangeBuffer[player], size);
+								memcpy(connection.PixelLineBuffer + sizeof(MsgFrameBox), connection.TerrainChangeBuffer, size);
 #endif
 							} else {
 								frameData->DataSize = result;
 							}
 
-							m_FullBlocks[player]++;
+							connection.Stats.FullBlocks++;
 						} else {
 							frameData->DataSize = 0;
-							m_EmptyBlocks[player]++;
+							connection.Stats.EmptyBlocks++;
 						}
 
 						int payloadSize = frameData->DataSize + sizeof(MsgFrameBox);
 
-						m_Server->Send((const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+						SendPlayerPacket(player, (const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED);
 
-						m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-						m_DataSentTotal[player] += payloadSize;
+						connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+						connection.Stats.DataSentTotal += payloadSize;
 
-						m_FrameDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-						m_FrameDataSentTotal[player] += payloadSize;
+						connection.Stats.FrameDataSentCurrent[STAT_CURRENT] += payloadSize;
+						connection.Stats.FrameDataSentTotal += payloadSize;
 
-						m_DataUncompressedCurrent[player][STAT_CURRENT] += frameData->UncompressedSize;
-						m_DataUncompressedTotal[player] += frameData->UncompressedSize;
+						connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += frameData->UncompressedSize;
+						connection.Stats.DataUncompressedTotal += frameData->UncompressedSize;
 					}
 				}
 			}
 		} else {
-			MsgFrameLine *frameData = (MsgFrameLine *)m_PixelLineBuffer[player];
-			frameData->FrameNumber = m_FrameNumbers[player];
+			MsgFrameLine *frameData = (MsgFrameLine *)connection.PixelLineBuffer;
+			frameData->FrameNumber = connection.FrameNumber;
 
 			// Save message ID
 			frameData->Id = ID_SRV_FRAME_LINE;
@@ -1392,20 +1610,19 @@ namespace RTE {
 			int startLine = 0;
 			int step = 1;
 
-			if (m_UseInterlacing) {
+			if (connection.UseInterlacing) {
 				step = 2;
-				m_SendEven[player] = !m_SendEven[player];
-				startLine = m_SendEven[player] ? 0 : 1;
+				startLine = connection.SendEven ? 0 : 1;
 			}
 
-			for (int m_CurrentFrameLine = startLine; m_CurrentFrameLine < m_BackBuffer8[player]->h; m_CurrentFrameLine += step) {
+			for (int m_CurrentFrameLine = startLine; m_CurrentFrameLine < connection.BackBuffer8->h; m_CurrentFrameLine += step) {
 				for (int layer = 0; layer < 2; layer++) {
 					const BITMAP *backBuffer = 0;
 
 					if (layer == 0) {
-						backBuffer = m_BackBuffer8[player];
+						backBuffer = connection.BackBuffer8;
 					} else if (layer == 1) {
-						backBuffer = m_BackBufferGUI8[player];
+						backBuffer = connection.BackBufferGUI8;
 					}
 
 					// Save line number
@@ -1448,47 +1665,48 @@ namespace RTE {
 
 					if (!lineIsEmpty) {
 						if (m_UseHighCompression) {
-							result = LZ4_compress_HC_extStateHC(m_LZ4CompressionState[player], (char *)backBuffer->line[m_CurrentFrameLine], (char *)(m_PixelLineBuffer[player] + sizeof(MsgFrameLine)), backBuffer->w, backBuffer->w, compressionMethod);
+							result = LZ4_compress_HC_extStateHC(connection.LZ4CompressionState, (char *)backBuffer->line[m_CurrentFrameLine], (char *)(connection.PixelLineBuffer + sizeof(MsgFrameLine)), backBuffer->w, backBuffer->w, compressionMethod);
 						} else if (m_UseFastCompression) {
-							result = LZ4_compress_fast_extState(m_LZ4FastCompressionState[player], (char *)backBuffer->line[m_CurrentFrameLine], (char *)(m_PixelLineBuffer[player] + sizeof(MsgFrameLine)), backBuffer->w, backBuffer->w, accelerationFactor);
+							result = LZ4_compress_fast_extState(connection.LZ4FastCompressionState, (char *)backBuffer->line[m_CurrentFrameLine], (char *)(connection.PixelLineBuffer + sizeof(MsgFrameLine)), backBuffer->w, backBuffer->w, accelerationFactor);
 						}
 
 						// Compression failed or ineffective, send as is
-						if (result == 0 || result == m_BackBuffer8[player]->w) {
+						if (result == 0 || result == connection.BackBuffer8->w) {
 #ifdef _WIN32
-							memcpy_s(m_PixelLineBuffer[player] + sizeof(MsgFrameLine), c_MaxPixelLineBufferSize, backBuffer->line[m_CurrentFrameLine], backBuffer->w);
+							memcpy_s(connection.PixelLineBuffer + sizeof(MsgFrameLine), c_MaxPixelLineBufferSize, backBuffer->line[m_CurrentFrameLine], backBuffer->w);
 #else
-							memcpy(m_PixelLineBuffer[player] + sizeof(MsgFrameLine), backBuffer->line[m_CurrentFrameLine], backBuffer->w);
+							memcpy(connection.PixelLineBuffer + sizeof(MsgFrameLine), backBuffer->line[m_CurrentFrameLine], backBuffer->w);
 #endif
 						} else {
 							frameData->DataSize = result;
 						}
 
-						m_FullBlocks[player]++;
+						connection.Stats.FullBlocks++;
 					} else {
 						frameData->DataSize = 0;
-						m_EmptyBlocks[player]++;
+						connection.Stats.EmptyBlocks++;
 					}
 
 					int payloadSize = frameData->DataSize + sizeof(MsgFrameLine);
 
-					m_Server->Send((const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+					SendPlayerPacket(player, (const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED);
 
-					m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
-					m_DataSentTotal[player] += payloadSize;
+					connection.Stats.DataSentCurrent[STAT_CURRENT] += payloadSize;
+					connection.Stats.DataSentTotal += payloadSize;
 
-					m_FrameDataSentCurrent[player][STAT_CURRENT] += payloadSize;
-					m_FrameDataSentTotal[player] += payloadSize;
+					connection.Stats.FrameDataSentCurrent[STAT_CURRENT] += payloadSize;
+					connection.Stats.FrameDataSentTotal += payloadSize;
 
-					m_DataUncompressedCurrent[player][STAT_CURRENT] += frameData->UncompressedSize;
-					m_DataUncompressedTotal[player] += frameData->UncompressedSize;
+					connection.Stats.DataUncompressedCurrent[STAT_CURRENT] += frameData->UncompressedSize;
+					connection.Stats.DataUncompressedTotal += frameData->UncompressedSize;
 				}
 			}
 		}
 		ProcessTerrainChanges(player);
+		ReleaseEncodeSlot();
 
 		double secsSinceSendStart = static_cast<double>(g_TimerMan.GetRealTickCount() - currentTicks) / static_cast<double>(g_TimerMan.GetTicksPerSecond());
-		m_MsecPerSendCall[player] = static_cast<int>(secsSinceSendStart * 1000.0);
+		connection.MsecPerSendCall = static_cast<int>(secsSinceSendStart * 1000.0);
 
 		SetThreadExitReason(player, NetworkServer::NORMAL);
 		return 0;
@@ -1497,31 +1715,32 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::UpdateStats(short player) {
+		ClientConnection &connection = *m_ClientConnections[player];
 		long long currentTicks = g_TimerMan.GetRealTickCount();
 
-		if (currentTicks - m_LastStatResetTime[player] > g_TimerMan.GetTicksPerSecond() || currentTicks - m_LastStatResetTime[player] < -g_TimerMan.GetTicksPerSecond()) {
-			m_LastStatResetTime[player] = currentTicks;
-
-			m_DataUncompressedCurrent[player][STAT_SHOWN] = m_DataUncompressedCurrent[player][STAT_CURRENT];
-			m_DataSentCurrent[player][STAT_SHOWN] = m_DataSentCurrent[player][STAT_CURRENT];
-			m_FrameDataSentCurrent[player][STAT_SHOWN] = m_FrameDataSentCurrent[player][STAT_CURRENT];
-			m_PostEffectDataSentCurrent[player][STAT_SHOWN] = m_PostEffectDataSentCurrent[player][STAT_CURRENT];
-			m_SoundDataSentCurrent[player][STAT_SHOWN] = m_SoundDataSentCurrent[player][STAT_CURRENT];
-			m_TerrainDataSentCurrent[player][STAT_SHOWN] = m_TerrainDataSentCurrent[player][STAT_CURRENT];
-			m_OtherDataSentCurrent[player][STAT_SHOWN] = m_OtherDataSentCurrent[player][STAT_CURRENT];
-
-			m_DataUncompressedCurrent[player][STAT_CURRENT] = 0;
-			m_DataSentCurrent[player][STAT_CURRENT] = 0;
-			m_FrameDataSentCurrent[player][STAT_CURRENT] = 0;
-			m_PostEffectDataSentCurrent[player][STAT_CURRENT] = 0;
-			m_SoundDataSentCurrent[player][STAT_CURRENT] = 0;
-			m_TerrainDataSentCurrent[player][STAT_CURRENT] = 0;
-			m_OtherDataSentCurrent[player][STAT_CURRENT] = 0;
+		if (currentTicks - connection.LastStatResetTime > g_TimerMan.GetTicksPerSecond() || currentTicks - connection.LastStatResetTime < -g_TimerMan.GetTicksPerSecond()) {
+			connection.LastStatResetTime = currentTicks;
+
+			connection.Stats.DataUncompressedCurrent[STAT_SHOWN] = connection.Stats.DataUncompressedCurrent[STAT_CURRENT];
+			connection.Stats.DataSentCurrent[STAT_SHOWN] = connection.Stats.DataSentCurrent[STAT_CURRENT];
+			connection.Stats.FrameDataSentCurrent[STAT_SHOWN] = connection.Stats.FrameDataSentCurrent[STAT_CURRENT];
+			connection.Stats.PostEffectDataSentCurrent[STAT_SHOWN] = connection.Stats.PostEffectDataSentCurrent[STAT_CURRENT];
+			connection.Stats.SoundDataSentCurrent[STAT_SHOWN] = connection.Stats.SoundDataSentCurrent[STAT_CURRENT];
+			connection.Stats.TerrainDataSentCurrent[STAT_SHOWN] = connection.Stats.TerrainDataSentCurrent[STAT_CURRENT];
+			connection.Stats.OtherDataSentCurrent[STAT_SHOWN] = connection.Stats.OtherDataSentCurrent[STAT_CURRENT];
+
+			connection.Stats.DataUncompressedCurrent[STAT_CURRENT] = 0;
+			connection.Stats.DataSentCurrent[STAT_CURRENT] = 0;
+			connection.Stats.FrameDataSentCurrent[STAT_CURRENT] = 0;
+			connection.Stats.PostEffectDataSentCurrent[STAT_CURRENT] = 0;
+			connection.Stats.SoundDataSentCurrent[STAT_CURRENT] = 0;
+			connection.Stats.TerrainDataSentCurrent[STAT_CURRENT] = 0;
+			connection.Stats.OtherDataSentCurrent[STAT_CURRENT] = 0;
 		}
 
-		if (m_PingTimer[player].IsPastRealMS(500)) {
-			m_Ping[player] = m_Server->GetLastPing(m_ClientConnections[player].ClientId);
-			m_PingTimer[player].Reset();
+		if (connection.PingTimer.IsPastRealMS(500)) {
+			connection.Ping = m_Server->GetLastPing(connection.ClientId);
+			connection.PingTimer.Reset();
 		}
 	}
 
@@ -1558,93 +1777,176 @@ namespace RTE {
 			g_FrameMan.GetLargeFont()->DrawAligned(&guiBMP, midX, 50, "NOT IN GAME ACTIVITY", GUIFont::Centre);
 		}
 
-		m_FramesSent[c_MaxClients] = 0;
-		m_FramesSkipped[c_MaxClients] = 0;
-
-		m_DataUncompressedCurrent[c_MaxClients][STAT_SHOWN] = 0;
-		m_DataSentCurrent[c_MaxClients][STAT_SHOWN] = 0;
-		m_FrameDataSentCurrent[c_MaxClients][STAT_SHOWN] = 0;
-		m_TerrainDataSentCurrent[c_MaxClients][STAT_SHOWN] = 0;
-		m_OtherDataSentCurrent[c_MaxClients][STAT_SHOWN] = 0;
-
-		m_FrameDataSentTotal[c_MaxClients] = 0;
-		m_TerrainDataSentTotal[c_MaxClients] = 0;
-		m_OtherDataSentTotal[c_MaxClients] = 0;
-
-		m_DataUncompressedTotal[c_MaxClients] = 0;
-		m_DataSentTotal[c_MaxClients] = 0;
-
-		m_SendBufferBytes[c_MaxClients] = 0;
-		m_SendBufferMessages[c_MaxClients] = 0;
-
-		m_FullBlocks[c_MaxClients] = 0;
-		m_EmptyBlocks[c_MaxClients] = 0;
-
-
-		for (short i = 0; i < MAX_STAT_RECORDS; i++) {
-			// Update sum
-			if (i < c_MaxClients) {
-				m_FramesSent[c_MaxClients] += m_FramesSent[i];
-				m_FramesSkipped[c_MaxClients] += m_FramesSkipped[i];
-
-				m_DataUncompressedCurrent[c_MaxClients][STAT_SHOWN] += m_DataUncompressedCurrent[i][STAT_SHOWN];
-				m_DataSentCurrent[c_MaxClients][STAT_SHOWN] += m_DataSentCurrent[i][STAT_SHOWN];
-				m_FrameDataSentCurrent[c_MaxClients][STAT_SHOWN] += m_FrameDataSentCurrent[i][STAT_SHOWN];
-				m_TerrainDataSentCurrent[c_MaxClients][STAT_SHOWN] += m_TerrainDataSentCurrent[i][STAT_SHOWN];
-				m_OtherDataSentCurrent[c_MaxClients][STAT_SHOWN] += m_OtherDataSentCurrent[i][STAT_SHOWN];
-
-				m_FrameDataSentTotal[c_MaxClients] += m_FrameDataSentTotal[i];
-				m_TerrainDataSentTotal[c_MaxClients] += m_TerrainDataSentTotal[i];
-				m_OtherDataSentTotal[c_MaxClients] += m_OtherDataSentTotal[i];
-
-				m_DataUncompressedTotal[c_MaxClients] += m_DataUncompressedTotal[i];
-				m_DataSentTotal[c_MaxClients] += m_DataSentTotal[i];
+		// Sum up the totals from the clients connected right now
+		m_TotalStats = NetworkStats{};
+		for (const std::unique_ptr<ClientConnection> &connection : m_ClientConnections) {
+			if (!connection) {
+				continue;
+			}
+			const NetworkStats &stats = connection->Stats;
+			m_TotalStats.FramesSent += stats.FramesSent;
+			m_TotalStats.FramesSkipped += stats.FramesSkipped;
+
+			m_TotalStats.DataUncompressedCurrent[STAT_SHOWN] += stats.DataUncompressedCurrent[STAT_SHOWN];
+			m_TotalStats.DataSentCurrent[STAT_SHOWN] += stats.DataSentCurrent[STAT_SHOWN];
+			m_TotalStats.FrameDataSentCurrent[STAT_SHOWN] += stats.FrameDataSentCurrent[STAT_SHOWN];
+			m_TotalStats.PostEffectDataSentCurrent[STAT_SHOWN] += stats.PostEffectDataSentCurrent[STAT_SHOWN];
+			m_TotalStats.SoundDataSentCurrent[STAT_SHOWN] += stats.SoundDataSentCurrent[STAT_SHOWN];
+			m_TotalStats.TerrainDataSentCurrent[STAT_SHOWN] += stats.TerrainDataSentCurrent[STAT_SHOWN];
+			m_TotalStats.OtherDataSentCurrent[STAT_SHOWN] += stats.OtherDataSentCurrent[STAT_SHOWN];
+
+			m_TotalStats.FrameDataSentTotal += stats.FrameDataSentTotal;
+			m_TotalStats.TerrainDataSentTotal += stats.TerrainDataSentTotal;
+			m_TotalStats.OtherDataSentTotal += stats.OtherDataSentTotal;
+
+			m_TotalStats.DataUncompressedTotal += stats.DataUncompressedTotal;
+			m_TotalStats.DataSentTotal += stats.DataSentTotal;
+
+			m_TotalStats.SendBufferBytes += stats.SendBufferBytes;
+			m_TotalStats.SendBufferMessages += stats.SendBufferMessages;
+
+			m_TotalStats.FullBlocks += stats.FullBlocks;
+			m_TotalStats.EmptyBlocks += stats.EmptyBlocks;
+		}
 
-				m_SendBufferBytes[c_MaxClients] += m_SendBufferBytes[i];
-				m_SendBufferMessages[c_MaxClients] += m_SendBufferMessages[i];
+		const NetworkStats noStats = NetworkStats{};
+		int columnWidth = g_FrameMan.GetResX() / (c_MaxClients + 1);
 
-				m_FullBlocks[c_MaxClients] += m_FullBlocks[i];
-				m_EmptyBlocks[c_MaxClients] += m_EmptyBlocks[i];
-			}
+		for (short i = 0; i <= c_MaxClients; i++) {
+			bool isTotal = i == c_MaxClients;
+			const ClientConnection *connection = isTotal ? nullptr : m_ClientConnections[i].get();
+			const NetworkStats &stats = isTotal ? m_TotalStats : (connection ? connection->Stats : noStats);
 
 			// Update compression ratio
-			double compressionRatio = (m_DataUncompressedTotal[i] > 0) ? static_cast<double>(m_DataSentTotal[i]) / static_cast<double>(m_DataUncompressedTotal[i]) : 0;
-			double emptyRatio = (m_EmptyBlocks[i] > 0) ? static_cast<double>(m_FullBlocks[i]) / static_cast<double>(m_EmptyBlocks[i]) : 0;
+			double compressionRatio = (stats.DataUncompressedTotal > 0) ? static_cast<double>(stats.DataSentTotal) / static_cast<double>(stats.DataUncompressedTotal) : 0;
+			double emptyRatio = (stats.EmptyBlocks > 0) ? static_cast<double>(stats.FullBlocks) / static_cast<double>(stats.EmptyBlocks) : 0;
 
 			int fps = 0;
-			if (m_MsecPerFrame[i] > 0) { fps = 1000 / m_MsecPerFrame[i]; }
+			if (connection && connection->MsecPerFrame > 0) { fps = 1000 / connection->MsecPerFrame; }
 			std::string playerName = IsPlayerConnected(i) ? GetPlayerName(i) : "- NO PLAYER -";
 
 			// Jesus christ
 			std::snprintf(buf, sizeof(buf),
 					  "%s\nPing %u\nCmp Mbit: %.1f\nUnc Mbit: %.1f\nR: %.2f\nFrame Kbit: %lu\nGlow Kbit: %lu\nSound Kbit: %lu\nScene Kbit: %lu\nFrames sent: %uK\nFrame skipped: %uK\nBlocks full: %uK\nBlocks empty: %uK\nBlk Ratio: %.2f\nFPS: %d\nSend Ms %d\nTotal Data %lu MB",
-					  (i == c_MaxClients) ? "- TOTALS - " : playerName.c_str(),
-					  (i < c_MaxClients) ? m_Ping[i] : 0,
-					  static_cast<double>(m_DataSentCurrent[i][STAT_SHOWN]) / 125000,
-					  static_cast<double>(m_DataUncompressedCurrent[i][STAT_SHOWN]) / 125000,
+					  isTotal ? "- TOTALS - " : playerName.c_str(),
+					  connection ? connection->Ping : 0,
+					  static_cast<double>(stats.DataSentCurrent[STAT_SHOWN]) / 125000,
+					  static_cast<double>(stats.DataUncompressedCurrent[STAT_SHOWN]) / 125000,
 					  compressionRatio,
-					  m_FrameDataSentCurrent[i][STAT_SHOWN] / 125,
-					  m_PostEffectDataSentCurrent[i][STAT_SHOWN] / 125,
-					  m_SoundDataSentCurrent[i][STAT_SHOWN] / 125,
-					  m_TerrainDataSentCurrent[i][STAT_SHOWN] / 125,
-					  m_FramesSent[i] / 1000,
-					  m_FramesSkipped[i] / 1000,
-					  m_FullBlocks[i] / 1000,
-					  m_EmptyBlocks[i] / 1000,
+					  stats.FrameDataSentCurrent[STAT_SHOWN] / 125,
+					  stats.PostEffectDataSentCurrent[STAT_SHOWN] / 125,
+					  stats.SoundDataSentCurrent[STAT_SHOWN] / 125,
+					  stats.TerrainDataSentCurrent[STAT_SHOWN] / 125,
+					  stats.FramesSent / 1000,
+					  stats.FramesSkipped / 1000,
+					  stats.FullBlocks / 1000,
+					  stats.EmptyBlocks / 1000,
 					  emptyRatio,
-					  (i < c_MaxClients) ? fps : 0,
-					  (i < c_MaxClients) ? m_MsecPerSendCall[i] : 0,
-					  m_DataSentTotal[i] / (1024 * 1024)
+					  fps,
+					  connection ? connection->MsecPerSendCall : 0,
+					  stats.DataSentTotal / (1024 * 1024)
 			);
 
-			g_FrameMan.GetLargeFont()->DrawAligned(&guiBMP, 10 + i * g_FrameMan.GetResX() / 5, 75, buf, GUIFont::Left);
+			g_FrameMan.GetLargeFont()->DrawAligned(&guiBMP, 10 + i * columnWidth, 75, buf, GUIFont::Left);
+
+			if (!isTotal) {
+				int lines = 7;
+				std::snprintf(buf, sizeof(buf), "Thread: %d\nBuffer: %d / %d\nQuality: %d%s\nFPS %d  Box %dx%d\nLZ4: %d%s\nLink Kbit: %lu\nQueue Ms: %d",
+						  connection ? connection->ThreadExitReason : 0, stats.SendBufferMessages, stats.SendBufferBytes / 1024,
+						  connection ? connection->QualityLevel : 0,
+						  (connection && connection->UseInterlacing) ? " Intl" : "",
+						  connection ? connection->EncodingFps : 0,
+						  connection ? connection->BoxWidth : 0,
+						  m_BoxHeight,
+						  connection ? connection->CompressionLevel : 0,
+						  m_UseHighCompression ? " HC" : "",
+						  connection ? connection->EstimatedBandwidth / 125 : 0,
+						  connection ? connection->QueueDelay : 0
+				);
+				g_FrameMan.GetLargeFont()->DrawAligned(&guiBMP, 10 + i * columnWidth, g_FrameMan.GetResY() - lines * 15, buf, GUIFont::Left);
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool NetworkServer::SetStatisticsCSVPath(const std::string &filePath) {
+		m_StatisticsCSV.open(filePath, std::ios_base::out | std::ios_base::trunc);
+		if (!m_StatisticsCSV.is_open()) {
+			return false;
+		}
+		m_StatisticsCSV << "TimeS,Client,Name,Ping,SentKbit,UncompressedKbit,CompressionRatio,FrameKbit,PostEffectKbit,SoundKbit,TerrainKbit,OtherKbit,FramesSent,FramesSkipped,DelayedFrames,FullBlocks,EmptyBlocks,FPS,SendMs,SendBufferMessages,SendBufferKB,TotalSentMB,SimUpdateMs,SimLoad,QualityLevel,EncodingFps,Interlacing,BoxWidth,CompressionLevel,EstimatedKbit,QueueDelayMs\n";
+		m_StatisticsCSVTimer.Reset();
+		m_StatisticsCSVStartTimer.Reset();
+		return true;
+	}
 
-			if (i < c_MaxClients) {
-				int lines = 2;
-				std::snprintf(buf, sizeof(buf), "Thread: %d\nBuffer: %d / %d", m_ThreadExitReason[i], m_SendBufferMessages[i], m_SendBufferBytes[i] / 1024);
-				g_FrameMan.GetLargeFont()->DrawAligned(&guiBMP, 10 + i * g_FrameMan.GetResX() / 5, g_FrameMan.GetResY() - lines * 15, buf, GUIFont::Left);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::WriteStatisticsCSV() {
+		float simLoad = g_PerformanceMan.GetSimLoad();
+		double simUpdateMs = static_cast<double>(simLoad * g_TimerMan.GetDeltaTimeMS());
+
+		char buf[512];
+		for (short i = 0; i <= c_MaxClients; i++) {
+			bool isTotal = i == c_MaxClients;
+			if (!isTotal && !IsPlayerConnected(i)) {
+				continue;
+			}
+			const ClientConnection *connection = isTotal ? nullptr : m_ClientConnections[i].get();
+			const NetworkStats &stats = isTotal ? m_TotalStats : connection->Stats;
+
+			double compressionRatio = (stats.DataUncompressedTotal > 0) ? static_cast<double>(stats.DataSentTotal) / static_cast<double>(stats.DataUncompressedTotal) : 0;
+			int fps = (connection && connection->MsecPerFrame > 0) ? 1000 / connection->MsecPerFrame : 0;
+			int delayedFrames = 0;
+			if (isTotal) {
+				for (const std::unique_ptr<ClientConnection> &otherConnection : m_ClientConnections) {
+					if (otherConnection) { delayedFrames += otherConnection->DelayedFrames; }
+				}
+			} else {
+				delayedFrames = connection->DelayedFrames;
 			}
+
+			// Names can have commas in them, so they're quoted
+			std::string name = isTotal ? "TOTALS" : GetPlayerName(i);
+			std::replace(name.begin(), name.end(), '"', '\'');
+
+			std::snprintf(buf, sizeof(buf), "%.1f,%s,\"%s\",%u,%.1f,%.1f,%.3f,%lu,%lu,%lu,%lu,%lu,%u,%u,%d,%d,%d,%d,%d,%d,%d,%lu,%.2f,%.3f,%d,%d,%d,%d,%d,%lu,%d\n",
+				m_StatisticsCSVStartTimer.GetElapsedRealTimeS(),
+				isTotal ? "Total" : std::to_string(i).c_str(),
+				name.c_str(),
+				connection ? connection->Ping : 0,
+				static_cast<double>(stats.DataSentCurrent[STAT_SHOWN]) / 125,
+				static_cast<double>(stats.DataUncompressedCurrent[STAT_SHOWN]) / 125,
+				compressionRatio,
+				stats.FrameDataSentCurrent[STAT_SHOWN] / 125,
+				stats.PostEffectDataSentCurrent[STAT_SHOWN] / 125,
+				stats.SoundDataSentCurrent[STAT_SHOWN] / 125,
+				stats.TerrainDataSentCurrent[STAT_SHOWN] / 125,
+				stats.OtherDataSentCurrent[STAT_SHOWN] / 125,
+				stats.FramesSent,
+				stats.FramesSkipped,
+				delayedFrames,
+				stats.FullBlocks,
+				stats.EmptyBlocks,
+				fps,
+				connection ? connection->MsecPerSendCall : 0,
+				stats.SendBufferMessages,
+				stats.SendBufferBytes / 1024,
+				stats.DataSentTotal / (1024 * 1024),
+				simUpdateMs,
+				simLoad,
+				connection ? connection->QualityLevel : 0,
+				connection ? connection->EncodingFps : 0,
+				(connection && connection->UseInterlacing) ? 1 : 0,
+				connection ? connection->BoxWidth : 0,
+				connection ? connection->CompressionLevel : 0,
+				connection ? connection->EstimatedBandwidth / 125 : 0,
+				connection ? connection->QueueDelay : 0
+			);
+			m_StatisticsCSV << buf;
 		}
+		m_StatisticsCSV.flush();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1676,9 +1978,13 @@ namespace RTE {
 
 		if (processInput) {
 			for (short player = 0; player < c_MaxClients; player++) {
-				if (!m_InputMessages[player].empty()) {
-					MsgInput msg = m_InputMessages[player].front();
-					m_InputMessages[player].pop();
+				if (!m_ClientConnections[player]) {
+					continue;
+				}
+				ClientConnection &connection = *m_ClientConnections[player];
+				if (!connection.InputMessages.empty()) {
+					MsgInput msg = connection.InputMessages.front();
+					connection.InputMessages.pop();
 					ProcessInputMsg(player, msg);
 				}
 			}
@@ -1689,7 +1995,7 @@ namespace RTE {
 			for (short player = 0; player < c_MaxClients; player++) {
 				if (IsPlayerConnected(player)) {
 					votesNeeded++;
-					if (m_ResetActivityVotes[player]) { votes++; }
+					if (m_ClientConnections[player]->ResetActivityVote) { votes++; }
 				}
 			}
 			if (votes > 0) {
@@ -1703,7 +2009,7 @@ namespace RTE {
 			}
 			if (votes == votesNeeded && votesNeeded > 0) {
 				for (short player = 0; player < c_MaxClients; player++) {
-					m_ResetActivityVotes[player] = false;
+					if (m_ClientConnections[player]) { m_ClientConnections[player]->ResetActivityVote = false; }
 				}
 				// Only reset gameplay activities, and not server lobby
 				if (g_InActivity && g_ActivityMan.GetActivity()->GetPresetName() != "Multiplayer Lobby") {
@@ -1715,6 +2021,10 @@ namespace RTE {
 		}
 
 		DrawStatisticsData();
+		if (m_StatisticsCSV.is_open() && m_StatisticsCSVTimer.IsPastRealMS(1000)) {
+			WriteStatisticsCSV();
+			m_StatisticsCSVTimer.Reset();
+		}
 
 		// Clear sound events for unconnected players because AudioMan does not know about their state and stores broadcast sounds to their event lists
 		std::list<AudioMan::NetworkSoundData> soundList;
@@ -1786,6 +2096,9 @@ namespace RTE {
 				case ID_CLT_INPUT:
 					ReceiveInputMsg(packet);
 					break;
+				case ID_RLY_REGISTER:
+					ReceiveRelayRegisterMsg(packet);
+					break;
 				case ID_CLT_SCENE_ACCEPTED:
 					ReceiveSceneAcceptedMsg(packet);
 					break;
@@ -1825,7 +2138,7 @@ namespace RTE {
 						bsIn.IgnoreBytes(1);
 						bsIn.Read(time);
 						dataLength = packet->length - sizeof(unsigned char) - sizeof(RakNet::TimeMS);
-						m_Ping[player] = (unsigned int)(RakNet::GetTimeMS() - time);
+						connection.Ping = (unsigned int)(RakNet::GetTimeMS() - time);
 					}
 					break;
 				}
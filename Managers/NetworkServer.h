@@ -26,8 +26,7 @@ namespace RTE {
 		/// </summary>
 		enum NetworkServerStats {
 			STAT_CURRENT = 0,
-			STAT_SHOWN,
-			MAX_STAT_RECORDS = 5
+			STAT_SHOWN
 		};
 
 		/// <summary>
@@ -90,14 +89,14 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player">The player to check for.</param>
 		/// <returns>A string with the network player's name.</returns>
-		std::string & GetPlayerName(short player) { return m_ClientConnections[player].PlayerName; }
+		std::string GetPlayerName(short player) const { return m_ClientConnections[player] ? m_ClientConnections[player]->PlayerName : ""; }
 
 		/// <summary>
 		/// Gets whether the specified player is connected to the server or not.
 		/// </summary>
 		/// <param name="player">The player to check for.</param>
 		/// <returns>Whether the player is connected to the server or not.</returns>
-		bool IsPlayerConnected(short player) const { return m_ClientConnections[player].IsActive; }
+		bool IsPlayerConnected(short player) const { return m_ClientConnections[player] && m_ClientConnections[player]->IsActive; }
 
 		/// <summary>
 		/// Sets the port this server will be using.
@@ -116,14 +115,21 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player">The player to set for.</param>
 		/// <param name="msecs">Milliseconds to sleep for.</param>
-		void SetMSecsToSleep(short player, int msecs) { m_MSecsToSleep[player] = msecs; };
+		void SetMSecsToSleep(short player, int msecs) { m_ClientConnections[player]->MSecsToSleep = msecs; };
 
 		/// <summary>
 		/// Gets the ping time of the specified player.
 		/// </summary>
 		/// <param name="player">The player to get for.</param>
 		/// <returns>The ping time of the player.</returns>
-		unsigned short GetPing(short player) const { return m_Ping[player]; }
+		unsigned short GetPing(short player) const { return m_ClientConnections[player] ? m_ClientConnections[player]->Ping : 0; }
+
+		/// <summary>
+		/// Starts writing the server statistics to a CSV file once a second, one row per connected player plus one for the totals, so load tests can be compared automatically.
+		/// </summary>
+		/// <param name="filePath">The path of the CSV file to write. Overwritten if it exists.</param>
+		/// <returns>Whether the file could be opened for writing.</returns>
+		bool SetStatisticsCSVPath(const std::string &filePath);
 #pragma endregion
 
 #pragma region Concrete Methods
@@ -169,88 +175,184 @@ namespace RTE {
 	protected:
 
 		/// <summary>
-		/// 
+		/// Network statistics of one client, or of all of them summed up.
+		/// </summary>
+		struct NetworkStats {
+			unsigned int FramesSent; //!< Number of frames sent.
+			unsigned int FramesSkipped; //!< Number of frames skipped because the connection was congested.
+			int EmptyBlocks; //!<
+			int FullBlocks; //!<
+			int SendBufferBytes; //!<
+			int SendBufferMessages; //!<
+
+			unsigned long DataSentCurrent[2]; //!<
+			unsigned long DataSentTotal; //!<
+
+			unsigned long DataUncompressedCurrent[2]; //!<
+			unsigned long DataUncompressedTotal; //!<
+
+			unsigned long FrameDataSentCurrent[2]; //!<
+			unsigned long FrameDataSentTotal; //!<
+
+			unsigned long PostEffectDataSentCurrent[2]; //!<
+			unsigned long PostEffectDataSentTotal; //!<
+
+			unsigned long SoundDataSentCurrent[2]; //!<
+			unsigned long SoundDataSentTotal; //!<
+
+			unsigned long TerrainDataSentCurrent[2]; //!<
+			unsigned long TerrainDataSentTotal; //!<
+
+			unsigned long OtherDataSentCurrent[2]; //!<
+			unsigned long OtherDataSentTotal; //!<
+		};
+
+		/// <summary>
+		/// Everything the server keeps for one client. Allocated when the client connects and freed once it's gone, so an empty slot costs nothing but a pointer.
+		/// The copies of the client's frame are sized to the resolution it registered with.
 		/// </summary>
 		struct ClientConnection {
-			bool IsActive; //!<
+			/// <summary>
+			/// Constructor method used to instantiate a ClientConnection for a client that just connected, allocating its compression states.
+			/// </summary>
+			/// <param name="clientId">The address of the client.</param>
+			/// <param name="internalId">The internal address of the client, if it has one.</param>
+			ClientConnection(const RakNet::SystemAddress &clientId, const RakNet::SystemAddress &internalId);
+
+			/// <summary>
+			/// Destructor method used to free the compression states and frame copies of a ClientConnection. The send thread has to be joined before this.
+			/// </summary>
+			~ClientConnection();
+
+			std::atomic<bool> IsActive; //!< Whether the client registered and is being sent the game.
 			RakNet::SystemAddress ClientId; //!<
 			RakNet::SystemAddress InternalId; //!<
 			int ResX; //!<
 			int ResY; //!<
 			std::thread *SendThread; //!<
 			std::string PlayerName; //!<
+
+			int ThreadExitReason; //!<
+			long MSecsSinceLastUpdate; //!<
+			long MSecsToSleep; //!<
+
+			unsigned char PixelLineBuffer[c_MaxPixelLineBufferSize]; //!<
+			unsigned char TerrainChangeBuffer[c_MaxPixelLineBufferSize]; //!<
+
+			BITMAP *BackBuffer8; //!<
+			BITMAP *BackBufferGUI8; //!<
+
+			void *LZ4CompressionState; //!<
+			void *LZ4FastCompressionState; //!<
+
+			int MouseState1; //!<
+			int MouseState2; //!<
+			int MouseState3; //!<
+
+			bool SendEven; //!<
+
+			std::atomic<bool> SendSceneSetupData; //!<
+			std::atomic<bool> SendSceneData; //!<
+			std::atomic<bool> SendFrameData; //!<
+
+			std::mutex Mutex; //!<
+			std::queue<SceneMan::TerrainChange> PendingTerrainChanges; //!<
+			std::queue<SceneMan::TerrainChange> CurrentTerrainChanges; //!<
+
+			std::queue<MsgInput> InputMessages; //!<
+			bool ResetActivityVote; //!<
+
+			int FrameNumber; //!<
+
+			unsigned short Ping; //!<
+			Timer PingTimer; //!<
+
+			int DelayedFrames; //!<
+			int MsecPerFrame; //!<
+			int MsecPerSendCall; //!<
+
+			long long LastFrameSentTime; //!<
+			long long LastStatResetTime; //!<
+
+			NetworkStats Stats; //!<
+
+			int QualityLevel; //!< The step of the quality ladder this client is sent at. 0 is the configured settings.
+			int EncodingFps; //!< The frame rate this client is sent at.
+			bool UseInterlacing; //!< Whether this client is sent interlaced frames.
+			int BoxWidth; //!< The width of the boxes this client is sent frames in.
+			int CompressionLevel; //!< The LZ4HC level this client's frames are compressed with, or the acceleration factor when using fast compression.
+			bool CompressionLimitedByTime; //!< Whether sending took too long last time to afford compressing harder than configured.
+			int QueueDelay; //!< How many milliseconds the data waiting in this client's send buffer takes to go out at the current send rate.
+			unsigned long EstimatedBandwidth; //!< Estimate of how many bytes per second the link to this client carries.
+			unsigned int FramesSkippedAtQualityUpdate; //!< The number of skipped frames when the quality level was last updated, to tell whether any were skipped since.
+			bool ProbingQuality; //!< Whether the last change was a step up that hasn't proven itself yet.
+			int QualityProbeHoldMS; //!< How long the link has to stay clear before stepping up. Doubles every time a step up congests the link right away.
+			Timer QualityUpdateTimer; //!< Timer for updating the quality level every c_QualityUpdateIntervalMS.
+			Timer QualityStepTimer; //!< Time since the quality level last changed.
+			Timer QualityClearTimer; //!< Time since the link was last congested.
+
+			// Disallow the use of some implicit methods.
+			ClientConnection(const ClientConnection &reference) = delete;
+			ClientConnection & operator=(const ClientConnection &rhs) = delete;
 		};
 
-		static const std::string c_ClassName; //!< A string with the friendly-formatted type name of this object.
+		/// <summary>
+		/// One step of the quality ladder clients are moved along depending on how well their link keeps up. Every step trades some more picture quality for less bandwidth than the one before it.
+		/// </summary>
+		struct QualityStep {
+			float FpsScale; //!< The fraction of the configured encoding fps to send at.
+			bool ForceInterlacing; //!< Whether to interlace even if the configured settings don't.
+			int BoxWidthScale; //!< What to multiply the configured box width by. Bigger boxes compress better and carry less message overhead per pixel.
+			int ExtraCompression; //!< How much higher than configured the LZ4HC level goes, or how much lower the fast acceleration factor goes.
+		};
 
-		bool m_IsInServerMode = false; //!<
+		static const std::string c_ClassName; //!< A string with the friendly-formatted type name of this object.
 
-		int m_ThreadExitReason[c_MaxClients]; //!<
+		static constexpr std::array<QualityStep, 6> c_QualitySteps = {{ { 1.0F, false, 1, 0 }, { 1.0F, false, 1, 2 }, { 0.75F, false, 2, 2 }, { 0.75F, true, 2, 2 }, { 0.5F, true, 2, 2 }, { 0.34F, true, 2, 2 } }}; //!< The quality ladder. Step 0 is the configured settings.
+		static constexpr int c_QualityUpdateIntervalMS = 500; //!< How often the quality level of each client is reconsidered.
+		static constexpr int c_QualityStepDownIntervalMS = 1000; //!< How long a step down gets to take effect before stepping down again, since the send buffer takes a while to drain.
+		static constexpr int c_TargetQueueDelayMS = 100; //!< How long data may wait in a client's send buffer before the link counts as congested.
+		static constexpr int c_MinQualityProbeHoldMS = 3000; //!< How long the link has to stay clear before stepping up, unless step ups failed recently.
+		static constexpr int c_MaxQualityProbeHoldMS = 30000; //!< The longest the link has to stay clear before stepping up, after step ups failed repeatedly.
 
-		long m_MSecsSinceLastUpdate[c_MaxClients]; //!<
-		long m_MSecsToSleep[c_MaxClients]; //!<
+		bool m_IsInServerMode = false; //!<
 
 		RakNet::RakPeerInterface *m_Server; //!<
 
 		std::string m_ServerPort; //!<
 
-		ClientConnection m_ClientConnections[c_MaxClients]; //!<
+		std::unique_ptr<ClientConnection> m_ClientConnections[c_MaxClients]; //!< The connection of each player slot, or nullptr if nobody is connected in it.
 
 		RakNet::NatPunchthroughClient m_NATPunchthroughClient; //!<
 		RakNet::SystemAddress m_NATServiceServerID; //!<
 		bool m_NatServerConnected; //!<
 
-		unsigned char m_PixelLineBuffer[c_MaxClients][c_MaxPixelLineBufferSize]; //!<
-
-		BITMAP *m_BackBuffer8[c_MaxClients]; //!<
-		BITMAP *m_BackBufferGUI8[c_MaxClients]; //!<
-
-		void *m_LZ4CompressionState[c_MaxClients]; //!<
-		void *m_LZ4FastCompressionState[c_MaxClients]; //!<
-
-		int m_MouseState1[c_MaxClients]; //!<
-		int m_MouseState2[c_MaxClients]; //!<
-		int m_MouseState3[c_MaxClients]; //!<
-
-		int m_MouseEvent1[c_MaxClients]; //!<
-		int m_MouseEvent2[c_MaxClients]; //!<
-		int m_MouseEvent3[c_MaxClients]; //!<
-
 		bool m_UseHighCompression; //!<
 		bool m_UseFastCompression; //!<
 		int m_HighCompressionLevel; //!<
 		int m_FastAccelerationFactor; //!<
 		bool m_UseInterlacing; //!<
 		int m_EncodingFps; //!<
-
-		bool m_SendEven[c_MaxClients]; //!<
+		bool m_UseAdaptiveQuality; //!< Whether each client's frame rate, interlacing, box size and compression are adapted to what its link keeps up with, instead of all being sent at the configured settings.
 
 		bool m_ShowStats; //!<
 		bool m_ShowInput; //!<
 
-		bool m_SendSceneSetupData[c_MaxClients]; //!<
-		bool m_SendSceneData[c_MaxClients]; //!<
-		bool m_SceneAvailable[c_MaxClients]; //!<
-		bool m_SendFrameData[c_MaxClients]; //!<
-		std::mutex m_SceneLock[c_MaxClients]; //!<
-
-		unsigned char m_TerrainChangeBuffer[c_MaxClients][c_MaxPixelLineBufferSize]; //!<
-		std::queue<SceneMan::TerrainChange> m_PendingTerrainChanges[c_MaxClients]; //!<
-		std::queue<SceneMan::TerrainChange> m_CurrentTerrainChanges[c_MaxClients]; //!<
-
-		std::mutex m_Mutex[c_MaxClients]; //!<
+		std::atomic<bool> m_SceneAvailable; //!< Whether a scene was loaded and can be sent to clients.
+		std::shared_mutex m_SceneLock; //!< Held shared by send threads transferring the scene and exclusively while a new scene loads.
 
-		//std::mutex m_InputQueueMutex[c_MaxClients];
-		std::queue<MsgInput> m_InputMessages[c_MaxClients]; //!<
+		std::mutex m_EncodeSchedulerMutex; //!< Mutex lock for the encode scheduler.
+		std::condition_variable m_EncodeSchedulerCondition; //!< Signaled when an encode slot frees up or a waiting client goes away.
+		std::deque<short> m_EncodeQueue; //!< The players waiting for an encode slot, in the order their frames became due.
+		int m_EncodersRunning; //!< How many send threads are encoding a frame right now.
+		int m_MaxConcurrentEncoders; //!< How many send threads can encode a frame at once. Leaves a core for the simulation.
 
 		unsigned char m_SceneID; //!<
 
-		bool m_ResetActivityVotes[c_MaxClients]; //!<
-
-		int m_FrameNumbers[c_MaxClients]; //!<
-
-		unsigned short m_Ping[c_MaxClients]; //!< 
-		Timer m_PingTimer[c_MaxClients]; //!<
+		mutable std::mutex m_RelayMutex; //!< Mutex lock for the spectator relay's address and watched player, which the main thread changes while send threads read them.
+		RakNet::SystemAddress m_RelayId; //!< The address of the connected spectator relay, if any.
+		short m_RelayPlayer; //!< The player whose stream is mirrored to the spectator relay. -1 if no relay is connected.
+		std::atomic<bool> m_SendRelaySceneData; //!< Whether the spectator relay still needs the current scene because it connected after the watched player got it.
 
 		Timer m_LastPackedReceived; //!<
 
@@ -259,40 +361,11 @@ namespace RTE {
 		int m_BoxWidth; //!<
 		int m_BoxHeight; //!<
 
-		int m_EmptyBlocks[MAX_STAT_RECORDS]; //!<
-		int m_FullBlocks[MAX_STAT_RECORDS]; //!<
-		int m_SendBufferBytes[MAX_STAT_RECORDS]; //!<
-		int m_SendBufferMessages[MAX_STAT_RECORDS]; //!<
-		int m_DelayedFrames[c_MaxClients]; //!<
-		int m_MsecPerFrame[c_MaxClients]; //!<
-		int m_MsecPerSendCall[c_MaxClients]; //!<
-
-		long long m_LastFrameSentTime[c_MaxClients]; //!<
-		long long m_LastStatResetTime[c_MaxClients]; //!<
+		NetworkStats m_TotalStats; //!< The statistics of all connected clients summed up, updated when they're drawn.
 
-		unsigned int m_FramesSent[MAX_STAT_RECORDS]; //!< Number of frames sent by the server to each client and total.
-		unsigned int m_FramesSkipped[MAX_STAT_RECORDS]; //!< Numbers of frames skipped by the server for each client and total.
-
-		unsigned long m_DataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long m_DataSentTotal[MAX_STAT_RECORDS]; //!<
-
-		unsigned long m_DataUncompressedTotal[MAX_STAT_RECORDS]; //!<
-		unsigned long m_DataUncompressedCurrent[MAX_STAT_RECORDS][2]; //!<
-
-		unsigned long m_FrameDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long m_FrameDataSentTotal[MAX_STAT_RECORDS]; //!<
-
-		unsigned long  m_PostEffectDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long  m_PostEffectDataSentTotal[MAX_STAT_RECORDS]; //!<
-
-		unsigned long  m_SoundDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long  m_SoundDataSentTotal[MAX_STAT_RECORDS]; //!<
-
-		unsigned long  m_TerrainDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long  m_TerrainDataSentTotal[MAX_STAT_RECORDS]; //!<
-
-		unsigned long m_OtherDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
-		unsigned long m_OtherDataSentTotal[MAX_STAT_RECORDS]; //!<
+		std::ofstream m_StatisticsCSV; //!< The CSV file the statistics are written to, if one was set.
+		Timer m_StatisticsCSVTimer; //!< Timer for writing a row of statistics to the CSV file once a second.
+		Timer m_StatisticsCSVStartTimer; //!< Timer for the time column of the CSV file, started when the file was opened.
 
 	private:
 
@@ -309,7 +382,19 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player"></param>
 		/// <param name="reason"></param>
-		void SetThreadExitReason(short player, int reason) { m_ThreadExitReason[player] = reason; };
+		void SetThreadExitReason(short player, int reason) { m_ClientConnections[player]->ThreadExitReason = reason; };
+
+		/// <summary>
+		/// Waits for a turn to encode a frame for a player. Players get turns in the order their frames became due and only a few encode at once, so no client can starve the others or the simulation of CPU time however many are connected.
+		/// </summary>
+		/// <param name="player">The player whose frame is due.</param>
+		/// <returns>Whether the player got a turn. False if it disconnected or the server is shutting down while waiting.</returns>
+		bool AcquireEncodeSlot(short player);
+
+		/// <summary>
+		/// Ends a turn given by AcquireEncodeSlot, letting the next waiting player encode.
+		/// </summary>
+		void ReleaseEncodeSlot();
 #pragma endregion
 
 #pragma region Network Event Handling
@@ -338,12 +423,51 @@ namespace RTE {
 		/// <param name="packet"></param>
 		void ReceiveDisconnection(RakNet::Packet *packet);
 
+		/// <summary>
+		/// Frees a player slot, waiting for its send thread to finish first so the connection can be deleted safely.
+		/// </summary>
+		/// <param name="player">The player whose slot to free.</param>
+		void DestroyClientConnection(short player);
+
 		/// <summary>
 		/// 
 		/// </summary>
 		/// <param name="packet"></param>
 		void ReceiveRegisterMsg(RakNet::Packet *packet);
 
+		/// <summary>
+		/// Registers a spectator relay and starts mirroring the stream of the player it asked for to it. The relay doesn't take up a player slot.
+		/// Relays are only accepted if they give the password set in SettingsMan, and none are accepted if it's empty.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgRegisterRelay.</param>
+		void ReceiveRelayRegisterMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Gets whether a spectator relay is connected and watching the specified player.
+		/// </summary>
+		/// <param name="player">The player to check for.</param>
+		/// <returns>Whether the player's stream is mirrored to a spectator relay.</returns>
+		bool IsRelayWatchingPlayer(short player) const { return GetRelayAddress(player) != RakNet::UNASSIGNED_SYSTEM_ADDRESS; }
+
+		/// <summary>
+		/// Gets the address of the spectator relay if it's watching the specified player. Safe to use from the send threads.
+		/// </summary>
+		/// <param name="player">The player to check for.</param>
+		/// <returns>The address of the relay, or UNASSIGNED_SYSTEM_ADDRESS if no relay is watching the player.</returns>
+		RakNet::SystemAddress GetRelayAddress(short player) const { std::lock_guard<std::mutex> relayLock(m_RelayMutex); return (m_RelayPlayer >= 0 && m_RelayPlayer == player) ? m_RelayId : RakNet::UNASSIGNED_SYSTEM_ADDRESS; }
+
+		/// <summary>
+		/// Sends a message to a player, and to the spectator relay as well if it's watching that player, so the relay gets the exact packets the player does without encoding anything twice.
+		/// Reliable messages go to the relay ordered, so it applies scene lines and terrain changes to its copy of the terrain in the order they were sent.
+		/// </summary>
+		/// <param name="player">The player to send to.</param>
+		/// <param name="data">The message to send.</param>
+		/// <param name="size">The size of the message in bytes.</param>
+		/// <param name="priority">The RakNet priority to send with.</param>
+		/// <param name="reliability">The RakNet reliability to send with.</param>
+		/// <param name="relayOnly">Whether to send to the spectator relay only, when catching it up.</param>
+		void SendPlayerPacket(short player, const char *data, int size, PacketPriority priority, PacketReliability reliability, bool relayOnly = false);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -363,12 +487,6 @@ namespace RTE {
 		/// <param name="msg"></param>
 		void ProcessInputMsg(short player, MsgInput msg);
 
-		/// <summary>
-		/// 
-		/// </summary>
-		/// <param name="player"></param>
-		void ClearInputMessages(short player);
-
 		/// <summary>
 		/// 
 		/// </summary>
@@ -388,20 +506,28 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player"></param>
 		/// <returns></returns>
-		bool IsSceneAvailable(short player) const { return m_SceneAvailable[player]; }
+		bool IsSceneAvailable(short player) const { return m_SceneAvailable; }
 
 		/// <summary>
 		/// 
 		/// </summary>
 		/// <param name="player"></param>
 		/// <returns></returns>
-		bool NeedToSendSceneSetupData(short player) const { return m_SendSceneSetupData[player]; }
+		bool NeedToSendSceneSetupData(short player) const { return m_ClientConnections[player]->SendSceneSetupData; }
+
+		/// <summary>
+		/// Gets whether the spectator relay watching the specified player still needs to be sent the current scene.
+		/// </summary>
+		/// <param name="player">The player to check for.</param>
+		/// <returns>Whether the relay needs the scene.</returns>
+		bool NeedToSendRelaySceneData(short player) const { return m_SendRelaySceneData && IsRelayWatchingPlayer(player); }
 
 		/// <summary>
 		/// 
 		/// </summary>
 		/// <param name="player"></param>
-		void SendSceneSetupData(short player);
+		/// <param name="relayOnly">Whether to send to the spectator relay only, when catching it up.</param>
+		void SendSceneSetupData(short player, bool relayOnly = false);
 
 		/// <summary>
 		/// 
@@ -414,13 +540,14 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player"></param>
 		/// <returns></returns>
-		bool NeedToSendSceneData(short player) const { return m_SendSceneData[player]; }
+		bool NeedToSendSceneData(short player) const { return m_ClientConnections[player]->SendSceneData; }
 
 		/// <summary>
 		/// 
 		/// </summary>
 		/// <param name="player"></param>
-		void SendSceneData(short player);
+		/// <param name="relayOnly">Whether to send to the spectator relay only, when catching it up.</param>
+		void SendSceneData(short player, bool relayOnly = false);
 
 		/// <summary>
 		/// 
@@ -458,7 +585,8 @@ namespace RTE {
 		/// 
 		/// </summary>
 		/// <param name="player"></param>
-		void SendSceneEndMsg(short player);
+		/// <param name="relayOnly">Whether to send to the spectator relay only, when catching it up.</param>
+		void SendSceneEndMsg(short player, bool relayOnly = false);
 #pragma endregion
 
 #pragma region Network Frame Handling and Drawing
@@ -487,7 +615,7 @@ namespace RTE {
 		/// </summary>
 		/// <param name="player"></param>
 		/// <returns></returns>
-		bool SendFrameData(short player) const { return m_SendFrameData[player]; }
+		bool SendFrameData(short player) const { return m_ClientConnections[player] && m_ClientConnections[player]->SendFrameData; }
 
 		/// <summary>
 		/// 
@@ -495,6 +623,20 @@ namespace RTE {
 		/// <param name="player"></param>
 		void SendPostEffectData(short player);
 
+		/// <summary>
+		/// Sets a player's frame rate, interlacing, box size and compression according to a step of the quality ladder, derived from the configured settings.
+		/// </summary>
+		/// <param name="player">The player to set for.</param>
+		/// <param name="level">The step of the quality ladder.</param>
+		void ApplyQualityLevel(short player, int level);
+
+		/// <summary>
+		/// Estimates the bandwidth of a player's link from the RakNet statistics and the depth of its send buffer, and steps its quality down when data waits longer than c_TargetQueueDelayMS to go out or frames had to be skipped.
+		/// Steps back up after the link stayed clear for a while, waiting longer each time a step up congests it right away. Done every c_QualityUpdateIntervalMS.
+		/// </summary>
+		/// <param name="player">The player to update for.</param>
+		void UpdateQualityLevel(short player);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -514,6 +656,11 @@ namespace RTE {
 		/// 
 		/// </summary>
 		void DrawStatisticsData();
+
+		/// <summary>
+		/// Writes the statistics of every connected player and the totals to the CSV file. The totals are summed up by DrawStatisticsData, so this needs to be done after it.
+		/// </summary>
+		void WriteStatisticsCSV();
 #pragma endregion
 
 #pragma region Update Breakdown
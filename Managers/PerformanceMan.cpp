@@ -2,6 +2,7 @@
 #include "MovableMan.h"
 #include "FrameMan.h"
 #include "AudioMan.h"
+#include "LuaMan.h"
 #include "Timer.h"
 
 #include "GUI.h"
@@ -44,6 +45,7 @@ namespace RTE {
 		m_PerfCounterNames[PERF_PARTICLES_PASS2] = "Prt Update";
 		m_PerfCounterNames[PERF_ACTORS_AI] = "Act AI";
 		m_PerfCounterNames[PERF_ACTIVITY] = "Activity";
+		m_PerfCounterNames[PERF_LUA_GC] = "Lua GC";
 
 		return 0;
 	}
@@ -91,6 +93,20 @@ namespace RTE {
 		g_AudioMan.SetGlobalPitch(pitch);
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PerformanceMan::GetSimLoad() const {
+		// The current sample is still being measured, so start from the one before it
+		unsigned long long totalSimTime = 0;
+		unsigned short sample = m_Sample;
+		for (unsigned short i = 0; i < c_Average; ++i) {
+			if (sample == 0) { sample = c_MaxSamples; }
+			sample--;
+			totalSimTime += m_PerfData[PERF_SIM_TOTAL][sample];
+		}
+		return static_cast<float>(totalSimTime) / static_cast<float>(c_Average) / (g_TimerMan.GetDeltaTimeMS() * 1000.0F);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::ResetFrameTimer() { m_FrameTimer->Reset(); }
@@ -198,6 +214,9 @@ namespace RTE {
 			}
 			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 100, str, GUIFont::Left);
 
+			std::snprintf(str, sizeof(str), "Lua Heap: %zu KB (%.1f KB/update)", g_LuaMan.GetHeapSize() >> 10, g_LuaMan.GetGCAllocationRate() / 1024.0F);
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 110, str, GUIFont::Left);
+
 			// If in split screen mode don't draw graphs because they don't fit anyway.
 			if (m_AdvancedPerfStats && g_FrameMan.GetScreenCount() == 1) { DrawPeformanceGraphs(bitmapToDrawTo); }
 		}
@@ -29,6 +29,7 @@ namespace RTE {
 			PERF_PARTICLES_PASS2,
 			PERF_PARTICLES_PASS1,
 			PERF_ACTIVITY,
+			PERF_LUA_GC,
 			PERF_COUNT
 		};
 
@@ -105,6 +106,12 @@ namespace RTE {
 		/// </summary>
 		/// <param name="showGraphs">Whether to show the performance graphs or not.</param>
 		void ShowAdvancedPerformanceStats(bool showGraphs = true) { m_AdvancedPerfStats = showGraphs; }
+
+		/// <summary>
+		/// Gets how long the last few completed sim updates took on average, as a fraction of the sim time each of them represents. Anything over 1 means the simulation is falling behind real time.
+		/// </summary>
+		/// <returns>The average sim load.</returns>
+		float GetSimLoad() const;
 #pragma endregion
 
 #pragma region Performance Counter Handling
@@ -155,7 +162,7 @@ namespace RTE {
 		const unsigned short c_StatsOffsetX = 17; //!< Offset of the stat text from the left edge of the screen.
 		const unsigned short c_StatsHeight = 14; //!< Height of each stat text line.
 		const unsigned short c_GraphsOffsetX = 14; //!< Offset of the graph from the left edge of the screen.
-		const unsigned short c_GraphsStartOffsetY = 134; //!< Position the first graph block will be drawn from the top edge of the screen.
+		const unsigned short c_GraphsStartOffsetY = 144; //!< Position the first graph block will be drawn from the top edge of the screen.
 		const unsigned short c_GraphHeight = 20; //!< Height of the performance graph.
 		const unsigned short c_GraphBlockHeight = 34; //!< Height of the whole graph block (text height and graph height combined).
 
@@ -38,8 +38,11 @@ namespace RTE
 
 #define CLEANAIRINTERVAL 200000
 #define COMPACTINGHEIGHT 25
+#define STRUCTURALCELLSIZE 64
+#define STRUCTURALSEARCHLIMIT 1048576
 
 const std::string SceneMan::m_ClassName = "SceneMan";
+thread_local Vector SceneMan::m_LastRayHitPos;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +84,7 @@ void SceneMan::Clear()
     m_pMOIDLayer = 0;
     m_MOIDDrawings.clear();
     m_pDebugLayer = 0;
+    m_MainThreadID = std::this_thread::get_id();
     m_LastRayHitPos.Reset();
 
     m_LayerDrawMode = g_LayerNormal;
@@ -109,11 +113,43 @@ void SceneMan::Clear()
     m_LastUpdatedScreen = 0;
     m_SecondStructPass = false;
 //    m_CalcTimer.Reset();
+    m_StructuralCalcEnabled = false;
+    m_StructuralCalcTime = 2;
+    m_StructuralCellCountX = 0;
+    m_StructuralCellCountY = 0;
+    m_StructuralDirtyCells.clear();
+    m_StructuralDirtyQueue.clear();
+    m_StructuralVisited.clear();
+    m_StructuralSearchVisited.clear();
+    m_StructuralSearchStack.clear();
+    m_StructuralCellStates.clear();
+    m_StructuralOrphans.clear();
+    std::fill(std::begin(m_StructuralSolid), std::end(m_StructuralSolid), false);
     m_CleanTimer.Reset();
 
-	if (m_pOrphanSearchBitmap)
-		destroy_bitmap(m_pOrphanSearchBitmap);
-	m_pOrphanSearchBitmap = create_bitmap_ex(8, MAXORPHANRADIUS , MAXORPHANRADIUS);
+    m_TeamVisibilityInterval = 4;
+    m_TeamVisibilityFrame = 0;
+    for (int team = 0; team < Activity::MaxTeamCount; ++team)
+        m_TeamViewers[team].clear();
+    m_VisibilityScans.clear();
+    m_VisibilityOpaque.clear();
+    m_VisibilityStamps.clear();
+    m_VisibilityStamp = 0;
+    m_VisibilityCellWidth = 0;
+    m_VisibilityCellHeight = 0;
+    m_VisibilitySamplesPerCell = 0;
+
+	m_OrphanSearchVisited.assign(MAXORPHANRADIUS * MAXORPHANRADIUS, 0);
+	m_OrphanSearchStamp = 0;
+	m_OrphanSearchSeeds.clear();
+	m_OrphanSearchPixels.clear();
+	m_AnchoredPixelStamps.assign(MAXORPHANRADIUS * MAXORPHANRADIUS, 0);
+	m_AnchoredPixelStamp = 0;
+	m_AnchoredWindowX = 0;
+	m_AnchoredWindowY = 0;
+	m_AnchoredWindowKey = -1;
+	m_AnchoredWindowTick = -1;
+	m_MaxOrphanParticles = 64;
 }
 
 /*
@@ -245,6 +281,14 @@ int SceneMan::LoadScene(Scene *pNewScene, bool placeObjects, bool placeUnits) {
     // Finally draw the ID:s of the MO:s to the MOID layers for the first time
     g_MovableMan.UpdateDrawMOIDs(m_pMOIDLayer->GetBitmap());
 
+    // Whatever the terrain looks like after loading is taken as stable, only later changes get checked for support
+    ResetStructuralCalc();
+
+    // Viewers registered on the previous scene are meaningless here
+    for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
+        m_TeamViewers[team].clear();
+    m_TeamVisibilityFrame = 0;
+
 	g_NetworkServer.LockScene(false);
 	g_NetworkServer.ResetScene();
 
@@ -378,6 +422,22 @@ int SceneMan::ReadProperty(std::string propName, Reader &reader)
             }
         }
     }
+    else if (propName == "EnableStructuralCalc")
+        reader >> m_StructuralCalcEnabled;
+    else if (propName == "StructuralCalcTimeMS")
+        reader >> m_StructuralCalcTime;
+    else if (propName == "MaxOrphanParticles")
+    {
+        int maxParticles;
+        reader >> maxParticles;
+        SetMaxOrphanParticles(maxParticles);
+    }
+    else if (propName == "TeamVisibilityInterval")
+    {
+        int interval;
+        reader >> interval;
+        SetTeamVisibilityInterval(interval);
+    }
     else
         return Serializable::ReadProperty(propName, reader);
 
@@ -423,9 +483,6 @@ void SceneMan::Destroy()
     delete m_pMOColorLayer;
     delete m_pUnseenRevealSound;
 
-	destroy_bitmap(m_pOrphanSearchBitmap);
-	m_pOrphanSearchBitmap = 0;
-
     Clear();
 }
 
@@ -571,6 +628,85 @@ bool SceneMan::MOIDClearCheck()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WrapPixelInBounds
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Wraps a pixel coordinate onto a layer along the axes that wrap, and
+//                  tells whether it ended up within the layer.
+
+template <bool WrapX, bool WrapY>
+bool SceneMan::WrapPixelInBounds(int &pixelX, int &pixelY, int width, int height)
+{
+    if (pixelX < 0 || pixelX >= width)
+    {
+        if (!WrapX)
+            return false;
+        pixelX = ((pixelX % width) + width) % width;
+    }
+    if (pixelY < 0 || pixelY >= height)
+    {
+        if (!WrapY)
+            return false;
+        pixelY = ((pixelY % height) + height) % height;
+    }
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WrapPixelInBounds
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Picks the specialization of WrapPixelInBounds that matches the
+//                  wrapping settings passed in.
+
+bool SceneMan::WrapPixelInBounds(int &pixelX, int &pixelY, int width, int height, bool wrapX, bool wrapY)
+{
+    if (wrapX)
+        return wrapY ? WrapPixelInBounds<true, true>(pixelX, pixelY, width, height) : WrapPixelInBounds<true, false>(pixelX, pixelY, width, height);
+    return wrapY ? WrapPixelInBounds<false, true>(pixelX, pixelY, width, height) : WrapPixelInBounds<false, false>(pixelX, pixelY, width, height);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReadSpan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies a horizontal run of pixels from a bitmap, splitting it at the
+//                  horizontal seam and filling anything out of bounds with a set value.
+
+template <bool WrapX, bool WrapY, typename PixelType, typename DestType>
+void SceneMan::ReadSpan(const BITMAP *pBitmap, int pixelX, int pixelY, int length, DestType *pDest, DestType outOfBoundsValue)
+{
+    int dummyX = 0;
+    if (!WrapPixelInBounds<false, WrapY>(dummyX, pixelY, pBitmap->w, pBitmap->h))
+    {
+        std::fill(pDest, pDest + length, outOfBoundsValue);
+        return;
+    }
+    const PixelType *pRow = reinterpret_cast<const PixelType *>(pBitmap->line[pixelY]);
+
+    while (length > 0)
+    {
+        int runX = pixelX;
+        int runLength;
+        if (WrapPixelInBounds<WrapX, false>(runX, dummyX, pBitmap->w, pBitmap->h))
+        {
+            // Copy up to the seam or the end of the span, whichever comes first
+            runLength = std::min(length, pBitmap->w - runX);
+            std::copy(pRow + runX, pRow + runX + runLength, pDest);
+        }
+        else
+        {
+            // Only reachable when not wrapping; fill up to the left edge or the end of the span
+            runLength = (pixelX < 0) ? std::min(length, -pixelX) : length;
+            std::fill(pDest, pDest + runLength, outOfBoundsValue);
+        }
+        pixelX += runLength;
+        pDest += runLength;
+        length -= runLength;
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetTerrMatter
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -581,21 +717,15 @@ unsigned char SceneMan::GetTerrMatter(int pixelX, int pixelY)
 {
     RTEAssert(m_pCurrentScene, "Trying to get terrain matter before there is a scene or terrain!");
 
-    WrapPosition(pixelX, pixelY);
-
-    BITMAP *pTMatBitmap = m_pCurrentScene->GetTerrain()->GetMaterialBitmap();
+    const SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+    const BITMAP *pTMatBitmap = pTerrain->GetMaterialBitmap();
 
-    // If it's still below or to the sides out of bounds after
-    // what is supposed to be wrapped, shit is out of bounds.
-    if (pixelX < 0 || pixelX >= pTMatBitmap->w || pixelY >= pTMatBitmap->h)
+    // If it's out of bounds after wrapping what is supposed to be wrapped, including above the terrain bitmap, it's air
+    if (!WrapPixelInBounds(pixelX, pixelY, pTMatBitmap->w, pTMatBitmap->h, pTerrain->WrapsX(), pTerrain->WrapsY()))
 //        return g_MaterialOutOfBounds;
         return g_MaterialAir;
 
-    // If above terrain bitmap, return air material.
-    if (pixelY < 0)
-        return g_MaterialAir;
-
-    return getpixel(pTMatBitmap, pixelX, pixelY);
+    return pTMatBitmap->line[pixelY][pixelX];
 }
 
 
@@ -607,15 +737,44 @@ unsigned char SceneMan::GetTerrMatter(int pixelX, int pixelY)
 
 MOID SceneMan::GetMOIDPixel(int pixelX, int pixelY)
 {
-    WrapPosition(pixelX, pixelY);
+    static_assert(c_MOIDLayerBitDepth == 16, "GetMOIDPixel reads the MOID layer as 16bpp");
+    const BITMAP *pMOIDBitmap = m_pMOIDLayer->GetBitmap();
 
-    if (pixelX < 0 ||
-       pixelX >= m_pMOIDLayer->GetBitmap()->w ||
-       pixelY < 0 ||
-       pixelY >= m_pMOIDLayer->GetBitmap()->h)
+    if (!WrapPixelInBounds(pixelX, pixelY, pMOIDBitmap->w, pMOIDBitmap->h, m_pMOIDLayer->WrapsX(), m_pMOIDLayer->WrapsY()))
         return g_NoMOID;
 
-    return getpixel(m_pMOIDLayer->GetBitmap(), pixelX, pixelY);
+    return reinterpret_cast<const uint16_t *>(pMOIDBitmap->line[pixelY])[pixelX];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTerrMatterSpan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reads a horizontal run of pixels from the material representation of
+//                  this Scene in one go.
+
+void SceneMan::GetTerrMatterSpan(int pixelX, int pixelY, int length, unsigned char *pDest)
+{
+    RTEAssert(m_pCurrentScene, "Trying to get terrain matter before there is a scene or terrain!");
+
+    const SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+    const BITMAP *pTMatBitmap = pTerrain->GetMaterialBitmap();
+    unsigned char air = g_MaterialAir;
+
+    if (pTerrain->WrapsX())
+    {
+        if (pTerrain->WrapsY())
+            ReadSpan<true, true, unsigned char>(pTMatBitmap, pixelX, pixelY, length, pDest, air);
+        else
+            ReadSpan<true, false, unsigned char>(pTMatBitmap, pixelX, pixelY, length, pDest, air);
+    }
+    else
+    {
+        if (pTerrain->WrapsY())
+            ReadSpan<false, true, unsigned char>(pTMatBitmap, pixelX, pixelY, length, pDest, air);
+        else
+            ReadSpan<false, false, unsigned char>(pTMatBitmap, pixelX, pixelY, length, pDest, air);
+    }
 }
 
 
@@ -964,7 +1123,7 @@ bool SceneMan::WillPenetrate(const int posX,
         return false;
 
     float impMag = impulse.GetMagnitude();
-    unsigned char materialID = getpixel(m_pCurrentScene->GetTerrain()->GetMaterialBitmap(), posX, posY);
+    unsigned char materialID = _getpixel(m_pCurrentScene->GetTerrain()->GetMaterialBitmap(), posX, posY);
 
     return impMag >= GetMaterialFromID(materialID)->GetIntegrity();
 }
@@ -976,83 +1135,196 @@ bool SceneMan::WillPenetrate(const int posX,
 
 int SceneMan::RemoveOrphans(int posX, int posY, int radius, int maxArea, bool remove)
 {
+	// Returned when the region reaches the edge of the search area, or joins one that did earlier this update, so is held up by terrain outside it
+	const int anchoredArea = MAXORPHANRADIUS * MAXORPHANRADIUS + 1;
+
+	if (!m_pCurrentScene)
+		return 0;
 	if (radius > MAXORPHANRADIUS)
 		radius = MAXORPHANRADIUS;
 
-	clear_to_color(m_pOrphanSearchBitmap, g_MaterialAir);
-	int area = RemoveOrphans(posX, posY, posX, posY, 0, radius, maxArea, false);
-	if (remove && area <= maxArea)
+	// Bump the stamp instead of clearing the visited buffer, it only needs a real clear once the stamp wraps around
+	if (++m_OrphanSearchStamp == 0)
+	{
+		std::fill(m_OrphanSearchVisited.begin(), m_OrphanSearchVisited.end(), 0);
+		m_OrphanSearchStamp = 1;
+	}
+
+	int originX = posX - radius / 2;
+	int originY = posY - radius / 2;
+	int centerX = posX - originX;
+	int centerY = posY - originY;
+	bool centerIsAir = GetTerrMatter(posX, posY) == g_MaterialAir;
+
+	// Whether a region is anchored depends on where the edges of the search window are, so anchored regions are only remembered for repeated searches
+	// through the same window during the same sim update, like repeated hits on the same spot. Any other window starts with nothing known.
+	long long simTick = g_TimerMan.GetSimTickCount();
+	int searchKey = (radius << 16) | (maxArea & 0xFFFF);
+	if (simTick != m_AnchoredWindowTick || searchKey != m_AnchoredWindowKey || originX != m_AnchoredWindowX || originY != m_AnchoredWindowY)
+	{
+		if (++m_AnchoredPixelStamp == 0)
+		{
+			std::fill(m_AnchoredPixelStamps.begin(), m_AnchoredPixelStamps.end(), 0);
+			m_AnchoredPixelStamp = 1;
+		}
+		m_AnchoredWindowX = originX;
+		m_AnchoredWindowY = originY;
+		m_AnchoredWindowKey = searchKey;
+		m_AnchoredWindowTick = simTick;
+	}
+
+	// The search starts from the center even if it's already been knocked out, so everything that was touching it counts as one region
+	auto isSolid = [&](int localX, int localY) { return (localX == centerX && localY == centerY) || GetTerrMatter(originX + localX, originY + localY) != g_MaterialAir; };
+	auto isVisited = [&](int localX, int localY) { return m_OrphanSearchVisited[localY * MAXORPHANRADIUS + localX] == m_OrphanSearchStamp; };
+	auto isEdge = [&](int localX, int localY) { return localX <= 0 || localY <= 0 || localX >= radius - 1 || localY >= radius - 1; };
+
+	m_OrphanSearchSeeds.clear();
+	m_OrphanSearchPixels.clear();
+	m_OrphanSearchSeeds.push_back(std::make_pair(centerX, centerY));
+	int area = 0;
+	bool anchored = false;
+
+	// Scanline fill: every seed is grown into a full horizontal span, and only the start of each solid run on the rows above and below it gets seeded
+	while (!m_OrphanSearchSeeds.empty() && !anchored && area <= maxArea)
+	{
+		int seedX = m_OrphanSearchSeeds.back().first;
+		int seedY = m_OrphanSearchSeeds.back().second;
+		m_OrphanSearchSeeds.pop_back();
+
+		if (isEdge(seedX, seedY))
+		{
+			anchored = true;
+			break;
+		}
+		if (isVisited(seedX, seedY))
+			continue;
+
+		int spanLeft = seedX;
+		int spanRight = seedX;
+		while (!anchored && !isVisited(spanLeft - 1, seedY) && isSolid(spanLeft - 1, seedY))
+			anchored = isEdge(--spanLeft, seedY);
+		while (!anchored && !isVisited(spanRight + 1, seedY) && isSolid(spanRight + 1, seedY))
+			anchored = isEdge(++spanRight, seedY);
+
+		for (int x = spanLeft; x <= spanRight && !anchored; ++x)
+			anchored = m_AnchoredPixelStamps[seedY * MAXORPHANRADIUS + x] == m_AnchoredPixelStamp;
+		if (anchored)
+			break;
+
+		for (int x = spanLeft; x <= spanRight; ++x)
+		{
+			m_OrphanSearchVisited[seedY * MAXORPHANRADIUS + x] = m_OrphanSearchStamp;
+			if (!centerIsAir || x != centerX || seedY != centerY)
+				m_OrphanSearchPixels.push_back(std::make_pair(originX + x, originY + seedY));
+		}
+		area += spanRight - spanLeft + 1;
+
+		// Diagonal neighbours count too, so the runs above and below are checked one pixel past each end of the span
+		for (int rowY = seedY - 1; rowY <= seedY + 1; rowY += 2)
+		{
+			bool inRun = false;
+			for (int x = spanLeft - 1; x <= spanRight + 1; ++x)
+			{
+				bool startsRun = !isVisited(x, rowY) && isSolid(x, rowY);
+				if (startsRun && !inRun)
+					m_OrphanSearchSeeds.push_back(std::make_pair(x, rowY));
+				inRun = startsRun;
+			}
+		}
+	}
+
+	if (anchored || area > maxArea)
 	{
-		clear_to_color(m_pOrphanSearchBitmap, g_MaterialAir);
-		RemoveOrphans(posX, posY, posX, posY, 0, radius, maxArea, true);
+		for (const std::pair<int, int> &pixel : m_OrphanSearchPixels)
+			m_AnchoredPixelStamps[(pixel.second - originY) * MAXORPHANRADIUS + pixel.first - originX] = m_AnchoredPixelStamp;
+		return anchored ? anchoredArea : area;
 	}
 
+	if (remove)
+		RemoveOrphans(m_OrphanSearchPixels, m_MaxOrphanParticles);
+
 	return area;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveOrphans
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns the area of an orphaned region at specified coordinates. 
+// Description:     Removes a batch of terrain pixels that are known to be orphaned and
+//                  registers the whole change as a single area.
 
-int SceneMan::RemoveOrphans(int posX, int posY, 
-							int centerPosX, int centerPosY, 
-							int accumulatedArea, int radius, int maxArea, bool remove)
+int SceneMan::RemoveOrphans(const std::vector<std::pair<int, int>> &orphanedPixels, int maxParticles)
 {
-	int area = 0;
-	int bmpX = 0;
-	int bmpY = 0;
+    if (!m_pCurrentScene || orphanedPixels.empty())
+        return 0;
 
-	BITMAP * mat = m_pCurrentScene->GetTerrain()->GetMaterialBitmap();
+    // Spread the particles evenly over the batch so a big collapse doesn't flood MovableMan, but still looks like it came from all of it
+    int pixelCount = orphanedPixels.size();
+    int particleStride = maxParticles > 0 ? std::max(1, (pixelCount + maxParticles - 1) / maxParticles) : 0;
 
-	if (posX < 0 || posY < 0 || posX >= mat->w || posY >= mat->h) return 0;
+    int minX = std::numeric_limits<int>::max();
+    int minY = std::numeric_limits<int>::max();
+    int maxX = std::numeric_limits<int>::min();
+    int maxY = std::numeric_limits<int>::min();
+    int removedCount = 0;
 
-    unsigned char materialID = _getpixel(mat, posX, posY);
-    if (materialID == g_MaterialAir && (posX != centerPosX || posY != centerPosY))
-		return 0;
-	else
-	{
-		bmpX = posX - (centerPosX - radius / 2);
-		bmpY = posY - (centerPosY - radius / 2);
-
-		// We reached the border of orphan-searching area and 
-		// there are still material pixels there -> the area is not an orphaned teran piece, abort search
-		if (bmpX <= 0 || bmpY <= 0 || bmpX >= radius - 1 || bmpY >= radius - 1)
-			return MAXORPHANRADIUS * MAXORPHANRADIUS + 1;
-		else
-		// Check if pixel was already checked
-		{
-			if (_getpixel(m_pOrphanSearchBitmap, bmpX, bmpY) != g_MaterialAir)
-				return 0;
-		}
-	}
+    for (int i = 0; i < pixelCount; ++i)
+    {
+        int posX = orphanedPixels[i].first;
+        int posY = orphanedPixels[i].second;
+        if (!IsWithinBounds(posX, posY))
+            continue;
 
-	_putpixel(m_pOrphanSearchBitmap, bmpX, bmpY, materialID);
-	area++;
+        // Keep the bounds unwrapped so RegisterTerrainChange can split them over the seam
+        minX = std::min(minX, posX);
+        minY = std::min(minY, posY);
+        maxX = std::max(maxX, posX);
+        maxY = std::max(maxY, posY);
 
-	// We're clear to remove the pixel
-	if (remove)
-	{
-		Material const * sceneMat = GetMaterialFromID(materialID);
-		Material const * spawnMat;
-        spawnMat = sceneMat->GetSpawnMaterial() ? GetMaterialFromID(sceneMat->GetSpawnMaterial()) : sceneMat;
-		float sprayScale = 0.1;
+        ForceBounds(posX, posY);
+        RemoveOrphanPixel(posX, posY, particleStride > 0 && i % particleStride == 0);
+        ++removedCount;
+    }
+
+    if (removedCount > 0)
+    {
+        int width = maxX - minX + 1;
+        int height = maxY - minY + 1;
+        RegisterTerrainChange(minX, minY, width, height, g_MaskColor, false);
+        // Grow the area by a pixel so whatever was resting on or hanging off the removed pixels gets checked again too
+        m_pCurrentScene->GetTerrain()->AddUpdatedMaterialArea(Box(Vector(minX - 1, minY - 1), width + 2, height + 2));
+    }
+
+    return removedCount;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RemoveOrphanPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears a single terrain pixel, optionally spawning a MOPixel of its
+//                  material drifting off it.
+
+void SceneMan::RemoveOrphanPixel(int posX, int posY, bool spawnParticle)
+{
+    SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+
+    if (spawnParticle)
+    {
+        Material const * sceneMat = GetMaterialFromID(pTerrain->GetMaterialPixel(posX, posY));
+        Material const * spawnMat = sceneMat->GetSpawnMaterial() ? GetMaterialFromID(sceneMat->GetSpawnMaterial()) : sceneMat;
+        float sprayScale = 0.1;
         Color spawnColor;
         if (spawnMat->UsesOwnColor())
             spawnColor = spawnMat->GetColor();
         else
-            spawnColor.SetRGBWithIndex(m_pCurrentScene->GetTerrain()->GetFGColorPixel(posX, posY));
+            spawnColor.SetRGBWithIndex(pTerrain->GetFGColorPixel(posX, posY));
 
         // No point generating a key-colored MOPixel
         if (spawnColor.GetIndex() != g_MaskColor)
         {
-			// TEST COLOR
-			// spawnColor = 5;
-
-            // Get the new pixel from the pre-allocated pool, should be faster than dynamic allocation
             // Density is used as the mass for the new MOPixel
-			float tempMax = 2.0F * sprayScale;
-			float tempMin = tempMax / 2.0F;
+            float tempMax = 2.0F * sprayScale;
+            float tempMin = tempMax / 2.0F;
             MOPixel *pixelMO = new MOPixel(spawnColor,
                                            spawnMat->GetPixelDensity(),
                                            Vector(posX, posY),
@@ -1066,24 +1338,12 @@ int SceneMan::RemoveOrphans(int posX, int posY,
             g_MovableMan.AddParticle(pixelMO);
             pixelMO = 0;
         }
-        m_pCurrentScene->GetTerrain()->SetFGColorPixel(posX, posY, g_MaskColor);
-		RegisterTerrainChange(posX, posY, 1, 1, g_MaskColor, false);
-        m_pCurrentScene->GetTerrain()->SetMaterialPixel(posX, posY, g_MaterialAir);
-	}
-
-	int xoff[8] = { -1,  0,  1, -1,  1, -1,  0,  1};
-	int yoff[8] = { -1, -1, -1,  0,  0,  1,  1,  1};
-
-	for (int c = 0; c < 8; c++)
-	{
-		area += RemoveOrphans(posX + xoff[c], posY + yoff[c], centerPosX, centerPosY, area, radius, maxArea, remove);
-		if (accumulatedArea + area > maxArea)
-			break;
-	}
-
-	return area;
+    }
+    pTerrain->SetFGColorPixel(posX, posY, g_MaskColor);
+    pTerrain->SetMaterialPixel(posX, posY, g_MaterialAir);
 }
 
+
 void SceneMan::RegisterTerrainChange(int x, int y, int w, int h, unsigned char color, bool back) 
 {
 	if (!g_NetworkServer.IsServerModeEnabled())
@@ -1292,6 +1552,10 @@ bool SceneMan::TryPenetrate(const int posX,
 //        retardation = -sceneMat.density;
         retardation = -(sceneMat->GetIntegrity() / impMag);
 
+        // Let the structural calculations know something may have lost its footing here
+        if (m_StructuralCalcEnabled)
+            QueueStructuralArea(Box(Vector(posX - 1, posY - 1), 3, 3));
+
         // If this is a scrap pixel, or there is no background pixel 'supporting' the knocked-loose pixel, make the column above also turn into particles
         if (sceneMat->IsScrap() || _getpixel(m_pCurrentScene->GetTerrain()->GetBGColorBitmap(), posX, posY) == g_MaskColor)
         {
@@ -1344,7 +1608,7 @@ bool SceneMan::TryPenetrate(const int posX,
                             }
 
 							// Remove orphaned terrain left from hits and scrap damage
-							RemoveOrphans(posX + testY%2 ? -1 : 1, testY, 5, 25, true);
+							RemoveOrphans(posX + (testY % 2 ? -1 : 1), testY, 5, 25, true);
 						}
 
                         // Clear the terrain pixel now when the particle has been generated from it
@@ -1363,9 +1627,6 @@ bool SceneMan::TryPenetrate(const int posX,
 		if (removeOrphansRadius && removeOrphansMaxArea && removeOrphansRate > 0 && RandomNum() < removeOrphansRate)
 		{
 			RemoveOrphans(posX, posY, removeOrphansRadius, removeOrphansMaxArea, true);
-			/*PALETTE palette;
-			get_palette(palette);
-			save_bmp("Orphan.bmp", m_pOrphanSearchBitmap, palette);*/
 		}
 
         return true;
@@ -1622,8 +1883,9 @@ void SceneMan::RestoreUnseenBox(const int posX, const int posY, const int width,
 bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip, bool reveal)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     if (!m_pCurrentScene->GetUnseenLayer(team))
@@ -1722,15 +1984,15 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
             skipped = 0;
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     return affectedAny;
@@ -1761,6 +2023,394 @@ bool SceneMan::CastUnseeRay(int team, const Vector &start, const Vector &ray, Ve
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterTeamViewer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds a point of view to be folded into the next visibility pass of a
+//                  team. Ignored on updates where no pass will run.
+
+void SceneMan::RegisterTeamViewer(int team, const Vector &eyePos, const Vector &lookVector, float halfFOV)
+{
+    if (team < Activity::TeamOne || team >= Activity::MaxTeamCount || !WantsTeamViewers())
+        return;
+
+    TeamViewer viewer;
+    viewer.EyePos = eyePos;
+    viewer.Range = lookVector.GetMagnitude();
+    viewer.LookDir = viewer.Range > 0 ? lookVector / viewer.Range : Vector(1, 0);
+    viewer.HalfFOV = std::min(halfFOV, 180.0F) * c_PI / 180.0F;
+    m_TeamViewers[team].push_back(viewer);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateTeamVisibility
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the team visibility pass if it is due this update.
+
+void SceneMan::UpdateTeamVisibility()
+{
+    if (!m_pCurrentScene || m_TeamVisibilityInterval <= 0)
+        return;
+
+    bool passDue = WantsTeamViewers();
+    m_TeamVisibilityFrame = (m_TeamVisibilityFrame + 1) % m_TeamVisibilityInterval;
+    if (!passDue)
+        return;
+
+    // New stamp so every opacity cell gets sampled from the current Terrain again, but only once for all teams
+    if (++m_VisibilityStamp == 0)
+    {
+        std::fill(m_VisibilityStamps.begin(), m_VisibilityStamps.end(), 0);
+        m_VisibilityStamp = 1;
+    }
+
+    // Octant transforms from (column, row) scan coordinates to unseen layer offsets
+    static const int octantTransforms[8][4] = {
+        { 1, 0, 0, 1 }, { 0, 1, 1, 0 }, { 0, -1, 1, 0 }, { -1, 0, 0, 1 },
+        { -1, 0, 0, -1 }, { 0, -1, -1, 0 }, { 0, 1, -1, 0 }, { 1, 0, 0, -1 }
+    };
+
+    for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
+    {
+        std::vector<TeamViewer> &viewers = m_TeamViewers[team];
+        if (viewers.empty())
+            continue;
+
+        SceneLayer *pUnseenLayer = m_pCurrentScene->GetUnseenLayer(team);
+        BITMAP *pUnseenBitmap = pUnseenLayer ? pUnseenLayer->GetBitmap() : 0;
+        if (!pUnseenBitmap)
+        {
+            viewers.clear();
+            continue;
+        }
+
+        Vector cellSize = pUnseenLayer->GetScaleFactor();
+        int cellWidth = std::max(static_cast<int>(cellSize.m_X), 1);
+        int cellHeight = std::max(static_cast<int>(cellSize.m_Y), 1);
+        size_t cellCount = pUnseenBitmap->w * pUnseenBitmap->h;
+        if (m_VisibilityStamps.size() != cellCount || cellWidth != m_VisibilityCellWidth || cellHeight != m_VisibilityCellHeight)
+        {
+            m_VisibilityOpaque.assign(cellCount, false);
+            m_VisibilityStamps.assign(cellCount, 0);
+            m_VisibilityCellWidth = cellWidth;
+            m_VisibilityCellHeight = cellHeight;
+            // Seeing rays skip half the smallest cell side between samples, so each cell they cross costs them that many samples
+            int smallestSide = std::min(cellWidth, cellHeight);
+            m_VisibilitySamplesPerCell = std::max(smallestSide / std::max(smallestSide / 2, 1), 1);
+        }
+
+        std::list<Vector> &seenPixels = m_pCurrentScene->GetSeenPixels(team);
+        int smallestCellSide = std::min(cellWidth, cellHeight);
+
+        // Viewers standing in the same cell with overlapping cones see from the same place, so they're scanned together
+        size_t scanCount = 0;
+        for (const TeamViewer &viewer : viewers)
+        {
+            int originX = static_cast<int>(std::floor(viewer.EyePos.m_X / static_cast<float>(cellWidth)));
+            int originY = static_cast<int>(std::floor(viewer.EyePos.m_Y / static_cast<float>(cellHeight)));
+            if (!WrapPixelInBounds(originX, originY, pUnseenBitmap->w, pUnseenBitmap->h, m_pCurrentScene->WrapsX(), m_pCurrentScene->WrapsY()))
+                continue;
+
+            VisibilityCone cone;
+            SetVisibilityCone(cone, viewer.LookDir, viewer.HalfFOV, static_cast<int>(viewer.Range / static_cast<float>(smallestCellSide)));
+
+            VisibilityScan *pScan = 0;
+            for (size_t scanIndex = 0; scanIndex < scanCount && !pScan; ++scanIndex)
+            {
+                VisibilityScan &otherScan = m_VisibilityScans[scanIndex];
+                if (otherScan.OriginX == originX && otherScan.OriginY == originY && MergeVisibilityCone(otherScan.Coverage, cone))
+                    pScan = &otherScan;
+            }
+            if (!pScan)
+            {
+                if (scanCount == m_VisibilityScans.size())
+                    m_VisibilityScans.push_back(VisibilityScan());
+                pScan = &m_VisibilityScans[scanCount++];
+                pScan->EyePos = viewer.EyePos;
+                pScan->OriginX = originX;
+                pScan->OriginY = originY;
+                pScan->Cones.clear();
+                pScan->Coverage = cone;
+            }
+            pScan->Cones.push_back(cone);
+        }
+        viewers.clear();
+
+        for (size_t scanIndex = 0; scanIndex < scanCount; ++scanIndex)
+        {
+            VisibilityScan &scan = m_VisibilityScans[scanIndex];
+            scan.Revealed = false;
+            size_t seenBefore = seenPixels.size();
+
+            // The viewer can always see the cell it's standing in
+            unsigned char &originPixel = pUnseenBitmap->line[scan.OriginY][scan.OriginX];
+            if (originPixel != g_MaskColor)
+            {
+                originPixel = g_MaskColor;
+                seenPixels.push_back(Vector(scan.OriginX, scan.OriginY));
+                scan.Revealed = true;
+            }
+            for (int octant = 0; octant < 8; ++octant)
+            {
+                const int *transform = octantTransforms[octant];
+                Vector rowOffset(static_cast<float>(-transform[1] * cellWidth), static_cast<float>(-transform[3] * cellHeight));
+                Vector columnOffset(static_cast<float>(-transform[0] * cellWidth), static_cast<float>(-transform[2] * cellHeight));
+                float lowSlope;
+                float highSlope;
+                bool wholeOctant;
+                if (!GetVisibilityConeSlopes(scan.Coverage, rowOffset, columnOffset, lowSlope, highSlope, wholeOctant))
+                    continue;
+
+                // Cells only need checking against the separate cones if none of them sees all of the octant as far as the scan goes
+                scan.SeesWholeOctant = false;
+                for (size_t coneIndex = 0; coneIndex < scan.Cones.size() && !scan.SeesWholeOctant; ++coneIndex)
+                {
+                    const VisibilityCone &cone = scan.Cones[coneIndex];
+                    float coneLowSlope;
+                    float coneHighSlope;
+                    scan.SeesWholeOctant = cone.Radius >= scan.Coverage.Radius && GetVisibilityConeSlopes(cone, rowOffset, columnOffset, coneLowSlope, coneHighSlope, wholeOctant) && wholeOctant;
+                }
+                ScanVisibilityOctant(pUnseenBitmap, seenPixels, scan, 1, highSlope, lowSlope, transform[0], transform[1], transform[2], transform[3]);
+            }
+
+            // Play the reveal sound, if there's not too many already revealed this frame
+            if (scan.Revealed && seenBefore < 5 && g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound)
+                m_pUnseenRevealSound->Play(scan.EyePos);
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetVisibilityCone
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Fills in a cone of sight from its look direction and half angle.
+
+void SceneMan::SetVisibilityCone(VisibilityCone &cone, const Vector &lookDir, float halfFOV, int radius)
+{
+    cone.LookDir = lookDir;
+    cone.LookAngle = std::atan2(lookDir.m_Y, lookDir.m_X);
+    cone.HalfFOV = std::min(halfFOV, c_PI);
+    // A cone of 180 degrees or more either way is all around, which no dot product can fall below
+    cone.CosHalfFOV = cone.HalfFOV >= c_PI ? -2.0F : std::cos(cone.HalfFOV);
+    cone.MinEdge.SetXY(std::cos(cone.LookAngle - cone.HalfFOV), std::sin(cone.LookAngle - cone.HalfFOV));
+    cone.MaxEdge.SetXY(std::cos(cone.LookAngle + cone.HalfFOV), std::sin(cone.LookAngle + cone.HalfFOV));
+    cone.Radius = radius;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MergeVisibilityCone
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Widens a cone of sight to also cover another one, if the two overlap.
+
+bool SceneMan::MergeVisibilityCone(VisibilityCone &coverage, const VisibilityCone &cone)
+{
+    float angleBetween = std::remainder(cone.LookAngle - coverage.LookAngle, c_TwoPI);
+    if (std::fabs(angleBetween) > coverage.HalfFOV + cone.HalfFOV)
+        return false;
+
+    // Angles relative to the look of the covering cone
+    float minAngle = std::min(-coverage.HalfFOV, angleBetween - cone.HalfFOV);
+    float maxAngle = std::max(coverage.HalfFOV, angleBetween + cone.HalfFOV);
+    float mergedHalfFOV = std::min((maxAngle - minAngle) * 0.5F, c_PI);
+    int mergedRadius = std::max(coverage.Radius, cone.Radius);
+
+    // Don't merge if scanning the cones together would cover more than scanning them apart, like a short look all around and a long narrow one
+    float mergedArea = mergedHalfFOV * static_cast<float>(mergedRadius * mergedRadius);
+    if (mergedArea > coverage.HalfFOV * static_cast<float>(coverage.Radius * coverage.Radius) + cone.HalfFOV * static_cast<float>(cone.Radius * cone.Radius))
+        return false;
+
+    float mergedAngle = coverage.LookAngle + (minAngle + maxAngle) * 0.5F;
+    SetVisibilityCone(coverage, Vector(std::cos(mergedAngle), std::sin(mergedAngle)), mergedHalfFOV, mergedRadius);
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetVisibilityConeSlopes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Works out which part of an octant a cone of sight can see, as the
+//                  range of scan slopes from 0 along the octant's axis to 1 along its
+//                  diagonal.
+
+bool SceneMan::GetVisibilityConeSlopes(const VisibilityCone &cone, const Vector &rowOffset, const Vector &columnOffset, float &lowSlope, float &highSlope, bool &wholeOctant)
+{
+    lowSlope = 0;
+    highSlope = 1;
+    wholeOctant = true;
+    if (cone.HalfFOV >= c_PI)
+        return true;
+
+    // The direction at a slope is rowOffset + slope * columnOffset, so which side of an edge of the cone it's on changes linearly with the slope
+    auto crossProduct = [](const Vector &first, const Vector &second) { return first.m_X * second.m_Y - first.m_Y * second.m_X; };
+    float minEdgeBase = crossProduct(cone.MinEdge, rowOffset);
+    float minEdgeRate = crossProduct(cone.MinEdge, columnOffset);
+    float maxEdgeBase = crossProduct(rowOffset, cone.MaxEdge);
+    float maxEdgeRate = crossProduct(columnOffset, cone.MaxEdge);
+
+    // Keeps only the slopes where base + rate * slope isn't negative
+    auto clipSlopes = [](float base, float rate, float &low, float &high)
+    {
+        if (rate > 0)
+            low = std::max(low, -base / rate);
+        else if (rate < 0)
+            high = std::min(high, -base / rate);
+        else if (base < 0)
+        {
+            low = 1;
+            high = 0;
+        }
+    };
+
+    if (cone.HalfFOV <= c_HalfPI)
+    {
+        // A cone no wider than a half plane sees what's inside both its edges
+        clipSlopes(minEdgeBase, minEdgeRate, lowSlope, highSlope);
+        clipSlopes(maxEdgeBase, maxEdgeRate, lowSlope, highSlope);
+        wholeOctant = lowSlope <= 0 && highSlope >= 1;
+        return lowSlope <= highSlope;
+    }
+
+    // A wider cone sees everything but the gap outside both its edges, which only trims the scan if it reaches one end of the octant
+    float gapLowSlope = 0;
+    float gapHighSlope = 1;
+    clipSlopes(-minEdgeBase, -minEdgeRate, gapLowSlope, gapHighSlope);
+    clipSlopes(-maxEdgeBase, -maxEdgeRate, gapLowSlope, gapHighSlope);
+    if (gapLowSlope > gapHighSlope)
+        return true;
+
+    wholeOctant = false;
+    if (gapLowSlope <= 0 && gapHighSlope >= 1)
+        return false;
+    if (gapLowSlope <= 0)
+        lowSlope = gapHighSlope;
+    else if (gapHighSlope >= 1)
+        highSlope = gapLowSlope;
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsVisibilityCellOpaque
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a cell of the coarse opacity grid blocks sight, sampling
+//                  the Terrain under it the first time it is asked about this pass.
+
+bool SceneMan::IsVisibilityCellOpaque(int cellX, int cellY, int layerWidth)
+{
+    int cellIndex = cellY * layerWidth + cellX;
+    if (m_VisibilityStamps[cellIndex] != m_VisibilityStamp)
+    {
+        // Same strength limit the Actors cast their own seeing rays with
+        const float strengthLimit = 25.0F;
+        int pixelX = cellX * m_VisibilityCellWidth + m_VisibilityCellWidth / 2;
+        int pixelY = cellY * m_VisibilityCellHeight + m_VisibilityCellHeight / 2;
+        float integrity = GetMaterialFromID(GetTerrMatter(pixelX, pixelY))->GetIntegrity();
+        m_VisibilityOpaque[cellIndex] = integrity * static_cast<float>(m_VisibilitySamplesPerCell) >= strengthLimit;
+        m_VisibilityStamps[cellIndex] = m_VisibilityStamp;
+    }
+    return m_VisibilityOpaque[cellIndex];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ScanVisibilityOctant
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recursively shadowcasts one octant of a scan's sight, revealing
+//                  the visible cells of the unseen layer.
+
+void SceneMan::ScanVisibilityOctant(BITMAP *pUnseenBitmap, std::list<Vector> &seenPixels, VisibilityScan &scan, int row, float startSlope, float endSlope, int xx, int xy, int yx, int yy)
+{
+    if (startSlope < endSlope)
+        return;
+
+    int radius = scan.Coverage.Radius;
+    int radiusSquared = radius * radius;
+    bool wrapsX = m_pCurrentScene->WrapsX();
+    bool wrapsY = m_pCurrentScene->WrapsY();
+    float newStartSlope = 0;
+    // How far from the axis the rows reach before leaving the circle, which only shrinks as they go out
+    int rowExtent = radius;
+
+    for (int distance = row; distance <= radius; ++distance)
+    {
+        while (rowExtent * rowExtent + distance * distance > radiusSquared)
+            --rowExtent;
+
+        bool blocked = false;
+        int deltaY = -distance;
+        for (int deltaX = -std::min(distance, rowExtent); deltaX <= 0; ++deltaX)
+        {
+            float leftSlope = (static_cast<float>(deltaX) - 0.5F) / (static_cast<float>(deltaY) + 0.5F);
+            float rightSlope = (static_cast<float>(deltaX) + 0.5F) / (static_cast<float>(deltaY) - 0.5F);
+            if (startSlope < rightSlope)
+                continue;
+            if (endSlope > leftSlope)
+                break;
+
+            int offsetX = deltaX * xx + deltaY * xy;
+            int offsetY = deltaX * yx + deltaY * yy;
+            int cellX = scan.OriginX + offsetX;
+            int cellY = scan.OriginY + offsetY;
+            // Off the edge of a non-wrapping Scene is as good as a wall
+            bool inBounds = WrapPixelInBounds(cellX, cellY, pUnseenBitmap->w, pUnseenBitmap->h, wrapsX, wrapsY);
+            bool opaque = !inBounds || IsVisibilityCellOpaque(cellX, cellY, pUnseenBitmap->w);
+
+            unsigned char *pPixel = inBounds ? &pUnseenBitmap->line[cellY][cellX] : 0;
+            if (pPixel && *pPixel != g_MaskColor)
+            {
+                bool seen = scan.SeesWholeOctant;
+                if (!seen)
+                {
+                    float offsetWorldX = static_cast<float>(offsetX * m_VisibilityCellWidth);
+                    float offsetWorldY = static_cast<float>(offsetY * m_VisibilityCellHeight);
+                    float lengthSquared = offsetWorldX * offsetWorldX + offsetWorldY * offsetWorldY;
+                    int distanceSquared = deltaX * deltaX + deltaY * deltaY;
+                    for (size_t coneIndex = 0; coneIndex < scan.Cones.size() && !seen; ++coneIndex)
+                    {
+                        const VisibilityCone &cone = scan.Cones[coneIndex];
+                        if (distanceSquared > cone.Radius * cone.Radius)
+                            continue;
+                        // Both sides of the cone test squared, minding their signs, so no cell needs a square root
+                        float dot = offsetWorldX * cone.LookDir.m_X + offsetWorldY * cone.LookDir.m_Y;
+                        float boundSquared = lengthSquared * cone.CosHalfFOV * cone.CosHalfFOV;
+                        seen = cone.CosHalfFOV >= 0 ? (dot >= 0 && dot * dot >= boundSquared) : (dot >= 0 || dot * dot <= boundSquared);
+                    }
+                }
+                if (seen)
+                {
+                    *pPixel = g_MaskColor;
+                    seenPixels.push_back(Vector(cellX, cellY));
+                    scan.Revealed = true;
+                }
+            }
+
+            if (blocked)
+            {
+                if (opaque)
+                {
+                    newStartSlope = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                startSlope = newStartSlope;
+            }
+            else if (opaque && distance < radius)
+            {
+                // The wall itself is seen but casts a shadow, so the part of the view passing by its near side is followed on in the next rows separately
+                blocked = true;
+                ScanVisibilityOctant(pUnseenBitmap, seenPixels, scan, distance + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                newStartSlope = rightSlope;
+            }
+        }
+        if (blocked)
+            break;
+    }
+}
+
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CastMaterialRay
@@ -1771,8 +2421,9 @@ bool SceneMan::CastUnseeRay(int team, const Vector &start, const Vector &ray, Ve
 bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool wrap)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -1857,15 +2508,15 @@ bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     return foundPixel;
@@ -1902,8 +2553,9 @@ float SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
 bool SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool checkMOs)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -1988,15 +2640,15 @@ bool SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsign
             skipped = 0;
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     return foundPixel;
@@ -2222,8 +2874,9 @@ float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int s
 bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, unsigned char ignoreMaterial, bool wrap)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -2317,15 +2970,15 @@ bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float str
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     // If no pixel of sufficient strength was found, set the result to the final tried position
@@ -2346,8 +2999,9 @@ bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float str
 bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, bool wrap)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -2437,15 +3091,15 @@ bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float str
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     // If no pixel of sufficient strength was found, set the result to the final tried position
@@ -2466,8 +3120,9 @@ bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float str
 MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -2584,15 +3239,15 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     // Didn't hit anything but air
@@ -2608,8 +3263,9 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
 bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID targetMOID, Vector &resultPos, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;;
@@ -2706,15 +3362,15 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 120);
 #endif
         }
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     // Didn't hit the target
@@ -2731,8 +3387,9 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
 float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &obstaclePos, Vector &freePos, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, int skip)
 {
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->LockBitmaps();
+    SceneLayer *pDebugLayer = GetRayDebugLayer();
+    if (pDebugLayer)
+        pDebugLayer->LockBitmaps();
 #endif
 
     int hitCount = 0, error, dom, sub, domSteps, skipped = skip;
@@ -2841,8 +3498,8 @@ float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &
 
 #ifdef DEBUG_BUILD
             // Draw debug graphics, if applicable
-            if (m_pDebugLayer)
-                m_pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
+            if (pDebugLayer)
+                pDebugLayer->SetPixel(intPos[X], intPos[Y], 13);
 #endif
         }
         else
@@ -2850,8 +3507,8 @@ float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &
     }
 
 #ifdef DEBUG_BUILD
-    if (m_pDebugLayer)
-        m_pDebugLayer->UnlockBitmaps();
+    if (pDebugLayer)
+        pDebugLayer->UnlockBitmaps();
 #endif
 
     // Add the pixel fraction to the free position if there were any free pixels
@@ -2933,47 +3590,240 @@ Vector SceneMan::MovePointToGround(const Vector &from, int maxAltitude, int accu
 // Description:     Calculates the structural integrity of the Terrain during a set time
 //                  and turns structurally unsound areas into MovableObject:s.
 
-void SceneMan::StructuralCalc(unsigned long calcTime) {
+void SceneMan::StructuralCalc(unsigned long calcTime)
+{
+    if (!m_pCurrentScene)
+        return;
 
-// TODO: Develop this!")
-    return;
+    SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+    if (!m_StructuralCalcEnabled || calcTime == 0)
+    {
+        pTerrain->ClearUpdatedStructuralAreas();
+        return;
+    }
+    if (m_StructuralDirtyCells.empty())
+        ResetStructuralCalc();
 
+    std::list<Box> &updatedAreas = pTerrain->GetUpdatedStructuralAreas();
+    for (const Box &area : updatedAreas)
+        QueueStructuralArea(area);
+    pTerrain->ClearUpdatedStructuralAreas();
 
-    if (calcTime <= 0)
-        return;
-    // Pad the time a little for FPS smoothness.
-    calcTime -= 1;
+    // Work through the oldest changes first and leave whatever doesn't fit in the budget for the next frame
     m_CalcTimer.Reset();
+    while (!m_StructuralDirtyQueue.empty() && !m_CalcTimer.IsPastRealMS(calcTime))
+    {
+        int cellIndex = m_StructuralDirtyQueue.front();
+        m_StructuralDirtyQueue.pop_front();
+        m_StructuralDirtyCells[cellIndex] = false;
+        StructuralCalcCell(cellIndex);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ResetStructuralCalc
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sizes the structural cell grid to the current Scene and forgets any
+//                  pending work, including the Terrain changes made while loading.
+
+void SceneMan::ResetStructuralCalc()
+{
+    m_StructuralDirtyQueue.clear();
+    if (!m_pCurrentScene)
+    {
+        m_StructuralCellCountX = 0;
+        m_StructuralCellCountY = 0;
+        m_StructuralDirtyCells.clear();
+        m_StructuralVisited.clear();
+        return;
+    }
+
+    m_StructuralCellCountX = (GetSceneWidth() + STRUCTURALCELLSIZE - 1) / STRUCTURALCELLSIZE;
+    m_StructuralCellCountY = (GetSceneHeight() + STRUCTURALCELLSIZE - 1) / STRUCTURALCELLSIZE;
+    m_StructuralDirtyCells.assign(m_StructuralCellCountX * m_StructuralCellCountY, false);
+    m_StructuralVisited.assign(GetSceneWidth() * GetSceneHeight(), false);
+    m_pCurrentScene->GetTerrain()->ClearUpdatedStructuralAreas();
+
+    for (int matID = 0; matID < c_PaletteEntriesNumber; ++matID)
+        m_StructuralSolid[matID] = matID != g_MaterialAir && matID != g_MaterialCavity && m_apMatPalette[matID];
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          QueueStructuralArea
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks every structural cell overlapping a box as needing evaluation.
+
+void SceneMan::QueueStructuralArea(const Box &area)
+{
+    if (m_StructuralCellCountX <= 0 || m_StructuralCellCountY <= 0)
+        return;
+
+    const float cellSize = static_cast<float>(STRUCTURALCELLSIZE);
+    Vector corner = area.GetCorner();
+    int firstCellX = static_cast<int>(std::floor(corner.m_X / cellSize));
+    int lastCellX = static_cast<int>(std::floor((corner.m_X + area.GetWidth()) / cellSize));
+    int firstCellY = static_cast<int>(std::floor(corner.m_Y / cellSize));
+    int lastCellY = static_cast<int>(std::floor((corner.m_Y + area.GetHeight()) / cellSize));
+
+    if (!SceneWrapsX())
+    {
+        firstCellX = std::max(firstCellX, 0);
+        lastCellX = std::min(lastCellX, m_StructuralCellCountX - 1);
+    }
+    else if (lastCellX - firstCellX >= m_StructuralCellCountX)
+    {
+        firstCellX = 0;
+        lastCellX = m_StructuralCellCountX - 1;
+    }
+    if (!SceneWrapsY())
+    {
+        firstCellY = std::max(firstCellY, 0);
+        lastCellY = std::min(lastCellY, m_StructuralCellCountY - 1);
+    }
+    else if (lastCellY - firstCellY >= m_StructuralCellCountY)
+    {
+        firstCellY = 0;
+        lastCellY = m_StructuralCellCountY - 1;
+    }
+
+    for (int cellY = firstCellY; cellY <= lastCellY; ++cellY)
+    {
+        int wrappedCellY = ((cellY % m_StructuralCellCountY) + m_StructuralCellCountY) % m_StructuralCellCountY;
+        for (int cellX = firstCellX; cellX <= lastCellX; ++cellX)
+        {
+            int wrappedCellX = ((cellX % m_StructuralCellCountX) + m_StructuralCellCountX) % m_StructuralCellCountX;
+            int cellIndex = wrappedCellY * m_StructuralCellCountX + wrappedCellX;
+            if (!m_StructuralDirtyCells[cellIndex])
+            {
+                m_StructuralDirtyCells[cellIndex] = true;
+                m_StructuralDirtyQueue.push_back(cellIndex);
+            }
+        }
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StructuralCalcCell
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Evaluates the support of every terrain pixel in one structural cell
+//                  and removes the ones that have none.
 
-    SLTerrain *pTerrain = g_SceneMan.GetTerrain();
-    BITMAP *pColBitmap = pTerrain->GetFGColorBitmap();
-    BITMAP *pMatBitmap = pTerrain->GetMaterialBitmap();
-    BITMAP *pStructBitmap = pTerrain->GetStructuralBitmap();
-    Material **pMatPalette = GetMaterialPalette();
-    int posX, posY, height = pColBitmap->h, width = pColBitmap->w;
+int SceneMan::StructuralCalcCell(int cellIndex)
+{
+    // The most MOPixels a single collapsing cell may spawn
+    const int maxCellParticles = 256;
+    // What's been found out about the pixels of the cell so far
+    enum CellPixelState { Unknown = 0, Supported, Unsupported };
+
+    const BITMAP *pMatBitmap = m_pCurrentScene->GetTerrain()->GetMaterialBitmap();
+    int sceneWidth = GetSceneWidth();
+    int sceneHeight = GetSceneHeight();
+    bool wrapsX = SceneWrapsX();
+    bool wrapsY = SceneWrapsY();
+
+    int cellLeft = (cellIndex % m_StructuralCellCountX) * STRUCTURALCELLSIZE;
+    int cellTop = (cellIndex / m_StructuralCellCountX) * STRUCTURALCELLSIZE;
+    int cellRight = std::min(cellLeft + STRUCTURALCELLSIZE, sceneWidth);
+    int cellBottom = std::min(cellTop + STRUCTURALCELLSIZE, sceneHeight);
+    int cellWidth = cellRight - cellLeft;
+
+    m_StructuralCellStates.assign(cellWidth * (cellBottom - cellTop), Unknown);
+    m_StructuralOrphans.clear();
+
+    auto isInCell = [&](int x, int y) { return x >= cellLeft && x < cellRight && y >= cellTop && y < cellBottom; };
+    // Marks a solid pixel as visited, wrapping it first if the scene does. Neighbors past the edges of a scene that doesn't wrap are left alone
+    auto visitPixel = [&](int x, int y, bool withinCell)
+    {
+        if (x < 0 || x >= sceneWidth)
+        {
+            if (!wrapsX)
+                return;
+            x = (x + sceneWidth) % sceneWidth;
+        }
+        if (y < 0 || y >= sceneHeight)
+        {
+            if (!wrapsY)
+                return;
+            y = (y + sceneHeight) % sceneHeight;
+        }
+        int index = y * sceneWidth + x;
+        if (m_StructuralVisited[index] || !m_StructuralSolid[pMatBitmap->line[y][x]] || (withinCell && !isInCell(x, y)))
+            return;
+        m_StructuralVisited[index] = true;
+        m_StructuralSearchVisited.push_back(index);
+        if (!withinCell)
+            m_StructuralSearchStack.push_back(index);
+    };
+
+    for (int startY = cellTop; startY < cellBottom; ++startY)
+    {
+        for (int startX = cellLeft; startX < cellRight; ++startX)
+        {
+            if (m_StructuralCellStates[(startY - cellTop) * cellWidth + startX - cellLeft] != Unknown || !m_StructuralSolid[pMatBitmap->line[startY][startX]])
+                continue;
 
-    // Lock all bitmaps involved, outside the loop.
-    acquire_bitmap(pColBitmap);
-    acquire_bitmap(pMatBitmap);
-    acquire_bitmap(pStructBitmap);
+            // Gather the whole piece of solid terrain this pixel belongs to within the cell first, so one search settles all of it
+            m_StructuralSearchVisited.clear();
+            visitPixel(startX, startY, true);
+            for (size_t head = 0; head < m_StructuralSearchVisited.size(); ++head)
+            {
+                int x = m_StructuralSearchVisited[head] % sceneWidth;
+                int y = m_StructuralSearchVisited[head] / sceneWidth;
+                visitPixel(x, y + 1, true);
+                visitPixel(x - 1, y, true);
+                visitPixel(x + 1, y, true);
+                visitPixel(x, y - 1, true);
+            }
+            m_StructuralSearchStack.assign(m_StructuralSearchVisited.begin(), m_StructuralSearchVisited.end());
 
-    // Preprocess bottom row to have full support.
-    for (posX = width - 1; posX >= 0; --posX)
-        putpixel(pStructBitmap, posX, height - 1, 255);
+            // Follow the solid terrain from there until something holds it up: the bottom of the scene is the ground, the sides of a scene that doesn't wrap are walls,
+            // and doors are held up by their frames. Neighbors below are pushed last so they're followed first, which finds the ground quickly through solid terrain.
+            // Whatever is only connected to pixels already found to be supported is supported too. If nothing holds the piece up, the search has visited all of it.
+            bool supported = false;
+            while (!m_StructuralSearchStack.empty() && !supported)
+            {
+                int index = m_StructuralSearchStack.back();
+                m_StructuralSearchStack.pop_back();
+                int x = index % sceneWidth;
+                int y = index / sceneWidth;
+                if (y == sceneHeight - 1 || (!wrapsX && (x == 0 || x == sceneWidth - 1)) || pMatBitmap->line[y][x] == g_MaterialDoor ||
+                    (isInCell(x, y) && m_StructuralCellStates[(y - cellTop) * cellWidth + x - cellLeft] == Supported))
+                {
+                    supported = true;
+                }
+                // Pieces too big to search through in one go are assumed to be held up, so a single cell can't stall the frame
+                else if (m_StructuralSearchVisited.size() > STRUCTURALSEARCHLIMIT)
+                {
+                    supported = true;
+                }
+                else
+                {
+                    visitPixel(x, y - 1, false);
+                    visitPixel(x - 1, y, false);
+                    visitPixel(x + 1, y, false);
+                    visitPixel(x, y + 1, false);
+                }
+            }
+            m_StructuralSearchStack.clear();
 
-    // Start on the second row from bottom.
-    for (posY = height - 2; posY >= 0 && !m_CalcTimer.IsPastSimMS(calcTime); --posY) {
-        for (posX = width - 1; posX >= 0; --posX) {
-            getpixel(pColBitmap, posX, posY);
-            getpixel(pMatBitmap, posX, posY);
-            getpixel(pStructBitmap, posX, posY);
+            // Everything visited belongs to the same piece, so it all shares the outcome
+            for (int index : m_StructuralSearchVisited)
+            {
+                m_StructuralVisited[index] = false;
+                int x = index % sceneWidth;
+                int y = index / sceneWidth;
+                if (isInCell(x, y))
+                    m_StructuralCellStates[(y - cellTop) * cellWidth + x - cellLeft] = supported ? Supported : Unsupported;
+                if (!supported)
+                    m_StructuralOrphans.push_back(std::make_pair(x, y));
+            }
         }
     }
 
-    // Unlock all bitmaps involved.
-    release_bitmap(pColBitmap);
-    release_bitmap(pMatBitmap);
-    release_bitmap(pStructBitmap);
+    return m_StructuralOrphans.empty() ? 0 : RemoveOrphans(m_StructuralOrphans, maxCellParticles);
 }
 
 
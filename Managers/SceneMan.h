@@ -124,7 +124,7 @@ public:
 //                  memory. Create() should be called before using the object.
 // Arguments:       None.
 
-    SceneMan() { m_pOrphanSearchBitmap = 0; Clear(); }
+    SceneMan() { Clear(); }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -526,6 +526,22 @@ public:
     MOID GetMOIDPixel(int pixelX, int pixelY);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTerrMatterSpan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reads a horizontal run of pixels from the material representation of
+//                  this Scene in one go. Wrapping and bounds are dealt with once for
+//                  every part of the run that is contiguous in the bitmap, instead of
+//                  once per pixel. LockScene() must be called before using this method.
+// Arguments:       The X and Y coordinates of the first pixel of the run.
+//                  How many pixels to read.
+//                  The buffer to fill with material indices, which must hold at least
+//                  length entries. Pixels that are out of bounds read as air.
+// Return value:    None.
+
+    void GetTerrMatterSpan(int pixelX, int pixelY, int length, unsigned char *pDest);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetGlobalAcc
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -892,37 +908,29 @@ public:
 // Method:          RemoveOrphans
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Returns the area of an orphaned region at specified coordinates. 
+//                  The search is cut short as soon as the region is known to be too big
+//                  or held up by terrain outside the search area.
 // Arguments:       Coordinates to check for region, whether the orphaned region should be converted into MOPixels and region removed.
-//					Area of orphaned object calculated during recursve function call to check if we're out of limits
 //					Size of the are to look for orphaned objects
 //					Max area of orphaned object to remove
 //					Whether to actually remove orphaned pixels or not
-//					Whether to clear internal terrain tracking bitmap or not
-// Return value:    The area of orphaned region at posX,posY
+// Return value:    The area of orphaned region at posX,posY, or more than the max area
+//                  if the region isn't orphaned.
 
     int RemoveOrphans(int posX, int posY, int radius, int maxArea, bool remove = false);
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RemoveOrphans
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Returns the area of an orphaned region at specified coordinates. 
-// Arguments:       Coordinates to check for region, whether the orphaned region should be converted into MOPixels and region removed.
-//					Coordinates of initial terrain penetration to check, which serves as a center of orphaned object detection.
-//					Area of orphaned object calculated during recursve function call to check if we're out of limits
-//					Size of the are to look for orphaned objects
-//					Max area of orphaned object to remove
-//					Whether to actually remove orphaned pixels or not
-//					Whether to clear internal terrain tracking bitmap or not
-// Return value:    The area of orphaned region at posX,posY
+// Description:     Removes a batch of terrain pixels that are known to be orphaned,
+//                  turning some of them into MOPixels, and registers the whole change
+//                  as a single area instead of pixel by pixel.
+// Arguments:       The coordinates of the pixels to remove. They may be unwrapped.
+//                  How many MOPixels the batch may spawn at most. Pixels past that are
+//                  only removed.
+// Return value:    The number of pixels that were removed.
 
-    int RemoveOrphans(int posX,
-					  int posY,
-					  int centerPosX,
-					  int centerPosY,
-					  int accumulatedArea,
-					  int radius,
-					  int maxArea,
-					  bool remove = false);
+    int RemoveOrphans(const std::vector<std::pair<int, int>> &orphanedPixels, int maxParticles);
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          MakeAllUnseen
@@ -1367,6 +1375,152 @@ public:
     void StructuralCalc(unsigned long calcTime);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsStructuralCalcEnabled
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether the structural integrity of the Terrain is evaluated
+//                  and unsupported terrain collapsed each frame.
+// Arguments:       None.
+// Return value:    Whether structural calculations are enabled or not.
+
+    bool IsStructuralCalcEnabled() const { return m_StructuralCalcEnabled; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          EnableStructuralCalc
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether the structural integrity of the Terrain is evaluated
+//                  and unsupported terrain collapsed each frame.
+// Arguments:       Whether to enable or disable structural calculations.
+// Return value:    None.
+
+    void EnableStructuralCalc(bool enable = true) { m_StructuralCalcEnabled = enable; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStructuralCalcTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much real time StructuralCalc is allowed to use each frame.
+// Arguments:       None.
+// Return value:    The time budget in ms.
+
+    unsigned long GetStructuralCalcTime() const { return m_StructuralCalcTime; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetStructuralCalcTime
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how much real time StructuralCalc is allowed to use each frame.
+//                  Work that doesn't fit is carried over to the next frame.
+// Arguments:       The time budget in ms.
+// Return value:    None.
+
+    void SetStructuralCalcTime(unsigned long calcTime) { m_StructuralCalcTime = calcTime; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStructuralCalcBacklog
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many areas of the Terrain are still waiting to have their
+//                  structural integrity evaluated.
+// Arguments:       None.
+// Return value:    The number of waiting areas.
+
+    int GetStructuralCalcBacklog() const { return m_StructuralDirtyQueue.size(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetMaxOrphanParticles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the most MOPixels a single removed orphaned region of Terrain
+//                  spawns. The rest of its pixels just disappear.
+// Arguments:       None.
+// Return value:    The most MOPixels per removed region. 0 means none are spawned.
+
+    int GetMaxOrphanParticles() const { return m_MaxOrphanParticles; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetMaxOrphanParticles
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the most MOPixels a single removed orphaned region of Terrain
+//                  spawns. The rest of its pixels just disappear.
+// Arguments:       The most MOPixels per removed region. 0 means none are spawned.
+// Return value:    None.
+
+    void SetMaxOrphanParticles(int maxParticles) { m_MaxOrphanParticles = std::max(maxParticles, 0); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsTeamVisibilityEnabled
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether the unseen layers are revealed by the periodic
+//                  per-team visibility pass, instead of by a ray cast per Actor per frame.
+// Arguments:       None.
+// Return value:    Whether the team visibility pass is enabled or not.
+
+    bool IsTeamVisibilityEnabled() const { return m_TeamVisibilityInterval > 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTeamVisibilityInterval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many sim updates there are between team visibility passes.
+// Arguments:       None.
+// Return value:    The number of updates between passes. 0 means the pass is disabled.
+
+    int GetTeamVisibilityInterval() const { return m_TeamVisibilityInterval; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetTeamVisibilityInterval
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets how many sim updates there are between team visibility passes.
+// Arguments:       The number of updates between passes. 0 disables the pass, and each
+//                  Actor goes back to casting its own seeing ray every update.
+// Return value:    None.
+
+    void SetTeamVisibilityInterval(int interval) { m_TeamVisibilityInterval = std::max(interval, 0); m_TeamVisibilityFrame = 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WantsTeamViewers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Indicates whether the next team visibility pass runs this update, so
+//                  viewers registered now will actually be used.
+// Arguments:       None.
+// Return value:    Whether viewers should be registered this update.
+
+    bool WantsTeamViewers() const { return m_TeamVisibilityInterval > 0 && m_TeamVisibilityFrame % m_TeamVisibilityInterval == 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RegisterTeamViewer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Adds a point of view to be folded into the next visibility pass of a
+//                  team. Ignored on updates where no pass will run.
+// Arguments:       The team that is looking.
+//                  The scene position of the eyes.
+//                  The direction of the look, with the magnitude being the view range.
+//                  Half the angle of the view cone in degrees. 180 or more sees all around.
+// Return value:    None.
+
+    void RegisterTeamViewer(int team, const Vector &eyePos, const Vector &lookVector, float halfFOV);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateTeamVisibility
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the team visibility pass if it is due this update. Every team's
+//                  registered viewers are shadowcast together over a coarse opacity grid
+//                  at the resolution of the team's unseen layer, and all the cells they
+//                  can see are revealed in one go.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateTeamVisibility();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          IsWithinBounds
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1703,8 +1857,10 @@ protected:
 
     // Debug layer for seeing cast rays etc
     SceneLayer *m_pDebugLayer;
-    // The absolute end position of the last ray cast
-    Vector m_LastRayHitPos;
+    // The thread SceneMan was set up on. Only rays cast from it draw on the debug layer
+    std::thread::id m_MainThreadID;
+    // The absolute end position of the last ray cast on this thread. Per thread so rays can be cast from several threads at once, like in the AI sense phase
+    static thread_local Vector m_LastRayHitPos;
     // The mode we're drawing layers in to the screen
     int m_LayerDrawMode;
 
@@ -1753,11 +1909,94 @@ protected:
     // The Timer that keeps track of how much time there is left for
     // structural calculations each frame.
     Timer m_CalcTimer;
+    // Whether the structural integrity of the Terrain is evaluated each frame
+    bool m_StructuralCalcEnabled;
+    // The real time in ms StructuralCalc is allowed to use each frame
+    unsigned long m_StructuralCalcTime;
+    // The number of structural cells across and down the current Scene
+    int m_StructuralCellCountX;
+    int m_StructuralCellCountY;
+    // Which structural cells are waiting to be evaluated, so a cell is never queued twice
+    std::vector<bool> m_StructuralDirtyCells;
+    // The waiting structural cells in the order they were changed, oldest first
+    std::deque<int> m_StructuralDirtyQueue;
+    // Which Scene pixels the current anchor search has visited, one bit per pixel. Cleared again after every search
+    std::vector<bool> m_StructuralVisited;
+    // Scratch buffers reused for every evaluated cell, so the solver doesn't allocate while running
+    std::vector<int> m_StructuralSearchVisited;
+    std::vector<int> m_StructuralSearchStack;
+    std::vector<unsigned char> m_StructuralCellStates;
+    std::vector<std::pair<int, int>> m_StructuralOrphans;
+    // Whether each material is solid and can hold up what it touches, indexed by material ID. Air, cavities and undefined materials can't
+    bool m_StructuralSolid[c_PaletteEntriesNumber];
 
     // The Timer to measure time between cleanings of the color layer of the Terrain.
     Timer m_CleanTimer;
-	// Bitmap to look for orphaned regions
-	BITMAP * m_pOrphanSearchBitmap;
+	// Which pixels of the orphan search area have been visited, by search stamp, so the buffer doesn't need clearing between searches
+	std::vector<unsigned int> m_OrphanSearchVisited;
+	// The stamp of the current orphan search
+	unsigned int m_OrphanSearchStamp;
+	// Scanline seeds and found pixels of the current orphan search, kept around so searching doesn't allocate
+	std::vector<std::pair<int, int>> m_OrphanSearchSeeds;
+	std::vector<std::pair<int, int>> m_OrphanSearchPixels;
+	// Which pixels of the orphan search area are known to be part of anchored regions, by anchored stamp. Only valid for the search window below
+	std::vector<unsigned int> m_AnchoredPixelStamps;
+	// The stamp of the search window the anchored pixels were found in, bumped whenever a search looks through a different window
+	unsigned int m_AnchoredPixelStamp;
+	// The search window the anchored pixels are valid for: its top left corner, the radius and max area of the search, and the sim tick it ran in
+	int m_AnchoredWindowX;
+	int m_AnchoredWindowY;
+	int m_AnchoredWindowKey;
+	long long m_AnchoredWindowTick;
+	// The most MOPixels a single removed orphaned region spawns
+	int m_MaxOrphanParticles;
+
+    // A point of view waiting for the next team visibility pass
+    struct TeamViewer {
+        Vector EyePos;
+        Vector LookDir;
+        float Range;
+        float HalfFOV;
+    };
+    // One cone of sight, with its half angle in radians and its range in unseen layer cells
+    struct VisibilityCone {
+        Vector LookDir;
+        float LookAngle;
+        float HalfFOV;
+        float CosHalfFOV;
+        // The directions of the edges of the cone, counterclockwise and clockwise from the look direction
+        Vector MinEdge;
+        Vector MaxEdge;
+        int Radius;
+    };
+    // The parameters of the octant scans of all the viewers standing in one unseen layer cell whose cones overlap
+    struct VisibilityScan {
+        Vector EyePos;
+        int OriginX;
+        int OriginY;
+        // The cones of the merged viewers, and the one cone covering all of them that limits what gets scanned
+        std::vector<VisibilityCone> Cones;
+        VisibilityCone Coverage;
+        // Whether one of the cones sees all of the octant being scanned as far as the scan goes, so no cell needs checking against them
+        bool SeesWholeOctant;
+        bool Revealed;
+    };
+    // How many sim updates there are between team visibility passes, 0 meaning each Actor casts its own rays instead
+    int m_TeamVisibilityInterval;
+    // How many sim updates have been counted towards the next team visibility pass
+    int m_TeamVisibilityFrame;
+    // The viewers of each team registered for the next visibility pass
+    std::vector<TeamViewer> m_TeamViewers[Activity::MaxTeamCount];
+    // The scans of the current visibility pass, reused between passes so their cone lists aren't reallocated
+    std::vector<VisibilityScan> m_VisibilityScans;
+    // Whether each cell of the coarse opacity grid blocks sight, valid only where its stamp matches the current one, so the grid is only sampled where viewers actually look
+    std::vector<bool> m_VisibilityOpaque;
+    std::vector<unsigned int> m_VisibilityStamps;
+    unsigned int m_VisibilityStamp;
+    // The unseen layer cell size and number of seeing ray samples per cell the opacity grid is currently built for
+    int m_VisibilityCellWidth;
+    int m_VisibilityCellHeight;
+    int m_VisibilitySamplesPerCell;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1775,7 +2014,175 @@ private:
 
     void Clear();
 
-    
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ResetStructuralCalc
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sizes the structural cell grid to the current Scene and forgets any
+//                  pending work, including the Terrain changes made while loading.
+// Arguments:       None.
+// Return value:    None.
+
+    void ResetStructuralCalc();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          QueueStructuralArea
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Marks every structural cell overlapping a box as needing evaluation.
+// Arguments:       The unwrapped box of the changed area.
+// Return value:    None.
+
+    void QueueStructuralArea(const Box &area);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StructuralCalcCell
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds out whether each piece of solid terrain in one structural cell
+//                  is connected to the ground, a wall or a door, and removes the pieces
+//                  that aren't.
+// Arguments:       The index of the cell in the structural cell grid.
+// Return value:    The number of pixels that were removed.
+
+    int StructuralCalcCell(int cellIndex);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RemoveOrphanPixel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Clears a single terrain pixel, optionally spawning a MOPixel of its
+//                  material drifting off it. Does not register the terrain change.
+// Arguments:       The wrapped coordinates of the pixel.
+//                  Whether to spawn a MOPixel for it.
+// Return value:    None.
+
+    void RemoveOrphanPixel(int posX, int posY, bool spawnParticle);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsVisibilityCellOpaque
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether a cell of the coarse opacity grid blocks sight, sampling
+//                  the Terrain under it the first time it is asked about this pass.
+// Arguments:       The wrapped coordinates of the cell on the unseen layer.
+//                  The width of the unseen layer in cells.
+// Return value:    Whether the cell would stop a seeing ray.
+
+    bool IsVisibilityCellOpaque(int cellX, int cellY, int layerWidth);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetVisibilityCone
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Fills in a cone of sight from its look direction and half angle.
+// Arguments:       The cone to fill in.
+//                  The normalized look direction.
+//                  Half the angle of the cone in radians. Pi or more sees all around.
+//                  The range of the cone in unseen layer cells.
+// Return value:    None.
+
+    void SetVisibilityCone(VisibilityCone &cone, const Vector &lookDir, float halfFOV, int radius);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          MergeVisibilityCone
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Widens a cone of sight to also cover another one, if the two overlap.
+// Arguments:       The cone to widen.
+//                  The cone to cover.
+// Return value:    Whether the cones overlapped and were merged.
+
+    bool MergeVisibilityCone(VisibilityCone &coverage, const VisibilityCone &cone);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetVisibilityConeSlopes
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Works out which part of an octant a cone of sight can see, as the
+//                  range of scan slopes from 0 along the octant's axis to 1 along its
+//                  diagonal.
+// Arguments:       The cone.
+//                  The unseen layer offset of one row along the octant's axis, in pixels.
+//                  The unseen layer offset of one column towards the diagonal, in pixels.
+//                  The slopes bounding the part of the octant that is seen.
+//                  Whether all of the octant is seen.
+// Return value:    Whether any of the octant is seen.
+
+    bool GetVisibilityConeSlopes(const VisibilityCone &cone, const Vector &rowOffset, const Vector &columnOffset, float &lowSlope, float &highSlope, bool &wholeOctant);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ScanVisibilityOctant
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Recursively shadowcasts one octant of a scan's sight, revealing
+//                  the visible cells of the unseen layer.
+// Arguments:       The unseen layer bitmap being revealed.
+//                  The list the revealed cells are added to.
+//                  The scan parameters.
+//                  The row of the octant to start at.
+//                  The slopes bounding the still visible part of the octant.
+//                  The transform from octant to unseen layer coordinates.
+// Return value:    None.
+
+    void ScanVisibilityOctant(BITMAP *pUnseenBitmap, std::list<Vector> &seenPixels, VisibilityScan &scan, int row, float startSlope, float endSlope, int xx, int xy, int yx, int yy);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WrapPixelInBounds
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Wraps a pixel coordinate onto a layer along the axes that wrap, and
+//                  tells whether it ended up within the layer. Specialized at compile
+//                  time so the non-wrapping axes cost a single compare.
+// Arguments:       The X and Y coordinates to wrap, which will be modified.
+//                  The width and height of the layer.
+// Return value:    Whether the coordinates are within the layer after wrapping.
+
+    template <bool WrapX, bool WrapY>
+    static bool WrapPixelInBounds(int &pixelX, int &pixelY, int width, int height);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetRayDebugLayer
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the debug layer if rays cast from the calling thread may draw on
+//                  it. Rays cast from other threads, like the AI sense workers, don't,
+//                  since the layer can't be drawn on from several threads at once.
+// Arguments:       None.
+// Return value:    The debug layer, or 0 if there is none or this isn't the main thread.
+
+    SceneLayer * GetRayDebugLayer() const { return (std::this_thread::get_id() == m_MainThreadID) ? m_pDebugLayer : 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          WrapPixelInBounds
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Picks the specialization of WrapPixelInBounds that matches the
+//                  wrapping settings passed in.
+// Arguments:       The X and Y coordinates to wrap, which will be modified.
+//                  The width and height of the layer.
+//                  Whether the layer wraps horizontally and vertically.
+// Return value:    Whether the coordinates are within the layer after wrapping.
+
+    static bool WrapPixelInBounds(int &pixelX, int &pixelY, int width, int height, bool wrapX, bool wrapY);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ReadSpan
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Copies a horizontal run of pixels from a bitmap, splitting it at the
+//                  horizontal seam and filling anything out of bounds with a set value.
+// Arguments:       The bitmap to read from. Its pixels must be of type PixelType.
+//                  The X and Y coordinates of the first pixel of the run.
+//                  How many pixels to read.
+//                  The buffer to fill, which must hold at least length entries.
+//                  The value to write for pixels that are out of bounds.
+// Return value:    None.
+
+    template <bool WrapX, bool WrapY, typename PixelType, typename DestType>
+    static void ReadSpan(const BITMAP *pBitmap, int pixelX, int pixelY, int length, DestType *pDest, DestType outOfBoundsValue);
+
+
     // Disallow the use of some implicit methods.
 	SceneMan(const SceneMan &reference) = delete;
 	SceneMan & operator=(const SceneMan &rhs) = delete;
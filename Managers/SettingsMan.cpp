@@ -6,6 +6,7 @@
 #include "PerformanceMan.h"
 #include "PostProcessMan.h"
 #include "UInputMan.h"
+#include "LuaMan.h"
 
 namespace RTE {
 
@@ -40,7 +41,9 @@ namespace RTE {
 		m_NATServiceAddress = "127.0.0.1:61111";
 		m_NATServerName = "DefaultServerName";
 		m_NATServerPassword = "DefaultServerPassword";
+		m_SpectatorRelayPassword.clear();
 		m_ClientInputFps = 30;
+		m_ClientUseScrollPrediction = true;
 		m_ServerTransmitAsBoxes = true;
 		m_ServerBoxWidth = 32;
 		m_ServerBoxHeight = 44;
@@ -50,6 +53,7 @@ namespace RTE {
 		m_ServerFastAccelerationFactor = 1;
 		m_ServerUseInterlacing = false;
 		m_ServerEncodingFps = 30;
+		m_ServerUseAdaptiveQuality = true;
 		m_ServerSleepWhenIdle = false;
 		m_ServerSimSleepWhenIdle = false;
 
@@ -58,6 +62,7 @@ namespace RTE {
 		m_ShowMetaScenes = false;
 
 		m_RecommendedMOIDCount = 240;
+		m_SparseTerrainLayers = false;
 		m_PreciseCollisions = true;
 
 		m_LaunchIntoActivity = false;
@@ -142,6 +147,24 @@ namespace RTE {
 			reader >> m_BlipOnRevealUnseen;
 		} else if (propName == "MaxUnheldItems") {
 			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "ParticleBudget") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "SettleTimeBudgetMS") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "EnableSimLODGovernor") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "SimLODTargetLoad") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "LockSimLODSettling") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "LockSimLODCosmeticEmission") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "LockSimLODAISensing") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "LockSimLODFarUpdates") {
+			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "LockSimLODTinyParticleCollisions") {
+			g_MovableMan.ReadProperty(propName, reader);
 		} else if (propName == "SloMoThreshold") {
 			g_MovableMan.ReadProperty(propName, reader);
 		} else if (propName == "SloMoDurationMS") {
@@ -175,6 +198,20 @@ namespace RTE {
 			g_MovableMan.ReadProperty(propName, reader);
 		} else if (propName == "EnableMOSubtraction") {
 			g_MovableMan.ReadProperty(propName, reader);
+		} else if (propName == "EnableStructuralCalc") {
+			g_SceneMan.ReadProperty(propName, reader);
+		} else if (propName == "StructuralCalcTimeMS") {
+			g_SceneMan.ReadProperty(propName, reader);
+		} else if (propName == "MaxOrphanParticles") {
+			g_SceneMan.ReadProperty(propName, reader);
+		} else if (propName == "SparseTerrainLayers") {
+			reader >> m_SparseTerrainLayers;
+		} else if (propName == "TeamVisibilityInterval") {
+			g_SceneMan.ReadProperty(propName, reader);
+		} else if (propName == "LuaGCTimeBudgetUS") {
+			g_LuaMan.SetGCTimeBudget(std::stoi(reader.ReadPropValue()));
+		} else if (propName == "LuaGCIdleTimeLimitUS") {
+			g_LuaMan.SetGCIdleTimeLimit(std::stoi(reader.ReadPropValue()));
 		} else if (propName == "DeltaTime") {
 			g_TimerMan.SetDeltaTimeSecs(std::stof(reader.ReadPropValue()));
 		} else if (propName == "RealToSimCap") {
@@ -211,8 +248,12 @@ namespace RTE {
 			reader >> m_NATServerName;
 		} else if (propName == "NATServerPassword") {
 			reader >> m_NATServerPassword;
+		} else if (propName == "SpectatorRelayPassword") {
+			reader >> m_SpectatorRelayPassword;
 		} else if (propName == "ClientInputFps") {
 			reader >> m_ClientInputFps;
+		} else if (propName == "ClientUseScrollPrediction") {
+			reader >> m_ClientUseScrollPrediction;
 		} else if (propName == "ServerTransmitAsBoxes") {
 			reader >> m_ServerTransmitAsBoxes;
 		} else if (propName == "ServerBoxWidth") {
@@ -231,6 +272,8 @@ namespace RTE {
 			reader >> m_ServerUseInterlacing;
 		} else if (propName == "ServerEncodingFps") {
 			reader >> m_ServerEncodingFps;
+		} else if (propName == "ServerUseAdaptiveQuality") {
+			reader >> m_ServerUseAdaptiveQuality;
 		} else if (propName == "ServerSleepWhenIdle") {
 			reader >> m_ServerSleepWhenIdle;
 		} else if (propName == "ServerSimSleepWhenIdle") {
@@ -310,6 +353,25 @@ namespace RTE {
 		writer << m_BlipOnRevealUnseen;
 		writer.NewProperty("MaxUnheldItems");
 		writer << g_MovableMan.GetMaxDroppedItems();
+		writer.NewProperty("ParticleBudget");
+		writer << g_MovableMan.GetParticleBudget();
+		writer.NewProperty("SettleTimeBudgetMS");
+		writer << g_MovableMan.GetSettleTimeBudget();
+		const SimLODGovernor &simLODGovernor = g_MovableMan.GetSimLODGovernor();
+		writer.NewProperty("EnableSimLODGovernor");
+		writer << simLODGovernor.IsEnabled();
+		writer.NewProperty("SimLODTargetLoad");
+		writer << simLODGovernor.GetTargetLoad();
+		writer.NewProperty("LockSimLODSettling");
+		writer << simLODGovernor.IsKnobLocked(SimLODGovernor::SettleAggressiveness);
+		writer.NewProperty("LockSimLODCosmeticEmission");
+		writer << simLODGovernor.IsKnobLocked(SimLODGovernor::CosmeticEmission);
+		writer.NewProperty("LockSimLODAISensing");
+		writer << simLODGovernor.IsKnobLocked(SimLODGovernor::AISenseFrequency);
+		writer.NewProperty("LockSimLODFarUpdates");
+		writer << simLODGovernor.IsKnobLocked(SimLODGovernor::FarUpdateRate);
+		writer.NewProperty("LockSimLODTinyParticleCollisions");
+		writer << simLODGovernor.IsKnobLocked(SimLODGovernor::TinyParticleMOCollision);
 		writer.NewProperty("SloMoThreshold");
 		writer << g_MovableMan.GetSloMoThreshold();
 		writer.NewProperty("SloMoDurationMS");
@@ -353,6 +415,20 @@ namespace RTE {
 		writer << g_MovableMan.IsParticleSettlingEnabled();
 		writer.NewProperty("EnableMOSubtraction");
 		writer << g_MovableMan.IsMOSubtractionEnabled();
+		writer.NewProperty("EnableStructuralCalc");
+		writer << g_SceneMan.IsStructuralCalcEnabled();
+		writer.NewProperty("StructuralCalcTimeMS");
+		writer << g_SceneMan.GetStructuralCalcTime();
+		writer.NewProperty("MaxOrphanParticles");
+		writer << g_SceneMan.GetMaxOrphanParticles();
+		writer.NewProperty("SparseTerrainLayers");
+		writer << m_SparseTerrainLayers;
+		writer.NewProperty("TeamVisibilityInterval");
+		writer << g_SceneMan.GetTeamVisibilityInterval();
+		writer.NewProperty("LuaGCTimeBudgetUS");
+		writer << g_LuaMan.GetGCTimeBudget();
+		writer.NewProperty("LuaGCIdleTimeLimitUS");
+		writer << g_LuaMan.GetGCIdleTimeLimit();
 		writer.NewProperty("DeltaTime");
 		writer << g_TimerMan.GetDeltaTimeSecs();
 		writer.NewProperty("RealToSimCap");
@@ -404,6 +480,8 @@ namespace RTE {
 		writer << m_NATServerName;
 		writer.NewProperty("NATServerPassword");
 		writer << m_NATServerPassword;
+		writer.NewProperty("SpectatorRelayPassword");
+		writer << m_SpectatorRelayPassword;
 
 		writer.NewLine(false, 2);
 		writer.NewDivider(false);
@@ -411,6 +489,8 @@ namespace RTE {
 		writer.NewLine(false);
 		writer.NewProperty("ClientInputFps");
 		writer << m_ClientInputFps;
+		writer.NewProperty("ClientUseScrollPrediction");
+		writer << m_ClientUseScrollPrediction;
 		writer.NewProperty("ServerTransmitAsBoxes");
 		writer << m_ServerTransmitAsBoxes;
 		writer.NewProperty("ServerBoxWidth");
@@ -429,6 +509,8 @@ namespace RTE {
 		writer << m_ServerUseInterlacing;
 		writer.NewProperty("ServerEncodingFps");
 		writer << m_ServerEncodingFps;
+		writer.NewProperty("ServerUseAdaptiveQuality");
+		writer << m_ServerUseAdaptiveQuality;
 		writer.NewProperty("ServerSleepWhenIdle");
 		writer << m_ServerSleepWhenIdle;
 		writer.NewProperty("ServerSimSleepWhenIdle");
@@ -87,6 +87,12 @@ namespace RTE {
 		/// </summary>
 		/// <param name="newValue">True for precise collisions.</param>
 		void SetPreciseCollisions(bool newValue) { m_PreciseCollisions = newValue; }
+
+		/// <summary>
+		/// Gets whether the material and color layers of terrain are loaded as sparse bitmaps, where rows filled with a single value share their memory until they're changed.
+		/// </summary>
+		/// <returns>Whether terrain layers are sparse.</returns>
+		bool SparseTerrainLayers() const { return m_SparseTerrainLayers; }
 #pragma endregion
 
 #pragma region Display Settings
@@ -254,6 +260,12 @@ namespace RTE {
 		/// <param name="newValue">New password to use when connecting via NAT punch-through service.</param>
 		void SetNATServerPassword(std::string newValue) { m_NATServerPassword = newValue.empty() ? "DefaultServerPassword" : newValue; }
 
+		/// <summary>
+		/// Gets the password a spectator relay has to give to have a player's stream mirrored to it.
+		/// </summary>
+		/// <returns>The spectator relay password. Empty if relays aren't allowed to register.</returns>
+		const std::string & GetSpectatorRelayPassword() const { return m_SpectatorRelayPassword; }
+
 		/// <summary>
 		/// Gets whether server is using higher compression methods.
 		/// </summary>
@@ -290,12 +302,24 @@ namespace RTE {
 		/// <returns>The server frame transmission rate.</returns>
 		unsigned short GetServerEncodingFps() const { return m_ServerEncodingFps; }
 
+		/// <summary>
+		/// Gets whether the server adapts each client's frame rate, interlacing, box size and compression to what its connection keeps up with.
+		/// </summary>
+		/// <returns>Whether the server adapts the quality per client or not.</returns>
+		bool GetServerUseAdaptiveQuality() const { return m_ServerUseAdaptiveQuality; }
+
 		/// <summary>
 		/// Gets the input send rate between the client and the server.
 		/// </summary>
 		/// <returns>The input send rate.</returns>
 		unsigned short GetClientInputFps() const { return m_ClientInputFps; }
 
+		/// <summary>
+		/// Gets whether the client draws the view where it predicts it scrolled to since the last frame received from the server.
+		/// </summary>
+		/// <returns>Whether the client predicts scrolling or not.</returns>
+		bool GetClientUseScrollPrediction() const { return m_ClientUseScrollPrediction; }
+
 		/// <summary>
 		/// Gets whether the server transmits frames as blocks instead of lines.
 		/// </summary>
@@ -503,12 +527,15 @@ namespace RTE {
 		std::string m_NATServiceAddress; //!< NAT punch-through server address.
 		std::string m_NATServerName; //!< Server name to use when connecting via NAT punch-through service.
 		std::string m_NATServerPassword; //!< Server password to use when connecting via NAT punch-through service.
+		std::string m_SpectatorRelayPassword; //!< Password spectator relays have to give to register with the server. Empty refuses all relays.
 		unsigned short m_ClientInputFps; //!< The rate (in FPS) the client input is sent to the server.
+		bool m_ClientUseScrollPrediction; //!< Whether the client redraws the terrain and backgrounds every frame at where it predicts the view scrolled to, instead of only showing where the last received frame was, to hide the latency of the server.
 		bool m_ServerUseHighCompression; //!< Whether to use higher compression methods (default).
 		bool m_ServerUseFastCompression; //!< Whether to use faster compression methods and conserve CPU.
 		int m_ServerHighCompressionLevel; //!< Compression level. 10 is optimal, 12 is highest.
 		bool m_ServerUseInterlacing; //!< Use interlacing to heavily reduce bandwidth usage at the cost of visual degradation (unusable at 30 fps, but may be suitable at 60 fps).
 		unsigned short m_ServerEncodingFps; //!< Frame transmission rate. Higher value equals more CPU and bandwidth consumption.
+		bool m_ServerUseAdaptiveQuality; //!< Whether to lower the frame rate, interlace, send bigger boxes and compress harder for clients whose connection can't keep up with the configured settings, and raise them back once it can.
 		bool m_ServerSleepWhenIdle; //!< If true puts thread to sleep if it didn't receive anything for 10 seconds to avoid melting the CPU at 100% even if there are no connections.
 		bool m_ServerSimSleepWhenIdle; //!< If true the server will try to put the thread to sleep to reduce CPU load if the sim frame took less time to complete than it should at 30 fps.
 
@@ -532,6 +559,7 @@ namespace RTE {
 
 		unsigned int m_RecommendedMOIDCount; //!< Recommended max MOID's before removing actors from scenes.
 		bool m_PreciseCollisions; //!<Whether to use additional Draws during MO's PreTravel and PostTravel to update MO layer this frame with more precision, or just uses data from the last frame with less precision.
+		bool m_SparseTerrainLayers; //!< Whether the material and color layers of terrain are loaded as sparse bitmaps.
 
 		bool m_LaunchIntoActivity; //!< Whether to skip the intro and main menu and launch directly into the set default activity instead.
 
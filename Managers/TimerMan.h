@@ -98,6 +98,12 @@ namespace RTE {
 		/// <returns>The number of pure sim updates that have happened since the last drawn.</returns>
 		int SimUpdatesSinceDrawn() const { return m_SimUpdatesSinceDrawn; }
 
+		/// <summary>
+		/// Gets the number of whole sim updates that have been made since the sim was last reset.
+		/// </summary>
+		/// <returns>The number of sim updates.</returns>
+		long long GetSimUpdateCount() const { return m_SimUpdateCount; }
+
 		/// <summary>
 		/// Gets a time scale factor which will be used to speed up or slow down the progress of the simulation time in relation to the real world time.
 		/// </summary>
@@ -1797,6 +1797,8 @@ void BuyMenuGUI::CategoryChange(bool focusOnCategoryTabs)
         m_pCategoryTabs[m_MenuCategory]->SetFocus();
         m_pCategoryTabs[m_MenuCategory]->SetCheck(true);
     }
+    // Don't rebuild the list for every one of the possibly thousands of items added, only once they're all in
+    m_pShopList->BeginUpdate();
     m_pShopList->ClearList();
 
     // Hide/show the logo and special sets category buttons, and add all current presets to the list, and we're done.
@@ -1807,6 +1809,7 @@ void BuyMenuGUI::CategoryChange(bool focusOnCategoryTabs)
         m_pClearButton->SetVisible(true);
         // Add and done!
         AddPresetsToItemList();
+        m_pShopList->EndUpdate();
         return;
     }
     // Hide the sets buttons otherwise
@@ -1918,6 +1921,8 @@ void BuyMenuGUI::CategoryChange(bool focusOnCategoryTabs)
         }
     }
 
+    m_pShopList->EndUpdate();
+
     // Set the last saved index for this category so the menu scrolls down to it
     m_pShopList->SetSelectedIndex(m_CategoryItemIndex[m_MenuCategory]);
     m_ListItemIndex = m_CategoryItemIndex[m_MenuCategory];
@@ -1120,6 +1120,7 @@ void ObjectPickerGUI::Draw(BITMAP *drawBitmap) const
 void ObjectPickerGUI::UpdateGroupsList()
 {
     // Load in all the groups that exist in the given modulespace
+    m_pGroupsList->BeginUpdate();
     m_pGroupsList->ClearList();
 
 //    m_pGroupsList->AddItem("Bunker Modules");
@@ -1188,6 +1189,7 @@ void ObjectPickerGUI::UpdateGroupsList()
         if (!objectList.empty() && hasObjectsToShow && (!onlyAssembliesInGroup || *gItr == "Assemblies") && (!onlySchemesInGroup || showSchemes))// && *gItr != "Bunker Modules")
             m_pGroupsList->AddItem(*gItr);
     }
+    m_pGroupsList->EndUpdate();
 
     // Select and load the first group
     GUIListPanel::Item *pItem = m_pGroupsList->GetItem(0);
@@ -1207,6 +1209,8 @@ void ObjectPickerGUI::UpdateGroupsList()
 
 void ObjectPickerGUI::UpdateObjectsList(bool selectTop)
 {
+    // Don't rebuild the list for every one of the possibly thousands of items added, only once they're all in
+    m_pObjectsList->BeginUpdate();
     m_pObjectsList->ClearList();
 
     // The vector of lists which will be filled with objects, grouped by which data module they were read from
@@ -1297,6 +1301,8 @@ void ObjectPickerGUI::UpdateObjectsList(bool selectTop)
         }
     }
 
+    m_pObjectsList->EndUpdate();
+
     if (selectTop)
     {
         // Scroll the item list to the top
@@ -1805,6 +1805,7 @@ void ScenarioGUI::GetAllScenesAndActivities()
     // Go through the list and cast all the pointers to Activities so we have a handy list
     // Associate all Scenes compatible with each Activity
     // Populate the activities selection dropdown while we're at it
+    m_pActivitySelect->BeginUpdate();
     m_pActivitySelect->ClearList();
     int index = 0;
     int tutorialIndex = -1;
@@ -1835,6 +1836,7 @@ void ScenarioGUI::GetAllScenesAndActivities()
             index++;
         }
     }
+    m_pActivitySelect->EndUpdate();
 
     // Select the Tutorial Activity and Scene by default to start
     if (tutorialIndex >= 0)
@@ -0,0 +1,349 @@
+#include "LoadTestClient.h"
+
+#include "GetTime.h"
+
+#include <lz4.h>
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::Clear() {
+		m_Client = nullptr;
+		m_ServerID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+		m_Name.clear();
+		m_ResX = 0;
+		m_ResY = 0;
+		m_IsRegistered = false;
+		m_SceneReceived = false;
+		m_SceneID = 0;
+		m_SceneWidth = 0;
+		m_SceneHeight = 0;
+		for (int layer = 0; layer < 2; layer++) {
+			m_SceneLayers[layer].clear();
+			m_FrameLayers[layer].clear();
+		}
+		m_InputRNG.seed(0);
+		m_InputElementHeld = 0;
+		m_LastInputTime = 0;
+		m_NextInputChangeTime = 0;
+		m_Stats = { false, false, 0, 0, 0, 0, 0, -1 };
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int LoadTestClient::Create(const std::string &serverAddress, unsigned short serverPort, const std::string &name, int resX, int resY, unsigned int inputSeed) {
+		m_Name = name;
+		m_ResX = resX;
+		m_ResY = resY;
+		m_InputRNG.seed(inputSeed);
+		for (std::vector<unsigned char> &frameLayer : m_FrameLayers) {
+			frameLayer.assign(static_cast<size_t>(m_ResX) * static_cast<size_t>(m_ResY), 0);
+		}
+
+		m_Client = RakNet::RakPeerInterface::GetInstance();
+		RakNet::SocketDescriptor socketDescriptor;
+		socketDescriptor.socketFamily = AF_INET;
+		if (m_Client->Startup(1, &socketDescriptor, 1) != RakNet::RAKNET_STARTED) {
+			return -1;
+		}
+		m_Client->SetOccasionalPing(true);
+
+		if (m_Client->Connect(serverAddress.c_str(), serverPort, 0, 0) != RakNet::CONNECTION_ATTEMPT_STARTED) {
+			return -1;
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::Destroy() {
+		if (m_Client) {
+			if (m_ServerID != RakNet::UNASSIGNED_SYSTEM_ADDRESS) { SendIDOnlyMsg(ID_CLT_DISCONNECT); }
+			m_Client->Shutdown(300);
+			RakNet::RakPeerInterface::DestroyInstance(m_Client);
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::Update() {
+		for (RakNet::Packet *packet = m_Client->Receive(); packet; m_Client->DeallocatePacket(packet), packet = m_Client->Receive()) {
+			m_Stats.BytesReceived += packet->length;
+			RakNet::TimeUS decodeStartTime = RakNet::GetTimeUS();
+
+			switch (GetPacketIdentifier(packet)) {
+				case ID_CONNECTION_REQUEST_ACCEPTED:
+					m_ServerID = packet->systemAddress;
+					SendRegisterMsg();
+					break;
+				case ID_CONNECTION_ATTEMPT_FAILED:
+				case ID_NO_FREE_INCOMING_CONNECTIONS:
+				case ID_DISCONNECTION_NOTIFICATION:
+				case ID_CONNECTION_LOST:
+					m_ServerID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+					m_IsRegistered = false;
+					m_SceneReceived = false;
+					break;
+				case ID_SRV_ACCEPTED:
+					m_IsRegistered = true;
+					break;
+				case ID_SRV_FRAME_SETUP:
+					ReceiveFrameSetupMsg(packet);
+					break;
+				case ID_SRV_FRAME_LINE:
+					ReceiveFrameLineMsg(packet);
+					break;
+				case ID_SRV_FRAME_BOX:
+					ReceiveFrameBoxMsg(packet);
+					break;
+				case ID_SRV_SCENE_SETUP:
+					ReceiveSceneSetupMsg(packet);
+					break;
+				case ID_SRV_SCENE:
+					ReceiveSceneMsg(packet);
+					break;
+				case ID_SRV_SCENE_END:
+					SendIDOnlyMsg(ID_CLT_SCENE_ACCEPTED);
+					m_SceneReceived = true;
+					break;
+				case ID_SRV_TERRAIN:
+					ReceiveTerrainChangeMsg(packet);
+					break;
+				// Post effects, sounds and music aren't decoded any further than NetworkClient does before drawing or playing them, so counting their bytes is all there is to do
+				default:
+					break;
+			}
+			m_Stats.DecodeMicroseconds += RakNet::GetTimeUS() - decodeStartTime;
+		}
+
+		if (m_IsRegistered && RakNet::GetTimeMS() - m_LastInputTime >= c_InputIntervalMS) { SendInputMsg(); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	LoadTestClient::Stats LoadTestClient::TakeStats() {
+		Stats stats = m_Stats;
+		stats.Connected = m_IsRegistered;
+		stats.SceneReceived = m_SceneReceived;
+		stats.Ping = (m_ServerID != RakNet::UNASSIGNED_SYSTEM_ADDRESS) ? m_Client->GetLastPing(m_ServerID) : -1;
+		m_Stats = { false, false, 0, 0, 0, 0, 0, -1 };
+		return stats;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::SendRegisterMsg() {
+		MsgRegister msg;
+		msg.Id = ID_CLT_REGISTER;
+		msg.ResolutionX = m_ResX;
+		msg.ResolutionY = m_ResY;
+		strncpy(msg.Name, m_Name.c_str(), sizeof(msg.Name) - 1);
+		msg.Name[sizeof(msg.Name) - 1] = '\0';
+		m_Client->Send((const char *)&msg, sizeof(msg), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::SendInputMsg() {
+		static const InputElements syntheticElements[] = { INPUT_L_LEFT, INPUT_L_RIGHT, INPUT_JUMP, INPUT_CROUCH, INPUT_FIRE, INPUT_AIM_UP, INPUT_AIM_DOWN };
+
+		RakNet::TimeMS currentTime = RakNet::GetTimeMS();
+		unsigned int previouslyHeld = m_InputElementHeld;
+
+		if (currentTime >= m_NextInputChangeTime) {
+			m_InputElementHeld = 0;
+			for (InputElements element : syntheticElements) {
+				if (m_InputRNG() % 3 == 0) { m_InputElementHeld |= 1U << element; }
+			}
+			// Holding left and right at once just cancels out, so keep only one of them
+			if ((m_InputElementHeld & (1U << INPUT_L_LEFT)) && (m_InputElementHeld & (1U << INPUT_L_RIGHT))) { m_InputElementHeld &= ~(1U << ((m_InputRNG() % 2 == 0) ? INPUT_L_LEFT : INPUT_L_RIGHT)); }
+			m_NextInputChangeTime = currentTime + c_InputChangeIntervalMS / 2 + m_InputRNG() % c_InputChangeIntervalMS;
+		}
+
+		MsgInput msg;
+		msg.Id = ID_CLT_INPUT;
+
+		std::uniform_int_distribution<int> mouseMovement(-3, 3);
+		msg.MouseX = mouseMovement(m_InputRNG);
+		msg.MouseY = mouseMovement(m_InputRNG);
+		for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) {
+			msg.MouseButtonPressed[i] = false;
+			msg.MouseButtonReleased[i] = false;
+			msg.MouseButtonHeld[i] = false;
+		}
+		msg.ResetActivityVote = false;
+		msg.MouseWheelMoved = 0;
+
+		msg.InputElementHeld = m_InputElementHeld;
+		msg.InputElementPressed = m_InputElementHeld & ~previouslyHeld;
+		msg.InputElementReleased = previouslyHeld & ~m_InputElementHeld;
+
+		m_Client->Send((const char *)&msg, sizeof(msg), IMMEDIATE_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
+		m_LastInputTime = currentTime;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveFrameSetupMsg(RakNet::Packet *packet) {
+		const MsgFrameSetup *frameData = (MsgFrameSetup *)packet->data;
+		if (frameData->FrameNumber >= c_FramesToRemember) {
+			return;
+		}
+		m_Stats.FramesReceived++;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveFrameLineMsg(RakNet::Packet *packet) {
+		const MsgFrameLine *frameData = (MsgFrameLine *)packet->data;
+		if (frameData->Layer > 1) {
+			return;
+		}
+		m_Stats.PayloadBytes += frameData->DataSize;
+		m_Stats.UncompressedBytes += frameData->UncompressedSize;
+
+		int lineNumber = frameData->LineNumber;
+		if (lineNumber >= m_ResY) {
+			return;
+		}
+		unsigned char *line = m_FrameLayers[frameData->Layer].data() + static_cast<size_t>(lineNumber) * m_ResX;
+		int pixels = std::min(m_ResX, static_cast<int>(frameData->UncompressedSize));
+
+		if (frameData->DataSize == 0) {
+			std::memset(line, 0, m_ResX);
+		} else if (frameData->DataSize == frameData->UncompressedSize) {
+			std::memcpy(line, packet->data + sizeof(MsgFrameLine), pixels);
+		} else {
+			LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameLine)), (char *)line, frameData->DataSize, m_ResX);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveFrameBoxMsg(RakNet::Packet *packet) {
+		const MsgFrameBox *frameData = (MsgFrameBox *)packet->data;
+		if (frameData->Layer > 1) {
+			return;
+		}
+		m_Stats.PayloadBytes += frameData->DataSize;
+		m_Stats.UncompressedBytes += frameData->UncompressedSize;
+
+		int bpx = frameData->BoxX;
+		int bpy = frameData->BoxY;
+		int maxWidth = frameData->BoxWidth;
+		int maxHeight = frameData->BoxHeight;
+		if (bpx + maxWidth > m_ResX || bpy + maxHeight > m_ResY || maxWidth * maxHeight > c_MaxPixelLineBufferSize) {
+			return;
+		}
+		unsigned char *frameLayer = m_FrameLayers[frameData->Layer].data();
+
+		if (frameData->DataSize == 0) {
+			for (int y = 0; y < maxHeight; y++) {
+				std::memset(frameLayer + static_cast<size_t>(bpy + y) * m_ResX + bpx, 0, maxWidth);
+			}
+			return;
+		}
+		if (frameData->DataSize == frameData->UncompressedSize) {
+			std::memcpy(m_PixelLineBuffer, packet->data + sizeof(MsgFrameBox), frameData->DataSize);
+		} else {
+			LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameBox)), (char *)m_PixelLineBuffer, frameData->DataSize, frameData->UncompressedSize);
+		}
+		const unsigned char *lineAddr = m_PixelLineBuffer;
+		for (int y = 0; y < maxHeight; y++) {
+			std::memcpy(frameLayer + static_cast<size_t>(bpy + y) * m_ResX + bpx, lineAddr, maxWidth);
+			lineAddr += maxWidth;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveSceneSetupMsg(RakNet::Packet *packet) {
+		const MsgSceneSetup *frameData = (MsgSceneSetup *)packet->data;
+
+		m_SceneID = frameData->SceneId;
+		m_SceneWidth = std::max(static_cast<int>(frameData->Width), 0);
+		m_SceneHeight = std::max(static_cast<int>(frameData->Height), 0);
+		for (std::vector<unsigned char> &sceneLayer : m_SceneLayers) {
+			sceneLayer.assign(static_cast<size_t>(m_SceneWidth) * static_cast<size_t>(m_SceneHeight), 0);
+		}
+		m_SceneReceived = false;
+
+		SendIDOnlyMsg(ID_CLT_SCENE_SETUP_ACCEPTED);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveSceneMsg(RakNet::Packet *packet) {
+		const MsgSceneLine *frameData = (MsgSceneLine *)packet->data;
+		if (frameData->SceneId != m_SceneID || frameData->Layer > 1) {
+			return;
+		}
+		m_Stats.PayloadBytes += frameData->DataSize;
+		m_Stats.UncompressedBytes += frameData->UncompressedSize;
+
+		int width = frameData->UncompressedSize;
+		if (frameData->Y >= m_SceneHeight || frameData->X + width > m_SceneWidth) {
+			return;
+		}
+		unsigned char *dest = m_SceneLayers[frameData->Layer].data() + static_cast<size_t>(frameData->Y) * m_SceneWidth + frameData->X;
+
+		if (frameData->DataSize == 0) {
+			std::memset(dest, 0, width);
+		} else if (frameData->DataSize == frameData->UncompressedSize) {
+			std::memcpy(dest, packet->data + sizeof(MsgSceneLine), width);
+		} else {
+			LZ4_decompress_safe((char *)(packet->data + sizeof(MsgSceneLine)), (char *)dest, frameData->DataSize, width);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::ReceiveTerrainChangeMsg(RakNet::Packet *packet) {
+		const MsgTerrainChange *frameData = (MsgTerrainChange *)packet->data;
+		if (frameData->SceneId != m_SceneID || m_SceneLayers[0].empty()) {
+			return;
+		}
+		std::vector<unsigned char> &sceneLayer = m_SceneLayers[frameData->Back ? 0 : 1];
+
+		if (frameData->W == 1 && frameData->H == 1) {
+			if (frameData->X < m_SceneWidth && frameData->Y < m_SceneHeight) { sceneLayer[static_cast<size_t>(frameData->Y) * m_SceneWidth + frameData->X] = frameData->Color; }
+			return;
+		}
+		m_Stats.PayloadBytes += frameData->DataSize;
+		m_Stats.UncompressedBytes += frameData->UncompressedSize;
+
+		int size = frameData->UncompressedSize;
+		if (size > c_MaxPixelLineBufferSize || size < frameData->W * frameData->H) {
+			return;
+		}
+		if (frameData->DataSize == frameData->UncompressedSize) {
+			std::memcpy(m_PixelLineBuffer, packet->data + sizeof(MsgTerrainChange), size);
+		} else {
+			LZ4_decompress_safe((char *)(packet->data + sizeof(MsgTerrainChange)), (char *)m_PixelLineBuffer, frameData->DataSize, size);
+		}
+
+		int width = std::min(static_cast<int>(frameData->W), m_SceneWidth - frameData->X);
+		const unsigned char *src = m_PixelLineBuffer;
+		for (int y = 0; y < frameData->H && frameData->Y + y < m_SceneHeight && width > 0; y++) {
+			std::memcpy(sceneLayer.data() + static_cast<size_t>(frameData->Y + y) * m_SceneWidth + frameData->X, src, width);
+			src += frameData->W;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LoadTestClient::SendIDOnlyMsg(unsigned char messageID) {
+		m_Client->Send((const char *)&messageID, sizeof(messageID), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned char LoadTestClient::GetPacketIdentifier(const RakNet::Packet *packet) const {
+		if (packet->data[0] == ID_TIMESTAMP) {
+			return packet->data[sizeof(RakNet::MessageID) + sizeof(RakNet::Time)];
+		}
+		return packet->data[0];
+	}
+}
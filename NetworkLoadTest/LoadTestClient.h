@@ -0,0 +1,175 @@
+#ifndef _RTELOADTESTCLIENT_
+#define _RTELOADTESTCLIENT_
+
+#include "Constants.h"
+
+#include "RakPeerInterface.h"
+#include "NetworkMessages.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// Headless stand-in for a NetworkClient, used to load test a NetworkServer without a player per connection.
+	/// It does the same handshake and decodes every frame, scene and terrain message into plain buffers like NetworkClient does into its bitmaps, but never draws anything. It sends a synthetic input stream instead of real input.
+	/// </summary>
+	class LoadTestClient {
+
+	public:
+
+		/// <summary>
+		/// Measurements of a LoadTestClient over a stretch of time.
+		/// </summary>
+		struct Stats {
+			bool Connected; //!< Whether the client is connected and registered.
+			bool SceneReceived; //!< Whether the client has the whole scene and is getting frames.
+			int FramesReceived; //!< How many frames were started with a frame setup message.
+			unsigned long BytesReceived; //!< How many bytes of messages were received.
+			unsigned long PayloadBytes; //!< How many bytes of compressed frame, scene and terrain data were received.
+			unsigned long UncompressedBytes; //!< How many bytes the compressed frame, scene and terrain data decoded to.
+			unsigned long long DecodeMicroseconds; //!< How long decoding messages took.
+			int Ping; //!< The last ping to the server in milliseconds, or -1 if not connected.
+		};
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a LoadTestClient object in system memory. Create() should be called before using the object.
+		/// </summary>
+		LoadTestClient() { Clear(); }
+
+		/// <summary>
+		/// Makes the LoadTestClient object ready for use and starts connecting to the server.
+		/// </summary>
+		/// <param name="serverAddress">The address of the server.</param>
+		/// <param name="serverPort">The port of the server.</param>
+		/// <param name="name">The player name to register with.</param>
+		/// <param name="resX">The horizontal resolution to register with.</param>
+		/// <param name="resY">The vertical resolution to register with.</param>
+		/// <param name="inputSeed">The seed of the synthetic input stream, so runs can be repeated.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int Create(const std::string &serverAddress, unsigned short serverPort, const std::string &name, int resX, int resY, unsigned int inputSeed);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a LoadTestClient object before deletion from system memory.
+		/// </summary>
+		~LoadTestClient() { Destroy(); }
+
+		/// <summary>
+		/// Destroys and resets (through Clear()) the LoadTestClient object, disconnecting from the server.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Updates the state of this LoadTestClient. Handles all incoming packets and sends input when it's time to. Supposed to be done in a tight loop.
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Gets the measurements since the last time this was called and starts measuring anew.
+		/// </summary>
+		/// <returns>The measurements.</returns>
+		Stats TakeStats();
+#pragma endregion
+
+	private:
+
+		static constexpr int c_InputIntervalMS = 16; //!< How many milliseconds apart input messages are sent, about as often as a client running at 60 fps.
+		static constexpr int c_InputChangeIntervalMS = 1500; //!< How many milliseconds apart the synthetic input picks new elements to hold, on average.
+
+		RakNet::RakPeerInterface *m_Client; //!< The RakNet peer connected to the server.
+		RakNet::SystemAddress m_ServerID; //!< The address of the server, once connected.
+		std::string m_Name; //!< The player name this client registers with.
+		int m_ResX; //!< The horizontal resolution this client registers with.
+		int m_ResY; //!< The vertical resolution this client registers with.
+		bool m_IsRegistered; //!< Whether the server accepted this client's registration.
+		bool m_SceneReceived; //!< Whether the whole scene was received and acknowledged.
+
+		unsigned char m_SceneID; //!< The ID of the current scene.
+		int m_SceneWidth; //!< The width of the current scene.
+		int m_SceneHeight; //!< The height of the current scene.
+		std::vector<unsigned char> m_SceneLayers[2]; //!< The background and foreground terrain of the current scene.
+		std::vector<unsigned char> m_FrameLayers[2]; //!< The frame and GUI layers of the current frame, the size of the registered resolution.
+		unsigned char m_PixelLineBuffer[c_MaxPixelLineBufferSize]; //!< Buffer for decompressing boxes and terrain changes before they're copied into place.
+
+		std::mt19937 m_InputRNG; //!< Generator for the synthetic input stream.
+		unsigned int m_InputElementHeld; //!< The input elements currently held, as bit flags.
+		RakNet::TimeMS m_LastInputTime; //!< When the last input message was sent.
+		RakNet::TimeMS m_NextInputChangeTime; //!< When the synthetic input picks new elements to hold.
+
+		Stats m_Stats; //!< The measurements since TakeStats() was last called.
+
+#pragma region Network Event Handling
+		/// <summary>
+		/// Registers with the server once connected, same as NetworkClient::SendRegisterMsg.
+		/// </summary>
+		void SendRegisterMsg();
+
+		/// <summary>
+		/// Sends the next message of the synthetic input stream. Holds a random few of the movement, aiming and firing elements and wiggles the mouse, changing what's held every so often.
+		/// </summary>
+		void SendInputMsg();
+
+		/// <summary>
+		/// Counts a new frame.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgFrameSetup.</param>
+		void ReceiveFrameSetupMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Decodes a frame line into the frame layers, same as NetworkClient::ReceiveFrameLineMsg.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgFrameLine.</param>
+		void ReceiveFrameLineMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Decodes a frame box into the frame layers, same as NetworkClient::ReceiveFrameBoxMsg.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgFrameBox.</param>
+		void ReceiveFrameBoxMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Sets up the terrain buffers for a new scene and acknowledges it, same as NetworkClient::ReceiveSceneSetupMsg.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgSceneSetup.</param>
+		void ReceiveSceneSetupMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Decodes a scene line into the terrain, same as NetworkClient::ReceiveSceneMsg.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgSceneLine.</param>
+		void ReceiveSceneMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Decodes a terrain change into the terrain, same as NetworkClient::ReceiveTerrainChangeMsg.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgTerrainChange.</param>
+		void ReceiveTerrainChangeMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Sends a message to the server that only consists of an ID, like the scene acknowledgements.
+		/// </summary>
+		/// <param name="messageID">The ID of the message.</param>
+		void SendIDOnlyMsg(unsigned char messageID);
+#pragma endregion
+
+		/// <summary>
+		/// Gets the identifier of a packet, skipping the timestamp if there is one.
+		/// </summary>
+		/// <param name="packet">The packet to get the identifier of.</param>
+		/// <returns>The identifier of the packet.</returns>
+		unsigned char GetPacketIdentifier(const RakNet::Packet *packet) const;
+
+		/// <summary>
+		/// Clears all the member variables of this LoadTestClient, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		LoadTestClient(const LoadTestClient &reference) = delete;
+		LoadTestClient & operator=(const LoadTestClient &rhs) = delete;
+	};
+}
+#endif
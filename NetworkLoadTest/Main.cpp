@@ -0,0 +1,147 @@
+#include "LoadTestClient.h"
+
+#include "RakSleep.h"
+#include "GetTime.h"
+
+#include <csignal>
+
+using namespace RTE;
+
+volatile std::sig_atomic_t g_Quit = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Makes the load test stop early and still print its summary when the process is interrupted.
+/// </summary>
+/// <param name="signal">The signal received.</param>
+void QuitHandler(int signal) { g_Quit = 1; }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Implementation of the main function. Usage: -server address[:port] -clients count -duration seconds -csv path -resx width -resy height, all optional. Defaults to a server on this machine.
+/// Every second a row per client is written to standard output and the CSV file. Run the server with -statscsv to get its side of the measurements for the same stretch of time.
+/// </summary>
+int main(int argc, char *argv[]) {
+	std::string serverAddress = "127.0.0.1";
+	unsigned short serverPort = 8000;
+	int clientCount = c_MaxClients;
+	int durationS = 60;
+	std::string csvPath;
+	int resX = 960;
+	int resY = 540;
+
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::strcmp(argv[i], "-server") == 0) {
+			serverAddress = argv[++i];
+			std::string::size_type portPos = serverAddress.find(':');
+			if (portPos != std::string::npos) {
+				serverPort = static_cast<unsigned short>(std::atoi(serverAddress.c_str() + portPos + 1));
+				serverAddress.resize(portPos);
+			}
+		} else if (std::strcmp(argv[i], "-clients") == 0) {
+			clientCount = std::max(std::atoi(argv[++i]), 1);
+		} else if (std::strcmp(argv[i], "-duration") == 0) {
+			durationS = std::max(std::atoi(argv[++i]), 1);
+		} else if (std::strcmp(argv[i], "-csv") == 0) {
+			csvPath = argv[++i];
+		} else if (std::strcmp(argv[i], "-resx") == 0) {
+			resX = std::clamp(std::atoi(argv[++i]), 320, 4096);
+		} else if (std::strcmp(argv[i], "-resy") == 0) {
+			resY = std::clamp(std::atoi(argv[++i]), 200, 4096);
+		}
+	}
+
+	std::ofstream csvFile;
+	if (!csvPath.empty()) {
+		csvFile.open(csvPath);
+		if (!csvFile.is_open()) {
+			std::cout << "LOADTEST: Could not open " << csvPath << " for writing" << std::endl;
+			return 1;
+		}
+	}
+
+	std::signal(SIGINT, QuitHandler);
+	std::signal(SIGTERM, QuitHandler);
+
+	// Clients are connected a little apart so the server isn't hit with every scene transfer at once, which would measure the handshake instead of the steady state
+	const RakNet::TimeMS connectInterval = 250;
+
+	std::vector<std::unique_ptr<LoadTestClient>> clients;
+	clients.reserve(clientCount);
+
+	const std::string header = "TimeS,Client,Connected,SceneReceived,FPS,ReceivedKbit,UncompressedKbit,CompressionRatio,Ping,DecodeMs";
+	std::cout << header << std::endl;
+	if (csvFile.is_open()) { csvFile << header << "\n"; }
+
+	std::vector<LoadTestClient::Stats> totals(clientCount, LoadTestClient::Stats{ false, false, 0, 0, 0, 0, 0, -1 });
+	std::vector<int> secondsLive(clientCount, 0);
+
+	RakNet::TimeMS startTime = RakNet::GetTimeMS();
+	RakNet::TimeMS lastStatsTime = startTime;
+	int elapsedS = 0;
+
+	while (!g_Quit && elapsedS < durationS) {
+		RakNet::TimeMS currentTime = RakNet::GetTimeMS();
+
+		if (static_cast<int>(clients.size()) < clientCount && currentTime - startTime >= clients.size() * connectInterval) {
+			int clientNumber = static_cast<int>(clients.size());
+			clients.emplace_back(std::make_unique<LoadTestClient>());
+			if (clients.back()->Create(serverAddress, serverPort, "LoadTest" + std::to_string(clientNumber), resX, resY, static_cast<unsigned int>(clientNumber + 1)) < 0) {
+				std::cout << "LOADTEST: Client " << clientNumber << " could not start connecting to " << serverAddress << ":" << serverPort << std::endl;
+			}
+		}
+
+		for (const std::unique_ptr<LoadTestClient> &client : clients) {
+			client->Update();
+		}
+
+		if (currentTime - lastStatsTime >= 1000) {
+			float intervalS = static_cast<float>(currentTime - lastStatsTime) / 1000.0F;
+			lastStatsTime = currentTime;
+			elapsedS++;
+
+			for (int clientNumber = 0; clientNumber < static_cast<int>(clients.size()); clientNumber++) {
+				LoadTestClient::Stats stats = clients[clientNumber]->TakeStats();
+
+				LoadTestClient::Stats &total = totals[clientNumber];
+				total.FramesReceived += stats.FramesReceived;
+				total.BytesReceived += stats.BytesReceived;
+				total.PayloadBytes += stats.PayloadBytes;
+				total.UncompressedBytes += stats.UncompressedBytes;
+				total.DecodeMicroseconds += stats.DecodeMicroseconds;
+				if (stats.SceneReceived) { secondsLive[clientNumber]++; }
+
+				std::ostringstream row;
+				row << std::fixed << std::setprecision(2) << elapsedS << "," << clientNumber << "," << stats.Connected << "," << stats.SceneReceived << ","
+					<< static_cast<float>(stats.FramesReceived) / intervalS << ","
+					<< static_cast<float>(stats.BytesReceived) * 8.0F / 1000.0F / intervalS << ","
+					<< static_cast<float>(stats.UncompressedBytes) * 8.0F / 1000.0F / intervalS << ","
+					<< (stats.PayloadBytes > 0 ? static_cast<float>(stats.UncompressedBytes) / static_cast<float>(stats.PayloadBytes) : 0.0F) << ","
+					<< stats.Ping << ","
+					<< static_cast<float>(stats.DecodeMicroseconds) / 1000.0F;
+
+				std::cout << row.str() << std::endl;
+				if (csvFile.is_open()) { csvFile << row.str() << "\n"; }
+			}
+			if (csvFile.is_open()) { csvFile.flush(); }
+		}
+		RakSleep(1);
+	}
+
+	std::cout << "LOADTEST: Summary over " << elapsedS << " seconds" << std::endl;
+	for (int clientNumber = 0; clientNumber < static_cast<int>(clients.size()); clientNumber++) {
+		const LoadTestClient::Stats &total = totals[clientNumber];
+		float averageFPS = secondsLive[clientNumber] > 0 ? static_cast<float>(total.FramesReceived) / static_cast<float>(secondsLive[clientNumber]) : 0.0F;
+		float averageKbit = elapsedS > 0 ? static_cast<float>(total.BytesReceived) * 8.0F / 1000.0F / static_cast<float>(elapsedS) : 0.0F;
+
+		std::cout << std::fixed << std::setprecision(2) << "LOADTEST: Client " << clientNumber << ": " << secondsLive[clientNumber] << " s live, " << averageFPS << " fps, "
+			<< averageKbit << " kbit/s, " << static_cast<float>(total.DecodeMicroseconds) / 1000.0F << " ms decoding" << std::endl;
+	}
+
+	for (const std::unique_ptr<LoadTestClient> &client : clients) {
+		client->Destroy();
+	}
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "SpectatorRelay.h"
+
+#include "RakSleep.h"
+
+#include <csignal>
+
+using namespace RTE;
+
+volatile std::sig_atomic_t g_Quit = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Makes the relay shut down cleanly when the process is interrupted, so the server and spectators see it disconnect instead of timing out.
+/// </summary>
+/// <param name="signal">The signal received.</param>
+void QuitHandler(int signal) { g_Quit = 1; }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Implementation of the main function. Usage: -server address[:port] -port port -player number -spectators count -password password, all optional. Defaults to a server on this machine.
+/// The password has to match the SpectatorRelayPassword setting of the server, which refuses relays while it isn't set.
+/// </summary>
+int main(int argc, char *argv[]) {
+	std::string serverAddress = "127.0.0.1";
+	unsigned short serverPort = 8000;
+	unsigned short port = SpectatorRelay::c_DefaultPort;
+	short watchedPlayer = 0;
+	int maxSpectators = SpectatorRelay::c_DefaultMaxSpectators;
+	std::string password;
+
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::strcmp(argv[i], "-server") == 0) {
+			serverAddress = argv[++i];
+			std::string::size_type portPos = serverAddress.find(':');
+			if (portPos != std::string::npos) {
+				serverPort = static_cast<unsigned short>(std::atoi(serverAddress.c_str() + portPos + 1));
+				serverAddress.resize(portPos);
+			}
+		} else if (std::strcmp(argv[i], "-port") == 0) {
+			port = static_cast<unsigned short>(std::atoi(argv[++i]));
+		} else if (std::strcmp(argv[i], "-player") == 0) {
+			watchedPlayer = static_cast<short>(std::clamp(std::atoi(argv[++i]), 0, c_MaxClients - 1));
+		} else if (std::strcmp(argv[i], "-spectators") == 0) {
+			maxSpectators = std::max(std::atoi(argv[++i]), 1);
+		} else if (std::strcmp(argv[i], "-password") == 0) {
+			password = argv[++i];
+		}
+	}
+
+	std::signal(SIGINT, QuitHandler);
+	std::signal(SIGTERM, QuitHandler);
+
+	SpectatorRelay relay;
+	if (relay.Create(serverAddress, serverPort, port, watchedPlayer, maxSpectators, password) < 0) {
+		return 1;
+	}
+	std::cout << "RELAY: Relaying player " << watchedPlayer << " of " << serverAddress << ":" << serverPort << std::endl;
+
+	while (!g_Quit) {
+		relay.Update();
+		RakSleep(1);
+	}
+	relay.Destroy();
+	return 0;
+}
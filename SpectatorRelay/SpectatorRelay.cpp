@@ -0,0 +1,483 @@
+#include "SpectatorRelay.h"
+
+#include "RakNetStatistics.h"
+#include "GetTime.h"
+
+#include <lz4.h>
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::Clear() {
+		m_Peer = nullptr;
+		m_ServerID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+		m_ServerAddress.clear();
+		m_ServerPort = 0;
+		m_WatchedPlayer = 0;
+		m_Password.clear();
+		m_ConnectingToServer = false;
+		m_LastConnectAttemptTime = 0;
+		m_Spectators.clear();
+		m_SceneSetupMsg.clear();
+		m_SceneID = 0;
+		m_SceneWidth = 0;
+		m_SceneHeight = 0;
+		m_SceneLayers[0].clear();
+		m_SceneLayers[1].clear();
+		m_SceneComplete = false;
+		m_FrameSetupMsg.clear();
+		m_FrameParts.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SpectatorRelay::Create(const std::string &serverAddress, unsigned short serverPort, unsigned short port, short watchedPlayer, int maxSpectators, const std::string &password) {
+		m_ServerAddress = serverAddress;
+		m_ServerPort = serverPort;
+		m_WatchedPlayer = watchedPlayer;
+		m_Password = password;
+
+		m_Peer = RakNet::RakPeerInterface::GetInstance();
+
+		RakNet::SocketDescriptor socketDescriptor(port, 0);
+		socketDescriptor.socketFamily = AF_INET;
+
+		// One more connection than spectators for the server
+		if (m_Peer->Startup(maxSpectators + 1, &socketDescriptor, 1) != RakNet::RAKNET_STARTED) {
+			std::cout << "RELAY: Failed to open port " << port << std::endl;
+			return -1;
+		}
+		m_Peer->SetMaximumIncomingConnections(maxSpectators);
+		m_Peer->SetOccasionalPing(true);
+		m_Peer->SetUnreliableTimeout(50);
+
+		std::cout << "RELAY: Accepting up to " << maxSpectators << " spectators on port " << port << std::endl;
+		ConnectToServer();
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::Destroy() {
+		if (m_Peer) {
+			m_Peer->Shutdown(300);
+			RakNet::RakPeerInterface::DestroyInstance(m_Peer);
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::Update() {
+		ConnectToServer();
+
+		for (RakNet::Packet *packet = m_Peer->Receive(); packet; m_Peer->DeallocatePacket(packet), packet = m_Peer->Receive()) {
+			unsigned char packetIdentifier = GetPacketIdentifier(packet);
+
+			// The relay only ever connects out to the server, so the results of connection attempts are about it too
+			bool fromServer = packet->systemAddress == m_ServerID;
+			switch (packetIdentifier) {
+				case ID_CONNECTION_REQUEST_ACCEPTED:
+				case ID_CONNECTION_ATTEMPT_FAILED:
+				case ID_NO_FREE_INCOMING_CONNECTIONS:
+				case ID_INCOMPATIBLE_PROTOCOL_VERSION:
+					fromServer = true;
+					break;
+				default:
+					break;
+			}
+			if (fromServer) {
+				HandleServerPacket(packet, packetIdentifier);
+			} else {
+				HandleSpectatorPacket(packet, packetIdentifier);
+			}
+		}
+
+		if (m_SceneComplete) {
+			for (Spectator &spectator : m_Spectators) {
+				if (spectator.State == ReceivingScene) { SendSceneLines(spectator); }
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::HandleServerPacket(RakNet::Packet *packet, unsigned char packetIdentifier) {
+		switch (packetIdentifier) {
+			case ID_CONNECTION_REQUEST_ACCEPTED:
+				m_ServerID = packet->systemAddress;
+				m_ConnectingToServer = false;
+				std::cout << "RELAY: Connected to server " << m_ServerID.ToString(true) << std::endl;
+				SendRelayRegisterMsg();
+				break;
+			case ID_CONNECTION_ATTEMPT_FAILED:
+			case ID_NO_FREE_INCOMING_CONNECTIONS:
+			case ID_INCOMPATIBLE_PROTOCOL_VERSION:
+				m_ConnectingToServer = false;
+				std::cout << "RELAY: Could not connect to server, retrying" << std::endl;
+				break;
+			case ID_DISCONNECTION_NOTIFICATION:
+			case ID_CONNECTION_LOST:
+				ReceiveServerDisconnection();
+				break;
+			case ID_SRV_SCENE_SETUP:
+				ReceiveSceneSetupMsg(packet);
+				break;
+			case ID_SRV_SCENE:
+				ReceiveSceneMsg(packet);
+				break;
+			case ID_SRV_SCENE_END:
+				m_SceneComplete = !m_SceneSetupMsg.empty();
+				break;
+			case ID_SRV_TERRAIN:
+				ReceiveTerrainChangeMsg(packet);
+				break;
+			case ID_SRV_FRAME_SETUP:
+				ReceiveFrameSetupMsg(packet);
+				break;
+			case ID_SRV_FRAME_BOX:
+			case ID_SRV_FRAME_LINE:
+				ReceiveFramePartMsg(packet);
+				break;
+			case ID_SRV_POST_EFFECTS:
+				ForwardToSpectators(packet, MEDIUM_PRIORITY, RELIABLE_ORDERED, Live, true);
+				break;
+			// Sounds can't be skipped for congested spectators because a skipped stop would leave a sound playing forever
+			case ID_SRV_SOUND_EVENTS:
+			case ID_SRV_MUSIC_EVENTS:
+				ForwardToSpectators(packet, MEDIUM_PRIORITY, RELIABLE_ORDERED, Live);
+				break;
+			default:
+				break;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ConnectToServer() {
+		if (m_ServerID != RakNet::UNASSIGNED_SYSTEM_ADDRESS || m_ConnectingToServer || RakNet::GetTimeMS() - m_LastConnectAttemptTime < c_ReconnectInterval) {
+			return;
+		}
+		m_LastConnectAttemptTime = RakNet::GetTimeMS();
+		m_ConnectingToServer = m_Peer->Connect(m_ServerAddress.c_str(), m_ServerPort, 0, 0) == RakNet::CONNECTION_ATTEMPT_STARTED;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::SendRelayRegisterMsg() {
+		MsgRegisterRelay msg;
+		msg.Id = ID_RLY_REGISTER;
+		msg.Player = static_cast<unsigned char>(m_WatchedPlayer);
+		std::memset(msg.Password, 0, sizeof(msg.Password));
+		std::strncpy(msg.Password, m_Password.c_str(), sizeof(msg.Password) - 1);
+		m_Peer->Send((const char *)&msg, sizeof(msg), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveSceneSetupMsg(RakNet::Packet *packet) {
+		if (packet->length < sizeof(MsgSceneSetup)) {
+			return;
+		}
+		const MsgSceneSetup *sceneSetup = (MsgSceneSetup *)packet->data;
+
+		m_SceneSetupMsg.assign(packet->data, packet->data + packet->length);
+		m_SceneID = sceneSetup->SceneId;
+		m_SceneWidth = std::max(static_cast<int>(sceneSetup->Width), 0);
+		m_SceneHeight = std::max(static_cast<int>(sceneSetup->Height), 0);
+
+		// 0 is the mask color of 8 bit bitmaps, same as what the client clears its terrain to before the scene arrives
+		for (std::vector<unsigned char> &sceneLayer : m_SceneLayers) {
+			sceneLayer.assign(static_cast<size_t>(m_SceneWidth) * static_cast<size_t>(m_SceneHeight), 0);
+		}
+		m_SceneComplete = false;
+
+		// The resolution or box size may change with the scene, so old frame parts can't be trusted anymore
+		m_FrameSetupMsg.clear();
+		m_FrameParts.clear();
+
+		for (Spectator &spectator : m_Spectators) {
+			if (spectator.State >= Registered) { SendSceneSetupMsg(spectator); }
+		}
+		std::cout << "RELAY: New scene " << m_SceneWidth << " x " << m_SceneHeight << std::endl;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveSceneMsg(RakNet::Packet *packet) {
+		const MsgSceneLine *sceneLine = (MsgSceneLine *)packet->data;
+		if (packet->length < sizeof(MsgSceneLine) || sceneLine->SceneId != m_SceneID || sceneLine->Layer > 1 || m_SceneSetupMsg.empty()) {
+			return;
+		}
+		int width = sceneLine->UncompressedSize;
+		if (sceneLine->Y >= m_SceneHeight || sceneLine->X + width > m_SceneWidth || sizeof(MsgSceneLine) + sceneLine->DataSize > packet->length) {
+			return;
+		}
+		unsigned char *dest = m_SceneLayers[sceneLine->Layer].data() + static_cast<size_t>(sceneLine->Y) * m_SceneWidth + sceneLine->X;
+		const unsigned char *src = packet->data + sizeof(MsgSceneLine);
+
+		if (sceneLine->DataSize == 0) {
+			std::memset(dest, 0, width);
+		} else if (sceneLine->DataSize == sceneLine->UncompressedSize) {
+			std::memcpy(dest, src, width);
+		} else {
+			LZ4_decompress_safe((const char *)src, (char *)dest, sceneLine->DataSize, width);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveTerrainChangeMsg(RakNet::Packet *packet) {
+		const MsgTerrainChange *terrainChange = (MsgTerrainChange *)packet->data;
+		if (packet->length < sizeof(MsgTerrainChange) || terrainChange->SceneId != m_SceneID || m_SceneSetupMsg.empty()) {
+			return;
+		}
+		std::vector<unsigned char> &sceneLayer = m_SceneLayers[terrainChange->Back ? 0 : 1];
+
+		if (terrainChange->W == 1 && terrainChange->H == 1) {
+			if (terrainChange->X < m_SceneWidth && terrainChange->Y < m_SceneHeight) { sceneLayer[static_cast<size_t>(terrainChange->Y) * m_SceneWidth + terrainChange->X] = terrainChange->Color; }
+		} else {
+			int size = terrainChange->UncompressedSize;
+			if (size > c_MaxPixelLineBufferSize || size < terrainChange->W * terrainChange->H || sizeof(MsgTerrainChange) + terrainChange->DataSize > packet->length) {
+				return;
+			}
+			const char *src = (const char *)(packet->data + sizeof(MsgTerrainChange));
+			if (terrainChange->DataSize == terrainChange->UncompressedSize) {
+				std::memcpy(m_PixelBuffer, src, size);
+			} else {
+				LZ4_decompress_safe(src, (char *)m_PixelBuffer, terrainChange->DataSize, size);
+			}
+
+			// Copy the changed rows into the terrain, clipped to the scene like the client does
+			int width = std::min(static_cast<int>(terrainChange->W), m_SceneWidth - terrainChange->X);
+			const unsigned char *srcRow = m_PixelBuffer;
+			for (int y = 0; y < terrainChange->H && terrainChange->Y + y < m_SceneHeight && width > 0; y++) {
+				std::memcpy(sceneLayer.data() + static_cast<size_t>(terrainChange->Y + y) * m_SceneWidth + terrainChange->X, srcRow, width);
+				srcRow += terrainChange->W;
+			}
+		}
+		// Spectators still getting the scene need the change as well, in case their copy of that part of the terrain was already sent
+		ForwardToSpectators(packet, MEDIUM_PRIORITY, RELIABLE_ORDERED, ReceivingScene);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveFrameSetupMsg(RakNet::Packet *packet) {
+		m_FrameSetupMsg.assign(packet->data, packet->data + packet->length);
+
+		// Decide once per frame which spectators can't keep up, so they skip whole frames instead of getting a random part of each
+		RakNet::RakNetStatistics rns;
+		for (Spectator &spectator : m_Spectators) {
+			if (spectator.State == Live) {
+				m_Peer->GetStatistics(spectator.Address, &rns);
+				spectator.SkipFrame = rns.isLimitedByCongestionControl || rns.messageInSendBuffer[MEDIUM_PRIORITY] > c_MaxMessagesInSendBuffer;
+			}
+		}
+		ForwardToSpectators(packet, MEDIUM_PRIORITY, RELIABLE_ORDERED, Live, true);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveFramePartMsg(RakNet::Packet *packet) {
+		unsigned long long partKey = 0;
+		if (GetPacketIdentifier(packet) == ID_SRV_FRAME_BOX) {
+			if (packet->length < sizeof(MsgFrameBox)) {
+				return;
+			}
+			const MsgFrameBox *frameBox = (MsgFrameBox *)packet->data;
+			partKey = (1ULL << 48) | (static_cast<unsigned long long>(frameBox->Layer) << 32) | (static_cast<unsigned long long>(frameBox->BoxX) << 16) | frameBox->BoxY;
+		} else {
+			if (packet->length < sizeof(MsgFrameLine)) {
+				return;
+			}
+			const MsgFrameLine *frameLine = (MsgFrameLine *)packet->data;
+			partKey = (2ULL << 48) | (static_cast<unsigned long long>(frameLine->Layer) << 32) | frameLine->LineNumber;
+		}
+		m_FrameParts[partKey].assign(packet->data, packet->data + packet->length);
+
+		ForwardToSpectators(packet, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, Live, true);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveServerDisconnection() {
+		std::cout << "RELAY: Lost connection to server" << std::endl;
+		m_ServerID = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+
+		m_SceneSetupMsg.clear();
+		m_SceneLayers[0].clear();
+		m_SceneLayers[1].clear();
+		m_SceneComplete = false;
+		m_FrameSetupMsg.clear();
+		m_FrameParts.clear();
+
+		// Spectators keep the last picture they got and are caught up again from the next scene setup once the server is back
+		for (Spectator &spectator : m_Spectators) {
+			if (spectator.State > Registered) { spectator.State = Registered; }
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::HandleSpectatorPacket(RakNet::Packet *packet, unsigned char packetIdentifier) {
+		if (packetIdentifier == ID_NEW_INCOMING_CONNECTION) {
+			m_Spectators.push_back({ packet->systemAddress, Connected, 0, 0, 0, false });
+			return;
+		}
+		Spectator *spectator = FindSpectator(packet->systemAddress);
+		if (!spectator) {
+			return;
+		}
+
+		switch (packetIdentifier) {
+			case ID_DISCONNECTION_NOTIFICATION:
+			case ID_CONNECTION_LOST:
+			case ID_CLT_DISCONNECT:
+				m_Spectators.erase(m_Spectators.begin() + (spectator - m_Spectators.data()));
+				std::cout << "RELAY: Spectator left, " << m_Spectators.size() << " watching" << std::endl;
+				break;
+			case ID_CLT_REGISTER:
+				ReceiveRegisterMsg(*spectator, packet);
+				break;
+			case ID_CLT_SCENE_SETUP_ACCEPTED:
+				if (spectator->State == AwaitingSceneSetupAck) {
+					spectator->State = ReceivingScene;
+					spectator->SceneLayer = 0;
+					spectator->SceneLineX = 0;
+					spectator->SceneLineY = 0;
+				}
+				break;
+			case ID_CLT_SCENE_ACCEPTED:
+				if (spectator->State == AwaitingSceneAck) { SendFrameKeyframe(*spectator); }
+				break;
+			// Spectators don't control anything, so their input is dropped here
+			default:
+				break;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	SpectatorRelay::Spectator * SpectatorRelay::FindSpectator(const RakNet::SystemAddress &address) {
+		for (Spectator &spectator : m_Spectators) {
+			if (spectator.Address == address) {
+				return &spectator;
+			}
+		}
+		return nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ReceiveRegisterMsg(Spectator &spectator, RakNet::Packet *packet) {
+		if (packet->length < sizeof(MsgRegister)) {
+			return;
+		}
+		const MsgRegister *msgReg = (MsgRegister *)packet->data;
+		std::cout << "RELAY: Spectator " << std::string(msgReg->Name, strnlen(msgReg->Name, sizeof(msgReg->Name))) << " joined from " << spectator.Address.ToString(true) << ", " << m_Spectators.size() << " watching" << std::endl;
+
+		MsgAccepted msg;
+		msg.Id = ID_SRV_ACCEPTED;
+		m_Peer->Send((const char *)&msg, sizeof(MsgAccepted), HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, spectator.Address, false);
+		m_Peer->SetTimeoutTime(5000, spectator.Address);
+
+		spectator.State = Registered;
+		if (!m_SceneSetupMsg.empty()) { SendSceneSetupMsg(spectator); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::SendSceneSetupMsg(Spectator &spectator) {
+		m_Peer->Send((const char *)m_SceneSetupMsg.data(), static_cast<int>(m_SceneSetupMsg.size()), HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, spectator.Address, false);
+		spectator.State = AwaitingSceneSetupAck;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::SendSceneLines(Spectator &spectator) {
+		// Feed the scene a bit at a time so one spectator catching up doesn't hold up everyone else
+		RakNet::RakNetStatistics rns;
+		m_Peer->GetStatistics(spectator.Address, &rns);
+		if (rns.messageInSendBuffer[HIGH_PRIORITY] > c_MaxMessagesInSendBuffer) {
+			return;
+		}
+
+		MsgSceneLine *sceneLine = (MsgSceneLine *)m_SendBuffer;
+		sceneLine->Id = ID_SRV_SCENE;
+		sceneLine->SceneId = m_SceneID;
+
+		bool sceneIsEmpty = m_SceneWidth == 0 || m_SceneHeight == 0;
+
+		// Same order as the server sends the scene in, layer by layer and column of lines by column of lines
+		for (int linesSent = 0; linesSent < c_SceneLinesPerUpdate && spectator.SceneLayer < 2 && !sceneIsEmpty; linesSent++) {
+			int width = std::min(c_SceneLineWidth, m_SceneWidth - spectator.SceneLineX);
+			const unsigned char *line = m_SceneLayers[spectator.SceneLayer].data() + static_cast<size_t>(spectator.SceneLineY) * m_SceneWidth + spectator.SceneLineX;
+
+			sceneLine->X = spectator.SceneLineX;
+			sceneLine->Y = spectator.SceneLineY;
+			sceneLine->Width = width;
+			sceneLine->Layer = spectator.SceneLayer;
+			sceneLine->UncompressedSize = width;
+
+			int result = LZ4_compress_default((const char *)line, (char *)(m_SendBuffer + sizeof(MsgSceneLine)), width, c_MaxPixelLineBufferSize);
+
+			// Compression failed or ineffective, send as is
+			if (result <= 0 || result >= width) {
+				std::memcpy(m_SendBuffer + sizeof(MsgSceneLine), line, width);
+				sceneLine->DataSize = width;
+			} else {
+				sceneLine->DataSize = result;
+			}
+			m_Peer->Send((const char *)sceneLine, sizeof(MsgSceneLine) + sceneLine->DataSize, HIGH_PRIORITY, RELIABLE_ORDERED, 0, spectator.Address, false);
+
+			spectator.SceneLineY++;
+			if (spectator.SceneLineY >= m_SceneHeight) {
+				spectator.SceneLineY = 0;
+				spectator.SceneLineX += c_SceneLineWidth;
+				if (spectator.SceneLineX >= m_SceneWidth) {
+					spectator.SceneLineX = 0;
+					spectator.SceneLayer++;
+				}
+			}
+		}
+
+		if (spectator.SceneLayer >= 2 || sceneIsEmpty) {
+			MsgSceneEnd msg;
+			msg.Id = ID_SRV_SCENE_END;
+			m_Peer->Send((const char *)&msg, sizeof(MsgSceneEnd), HIGH_PRIORITY, RELIABLE_ORDERED, 0, spectator.Address, false);
+			spectator.State = AwaitingSceneAck;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::SendFrameKeyframe(Spectator &spectator) {
+		spectator.State = Live;
+		spectator.SkipFrame = false;
+
+		if (!m_FrameSetupMsg.empty()) { m_Peer->Send((const char *)m_FrameSetupMsg.data(), static_cast<int>(m_FrameSetupMsg.size()), MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, spectator.Address, false); }
+		for (const std::pair<const unsigned long long, std::vector<unsigned char>> &framePart : m_FrameParts) {
+			m_Peer->Send((const char *)framePart.second.data(), static_cast<int>(framePart.second.size()), MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, 0, spectator.Address, false);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SpectatorRelay::ForwardToSpectators(const RakNet::Packet *packet, PacketPriority priority, PacketReliability reliability, SpectatorState minState, bool skipCongested) {
+		for (const Spectator &spectator : m_Spectators) {
+			if (spectator.State >= minState && !(skipCongested && spectator.SkipFrame)) {
+				m_Peer->Send((const char *)packet->data, static_cast<int>(packet->length), priority, reliability, 0, spectator.Address, false);
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned char SpectatorRelay::GetPacketIdentifier(const RakNet::Packet *packet) const {
+		if (packet->data[0] == ID_TIMESTAMP) {
+			return packet->data[sizeof(RakNet::MessageID) + sizeof(RakNet::Time)];
+		}
+		return packet->data[0];
+	}
+}
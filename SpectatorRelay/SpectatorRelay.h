@@ -0,0 +1,245 @@
+#ifndef _RTESPECTATORRELAY_
+#define _RTESPECTATORRELAY_
+
+#include "Constants.h"
+
+#include "RakPeerInterface.h"
+#include "NetworkMessages.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// Standalone process that takes the stream a NetworkServer mirrors for one of its players and re-broadcasts it to any number of spectators, so they cost the server nothing.
+	/// Spectators connect with the regular game client as if the relay were a server. Each one is first caught up from a keyframe the relay keeps of the scene terrain and the latest frame, then gets the live stream.
+	/// </summary>
+	class SpectatorRelay {
+
+	public:
+
+		static constexpr unsigned short c_DefaultPort = 8001; //!< The port spectators connect to by default, next to the default server port.
+		static constexpr int c_DefaultMaxSpectators = 64; //!< How many spectators can connect by default.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a SpectatorRelay object in system memory. Create() should be called before using the object.
+		/// </summary>
+		SpectatorRelay() { Clear(); }
+
+		/// <summary>
+		/// Makes the SpectatorRelay object ready for use, opening the port for spectators and connecting to the server.
+		/// </summary>
+		/// <param name="serverAddress">The address of the server to relay.</param>
+		/// <param name="serverPort">The port of the server to relay.</param>
+		/// <param name="port">The port spectators connect to.</param>
+		/// <param name="watchedPlayer">The player whose stream is relayed.</param>
+		/// <param name="maxSpectators">How many spectators can connect at most.</param>
+		/// <param name="password">The spectator relay password set on the server.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int Create(const std::string &serverAddress, unsigned short serverPort, unsigned short port, short watchedPlayer, int maxSpectators, const std::string &password);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a SpectatorRelay object before deletion from system memory.
+		/// </summary>
+		~SpectatorRelay() { Destroy(); }
+
+		/// <summary>
+		/// Destroys and resets (through Clear()) the SpectatorRelay object, disconnecting everyone.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets how many spectators are connected to this relay.
+		/// </summary>
+		/// <returns>The number of connected spectators.</returns>
+		int GetSpectatorCount() const { return static_cast<int>(m_Spectators.size()); }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Updates the state of this SpectatorRelay. Handles all incoming packets from the server and the spectators and feeds the scene to spectators catching up. Supposed to be done in a tight loop.
+		/// </summary>
+		void Update();
+#pragma endregion
+
+	private:
+
+		/// <summary>
+		/// Enumeration for the steps a spectator goes through before getting the live stream. These follow the handshake NetworkClient does with a server.
+		/// </summary>
+		enum SpectatorState {
+			Connected = 0,
+			Registered,
+			AwaitingSceneSetupAck,
+			ReceivingScene,
+			AwaitingSceneAck,
+			Live
+		};
+
+		/// <summary>
+		/// A spectator connected to the relay.
+		/// </summary>
+		struct Spectator {
+			RakNet::SystemAddress Address; //!< The address of the spectator.
+			SpectatorState State; //!< How far the spectator is in the handshake.
+			int SceneLayer; //!< The terrain layer the spectator is being sent while catching up.
+			int SceneLineX; //!< The horizontal position of the next scene line the spectator will be sent while catching up.
+			int SceneLineY; //!< The vertical position of the next scene line the spectator will be sent while catching up.
+			bool SkipFrame; //!< Whether the send buffer of the spectator is too full to send it the current frame.
+		};
+
+		static constexpr int c_SceneLineWidth = 1280; //!< The width of the scene lines sent to catch up spectators, same as the server's.
+		static constexpr int c_SceneLinesPerUpdate = 250; //!< How many scene lines a spectator catching up is sent per update at most.
+		static constexpr int c_MaxMessagesInSendBuffer = 1000; //!< How many messages can wait in a spectator's send buffer before the relay holds back from sending it more.
+		static constexpr int c_ReconnectInterval = 3000; //!< How many milliseconds to wait between attempts to connect to the server.
+
+		RakNet::RakPeerInterface *m_Peer; //!< The RakNet peer used for both the server connection and the spectators.
+		RakNet::SystemAddress m_ServerID; //!< The address of the server, once connected.
+		std::string m_ServerAddress; //!< The address of the server to relay.
+		unsigned short m_ServerPort; //!< The port of the server to relay.
+		short m_WatchedPlayer; //!< The player whose stream is relayed.
+		std::string m_Password; //!< The password the server wants from spectator relays.
+		bool m_ConnectingToServer; //!< Whether a connection attempt to the server is in progress.
+		RakNet::TimeMS m_LastConnectAttemptTime; //!< When the last attempt to connect to the server was made.
+
+		std::vector<Spectator> m_Spectators; //!< The connected spectators.
+
+		std::vector<unsigned char> m_SceneSetupMsg; //!< The last MsgSceneSetup the server sent, kept as is to send to spectators. Empty if there's no scene yet.
+		unsigned char m_SceneID; //!< The ID of the current scene.
+		int m_SceneWidth; //!< The width of the current scene.
+		int m_SceneHeight; //!< The height of the current scene.
+		std::vector<unsigned char> m_SceneLayers[2]; //!< The background and foreground terrain of the current scene, kept up to date with terrain changes.
+		bool m_SceneComplete; //!< Whether the whole current scene has been received from the server.
+
+		std::vector<unsigned char> m_FrameSetupMsg; //!< The last MsgFrameSetup the server sent, kept as is for the keyframe.
+		std::map<unsigned long long, std::vector<unsigned char>> m_FrameParts; //!< The last frame box or line message the server sent for each part of the frame, kept as is for the keyframe.
+
+		unsigned char m_PixelBuffer[c_MaxPixelLineBufferSize]; //!< Buffer for decompressing terrain changes.
+		unsigned char m_SendBuffer[c_MaxPixelLineBufferSize + sizeof(MsgSceneLine)]; //!< Buffer for composing scene line messages to catch up spectators.
+
+#pragma region Server Message Handling
+		/// <summary>
+		/// Handles a packet that came from the server or is about the connection to it.
+		/// </summary>
+		/// <param name="packet">The packet to handle.</param>
+		/// <param name="packetIdentifier">The identifier of the packet.</param>
+		void HandleServerPacket(RakNet::Packet *packet, unsigned char packetIdentifier);
+
+		/// <summary>
+		/// Connects to the server if not connected already and enough time has passed since the last attempt.
+		/// </summary>
+		void ConnectToServer();
+
+		/// <summary>
+		/// Asks the server to start mirroring the watched player's stream to this relay.
+		/// </summary>
+		void SendRelayRegisterMsg();
+
+		/// <summary>
+		/// Stores a new scene setup, forgets the old scene and starts the handshake for the new one with every spectator that registered.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgSceneSetup.</param>
+		void ReceiveSceneSetupMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Decodes a line of the scene into the relay's copy of the terrain.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgSceneLine.</param>
+		void ReceiveSceneMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Applies a terrain change to the relay's copy of the terrain and passes it on to spectators that have the scene or are getting it.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgTerrainChange.</param>
+		void ReceiveTerrainChangeMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Stores a new frame setup and passes it on to live spectators, checking which of them are too congested to get this frame.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgFrameSetup.</param>
+		void ReceiveFrameSetupMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Stores a frame box or line as the latest for its part of the frame and passes it on to live spectators.
+		/// </summary>
+		/// <param name="packet">The packet holding the MsgFrameBox or MsgFrameLine.</param>
+		void ReceiveFramePartMsg(RakNet::Packet *packet);
+
+		/// <summary>
+		/// Handles the server going away. Forgets everything about the scene so spectators are caught up again once the server is back.
+		/// </summary>
+		void ReceiveServerDisconnection();
+#pragma endregion
+
+#pragma region Spectator Message Handling
+		/// <summary>
+		/// Handles a packet that came from a spectator or is about the connection to one.
+		/// </summary>
+		/// <param name="packet">The packet to handle.</param>
+		/// <param name="packetIdentifier">The identifier of the packet.</param>
+		void HandleSpectatorPacket(RakNet::Packet *packet, unsigned char packetIdentifier);
+
+		/// <summary>
+		/// Finds a connected spectator.
+		/// </summary>
+		/// <param name="address">The address of the spectator.</param>
+		/// <returns>Pointer to the spectator, or nullptr if there's no spectator with that address.</returns>
+		Spectator * FindSpectator(const RakNet::SystemAddress &address);
+
+		/// <summary>
+		/// Accepts the registration of a spectator and sends it the scene setup if there is a scene.
+		/// </summary>
+		/// <param name="spectator">The spectator that registered.</param>
+		/// <param name="packet">The packet holding the MsgRegister.</param>
+		void ReceiveRegisterMsg(Spectator &spectator, RakNet::Packet *packet);
+
+		/// <summary>
+		/// Sends the scene setup to a spectator, starting the scene handshake.
+		/// </summary>
+		/// <param name="spectator">The spectator to send to.</param>
+		void SendSceneSetupMsg(Spectator &spectator);
+
+		/// <summary>
+		/// Sends the next batch of scene lines to a spectator catching up, encoded from the relay's copy of the terrain. Sends the scene end message once all lines are sent.
+		/// </summary>
+		/// <param name="spectator">The spectator to send to.</param>
+		void SendSceneLines(Spectator &spectator);
+
+		/// <summary>
+		/// Makes a spectator live, sending it the keyframe of the latest frame setup and every latest frame part.
+		/// </summary>
+		/// <param name="spectator">The spectator that accepted the scene.</param>
+		void SendFrameKeyframe(Spectator &spectator);
+#pragma endregion
+
+		/// <summary>
+		/// Passes a packet from the server on to every spectator that's in one of the specified states.
+		/// </summary>
+		/// <param name="packet">The packet to pass on.</param>
+		/// <param name="priority">The RakNet priority to send with, same as the server used.</param>
+		/// <param name="reliability">The RakNet reliability to send with, same as the server used.</param>
+		/// <param name="minState">The earliest state a spectator needs to be in to get the packet.</param>
+		/// <param name="skipCongested">Whether spectators that are too congested for the current frame should not get the packet.</param>
+		void ForwardToSpectators(const RakNet::Packet *packet, PacketPriority priority, PacketReliability reliability, SpectatorState minState, bool skipCongested = false);
+
+		/// <summary>
+		/// Gets the identifier of a packet, skipping the timestamp if there is one.
+		/// </summary>
+		/// <param name="packet">The packet to get the identifier of.</param>
+		/// <returns>The identifier of the packet.</returns>
+		unsigned char GetPacketIdentifier(const RakNet::Packet *packet) const;
+
+		/// <summary>
+		/// Clears all the member variables of this SpectatorRelay, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		SpectatorRelay(const SpectatorRelay &reference) = delete;
+		SpectatorRelay & operator=(const SpectatorRelay &rhs) = delete;
+	};
+}
+#endif
@@ -86,7 +86,7 @@ namespace RTE {
 #pragma endregion
 
 #pragma region Network Constants
-	static constexpr unsigned short c_MaxClients = 4;
+	static constexpr unsigned short c_MaxClients = 4; //!< Maximum number of clients a server accepts. Each client plays as the player of the same number, so this can't exceed the number of players an Activity supports.
 	static constexpr unsigned short c_FramesToRemember = 3;
 	static constexpr unsigned short c_MaxLayersStoredForNetwork = 10;
 	static constexpr unsigned short c_MaxPixelLineBufferSize = 8192;
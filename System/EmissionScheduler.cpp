@@ -0,0 +1,71 @@
+#include "EmissionScheduler.h"
+#include "RandomStream.h"
+#include "MovableMan.h"
+#include "MovableObject.h"
+#include "TimerMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void EmissionScheduler::Clear() {
+		m_Requests.clear();
+		m_RequestedParticleCount = 0;
+		m_RandomValues.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void EmissionScheduler::AddRequest(const EmissionRequest &request) {
+		if (request.ParticlePreset && request.ParticleCount > 0) {
+			m_Requests.push_back(request);
+			m_RequestedParticleCount += request.ParticleCount;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int EmissionScheduler::ServiceRequests(int particleAllowance, float scale) {
+		float share = std::clamp(scale, 0.0F, 1.0F);
+		if (particleAllowance >= 0 && m_RequestedParticleCount > 0) { share = std::min(share, static_cast<float>(particleAllowance) / static_cast<float>(m_RequestedParticleCount)); }
+
+		// Carry what's rounded off each request over to the next one, so lots of small requests don't all get rounded down to nothing
+		float shareAccumulator = 0;
+		int emittedCount = 0;
+		for (EmissionRequest &request : m_Requests) {
+			shareAccumulator += static_cast<float>(request.ParticleCount) * share;
+			int particleCount = static_cast<int>(shareAccumulator);
+			shareAccumulator -= static_cast<float>(particleCount);
+			if (particleCount <= 0) {
+				continue;
+			}
+
+			// The velocity, angle and lifetime variation of all the request's particles come from its own stream, so they don't depend on the order requests were made in
+			RandomStream emissionRandom(RandomStream::ScheduledEmission, request.StreamID, g_TimerMan.GetSimUpdateCount());
+			m_RandomValues.resize(particleCount * 3);
+			emissionRandom.FillFloats(m_RandomValues.data(), m_RandomValues.size(), 0.0F, 1.0F);
+
+			for (int i = 0; i < particleCount; ++i) {
+				const float *randomValues = &m_RandomValues[i * 3];
+				MovableObject *particle = dynamic_cast<MovableObject *>(request.ParticlePreset->Clone());
+				particle->SetPos(request.Pos);
+
+				Vector emitVel(request.MinVelocity + request.VelocityRange * randomValues[0], 0);
+				emitVel.RadRotate(request.EmitAngle + request.Spread * (randomValues[1] * 2.0F - 1.0F));
+				emitVel = emitVel.GetXFlipped(request.HFlipped) * request.Rotation;
+				particle->SetVel(request.ParentVel + emitVel);
+
+				if (particle->GetLifetime() != 0) { particle->SetLifetime(particle->GetLifetime() * (1.0F + request.LifeVariation * (randomValues[2] * 2.0F - 1.0F))); }
+				if (request.LifetimeScale != 0) { particle->SetLifetime(particle->GetLifetime() * request.LifetimeScale); }
+				particle->SetTeam(request.Team);
+				particle->SetIgnoresTeamHits(true);
+				if (request.MOToNotHit) { particle->SetWhichMOToNotHit(request.MOToNotHit); }
+
+				g_MovableMan.AddMO(particle);
+			}
+			emittedCount += particleCount;
+		}
+		Reset();
+		return emittedCount;
+	}
+}
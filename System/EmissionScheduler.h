@@ -0,0 +1,93 @@
+#ifndef _RTEEMISSIONSCHEDULER_
+#define _RTEEMISSIONSCHEDULER_
+
+#include "Vector.h"
+#include "Matrix.h"
+
+namespace RTE {
+
+	class MovableObject;
+
+	/// <summary>
+	/// Emits the particles of all cosmetic emissions in a single pass each sim update, so how many of them there are is decided for all emitters at once.
+	/// Emitters register what each of their cosmetic emissions wants to emit while they update, and MovableMan services all the requests together afterwards,
+	/// giving every request the same share of whatever room is left under the particle budget.
+	/// </summary>
+	class EmissionScheduler {
+
+	public:
+
+		/// <summary>
+		/// Everything needed to emit one cosmetic emission's particles for one sim update. Copied out of the emitter so nothing happening to it before servicing matters.
+		/// </summary>
+		struct EmissionRequest {
+			const MovableObject *ParticlePreset; //!< The preset the emitted particles are cloned from. Owned by PresetMan.
+			int ParticleCount; //!< How many particles the emission wants to emit.
+			Vector Pos; //!< The absolute position the particles are emitted from.
+			Vector ParentVel; //!< The velocity the particles inherit from the emitter's root parent.
+			float MinVelocity; //!< The slowest particles are emitted at.
+			float VelocityRange; //!< How much faster than the minimum velocity particles can be emitted.
+			float EmitAngle; //!< The angle particles are emitted at relative to the emitter, in radians.
+			float Spread; //!< How far to either side of the emit angle particles can go, in radians.
+			Matrix Rotation; //!< The rotation of the emitter.
+			bool HFlipped; //!< Whether the emitter is flipped horizontally.
+			float LifeVariation; //!< How much the lifetime of particles varies either way, as a fraction of their preset's lifetime.
+			float LifetimeScale; //!< The emitter's throttle factor, which the lifetime of particles is scaled by. 0 leaves it alone.
+			int Team; //!< The team particles are emitted for.
+			MovableObject *MOToNotHit; //!< The MO particles shouldn't hit, if any. Ownership is NOT transferred!
+			unsigned long long StreamID; //!< The ID of the random stream the particles' variations are drawn from, unique to the emitter and emission.
+		};
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate an EmissionScheduler object in system memory.
+		/// </summary>
+		EmissionScheduler() { Clear(); }
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Gets how many particles all the requests waiting to be serviced want to emit together.
+		/// </summary>
+		/// <returns>The total number of requested particles.</returns>
+		int GetRequestedParticleCount() const { return m_RequestedParticleCount; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Registers what a cosmetic emission wants to emit this sim update. The particles are emitted when the requests are serviced.
+		/// </summary>
+		/// <param name="request">The request to register. Requests for no particles are ignored.</param>
+		void AddRequest(const EmissionRequest &request);
+
+		/// <summary>
+		/// Emits the particles of all waiting requests into MovableMan and clears them. Every request gets the same share of what it asked for.
+		/// </summary>
+		/// <param name="particleAllowance">How many particles can be emitted in total. Negative means there's no limit.</param>
+		/// <param name="scale">The largest share of what they asked for that requests get, from 0 to 1.</param>
+		/// <returns>How many particles were emitted.</returns>
+		int ServiceRequests(int particleAllowance, float scale);
+
+		/// <summary>
+		/// Drops all waiting requests without emitting anything.
+		/// </summary>
+		void Reset() { m_Requests.clear(); m_RequestedParticleCount = 0; }
+#pragma endregion
+
+	private:
+
+		std::vector<EmissionRequest> m_Requests; //!< The requests waiting to be serviced, in the order they were made.
+		int m_RequestedParticleCount; //!< How many particles the waiting requests want to emit together.
+		std::vector<float> m_RandomValues; //!< Scratch buffer for the random variations of a request's particles, kept around so servicing doesn't allocate.
+
+		/// <summary>
+		/// Clears all the member variables of this EmissionScheduler, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		EmissionScheduler(const EmissionScheduler &reference) = delete;
+		EmissionScheduler & operator=(const EmissionScheduler &rhs) = delete;
+	};
+}
+#endif
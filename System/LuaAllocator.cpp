@@ -0,0 +1,137 @@
+#include "LuaAllocator.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LuaAllocator::Clear() {
+		std::fill(std::begin(m_FreeLists), std::end(m_FreeLists), nullptr);
+		m_Pages.clear();
+		m_PageCursor = nullptr;
+		m_PageRemaining = 0;
+		m_DisplacedHeapBlocks.clear();
+		m_HeapSize = 0;
+		m_TotalAllocated = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LuaAllocator::Destroy() {
+		for (void *page : m_Pages) {
+			std::free(page);
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void * LuaAllocator::Allocate(void *userData, void *block, size_t oldSize, size_t newSize) {
+		LuaAllocator *allocator = static_cast<LuaAllocator *>(userData);
+		if (!block) { oldSize = 0; }
+		bool oldPooled = block && oldSize <= c_MaxPooledSize && !allocator->IsDisplacedHeapBlock(block);
+
+		if (newSize == 0) {
+			if (block) {
+				if (oldPooled) {
+					allocator->FreePooled(block, GetSizeClass(oldSize));
+				} else {
+					allocator->FreeHeap(block, oldSize);
+				}
+				allocator->m_HeapSize -= oldSize;
+			}
+			return nullptr;
+		}
+
+		bool newPooled = newSize <= c_MaxPooledSize;
+		void *newBlock = nullptr;
+		if (oldPooled && newPooled && GetSizeClass(oldSize) == GetSizeClass(newSize)) {
+			newBlock = block;
+		} else if (block && !oldPooled && !newPooled) {
+			newBlock = std::realloc(block, newSize);
+			if (!newBlock) {
+				return (newSize <= oldSize) ? allocator->KeepShrunkBlock(block, oldSize, newSize, false) : nullptr;
+			}
+			if (oldSize <= c_MaxPooledSize) { allocator->m_DisplacedHeapBlocks.erase(block); }
+		} else {
+			// Moving between the pool and the heap, or between size classes, always takes a copy. Lua raises a memory error if this fails while growing, leaving the old block alone
+			newBlock = newPooled ? allocator->AllocatePooled(GetSizeClass(newSize)) : std::malloc(newSize);
+			if (!newBlock) {
+				return (newSize <= oldSize) ? allocator->KeepShrunkBlock(block, oldSize, newSize, !oldPooled && newPooled) : nullptr;
+			}
+			if (block) {
+				std::memcpy(newBlock, block, std::min(oldSize, newSize));
+				if (oldPooled) {
+					allocator->FreePooled(block, GetSizeClass(oldSize));
+				} else {
+					allocator->FreeHeap(block, oldSize);
+				}
+			}
+		}
+
+		allocator->m_HeapSize += newSize;
+		allocator->m_HeapSize -= oldSize;
+		if (newSize > oldSize) { allocator->m_TotalAllocated += newSize - oldSize; }
+		return newBlock;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void * LuaAllocator::KeepShrunkBlock(void *block, size_t oldSize, size_t newSize, bool displacedFromHeap) {
+		if (displacedFromHeap) {
+			// Lua will hand it back with a pooled size, so it has to be remembered as a heap block or it would end up in a free list instead of being freed
+			try {
+				m_DisplacedHeapBlocks.insert(block);
+			} catch (const std::bad_alloc &) {
+				return nullptr;
+			}
+		}
+		m_HeapSize -= oldSize - newSize;
+		return block;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LuaAllocator::FreeHeap(void *block, size_t size) {
+		if (size <= c_MaxPooledSize) { m_DisplacedHeapBlocks.erase(block); }
+		std::free(block);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void * LuaAllocator::AllocatePooled(size_t sizeClass) {
+		FreeBlock *&freeList = m_FreeLists[sizeClass];
+		if (freeList) {
+			FreeBlock *freeBlock = freeList;
+			freeList = freeBlock->Next;
+			return freeBlock;
+		}
+
+		size_t blockSize = (sizeClass + 1) * c_SizeClassGranularity;
+		if (m_PageRemaining < blockSize) {
+			// The end of the current page is too small for this class, but it is always a whole number of granules so it can still serve a smaller one
+			if (m_PageRemaining > 0) { FreePooled(m_PageCursor, GetSizeClass(m_PageRemaining)); }
+
+			void *page = std::malloc(c_PageSize);
+			if (!page) {
+				m_PageCursor = nullptr;
+				m_PageRemaining = 0;
+				return nullptr;
+			}
+			m_Pages.push_back(page);
+			m_PageCursor = static_cast<char *>(page);
+			m_PageRemaining = c_PageSize;
+		}
+		void *newBlock = m_PageCursor;
+		m_PageCursor += blockSize;
+		m_PageRemaining -= blockSize;
+		return newBlock;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void LuaAllocator::FreePooled(void *block, size_t sizeClass) {
+		FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+		freeBlock->Next = m_FreeLists[sizeClass];
+		m_FreeLists[sizeClass] = freeBlock;
+	}
+}
@@ -0,0 +1,143 @@
+#ifndef _RTELUAALLOCATOR_
+#define _RTELUAALLOCATOR_
+
+namespace RTE {
+
+	/// <summary>
+	/// Memory allocator for a Lua state, matching the lua_Alloc signature.
+	/// Small blocks, which are the vast majority of what scripts allocate (tables, closures, short strings), are handed out from per size class free lists carved out of large pages.
+	/// Anything bigger goes straight to the C runtime heap. Also keeps count of how much memory the state uses and has allocated in total, so allocation rates can be measured.
+	/// </summary>
+	class LuaAllocator {
+
+	public:
+
+		static constexpr size_t c_SizeClassGranularity = 16; //!< Size difference between consecutive size classes. Also the alignment of every pooled block.
+		static constexpr size_t c_MaxPooledSize = 256; //!< Largest block size that is pooled.
+		static constexpr size_t c_SizeClassCount = c_MaxPooledSize / c_SizeClassGranularity; //!< Number of size classes.
+		static constexpr size_t c_PageSize = 64 * 1024; //!< Size of the pages pooled blocks are carved out of.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a LuaAllocator object in system memory.
+		/// </summary>
+		LuaAllocator() { Clear(); }
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a LuaAllocator object before deletion from system memory.
+		/// </summary>
+		~LuaAllocator() { Destroy(); }
+
+		/// <summary>
+		/// Frees all the pages of this LuaAllocator and resets it (through Clear()). Only to be done after the Lua state using it has been closed.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Gets how many bytes the Lua state currently has allocated through this.
+		/// </summary>
+		/// <returns>The size of the Lua heap in bytes.</returns>
+		size_t GetHeapSize() const { return m_HeapSize; }
+
+		/// <summary>
+		/// Gets how many bytes have been allocated through this in total, without counting anything freed since.
+		/// </summary>
+		/// <returns>The total allocated bytes.</returns>
+		unsigned long long GetTotalAllocated() const { return m_TotalAllocated; }
+
+		/// <summary>
+		/// Gets how many bytes of pages this has reserved for pooled blocks, in use or not.
+		/// </summary>
+		/// <returns>The reserved pool memory in bytes.</returns>
+		size_t GetPoolReserved() const { return m_Pages.size() * c_PageSize; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// The lua_Alloc function to create the Lua state with, passing the LuaAllocator in as the user data.
+		/// </summary>
+		/// <param name="userData">The LuaAllocator to allocate with.</param>
+		/// <param name="block">The block to reallocate or free, or null to allocate a new one.</param>
+		/// <param name="oldSize">The size of the block, as Lua always knows it.</param>
+		/// <param name="newSize">The size the block should have. 0 frees it.</param>
+		/// <returns>The new block, or null if it was freed or the allocation failed.</returns>
+		static void * Allocate(void *userData, void *block, size_t oldSize, size_t newSize);
+#pragma endregion
+
+	private:
+
+		/// <summary>
+		/// A free pooled block, linking to the next free block of the same size class.
+		/// </summary>
+		struct FreeBlock {
+			FreeBlock *Next; //!< The next free block, or null if this is the last one.
+		};
+
+		FreeBlock *m_FreeLists[c_SizeClassCount]; //!< The free blocks of each size class.
+		std::vector<void *> m_Pages; //!< All the pages pooled blocks have been carved out of. Owned by this.
+		char *m_PageCursor; //!< Where the next fresh block is carved out of the current page.
+		size_t m_PageRemaining; //!< How many bytes of the current page haven't been carved into blocks yet.
+		std::unordered_set<void *> m_DisplacedHeapBlocks; //!< Heap blocks Lua knows by a pooled size, because shrinking them into the pool failed. Almost always empty.
+		size_t m_HeapSize; //!< How many bytes are currently allocated.
+		unsigned long long m_TotalAllocated; //!< How many bytes have been allocated in total.
+
+		/// <summary>
+		/// Gets the size class a block size belongs to.
+		/// </summary>
+		/// <param name="size">The block size. Must be between 1 and c_MaxPooledSize.</param>
+		/// <returns>The index of the size class.</returns>
+		static size_t GetSizeClass(size_t size) { return (size - 1) / c_SizeClassGranularity; }
+
+		/// <summary>
+		/// Indicates whether a block Lua knows by a pooled size is actually a heap block.
+		/// </summary>
+		/// <param name="block">The block to check.</param>
+		/// <returns>Whether the block is a heap block that has to be freed as one.</returns>
+		bool IsDisplacedHeapBlock(void *block) const { return !m_DisplacedHeapBlocks.empty() && m_DisplacedHeapBlocks.find(block) != m_DisplacedHeapBlocks.end(); }
+
+		/// <summary>
+		/// Keeps a block that couldn't be shrunk, since Lua assumes shrinking never fails, and counts it as the size Lua will free it as.
+		/// </summary>
+		/// <param name="block">The block to keep.</param>
+		/// <param name="oldSize">The size of the block.</param>
+		/// <param name="newSize">The smaller size Lua asked for, and will know the block by from now on.</param>
+		/// <param name="displacedFromHeap">Whether the block is a heap block that Lua will now know by a pooled size.</param>
+		/// <returns>The kept block, or null if it couldn't be remembered as a heap block.</returns>
+		void * KeepShrunkBlock(void *block, size_t oldSize, size_t newSize, bool displacedFromHeap);
+
+		/// <summary>
+		/// Frees a heap block, forgetting it if it was a displaced one.
+		/// </summary>
+		/// <param name="block">The block to free.</param>
+		/// <param name="size">The size Lua knows the block by.</param>
+		void FreeHeap(void *block, size_t size);
+
+		/// <summary>
+		/// Takes a block from the free list of a size class, carving a new one out of the current page, or a new page, if there are none free.
+		/// </summary>
+		/// <param name="sizeClass">The size class to get a block of.</param>
+		/// <returns>The block, or null if a new page couldn't be allocated.</returns>
+		void * AllocatePooled(size_t sizeClass);
+
+		/// <summary>
+		/// Returns a block to the free list of its size class.
+		/// </summary>
+		/// <param name="block">The block to free.</param>
+		/// <param name="sizeClass">The size class the block belongs to.</param>
+		void FreePooled(void *block, size_t sizeClass);
+
+		/// <summary>
+		/// Clears all the member variables of this LuaAllocator, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		LuaAllocator(const LuaAllocator &reference) = delete;
+		LuaAllocator & operator=(const LuaAllocator &rhs) = delete;
+	};
+}
+#endif
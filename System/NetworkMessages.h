@@ -30,7 +30,8 @@ namespace RTE {
 		ID_SRV_TERRAIN,
 		ID_SRV_POST_EFFECTS,
 		ID_SRV_SOUND_EVENTS,
-		ID_SRV_MUSIC_EVENTS
+		ID_SRV_MUSIC_EVENTS,
+		ID_RLY_REGISTER
 	};
 
 // Pack the structs so 1 byte members are exactly 1 byte in memory instead of being aligned by 4 bytes (padding) so the correct representation is sent over the network without empty bytes consumed by alignment.
@@ -94,6 +95,16 @@ namespace RTE {
 		char Name[64];
 	};
 
+	/// <summary>
+	/// Sent by a spectator relay instead of MsgRegister, to have the frame stream of one player mirrored to it.
+	/// </summary>
+	struct MsgRegisterRelay {
+		unsigned char Id;
+
+		unsigned char Player;
+		char Password[64];
+	};
+
 	/// <summary>
 	/// 
 	/// </summary>
@@ -1,5 +1,6 @@
 #include "RTETools.h"
 #include "Vector.h"
+#include "RandomStream.h"
 
 namespace RTE {
 
@@ -31,12 +32,14 @@ namespace RTE {
 
 		std::seed_seq sequence(std::begin(seedData), std::end(seedData));
 		g_RNG.seed(sequence);
+		RandomStream::SetSeed(g_RNG());
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void SeedRNG(unsigned int seed) {
 		g_RNG.seed(seed);
+		RandomStream::SetSeed(seed);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
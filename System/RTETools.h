@@ -40,12 +40,12 @@ namespace RTE {
 
 #pragma region Random Numbers
 	/// <summary>
-	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine.
+	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine. Also reseeds all RandomStreams.
 	/// </summary>
 	void SeedRNG();
 
 	/// <summary>
-	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine.
+	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine. Also reseeds all RandomStreams.
 	/// </summary>
 	/// <param name="seed">Seed for the random number generator.</param>
 	void SeedRNG(unsigned int seed);
@@ -0,0 +1,72 @@
+#include "RandomStream.h"
+
+namespace RTE {
+
+	unsigned int RandomStream::s_Seed = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	RandomStream::RandomStream(StreamDomain domain, unsigned long long streamID, unsigned long long step) {
+		m_Counter = { 0, static_cast<unsigned int>(step), static_cast<unsigned int>(streamID), static_cast<unsigned int>(streamID >> 32) ^ static_cast<unsigned int>(step >> 32) };
+		m_Key = { s_Seed, static_cast<unsigned int>(domain) };
+		m_Buffer.fill(0);
+		m_BufferIndex = c_BlockSize;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int RandomStream::NextInt(int min, int max) {
+		if (max < min) { std::swap(min, max); }
+		// Scale the random bits into the range with a multiply instead of a modulo. The bias this leaves is far too small to matter for gameplay
+		unsigned long long range = static_cast<unsigned long long>(static_cast<long long>(max) - static_cast<long long>(min)) + 1;
+		return static_cast<int>(static_cast<long long>(min) + static_cast<long long>((static_cast<unsigned long long>(NextUInt()) * range) >> 32));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void RandomStream::FillFloats(float *values, size_t count, float min, float max) {
+		size_t valueIndex = 0;
+		// Use up what's left in the buffer first so the numbers come out in the same order as one at a time
+		while (valueIndex < count && m_BufferIndex < c_BlockSize) { values[valueIndex++] = NextFloat(min, max); }
+
+		// Generate whole blocks straight into the array. Every block only depends on its own counter, so the compiler is free to work on several at once
+		size_t wholeBlocks = (count - valueIndex) / c_BlockSize;
+		float range = max - min;
+		unsigned int block[c_BlockSize];
+		for (size_t blockIndex = 0; blockIndex < wholeBlocks; ++blockIndex) {
+			std::array<unsigned int, c_BlockSize> counter = m_Counter;
+			counter[0] += static_cast<unsigned int>(blockIndex);
+			GenerateBlock(counter, m_Key, block);
+			for (int i = 0; i < c_BlockSize; ++i) {
+				values[valueIndex + blockIndex * c_BlockSize + i] = min + range * ToUnitFloat(block[i]);
+			}
+		}
+		m_Counter[0] += static_cast<unsigned int>(wholeBlocks);
+		valueIndex += wholeBlocks * c_BlockSize;
+
+		while (valueIndex < count) { values[valueIndex++] = NextFloat(min, max); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void RandomStream::GenerateBlock(std::array<unsigned int, c_BlockSize> counter, std::array<unsigned int, 2> key, unsigned int *block) {
+		static constexpr unsigned long long multiplier0 = 0xD2511F53;
+		static constexpr unsigned long long multiplier1 = 0xCD9E8D57;
+		static constexpr unsigned int keyIncrement0 = 0x9E3779B9;
+		static constexpr unsigned int keyIncrement1 = 0xBB67AE85;
+
+		for (int round = 0; round < 10; ++round) {
+			unsigned long long product0 = multiplier0 * counter[0];
+			unsigned long long product1 = multiplier1 * counter[2];
+			counter = {
+				static_cast<unsigned int>(product1 >> 32) ^ counter[1] ^ key[0],
+				static_cast<unsigned int>(product1),
+				static_cast<unsigned int>(product0 >> 32) ^ counter[3] ^ key[1],
+				static_cast<unsigned int>(product0)
+			};
+			key[0] += keyIncrement0;
+			key[1] += keyIncrement1;
+		}
+		std::copy(counter.begin(), counter.end(), block);
+	}
+}
@@ -0,0 +1,118 @@
+#ifndef _RTERANDOMSTREAM_
+#define _RTERANDOMSTREAM_
+
+namespace RTE {
+
+	/// <summary>
+	/// Counter-based random number generator (Philox4x32-10) addressed by a domain, a stream ID and a step, like an MO's unique ID and the sim update number.
+	/// Every number a stream gives out is a pure function of the seed, its address and how many numbers came before it in that stream, so anything drawing from its own stream
+	/// gets the same results no matter what else drew random numbers before it, or on which thread. This keeps parallel updates and multiplayer replays deterministic.
+	/// </summary>
+	class RandomStream {
+
+	public:
+
+		/// <summary>
+		/// Enumeration of the subsystems that draw from their own streams, so the same stream ID used by two of them doesn't give both the same numbers.
+		/// </summary>
+		enum StreamDomain {
+			Emission = 0,
+			MovableObject,
+			AI,
+			Terrain,
+			Activity,
+			ScheduledEmission
+		};
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a RandomStream object in system memory.
+		/// </summary>
+		/// <param name="domain">The subsystem this stream belongs to.</param>
+		/// <param name="streamID">The ID of the stream within the domain, like the unique ID of the MO drawing from it.</param>
+		/// <param name="step">The step of the stream, like the current sim update number, so each step gets fresh numbers.</param>
+		RandomStream(StreamDomain domain, unsigned long long streamID, unsigned long long step);
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Sets the seed all streams are keyed by. Done by SeedRNG, so streams follow the seed of the global generator.
+		/// </summary>
+		/// <param name="seed">The seed to use.</param>
+		static void SetSeed(unsigned int seed) { s_Seed = seed; }
+#pragma endregion
+
+#pragma region Random Numbers
+		/// <summary>
+		/// Gets the next random 32 bits of this stream.
+		/// </summary>
+		/// <returns>A uniformly distributed random unsigned int.</returns>
+		unsigned int NextUInt() { if (m_BufferIndex == c_BlockSize) { GenerateBlock(m_Counter, m_Key, m_Buffer.data()); ++m_Counter[0]; m_BufferIndex = 0; } return m_Buffer[m_BufferIndex++]; }
+
+		/// <summary>
+		/// Gets a uniformly distributed random number in the range [0, 1).
+		/// </summary>
+		/// <returns>The random number.</returns>
+		float NextFloat() { return ToUnitFloat(NextUInt()); }
+
+		/// <summary>
+		/// Gets a uniformly distributed random number in the range [min, max).
+		/// </summary>
+		/// <param name="min">Lower boundary of the range to pick a number from.</param>
+		/// <param name="max">Upper boundary of the range to pick a number from.</param>
+		/// <returns>The random number.</returns>
+		float NextFloat(float min, float max) { return min + (max - min) * NextFloat(); }
+
+		/// <summary>
+		/// Gets a uniformly distributed random number in the range [-1, 1).
+		/// </summary>
+		/// <returns>The random number.</returns>
+		float NextNormalFloat() { return NextFloat(-1.0F, 1.0F); }
+
+		/// <summary>
+		/// Gets a uniformly distributed random integer in the range [min, max].
+		/// </summary>
+		/// <param name="min">Lower boundary of the range to pick a number from.</param>
+		/// <param name="max">Upper boundary of the range to pick a number from.</param>
+		/// <returns>The random number.</returns>
+		int NextInt(int min, int max);
+
+		/// <summary>
+		/// Fills an array with uniformly distributed random numbers in the range [min, max), generating whole blocks at a time so it can be vectorized.
+		/// Gives exactly the same numbers as calling NextFloat(min, max) the same number of times.
+		/// </summary>
+		/// <param name="values">The array to fill.</param>
+		/// <param name="count">How many numbers to put in the array.</param>
+		/// <param name="min">Lower boundary of the range to pick numbers from.</param>
+		/// <param name="max">Upper boundary of the range to pick numbers from.</param>
+		void FillFloats(float *values, size_t count, float min, float max);
+#pragma endregion
+
+	private:
+
+		static constexpr int c_BlockSize = 4; //!< How many numbers each counter value generates.
+
+		static unsigned int s_Seed; //!< The seed all streams are keyed by.
+
+		std::array<unsigned int, c_BlockSize> m_Counter; //!< The counter of the next block to generate. The first element counts blocks, the rest hold the step and stream ID.
+		std::array<unsigned int, 2> m_Key; //!< The key of this stream, made from the seed and the domain.
+		std::array<unsigned int, c_BlockSize> m_Buffer; //!< The last generated block.
+		int m_BufferIndex; //!< The index of the next unused number in the buffer. c_BlockSize when it is used up.
+
+		/// <summary>
+		/// Generates a block of random numbers from a counter and a key with the Philox4x32-10 function.
+		/// </summary>
+		/// <param name="counter">The counter to generate the block for.</param>
+		/// <param name="key">The key to generate the block with.</param>
+		/// <param name="block">The array of c_BlockSize numbers to put the block in.</param>
+		static void GenerateBlock(std::array<unsigned int, c_BlockSize> counter, std::array<unsigned int, 2> key, unsigned int *block);
+
+		/// <summary>
+		/// Turns random bits into a uniformly distributed float in the range [0, 1), using as many bits as a float's mantissa can hold.
+		/// </summary>
+		/// <param name="bits">The random bits.</param>
+		/// <returns>The random number.</returns>
+		static float ToUnitFloat(unsigned int bits) { return static_cast<float>(bits >> 8) * (1.0F / 16777216.0F); }
+	};
+}
+#endif
@@ -10,7 +10,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void Reader::Clear() {
-		m_Stream = 0;
+		m_FileData.clear();
+		m_Position = 0;
+		m_FileLoaded = false;
 		m_FilePath.clear();
 		m_CurrentLine = 1;
 		m_StreamStack.clear();
@@ -47,29 +49,24 @@ namespace RTE {
 		m_DataModuleName = m_FilePath.substr(0, firstSlashPos);
 		m_DataModuleID = g_PresetMan.GetModuleID(m_DataModuleName);
 
-		m_Stream = new std::ifstream(fileName);
-		if (!failOK) { RTEAssert(m_Stream->good(), "Failed to open data file \'" + std::string(fileName) + "\'!"); }
+		m_FileLoaded = LoadFile(m_FilePath, m_FileData);
+		if (!failOK) { RTEAssert(m_FileLoaded, "Failed to open data file \'" + std::string(fileName) + "\'!"); }
 
 		m_OverwriteExisting = overwrites;
 
 		// Report that we're starting a new file
 		m_ReportProgress = fpProgressCallback;
-		if (m_ReportProgress && m_Stream->good()) {
+		if (m_ReportProgress && m_FileLoaded) {
 			char report[512];
 			std::snprintf(report, sizeof(report), "\t%s on line %i", m_FileName.c_str(), m_CurrentLine);
 			m_ReportProgress(std::string(report), true);
 		}
-		return m_Stream->good() ? 0 : -1;
+		return m_FileLoaded ? 0 : -1;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void Reader::Destroy() {
-		delete m_Stream;
-		// Delete all the streams in the stream stack
-		for (const StreamInfo &streamInfo : m_StreamStack) {
-			delete streamInfo.Stream;
-		}
 		Clear();
 	}
 
@@ -85,27 +82,13 @@ namespace RTE {
 	void Reader::ReadLine(char *locString, int size) {
 		DiscardEmptySpace();
 
-		char temp;
-		char peek = m_Stream->peek();
-		int i = 0;
-
-		for (i = 0; i < size - 1 && peek != '\n' && peek != '\r' && peek != '\t'; ++i) {
-			temp = m_Stream->get();
-			// Check for line comment "//"
-			if (peek == '/' && m_Stream->peek() == '/') {
-				m_Stream->putback(temp);
-				break;
-			}
-			if (m_Stream->eof()) {
-				EndIncludeFile();
-				break;
-			}
-			if (!m_Stream->good()) { ReportError("Stream failed for some reason"); }
+		size_t lineEnd = FindLineEnd();
+		size_t length = std::min(lineEnd - m_Position, static_cast<size_t>(std::max(size - 1, 0)));
+		std::memcpy(locString, m_FileData.data() + m_Position, length);
+		locString[length] = '\0';
+		m_Position += length;
 
-			locString[i] = temp;
-			peek = m_Stream->peek();
-		}
-		locString[i] = '\0';
+		if (length < static_cast<size_t>(size - 1) && IsEndOfFile()) { EndIncludeFile(); }
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -113,46 +96,24 @@ namespace RTE {
 	std::string Reader::ReadLine() {
 		DiscardEmptySpace();
 
-		std::string retString;
-		char temp;
-		char peek = m_Stream->peek();
-
-		while (peek != '\n' && peek != '\r' && peek != '\t') {
-			temp = m_Stream->get();
-
-			// Check for line comment "//"
-			if (peek == '/' && m_Stream->peek() == '/') {
-				m_Stream->unget();
-				break;
-			}
-
-			if (m_Stream->eof()) { break; }
-			if (!m_Stream->good()) { ReportError("Stream failed for some reason"); }
-
-			retString.append(1, temp);
-			peek = m_Stream->peek();
-		}
-		return retString;
+		size_t lineStart = m_Position;
+		m_Position = FindLineEnd();
+		return std::string(std::string_view(m_FileData).substr(lineStart, m_Position - lineStart));
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	std::string Reader::ReadTo(char terminator, bool discardTerminator) {
-		std::string retString;
-		char temp;
-		char peek = m_Stream->peek();
-
-		while (peek != terminator) {
-			temp = m_Stream->get();
-
-			if (m_Stream->eof()) { break; }
-			if (!m_Stream->good()) { ReportError("Stream failed for some reason"); }
-
-			retString.append(1, temp);
-			peek = m_Stream->peek();
+		if (IsEndOfFile()) {
+			return "";
 		}
+		size_t readStart = m_Position;
+		const char *terminatorPos = static_cast<const char *>(std::memchr(m_FileData.data() + readStart, terminator, m_FileData.size() - readStart));
+		m_Position = terminatorPos ? terminatorPos - m_FileData.data() : m_FileData.size();
+
+		std::string retString(std::string_view(m_FileData).substr(readStart, m_Position - readStart));
 		// Discard the terminator if instructed to
-		if (discardTerminator && peek == terminator) { m_Stream->get(); }
+		if (discardTerminator && terminatorPos) { ++m_Position; }
 		return retString;
 	}
 
@@ -177,26 +138,18 @@ namespace RTE {
 	std::string Reader::ReadPropName() {
 		DiscardEmptySpace();
 
-		std::string retString;
-		char temp;
-		char peek;
-
-		while (true) {
-			peek = m_Stream->peek();
-			if (peek == '=') {
-				m_Stream->ignore(1);
-				break;
-			}
-			if (peek == '\n' || peek == '\r' || peek == '\t') {
-				ReportError("Property name wasn't followed by a value");
-			}
-			temp = m_Stream->get();
-			if (m_Stream->eof()) {
-				EndIncludeFile();
-				break;
-			}
-			if (!m_Stream->good()) { ReportError("Stream failed for some reason"); }
-			retString.append(1, temp);
+		size_t nameStart = m_Position;
+		size_t nameEnd = m_FileData.find_first_of("=\n\r\t", nameStart);
+		if (nameEnd != std::string::npos && m_FileData[nameEnd] != '=') {
+			m_Position = nameEnd;
+			ReportError("Property name wasn't followed by a value");
+		}
+		std::string retString(std::string_view(m_FileData).substr(nameStart, (nameEnd == std::string::npos ? m_FileData.size() : nameEnd) - nameStart));
+		if (nameEnd == std::string::npos) {
+			m_Position = m_FileData.size();
+			EndIncludeFile();
+		} else {
+			m_Position = nameEnd + 1;
 		}
 		// Trim the string of whitespace
 		retString = TrimString(retString);
@@ -230,28 +183,24 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	bool Reader::DiscardEmptySpace() {
-		char peek;
 		unsigned short indent = 0;
 		bool discardedLine = false;
 		char report[512];
 
 		while (true) {
-			peek = m_Stream->peek();
-
 			// If we have hit the end and don't have any files to resume, then quit and indicate that
-			if (m_Stream->eof()) {
+			if (IsEndOfFile()) {
 				return EndIncludeFile();
 			}
-			// Not end-of-file but still got junk back... something went to shit
-			if (peek == -1) { ReportError("Something went wrong reading the line; make sure it is providing the expected type"); }
+			char peek = m_FileData[m_Position];
 
 			// Discard spaces
 			if (peek == ' ') {
-				m_Stream->ignore(1);
+				++m_Position;
 			// Discard tabs, and count them
 			} else if (peek == '\t') {
 				indent++;
-				m_Stream->ignore(1);
+				++m_Position;
 			// Discard newlines and reset the tab count for the new line, also count the lines
 			} else if (peek == '\n' || peek == '\r') {
 				// So we don't count lines twice when there are both newline and carriage return at the end of lines
@@ -265,32 +214,29 @@ namespace RTE {
 				}
 				indent = 0;
 				discardedLine = true;
-				m_Stream->ignore(1);
+				++m_Position;
 
 			// Comment line?
-			} else if (m_Stream->peek() == '/') {
-				char temp = m_Stream->get();
-				char temp2;
+			} else if (peek == '/') {
+				char nextChar = (m_Position + 1 < m_FileData.size()) ? m_FileData[m_Position + 1] : '\0';
 
 				// Confirm that it's a comment line, if so discard it and continue
-				if (m_Stream->peek() == '/') {
-					while (m_Stream->peek() != '\n' && m_Stream->peek() != '\r' && !m_Stream->eof()) { m_Stream->ignore(1); }
+				if (nextChar == '/') {
+					m_Position = std::min(m_FileData.find_first_of("\n\r", m_Position), m_FileData.size());
 				// Block comment
-				} else if (m_Stream->peek() == '*') {
-					// Find the matching "*/"
-					while (!((temp2 = m_Stream->get()) == '*' && m_Stream->peek() == '/') && !m_Stream->eof()) {
-						// Count the lines within the comment though
-						if (temp2 == '\n') { ++m_CurrentLine; }
-					}
-					// Discard that final '/'
-					if (!m_Stream->eof()) { m_Stream->ignore(1); }
+				} else if (nextChar == '*') {
+					// Find the matching "*/", the search starting on the opening '*' like it always has
+					size_t commentEnd = m_FileData.find("*/", m_Position + 1);
+					commentEnd = (commentEnd == std::string::npos) ? m_FileData.size() : commentEnd + 2;
+					// Count the lines within the comment though
+					m_CurrentLine += static_cast<unsigned int>(std::count(m_FileData.begin() + m_Position, m_FileData.begin() + commentEnd, '\n'));
+					m_Position = commentEnd;
 
 				// Not a comment, so it's data, so quit.
 				} else {
-					m_Stream->putback(temp);
 					break;
 				}
-			} else { 
+			} else {
 				break;
 			}
 		}
@@ -339,16 +285,19 @@ namespace RTE {
 			std::snprintf(report, sizeof(report), "%s%s on line %i includes:", m_ReportTabs.c_str(), m_FileName.c_str(), m_CurrentLine);
 			m_ReportProgress(std::string(report), false);
 		}
-		// Push the current stream onto the StreamStack for future retrieval when the new include file has run out of data.
-		m_StreamStack.push_back(StreamInfo(m_Stream, m_FilePath, m_CurrentLine, m_PreviousIndent));
-
-		// Get the file path from the stream
-		m_FilePath = ReadPropValue();
-		m_Stream = new std::ifstream(m_FilePath.c_str());
-		if (m_Stream->fail()) {
+		// Push the current stream onto the StreamStack for future retrieval when the new include file has run out of data. The file path is read from it first so it resumes after it.
+		unsigned int includingLine = m_CurrentLine;
+		unsigned short includingIndent = m_PreviousIndent;
+		std::string includeFilePath = ReadPropValue();
+		m_StreamStack.emplace_back(std::move(m_FileData), m_Position, m_FilePath, includingLine, includingIndent);
+
+		m_FilePath = includeFilePath;
+		m_FileData.clear();
+		m_Position = 0;
+		if (!LoadFile(m_FilePath, m_FileData)) {
 			// Backpedal and set up to read the next property in the old stream
-			delete m_Stream;
-			m_Stream = m_StreamStack.back().Stream;
+			m_FileData = std::move(m_StreamStack.back().FileData);
+			m_Position = m_StreamStack.back().Position;
 			m_FilePath = m_StreamStack.back().FilePath;
 			m_CurrentLine = m_StreamStack.back().CurrentLine;
 			m_PreviousIndent = m_StreamStack.back().PreviousIndent;
@@ -400,8 +349,8 @@ namespace RTE {
 			return false;
 		}
 		// Replace the current included stream with the parent one
-		delete m_Stream;
-		m_Stream = m_StreamStack.back().Stream;
+		m_FileData = std::move(m_StreamStack.back().FileData);
+		m_Position = m_StreamStack.back().Position;
 		m_FilePath = m_StreamStack.back().FilePath;
 		m_CurrentLine = m_StreamStack.back().CurrentLine;
 		// Observe it's being added, not just replaced. This is to keep proper track when exiting out of a file
@@ -428,4 +377,69 @@ namespace RTE {
 		DiscardEmptySpace();
 		return true;
 	}
-}
\ No newline at end of file
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool Reader::LoadFile(const std::string &filePath, std::string &fileData) {
+		std::FILE *file = std::fopen(filePath.c_str(), "rb");
+		if (!file) {
+			return false;
+		}
+		std::fseek(file, 0, SEEK_END);
+		long fileSize = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+
+		fileData.resize(std::max(fileSize, 0L));
+		bool readOK = fileSize >= 0 && std::fread(fileData.data(), 1, fileData.size(), file) == fileData.size();
+		std::fclose(file);
+		if (!readOK) {
+			fileData.clear();
+			return false;
+		}
+		// Drop the carriage returns of Windows line endings in one pass, only if there are any
+		if (std::memchr(fileData.data(), '\r', fileData.size())) {
+			size_t writePos = 0;
+			for (size_t readPos = 0; readPos < fileData.size(); ++readPos) {
+				if (fileData[readPos] != '\r' || readPos + 1 == fileData.size() || fileData[readPos + 1] != '\n') { fileData[writePos++] = fileData[readPos]; }
+			}
+			fileData.resize(writePos);
+		}
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t Reader::FindLineEnd() const {
+		size_t lineEnd = m_Position;
+		while (true) {
+			lineEnd = m_FileData.find_first_of("\n\r\t/", lineEnd);
+			if (lineEnd == std::string::npos) {
+				return m_FileData.size();
+			}
+			// A lone slash is part of the line, only a line comment "//" ends it
+			if (m_FileData[lineEnd] != '/' || (lineEnd + 1 < m_FileData.size() && m_FileData[lineEnd + 1] == '/')) {
+				return lineEnd;
+			}
+			++lineEnd;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Reader & Reader::operator>>(char &var) {
+		DiscardEmptySpace();
+		if (!IsEndOfFile()) { var = m_FileData[m_Position++]; }
+		return *this;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Reader & Reader::operator>>(char *var) {
+		DiscardEmptySpace();
+		size_t wordEnd = std::min(m_FileData.find_first_of(" \t\n\r\v\f", m_Position), m_FileData.size());
+		std::memcpy(var, m_FileData.data() + m_Position, wordEnd - m_Position);
+		var[wordEnd - m_Position] = '\0';
+		m_Position = wordEnd;
+		return *this;
+	}
+}
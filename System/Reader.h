@@ -6,7 +6,7 @@ namespace RTE {
 	typedef std::function<void(std::string, bool)> ProgressCallback; //!< Convenient name definition for the progress report callback function.
 
 	/// <summary>
-	/// Reads RTE objects from std::istreams.
+	/// Reads RTE objects from data files, which are loaded whole and tokenized in memory.
 	/// </summary>
 	class Reader {
 
@@ -67,10 +67,10 @@ namespace RTE {
 		int GetReadModuleID() const;
 
 		/// <summary>
-		/// Gets a pointer to the istream of this reader.
+		/// Indicates whether everything in the file currently being read from has been read.
 		/// </summary>
-		/// <returns>A pointer to the istream object for this reader.</returns>
-		std::istream * GetStream() const { return m_Stream; }
+		/// <returns>Whether the end of the current file has been reached.</returns>
+		bool IsEndOfFile() const { return m_Position >= m_FileData.size(); }
 
 		/// <summary>
 		/// Gets the path of the current file this reader is reading from.
@@ -176,7 +176,7 @@ namespace RTE {
 		/// Shows whether this is still OK to read from. If file isn't present, etc, this will return false.
 		/// </summary>
 		/// <returns>Whether this Reader's stream is OK or not.</returns>
-		bool IsOK() const { return m_Stream && m_Stream->good(); }
+		bool IsOK() const { return m_FileLoaded && !m_EndOfStreams; }
 
 		/// <summary>
 		/// Makes an error message box pop up for the user that tells them something went wrong with the reading, and where.
@@ -191,18 +191,18 @@ namespace RTE {
 		/// </summary>
 		/// <param name="var">A reference to the variable that will be filled by the extracted data.</param>
 		/// <returns>A Reader reference for further use in an expression.</returns>
-		Reader & operator>>(bool &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(char &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(unsigned char &var) { DiscardEmptySpace(); int temp; *m_Stream >> temp; var = temp; return *this; }
-		Reader & operator>>(short &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(unsigned short &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(int &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(unsigned int &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(long &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(unsigned long &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(float &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(double &var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
-		Reader & operator>>(char * var) { DiscardEmptySpace(); *m_Stream >> var; return *this; }
+		Reader & operator>>(bool &var) { long long temp = 0; ReadNumber(temp); var = temp != 0; return *this; }
+		Reader & operator>>(char &var);
+		Reader & operator>>(unsigned char &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(short &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(unsigned short &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(int &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(unsigned int &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(long &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(unsigned long &var) { ReadInteger(var); return *this; }
+		Reader & operator>>(float &var) { ReadFloat(var); return *this; }
+		Reader & operator>>(double &var) { ReadFloat(var); return *this; }
+		Reader & operator>>(char * var);
 		Reader & operator>>(std::string &var) { var.assign(ReadLine()); return *this; }
 #pragma endregion
 
@@ -220,10 +220,10 @@ namespace RTE {
 		/// A struct containing information from the currently used stream.
 		/// </summary>
 		struct StreamInfo {
-			StreamInfo(std::ifstream *stream, std::string filePath, int currentLine, int prevIndent) : Stream(stream), FilePath(filePath), CurrentLine(currentLine), PreviousIndent(prevIndent) {}
+			StreamInfo(std::string &&fileData, size_t position, std::string filePath, int currentLine, int prevIndent) : FileData(std::move(fileData)), Position(position), FilePath(filePath), CurrentLine(currentLine), PreviousIndent(prevIndent) {}
 
-			// NOTE: These members are owned by the reader that owns this struct, so are not deleted when this is destroyed.
-			std::ifstream *Stream; //!< Currently used stream, is not on the StreamStack until a new stream is opened.
+			std::string FileData; //!< The whole contents of the stream's file.
+			size_t Position; //!< Where in the file the stream will continue reading from.
 			std::string FilePath; //!< Currently used stream's filepath.
 			unsigned int CurrentLine; //!< The line number the stream is on.
 			unsigned short PreviousIndent; //!< Count of tabs encountered on the last line DiscardEmptySpace() discarded.
@@ -231,7 +231,9 @@ namespace RTE {
 
 		static const std::string c_ClassName; //!< A string with the friendly-formatted type name of this.
 
-		std::ifstream *m_Stream; //!< Currently used stream, is not on the StreamStack until a new stream is opened.
+		std::string m_FileData; //!< The whole contents of the file currently being read from, loaded in one go. Not on the StreamStack until a new file is opened.
+		size_t m_Position; //!< Where in m_FileData the next character will be read from.
+		bool m_FileLoaded; //!< Whether the file this Reader was created with was found and loaded.
 		std::list<StreamInfo> m_StreamStack; //!< Stack of stream and filepath pairs, each one representing a file opened to read from within another.
 		bool m_EndOfStreams; //!< All streams have been depleted.
 
@@ -273,6 +275,39 @@ namespace RTE {
 		/// </summary>
 		/// <returns>Whether there were any stream on the stack to resume.</returns>
 		bool EndIncludeFile();
+
+		/// <summary>
+		/// Reads the whole contents of a file into a string with a single read, so it can be tokenized in memory instead of one character at a time through a stream.
+		/// Windows line endings are turned into plain newlines on the way, like text mode streams do.
+		/// </summary>
+		/// <param name="filePath">Path to the file to load.</param>
+		/// <param name="fileData">The string to fill with the contents of the file.</param>
+		/// <returns>Whether the file was found and read ok or not.</returns>
+		static bool LoadFile(const std::string &filePath, std::string &fileData);
+
+		/// <summary>
+		/// Finds where the line starting at the current position ends, which is at the first newline, tab or line comment, or the end of the file.
+		/// </summary>
+		/// <returns>The position of the end of the line in m_FileData.</returns>
+		size_t FindLineEnd() const;
+
+		/// <summary>
+		/// Reads an integer number after discarding any empty space before it, the same way stream extraction would but without the stream and locale overhead.
+		/// </summary>
+		/// <param name="var">A reference to the variable that will be filled by the extracted number.</param>
+		template <typename Type> void ReadInteger(Type &var) { long long temp = 0; ReadNumber(temp); var = static_cast<Type>(temp); }
+
+		/// <summary>
+		/// Reads a floating point number after discarding any empty space before it, the same way stream extraction would but without the stream and locale overhead.
+		/// </summary>
+		/// <param name="var">A reference to the variable that will be filled by the extracted number.</param>
+		template <typename Type> void ReadFloat(Type &var);
+
+		/// <summary>
+		/// Reads an integer, or a floating point number where the standard library supports it, with std::from_chars after discarding any empty space before it. Reports an error if there is something other than a number there.
+		/// </summary>
+		/// <param name="var">A reference to the variable that will be filled by the extracted number. Set to 0 if there's nothing left to read.</param>
+		template <typename Type> void ReadNumber(Type &var);
 #pragma endregion
 
 		/// <summary>
@@ -284,5 +319,43 @@ namespace RTE {
 		Reader(const Reader &reference) = delete;
 		Reader & operator=(const Reader &rhs) = delete;
 	};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template <typename Type> void Reader::ReadNumber(Type &var) {
+		DiscardEmptySpace();
+		if (IsEndOfFile()) {
+			var = 0;
+			return;
+		}
+		const char *numberStart = m_FileData.data() + m_Position;
+		const char *fileEnd = m_FileData.data() + m_FileData.size();
+		// Streams accept an explicit plus sign, std::from_chars doesn't
+		if (*numberStart == '+' && numberStart + 1 != fileEnd) { ++numberStart; }
+
+		std::from_chars_result result = std::from_chars(numberStart, fileEnd, var);
+		if (result.ec != std::errc()) { ReportError("Something went wrong reading the line; make sure it is providing the expected type"); }
+		m_Position = result.ptr - m_FileData.data();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template <typename Type> void Reader::ReadFloat(Type &var) {
+#ifdef __cpp_lib_to_chars
+		ReadNumber(var);
+#else
+		// Standard libraries before VS2019 16.4 and GCC 11 only have std::from_chars for integers. The locale is never changed from "C", so std::strtod reads numbers the same way
+		DiscardEmptySpace();
+		if (IsEndOfFile()) {
+			var = 0;
+			return;
+		}
+		const char *numberStart = m_FileData.data() + m_Position;
+		char *numberEnd = nullptr;
+		var = static_cast<Type>(std::strtod(numberStart, &numberEnd));
+		if (numberEnd == numberStart) { ReportError("Something went wrong reading the line; make sure it is providing the expected type"); }
+		m_Position = numberEnd - m_FileData.data();
+#endif
+	}
 }
 #endif
\ No newline at end of file
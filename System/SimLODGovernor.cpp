@@ -0,0 +1,34 @@
+#include "SimLODGovernor.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimLODGovernor::Clear() {
+		m_Enabled = false;
+		m_TargetLoad = c_DefaultTargetLoad;
+		m_Level = 0;
+		std::fill(std::begin(m_KnobLocked), std::end(m_KnobLocked), false);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimLODGovernor::SetTargetLoad(float targetLoad) {
+		m_TargetLoad = std::clamp(targetLoad, 0.1F, 1.0F);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimLODGovernor::Update(float simLoad) {
+		if (!m_Enabled) {
+			return;
+		}
+		// Go up quickly, harder the further over the target the load is, so a spike is caught within a few updates. Come back down slowly so detail doesn't flicker on and off
+		if (simLoad > m_TargetLoad) {
+			m_Level += c_RaiseRate * std::min(simLoad / m_TargetLoad, 4.0F);
+		} else if (simLoad < m_TargetLoad * c_HeadroomRatio) {
+			m_Level -= c_LowerRate;
+		}
+		m_Level = std::clamp(m_Level, 0.0F, 1.0F);
+	}
+}
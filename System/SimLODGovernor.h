@@ -0,0 +1,152 @@
+#ifndef _RTESIMLODGOVERNOR_
+#define _RTESIMLODGOVERNOR_
+
+namespace RTE {
+
+	/// <summary>
+	/// Keeps the simulation up with real time by trading away detail when sim updates take too long.
+	/// It raises a single level of detail reduction while the measured sim load is over its target and lowers it again slowly once there is headroom.
+	/// Every knob that level drives can be locked at full detail on its own, because anything driven by real time measurements makes the simulation non-deterministic.
+	/// </summary>
+	class SimLODGovernor {
+
+	public:
+
+		/// <summary>
+		/// Enumeration of the simulation details the governor can reduce.
+		/// </summary>
+		enum LODKnob {
+			SettleAggressiveness = 0,
+			CosmeticEmission,
+			AISenseFrequency,
+			FarUpdateRate,
+			TinyParticleMOCollision,
+			KnobCount
+		};
+
+		static constexpr float c_DefaultTargetLoad = 0.8F; //!< Default fraction of a sim update's time budget the governor aims to stay under.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a SimLODGovernor object in system memory.
+		/// </summary>
+		SimLODGovernor() { Clear(); }
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Indicates whether the governor is allowed to reduce any detail at all.
+		/// </summary>
+		/// <returns>Whether the governor is enabled.</returns>
+		bool IsEnabled() const { return m_Enabled; }
+
+		/// <summary>
+		/// Sets whether the governor is allowed to reduce any detail at all. Disabling it puts everything back to full detail right away.
+		/// </summary>
+		/// <param name="enable">Whether the governor is enabled.</param>
+		void SetEnabled(bool enable) { m_Enabled = enable; if (!enable) { Reset(); } }
+
+		/// <summary>
+		/// Gets the fraction of a sim update's time budget the governor aims to stay under.
+		/// </summary>
+		/// <returns>The target load.</returns>
+		float GetTargetLoad() const { return m_TargetLoad; }
+
+		/// <summary>
+		/// Sets the fraction of a sim update's time budget the governor aims to stay under.
+		/// </summary>
+		/// <param name="targetLoad">The target load. Clamped to between 0.1 and 1.</param>
+		void SetTargetLoad(float targetLoad);
+
+		/// <summary>
+		/// Indicates whether a knob is locked at full detail, so the simulation stays deterministic in what it controls.
+		/// </summary>
+		/// <param name="knob">The knob to check.</param>
+		/// <returns>Whether the knob is locked.</returns>
+		bool IsKnobLocked(LODKnob knob) const { return m_KnobLocked[knob]; }
+
+		/// <summary>
+		/// Sets whether a knob is locked at full detail, so the simulation stays deterministic in what it controls.
+		/// </summary>
+		/// <param name="knob">The knob to lock or unlock.</param>
+		/// <param name="lock">Whether the knob is locked.</param>
+		void SetKnobLocked(LODKnob knob, bool lock) { m_KnobLocked[knob] = lock; }
+
+		/// <summary>
+		/// Gets the current level of detail reduction, regardless of which knobs are locked.
+		/// </summary>
+		/// <returns>The level, from 0 (full detail) to 1 (most reduced).</returns>
+		float GetLevel() const { return m_Level; }
+
+		/// <summary>
+		/// Gets how much a knob's detail is currently reduced.
+		/// </summary>
+		/// <param name="knob">The knob to get the level of.</param>
+		/// <returns>The level of the knob, from 0 (full detail) to 1 (most reduced). Always 0 for locked knobs.</returns>
+		float GetKnobLevel(LODKnob knob) const { return m_KnobLocked[knob] ? 0 : m_Level; }
+#pragma endregion
+
+#pragma region Knob Values
+		/// <summary>
+		/// Gets how much the rest thresholds of particles and the limit of loose items are scaled, so things settle sooner.
+		/// </summary>
+		/// <returns>The scale, from 1 (full detail) down to 0.25.</returns>
+		float GetSettleThresholdScale() const { return 1.0F - 0.75F * GetKnobLevel(SettleAggressiveness); }
+
+		/// <summary>
+		/// Gets how much the rates of cosmetic emissions are scaled.
+		/// </summary>
+		/// <returns>The scale, from 1 (full detail) down to 0.</returns>
+		float GetCosmeticEmissionScale() const { return 1.0F - GetKnobLevel(CosmeticEmission); }
+
+		/// <summary>
+		/// Gets how many sim updates apart the native AI of each Actor gets to look for MOs.
+		/// </summary>
+		/// <returns>The interval, 1 being every update.</returns>
+		int GetAISenseInterval() const { return 1 + static_cast<int>(GetKnobLevel(AISenseFrequency) * static_cast<float>(c_MaxUpdateInterval - 1) + 0.5F); }
+
+		/// <summary>
+		/// Gets how many sim updates apart items and particles that aren't near any screen get updated. They still travel every update.
+		/// </summary>
+		/// <returns>The interval, 1 being every update.</returns>
+		int GetFarUpdateInterval() const { return 1 + static_cast<int>(GetKnobLevel(FarUpdateRate) * static_cast<float>(c_MaxUpdateInterval - 1) + 0.5F); }
+
+		/// <summary>
+		/// Indicates whether newly added tiny particles should still collide with MOs.
+		/// </summary>
+		/// <returns>Whether tiny particles hit MOs.</returns>
+		bool TinyParticlesHitMOs() const { return GetKnobLevel(TinyParticleMOCollision) < 0.5F; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Updates the level of detail reduction from the latest sim load measurement. Supposed to be done every sim update.
+		/// </summary>
+		/// <param name="simLoad">How long recent sim updates took, as a fraction of the time each one is meant to represent.</param>
+		void Update(float simLoad);
+
+		/// <summary>
+		/// Puts the SimLODGovernor back to full detail, keeping its settings.
+		/// </summary>
+		void Reset() { m_Level = 0; }
+#pragma endregion
+
+	private:
+
+		static constexpr int c_MaxUpdateInterval = 4; //!< The most sim updates apart anything throttled by the governor gets updated.
+		static constexpr float c_RaiseRate = 0.02F; //!< How much the level goes up per sim update at the target load. Scales with how far over the target the load is.
+		static constexpr float c_LowerRate = 0.002F; //!< How much the level goes down per sim update when there's headroom.
+		static constexpr float c_HeadroomRatio = 0.75F; //!< Fraction of the target load the sim load has to be under for the level to go down.
+
+		bool m_Enabled; //!< Whether the governor is allowed to reduce any detail. Off unless opted into through Settings.ini, because it makes the sim depend on how fast the machine runs it.
+		float m_TargetLoad; //!< The fraction of a sim update's time budget to stay under.
+		float m_Level; //!< The current level of detail reduction, from 0 to 1.
+		bool m_KnobLocked[KnobCount]; //!< Which knobs are locked at full detail.
+
+		/// <summary>
+		/// Clears all the member variables of this SimLODGovernor, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
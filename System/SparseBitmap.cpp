@@ -0,0 +1,110 @@
+#include "SparseBitmap.h"
+#include "RTEError.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// The row storage of a sparse BITMAP, kept in the BITMAP's extra pointer.
+	/// </summary>
+	struct SparseBitmapRows {
+		std::array<std::unique_ptr<unsigned char[]>, 256> UniformRows; //!< One read-only row per value whole rows are filled with, created when the first such row is found.
+		std::vector<std::unique_ptr<unsigned char[]>> OwnedRows; //!< The pixels of each row that has its own, indexed by row. Null for rows still pointing at a uniform row.
+		int OwnedRowCount; //!< How many rows have their own pixels.
+	};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	BITMAP * SparseBitmap::Create(const BITMAP *sourceBitmap) {
+		RTEAssert(sourceBitmap && bitmap_color_depth(const_cast<BITMAP *>(sourceBitmap)) == 8, "Trying to create a sparse BITMAP from something that isn't an 8bpp BITMAP!");
+		const int width = sourceBitmap->w;
+		const int height = sourceBitmap->h;
+
+		// Borrow the vtable and read bank switcher of a regular memory BITMAP of the same depth, so the sparse one is drawn with the same routines
+		BITMAP *templateBitmap = create_bitmap_ex(8, 1, 1);
+		if (!templateBitmap) {
+			return nullptr;
+		}
+		// Allocated the way Allegro allocates memory BITMAPs, with at least two line pointers, but without the block of pixels they point into
+		BITMAP *bitmap = static_cast<BITMAP *>(std::malloc(sizeof(BITMAP) + sizeof(unsigned char *) * std::max(height, 2)));
+		if (!bitmap) {
+			destroy_bitmap(templateBitmap);
+			return nullptr;
+		}
+		bitmap->w = bitmap->cr = width;
+		bitmap->h = bitmap->cb = height;
+		bitmap->clip = TRUE;
+		bitmap->cl = bitmap->ct = 0;
+		bitmap->vtable = templateBitmap->vtable;
+		bitmap->read_bank = templateBitmap->read_bank;
+		bitmap->write_bank = reinterpret_cast<void *>(&SparseBitmap::WriteRow);
+		bitmap->dat = nullptr;
+		// Flagged as a system BITMAP so Allegro's sprite routines go through the bank switcher for each row too, instead of writing through the line pointers directly
+		bitmap->id = BMP_ID_SYSTEM;
+		bitmap->x_ofs = 0;
+		bitmap->y_ofs = 0;
+		bitmap->seg = templateBitmap->seg;
+		destroy_bitmap(templateBitmap);
+
+		SparseBitmapRows *rows = new SparseBitmapRows();
+		rows->OwnedRows.resize(height);
+		rows->OwnedRowCount = 0;
+		bitmap->extra = rows;
+
+		for (int y = 0; y < height; ++y) {
+			const unsigned char *sourceRow = sourceBitmap->line[y];
+			// A row is uniform if every pixel is the same as the one after it
+			if (width <= 1 || std::memcmp(sourceRow, sourceRow + 1, width - 1) == 0) {
+				std::unique_ptr<unsigned char[]> &uniformRow = rows->UniformRows[sourceRow[0]];
+				if (!uniformRow) {
+					uniformRow.reset(new unsigned char[width]);
+					std::memset(uniformRow.get(), sourceRow[0], width);
+				}
+				bitmap->line[y] = uniformRow.get();
+			} else {
+				rows->OwnedRows[y].reset(new unsigned char[width]);
+				std::memcpy(rows->OwnedRows[y].get(), sourceRow, width);
+				bitmap->line[y] = rows->OwnedRows[y].get();
+				rows->OwnedRowCount++;
+			}
+		}
+		return bitmap;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SparseBitmap::Destroy(BITMAP *bitmap) {
+		if (!IsSparse(bitmap)) {
+			destroy_bitmap(bitmap);
+			return;
+		}
+		// Allegro can't destroy these, its system BITMAP path would hand it to the graphics driver
+		delete static_cast<SparseBitmapRows *>(bitmap->extra);
+		std::free(bitmap);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool SparseBitmap::IsSparse(const BITMAP *bitmap) {
+		return bitmap && bitmap->write_bank == reinterpret_cast<void *>(&SparseBitmap::WriteRow);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SparseBitmap::GetOwnedRowCount(const BITMAP *bitmap) {
+		return IsSparse(bitmap) ? static_cast<const SparseBitmapRows *>(bitmap->extra)->OwnedRowCount : bitmap->h;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	uintptr_t SparseBitmap::WriteRow(BITMAP *bitmap, int row) {
+		SparseBitmapRows *rows = static_cast<SparseBitmapRows *>(bitmap->extra);
+		std::unique_ptr<unsigned char[]> &ownedRow = rows->OwnedRows[row];
+		if (!ownedRow) {
+			ownedRow.reset(new unsigned char[bitmap->w]);
+			std::memcpy(ownedRow.get(), bitmap->line[row], bitmap->w);
+			bitmap->line[row] = ownedRow.get();
+			rows->OwnedRowCount++;
+		}
+		return reinterpret_cast<uintptr_t>(bitmap->line[row]);
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef _RTESPARSEBITMAP_
+#define _RTESPARSEBITMAP_
+
+struct BITMAP;
+
+namespace RTE {
+
+	/// <summary>
+	/// Builds 8bpp BITMAPs whose rows are allocated on demand. Rows that are filled with a single value, like the all-air sky or all-solid bedrock of a terrain layer,
+	/// all point at one shared row per value and cost no pixel memory of their own. A row gets its own copy of its pixels the first time anything writes to it.
+	/// The copy happens in the BITMAP's write bank switcher, which every Allegro drawing routine goes through for each row it writes to, so sparse BITMAPs can be drawn to,
+	/// blitted and read through their line pointers like any other. Code that writes through line pointers itself has to get them from bmp_write_line instead.
+	/// </summary>
+	class SparseBitmap {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Creates a sparse BITMAP holding the same pixels as another 8bpp BITMAP. The source BITMAP is left as it is.
+		/// </summary>
+		/// <param name="sourceBitmap">The 8bpp BITMAP to copy the pixels of. Can itself be sparse. Ownership is NOT transferred!</param>
+		/// <returns>The new sparse BITMAP, or nullptr if it couldn't be allocated. Ownership IS transferred! It has to be destroyed with SparseBitmap::Destroy.</returns>
+		static BITMAP * Create(const BITMAP *sourceBitmap);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destroys a BITMAP and frees all its rows. Works on regular BITMAPs too, so owners that might hold either kind can use it for both.
+		/// </summary>
+		/// <param name="bitmap">The BITMAP to destroy. Can be nullptr.</param>
+		static void Destroy(BITMAP *bitmap);
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Indicates whether a BITMAP was created by SparseBitmap.
+		/// </summary>
+		/// <param name="bitmap">The BITMAP to check. Can be nullptr.</param>
+		/// <returns>Whether the BITMAP is sparse.</returns>
+		static bool IsSparse(const BITMAP *bitmap);
+
+		/// <summary>
+		/// Gets how many rows of a sparse BITMAP have their own pixel memory, as opposed to sharing a uniform row.
+		/// </summary>
+		/// <param name="bitmap">The sparse BITMAP to check.</param>
+		/// <returns>The number of rows with their own pixel memory. All of them if the BITMAP isn't sparse.</returns>
+		static int GetOwnedRowCount(const BITMAP *bitmap);
+#pragma endregion
+
+	private:
+
+		/// <summary>
+		/// Gives a row of a sparse BITMAP its own pixels if it's still using a shared uniform row, so it can be written to. Installed as the BITMAP's write bank switcher.
+		/// Only the main thread writes to the BITMAPs this is used for, so it doesn't lock anything. Shared rows stay valid until the BITMAP is destroyed,
+		/// so threads reading through the line pointers while a row is being copied see either the old or the new row.
+		/// </summary>
+		/// <param name="bitmap">The sparse BITMAP being written to.</param>
+		/// <param name="row">The row about to be written to.</param>
+		/// <returns>The address of the row's own pixels.</returns>
+		static uintptr_t WriteRow(BITMAP *bitmap, int row);
+
+		// Disallow the use of some implicit methods.
+		SparseBitmap() = delete;
+	};
+}
+#endif
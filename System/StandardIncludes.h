@@ -11,8 +11,13 @@
 #include <functional>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
 #include <cctype>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <cstring>
 #include <vector>
 #include <list>
@@ -35,6 +40,7 @@
 #include <limits>
 #include <random>
 #include <array>
+#include <bitset>
 #include <filesystem>
 
 // TODO: Get rid of these once alias qualifiers are added.